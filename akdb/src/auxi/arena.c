@@ -0,0 +1,421 @@
+/**
+@file arena.c File that provides the region (arena) allocator used for query-scoped temporary memory
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "arena.h"
+
+#ifdef _WIN32
+#define AK_THREAD_LOCAL __declspec(thread)
+#else
+#define AK_THREAD_LOCAL __thread
+#endif
+
+/**
+ * @var AK_current_arena
+ * @brief Arena that temporary allocations of the calling thread go to, NULL if there is none
+ */
+static AK_THREAD_LOCAL AK_arena *AK_current_arena = NULL;
+
+/**
+ * @brief Function that rounds size up to the arena alignment
+ * @param size requested size
+ * @return aligned size
+ */
+static size_t AK_arena_align(size_t size) {
+    return (size + AK_ARENA_ALIGN - 1) & ~((size_t) AK_ARENA_ALIGN - 1);
+}
+
+/**
+ * @brief Function that allocates a new chunk and puts it at the head of the arena. In debug mode every
+ *        allocation gets a chunk of its own, so the debmod wrappers still see (and guard) each object separately.
+ * @param arena arena that receives the chunk
+ * @param size minimal number of usable bytes in the chunk
+ * @return pointer to the new chunk or NULL
+ */
+static AK_arena_chunk *AK_arena_new_chunk(AK_arena *arena, size_t size) {
+    AK_PRO;
+    size_t chunk_size = size;
+    AK_arena_chunk *chunk;
+
+    if (!AK_DEBMOD_ON) {
+        if (chunk_size < arena->chunk_size)
+            chunk_size = arena->chunk_size;
+        if (arena->chunk_size < AK_ARENA_MAX_CHUNK_SIZE)
+            arena->chunk_size *= 2;
+    }
+
+    chunk = (AK_arena_chunk *) AK_malloc(sizeof (AK_arena_chunk));
+    if (chunk == NULL) {
+        AK_EPI;
+        return NULL;
+    }
+    chunk->data = (char *) AK_malloc(chunk_size);
+    if (chunk->data == NULL) {
+        AK_free(chunk);
+        AK_EPI;
+        return NULL;
+    }
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    chunk->next = arena->head;
+    arena->head = chunk;
+    AK_EPI;
+    return chunk;
+}
+
+/**
+ * @brief Function that initializes an empty arena. No memory is reserved until the first allocation.
+ * @param arena arena to initialize
+ * @param chunk_size size of the first chunk, 0 for AK_ARENA_CHUNK_SIZE
+ * @return No return value
+ */
+void AK_arena_init(AK_arena *arena, size_t chunk_size) {
+    AK_PRO;
+    arena->head = NULL;
+    arena->chunk_size = chunk_size > 0 ? chunk_size : AK_ARENA_CHUNK_SIZE;
+    arena->allocated = 0;
+    arena->parent = NULL;
+    AK_EPI;
+}
+
+/**
+ * @brief Function that allocates size bytes from the arena. Memory is not initialized.
+ * @param arena arena to allocate from
+ * @param size number of bytes
+ * @return pointer to the memory or NULL if the system is out of memory
+ */
+void *AK_arena_alloc(AK_arena *arena, size_t size) {
+    AK_PRO;
+    AK_arena_chunk *chunk = arena->head;
+    void *ptr;
+
+    size = AK_arena_align(size > 0 ? size : 1);
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        chunk = AK_arena_new_chunk(arena, size);
+        if (chunk == NULL) {
+            AK_EPI;
+            return NULL;
+        }
+    }
+    ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->allocated += size;
+    AK_EPI;
+    return ptr;
+}
+
+/**
+ * @brief Function that allocates size bytes from the arena and sets them to zero
+ * @param arena arena to allocate from
+ * @param size number of bytes
+ * @return pointer to the memory or NULL
+ */
+void *AK_arena_calloc(AK_arena *arena, size_t size) {
+    AK_PRO;
+    void *ptr = AK_arena_alloc(arena, size);
+    if (ptr != NULL)
+        memset(ptr, 0, size);
+    AK_EPI;
+    return ptr;
+}
+
+/**
+ * @brief Function that checks whether ptr was handed out by the arena
+ * @param arena arena to check
+ * @param ptr pointer to check
+ * @return 1 if the pointer lies in one of the arena chunks, 0 otherwise
+ */
+int AK_arena_owns(AK_arena *arena, void *ptr) {
+    AK_PRO;
+    AK_arena_chunk *chunk;
+    char *p = (char *) ptr;
+
+    for (chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+        if (p >= chunk->data && p < chunk->data + chunk->size) {
+            AK_EPI;
+            return 1;
+        }
+    }
+    AK_EPI;
+    return 0;
+}
+
+/**
+ * @brief Function that remembers the current arena position
+ * @param arena arena
+ * @return mark that can be passed to AK_arena_release
+ */
+AK_arena_mark AK_arena_get_mark(AK_arena *arena) {
+    AK_PRO;
+    AK_arena_mark mark;
+    mark.chunk = arena->head;
+    mark.used = arena->head != NULL ? arena->head->used : 0;
+    mark.allocated = arena->allocated;
+    AK_EPI;
+    return mark;
+}
+
+/**
+ * @brief Function that releases everything allocated after the mark was taken. Chunks created after
+ *        the mark are returned to the system, the marked chunk is rewound. A mark taken on an empty
+ *        arena resets it.
+ * @param arena arena
+ * @param mark mark returned by AK_arena_get_mark
+ * @return No return value
+ */
+void AK_arena_release(AK_arena *arena, AK_arena_mark mark) {
+    AK_PRO;
+    AK_arena_chunk *next;
+
+    if (mark.chunk == NULL) {
+        /* mark of an empty arena, keep one chunk so a per-row mark/release does not hit the heap every time */
+        AK_arena_reset(arena);
+        AK_EPI;
+        return;
+    }
+    while (arena->head != NULL && arena->head != mark.chunk) {
+        next = arena->head->next;
+        AK_free(arena->head->data);
+        AK_free(arena->head);
+        arena->head = next;
+    }
+    if (arena->head != NULL)
+        arena->head->used = mark.used;
+    arena->allocated = mark.allocated;
+    AK_EPI;
+}
+
+/**
+ * @brief Function that empties the arena but keeps its newest (largest) chunk for reuse
+ * @param arena arena
+ * @return No return value
+ */
+void AK_arena_reset(AK_arena *arena) {
+    AK_PRO;
+    AK_arena_chunk *chunk, *next;
+
+    if (arena->head != NULL) {
+        chunk = arena->head->next;
+        while (chunk != NULL) {
+            next = chunk->next;
+            AK_free(chunk->data);
+            AK_free(chunk);
+            chunk = next;
+        }
+        arena->head->next = NULL;
+        arena->head->used = 0;
+    }
+    arena->allocated = 0;
+    AK_EPI;
+}
+
+/**
+ * @brief Function that returns all arena memory to the system
+ * @param arena arena
+ * @return No return value
+ */
+void AK_arena_destroy(AK_arena *arena) {
+    AK_PRO;
+    AK_arena_chunk *next;
+
+    while (arena->head != NULL) {
+        next = arena->head->next;
+        AK_free(arena->head->data);
+        AK_free(arena->head);
+        arena->head = next;
+    }
+    arena->allocated = 0;
+    AK_EPI;
+}
+
+/**
+ * @brief Function that returns the arena temporary allocations of the calling thread currently go to
+ * @return current arena or NULL
+ */
+AK_arena *AK_arena_current() {
+    return AK_current_arena;
+}
+
+/**
+ * @brief Function that changes the current arena of the calling thread. Passing NULL makes temporary
+ *        allocations go to the heap again, e.g. around calls whose results outlive the query.
+ * @param arena new current arena or NULL
+ * @return previous current arena
+ */
+AK_arena *AK_arena_set_current(AK_arena *arena) {
+    AK_arena *previous = AK_current_arena;
+    AK_current_arena = arena;
+    return previous;
+}
+
+/**
+ * @brief Function that opens a query scope. A new arena becomes current, all temporary lists and buffers
+ *        allocated until AK_query_arena_end are freed at once. Scopes can be nested.
+ * @return arena of the new scope or NULL if it could not be allocated
+ */
+AK_arena *AK_query_arena_begin() {
+    AK_PRO;
+    AK_arena *arena = (AK_arena *) AK_malloc(sizeof (AK_arena));
+    if (arena == NULL) {
+        AK_EPI;
+        return NULL;
+    }
+    AK_arena_init(arena, AK_ARENA_CHUNK_SIZE);
+    arena->parent = AK_current_arena;
+    AK_current_arena = arena;
+    AK_EPI;
+    return arena;
+}
+
+/**
+ * @brief Function that closes a query scope opened by AK_query_arena_begin, frees all its memory
+ *        and makes the enclosing scope current again
+ * @param arena arena returned by AK_query_arena_begin
+ * @return No return value
+ */
+void AK_query_arena_end(AK_arena *arena) {
+    AK_PRO;
+    if (arena == NULL) {
+        AK_EPI;
+        return;
+    }
+    AK_current_arena = arena->parent;
+    AK_arena_destroy(arena);
+    AK_free(arena);
+    AK_EPI;
+}
+
+/**
+ * @brief Function that allocates temporary memory. It comes from the current arena if there is one,
+ *        otherwise from the heap.
+ * @param size number of bytes
+ * @return pointer to the memory
+ */
+void *AK_temp_alloc(size_t size) {
+    AK_PRO;
+    void *ptr;
+    if (AK_current_arena != NULL)
+        ptr = AK_arena_alloc(AK_current_arena, size);
+    else
+        ptr = AK_malloc(size);
+    AK_EPI;
+    return ptr;
+}
+
+/**
+ * @brief Function that frees memory allocated by AK_temp_alloc. Memory owned by the current arena or
+ *        one of the enclosing ones is left for the wholesale release, heap memory is freed.
+ * @param ptr pointer to free
+ * @return No return value
+ */
+void AK_temp_free(void *ptr) {
+    AK_PRO;
+    AK_arena *arena;
+    if (ptr == NULL) {
+        AK_EPI;
+        return;
+    }
+    for (arena = AK_current_arena; arena != NULL; arena = arena->parent) {
+        if (AK_arena_owns(arena, ptr)) {
+            AK_EPI;
+            return;
+        }
+    }
+    AK_free(ptr);
+    AK_EPI;
+}
+
+/**
+ * @brief Function for testing the arena allocator
+ * @return TestResult
+ */
+TestResult AK_arena_test() {
+    AK_PRO;
+    int passed = 0, failed = 0;
+    int i;
+    AK_arena arena;
+    AK_arena_mark mark;
+    AK_arena *query, *inner;
+    char *small, *big, *p;
+
+    printf("\nArena allocation test\n");
+    AK_arena_init(&arena, 256);
+    small = (char *) AK_arena_alloc(&arena, 10);
+    p = (char *) AK_arena_alloc(&arena, 10);
+    if (small != NULL && p == small + AK_ARENA_ALIGN && ((size_t) p % AK_ARENA_ALIGN) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    printf("\nArena growth test\n");
+    big = (char *) AK_arena_alloc(&arena, 1000);
+    memset(big, 'x', 1000);
+    if (big != NULL && AK_arena_owns(&arena, big) && AK_arena_owns(&arena, small) && arena.allocated == 2 * AK_ARENA_ALIGN + 1008) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    printf("\nArena mark/release test\n");
+    mark = AK_arena_get_mark(&arena);
+    for (i = 0; i < 100; i++)
+        AK_arena_alloc(&arena, 100);
+    AK_arena_release(&arena, mark);
+    if (arena.allocated == mark.allocated && arena.head == mark.chunk && arena.head->used == mark.used) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_arena_destroy(&arena);
+
+    printf("\nQuery scope test\n");
+    query = AK_query_arena_begin();
+    p = (char *) AK_temp_alloc(32);
+    inner = AK_query_arena_begin();
+    small = (char *) AK_temp_alloc(32);
+    AK_temp_free(p);
+    AK_temp_free(small);
+    if (AK_arena_current() == inner && AK_arena_owns(query, p) && AK_arena_owns(inner, small)) {
+        passed++;
+    } else {
+        failed++;
+    }
+    AK_query_arena_end(inner);
+    AK_query_arena_end(query);
+    p = (char *) AK_temp_alloc(32);
+    if (AK_arena_current() == NULL && p != NULL) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_temp_free(p);
+
+    printf("\nNumber of tests that pass: %i\n", passed);
+    printf("Number of tests that fail: %i\n", failed);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
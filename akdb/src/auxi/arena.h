@@ -0,0 +1,100 @@
+/**
+@file arena.h Header file that provides data structures and declarations of functions for the region (arena) allocator
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef ARENA
+#define ARENA
+
+#include "test.h"
+#include "debug.h"
+#include "mempro.h"
+
+/**
+ * @def AK_ARENA_CHUNK_SIZE
+ * @brief size in bytes of the first chunk an arena reserves
+ */
+#define AK_ARENA_CHUNK_SIZE 65536
+
+/**
+ * @def AK_ARENA_MAX_CHUNK_SIZE
+ * @brief upper bound for chunk growth, chunks double in size until they reach it
+ */
+#define AK_ARENA_MAX_CHUNK_SIZE (4 * 1024 * 1024)
+
+/**
+ * @def AK_ARENA_ALIGN
+ * @brief alignment of every allocation handed out by an arena
+ */
+#define AK_ARENA_ALIGN 16
+
+/**
+ * @struct AK_arena_chunk
+ * @brief One contiguous piece of memory owned by an arena. Chunks are chained from the newest to the oldest.
+ */
+typedef struct AK_arena_chunk {
+    struct AK_arena_chunk *next;
+    size_t size;
+    size_t used;
+    char *data;
+} AK_arena_chunk;
+
+/**
+ * @struct AK_arena
+ * @brief Region allocator. Objects are bump-allocated from chunks and are never freed one by one,
+ *        the whole region is released at once (or rolled back to a mark).
+ * @var head newest chunk
+ * @var chunk_size size of the next chunk that will be requested
+ * @var allocated number of bytes handed out so far
+ * @var parent arena that was current before this one became current
+ */
+typedef struct AK_arena {
+    AK_arena_chunk *head;
+    size_t chunk_size;
+    size_t allocated;
+    struct AK_arena *parent;
+} AK_arena;
+
+/**
+ * @struct AK_arena_mark
+ * @brief Saved arena position, used to release everything allocated after it
+ */
+typedef struct {
+    AK_arena_chunk *chunk;
+    size_t used;
+    size_t allocated;
+} AK_arena_mark;
+
+void AK_arena_init(AK_arena *arena, size_t chunk_size);
+void *AK_arena_alloc(AK_arena *arena, size_t size);
+void *AK_arena_calloc(AK_arena *arena, size_t size);
+int AK_arena_owns(AK_arena *arena, void *ptr);
+AK_arena_mark AK_arena_get_mark(AK_arena *arena);
+void AK_arena_release(AK_arena *arena, AK_arena_mark mark);
+void AK_arena_reset(AK_arena *arena);
+void AK_arena_destroy(AK_arena *arena);
+
+AK_arena *AK_arena_current();
+AK_arena *AK_arena_set_current(AK_arena *arena);
+AK_arena *AK_query_arena_begin();
+void AK_query_arena_end(AK_arena *arena);
+void *AK_temp_alloc(size_t size);
+void AK_temp_free(void *ptr);
+
+TestResult AK_arena_test();
+
+#endif
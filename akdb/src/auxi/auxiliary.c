@@ -320,9 +320,10 @@ void AK_InsertBefore_L2(int type, char *data, int size,
   AK_PRO;
   struct list_node *new_elem;
 
-  new_elem = (struct list_node *)AK_malloc(sizeof(struct list_node));
+  new_elem = (struct list_node *)AK_temp_alloc(sizeof(struct list_node));
   new_elem->size = size;
   new_elem->type = type;
+  new_elem->is_null = 0;
 
   memcpy(new_elem->data, data, MAX_VARCHAR_LENGTH);
 
@@ -354,9 +355,10 @@ void AK_InsertAfter_L2(int type, char *data, int size,
   AK_PRO;
   struct list_node *new_elem;
 
-  new_elem = (struct list_node *)AK_malloc(sizeof(struct list_node));
+  new_elem = (struct list_node *)AK_temp_alloc(sizeof(struct list_node));
   new_elem->size = size;
   new_elem->type = type;
+  new_elem->is_null = 0;
   memcpy(new_elem->data, data, MAX_VARCHAR_LENGTH);
   if ((*current) == NULL) {
     (*L)->next = new_elem;
@@ -427,7 +429,7 @@ void AK_Delete_L3(struct list_node **current, struct list_node **L) {
   struct list_node *next = (*current)->next; // NextL( current, L );
 
   previous->next = next;
-  AK_free((*current));
+  AK_temp_free((*current));
   AK_EPI;
 }
 
@@ -450,7 +452,7 @@ void AK_DeleteAll_L3(struct list_node **L) {
   int counter = 0;
   while ((current = AK_First_L2(*L)) != NULL) {
     (*L)->next = current->next;
-    AK_free(current);
+    AK_temp_free(current);
     counter++;
     assert(counter < MAX_LOOP_ITERATIONS);
   }
@@ -31,6 +31,7 @@
 #include "ctype.h"
 #include "debug.h"
 #include "mempro.h"
+#include "arena.h"
 
 #define MAX_LOOP_ITERATIONS 1000
 //#include "ini_parser/iniparser.h"
@@ -74,6 +75,8 @@ struct list_node {
     //attribute name
     char attribute_name[ MAX_ATT_NAME ];
      int constraint; //if 0 then it is new data for insertion, if 1 then it is a constraint on which update and delete searches the data
+    //1 if the element holds NULL, data is then empty and type is the type of the column
+    int is_null;
     ///pointer to next element
     struct list_node *next;
 };
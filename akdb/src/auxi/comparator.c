@@ -0,0 +1,179 @@
+/**
+@file comparator.c File that provides the registry of type-aware comparators and hash functions
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "comparator.h"
+
+/**
+ * @var AK_type_registry
+ * @brief Comparator and hash function of every type, indexed by the type constant.
+ *        Types without a binary representation of their own are compared as bytes.
+ */
+AK_type_ops AK_type_registry[MAX_TYPE_OPS] = {
+    {AK_compare_int, AK_hash_int},       /* TYPE_INTERNAL */
+    {AK_compare_int, AK_hash_int},       /* TYPE_INT */
+    {AK_compare_float, AK_hash_float},   /* TYPE_FLOAT */
+    {AK_compare_number, AK_hash_number}, /* TYPE_NUMBER */
+    {AK_compare_bytes, AK_hash_bytes},   /* TYPE_VARCHAR */
+    {AK_compare_int, AK_hash_int},       /* TYPE_DATE */
+    {AK_compare_int, AK_hash_int},       /* TYPE_DATETIME */
+    {AK_compare_int, AK_hash_int},       /* TYPE_TIME */
+    {AK_compare_int, AK_hash_int},       /* TYPE_INTERVAL */
+    {AK_compare_int, AK_hash_int},       /* TYPE_PERIOD */
+    {AK_compare_bytes, AK_hash_bytes},   /* TYPE_BLOB */
+    {AK_compare_bool, AK_hash_bool},     /* TYPE_BOOL */
+    {AK_compare_bytes, AK_hash_bytes},   /* TYPE_OPERAND */
+    {AK_compare_bytes, AK_hash_bytes},   /* TYPE_OPERATOR */
+    {AK_compare_bytes, AK_hash_bytes},   /* TYPE_ATTRIBS */
+    {AK_compare_bytes, AK_hash_bytes},   /* TYPE_CONDITION */
+    {AK_compare_bytes, AK_hash_bytes}    /* TYPE_AGGREGATOR */
+};
+
+/**
+ * @author Unknown
+ * @brief Function that returns the comparator and hash function registered for a type
+ * @param type data type
+ * @return registry entry, the TYPE_VARCHAR (byte) entry for unknown types
+ */
+AK_type_ops *AK_get_type_ops(int type) {
+    AK_PRO;
+    if (type < 0 || type >= MAX_TYPE_OPS)
+        type = TYPE_VARCHAR;
+    AK_EPI;
+    return &AK_type_registry[type];
+}
+
+/**
+ * @author Unknown
+ * @brief Function that replaces the comparator and/or hash function of a type
+ * @param type data type
+ * @param compare new comparator, NULL keeps the current one
+ * @param hash new hash function, NULL keeps the current one
+ * @return EXIT_SUCCESS or EXIT_ERROR if the type is out of range
+ */
+int AK_register_type_ops(int type, AK_compare_fn compare, AK_hash_fn hash) {
+    AK_PRO;
+    if (type < 0 || type >= MAX_TYPE_OPS) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    if (compare != NULL)
+        AK_type_registry[type].compare = compare;
+    if (hash != NULL)
+        AK_type_registry[type].hash = hash;
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Comparator used by the test, orders varchars by length only
+ */
+static int AK_comparator_test_by_length(const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    return (a_size > b_size) - (a_size < b_size);
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing the comparator and hash registry
+ * @return TestResult
+ */
+TestResult AK_comparator_test() {
+    AK_PRO;
+    int passed = 0, failed = 0;
+    int i1 = -5, i2 = 3, i3 = 256, i4 = 512;
+    unsigned char f1[sizeof (double)], f2[sizeof (double)];
+    float f = 2.5f, g = -0.0f, h = 0.0f;
+    double d1 = -1.5, d2 = 10.25;
+    unsigned char t = 1, t2 = 7, fls = 0;
+    AK_compare_fn saved;
+
+    printf("\nInteger compare test\n");
+    /* byte or string comparison gets both of these wrong */
+    if (AK_compare_values(TYPE_INT, (unsigned char *) &i1, sizeof (int), (unsigned char *) &i2, sizeof (int)) < 0
+            && AK_compare_values(TYPE_INT, (unsigned char *) &i3, sizeof (int), (unsigned char *) &i4, sizeof (int)) < 0
+            && AK_compare_values(TYPE_DATE, (unsigned char *) &i4, sizeof (int), (unsigned char *) &i3, sizeof (int)) > 0
+            && AK_compare_values(TYPE_INT, (unsigned char *) &i2, sizeof (int), (unsigned char *) &i2, sizeof (int)) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    printf("\nFloat and number compare test\n");
+    /* a float is stored in sizeof(double) bytes, the bytes after it are not part of the value */
+    memset(f1, 0xAA, sizeof (f1));
+    memset(f2, 0x55, sizeof (f2));
+    memcpy(f1, &f, sizeof (float));
+    memcpy(f2, &f, sizeof (float));
+    if (AK_compare_values(TYPE_FLOAT, f1, sizeof (double), f2, sizeof (double)) == 0
+            && AK_hash_value(TYPE_FLOAT, f1, sizeof (double)) == AK_hash_value(TYPE_FLOAT, f2, sizeof (double))
+            && AK_hash_value(TYPE_FLOAT, (unsigned char *) &g, sizeof (float)) == AK_hash_value(TYPE_FLOAT, (unsigned char *) &h, sizeof (float))
+            && AK_compare_values(TYPE_NUMBER, (unsigned char *) &d1, sizeof (double), (unsigned char *) &d2, sizeof (double)) < 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    printf("\nVarchar and bool compare test\n");
+    if (AK_compare_values(TYPE_VARCHAR, (unsigned char *) "abc", 3, (unsigned char *) "abcd", 4) < 0
+            && AK_compare_values(TYPE_VARCHAR, (unsigned char *) "b", 1, (unsigned char *) "abcd", 4) > 0
+            && AK_compare_values(TYPE_VARCHAR, (unsigned char *) "abc", 3, (unsigned char *) "abc", 3) == 0
+            && AK_compare_values(TYPE_BOOL, &t, 1, &t2, 1) == 0
+            && AK_compare_values(TYPE_BOOL, &fls, 1, &t, 1) < 0
+            && AK_hash_value(TYPE_BOOL, &t, 1) == AK_hash_value(TYPE_BOOL, &t2, 1)
+            && AK_hash_value(TYPE_VARCHAR, (unsigned char *) "abc", 3) != AK_hash_value(TYPE_VARCHAR, (unsigned char *) "abd", 3)) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    printf("\nByte string hash test\n");
+    /* published 32 bit xxHash values, the last string is read in 16 byte stripes */
+    if (AK_hash_value(TYPE_VARCHAR, (unsigned char *) "", 0) == 0x02CC5D05U
+            && AK_hash_value(TYPE_VARCHAR, (unsigned char *) "abc", 3) == 0x32D153FFU
+            && AK_hash_value(TYPE_VARCHAR, (unsigned char *) "Nobody inspects the spammish repetition", 39) == 0xE2293B2FU
+            && AK_hash_combine(AK_hash_combine(0, i2), i3) != AK_hash_combine(AK_hash_combine(0, i3), i2)) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    printf("\nRegistry test\n");
+    saved = AK_get_type_ops(TYPE_VARCHAR)->compare;
+    AK_register_type_ops(TYPE_VARCHAR, AK_comparator_test_by_length, NULL);
+    if (AK_compare_values(TYPE_VARCHAR, (unsigned char *) "zz", 2, (unsigned char *) "aaa", 3) < 0
+            && AK_get_type_ops(-1) == AK_get_type_ops(TYPE_VARCHAR)
+            && AK_register_type_ops(MAX_TYPE_OPS, saved, NULL) == EXIT_ERROR) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_register_type_ops(TYPE_VARCHAR, saved, NULL);
+
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
@@ -0,0 +1,294 @@
+/**
+@file comparator.h Header file that provides data structures, declarations of functions and inline helpers for the type-aware comparator and hash registry
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef COMPARATOR
+#define COMPARATOR
+
+#include <string.h>
+#include "constants.h"
+#include "test.h"
+#include "mempro.h"
+
+/**
+ * @def MAX_TYPE_OPS
+ * @brief number of slots in the registry, one for every type constant from TYPE_INTERNAL to TYPE_AGGREGATOR
+ */
+#define MAX_TYPE_OPS (TYPE_AGGREGATOR + 1)
+
+/**
+ * @typedef AK_compare_fn
+ * @brief compares two stored values, returns negative, zero or positive number
+ */
+typedef int (*AK_compare_fn)(const unsigned char *a, int a_size, const unsigned char *b, int b_size);
+
+/**
+ * @typedef AK_hash_fn
+ * @brief hashes a stored value, equal values give equal hashes
+ */
+typedef unsigned int (*AK_hash_fn)(const unsigned char *value, int size);
+
+/**
+ * @struct AK_type_ops
+ * @brief Comparator and hash function of one data type
+ * @var compare compares two values stored in blocks
+ * @var hash hashes a value stored in a block
+ */
+typedef struct {
+    AK_compare_fn compare;
+    AK_hash_fn hash;
+} AK_type_ops;
+
+extern AK_type_ops AK_type_registry[MAX_TYPE_OPS];
+
+/*
+ * The helpers below work on the binary representation the values have in block data
+ * (see AK_type_size). They are inline and have no AK_PRO/AK_EPI because they are
+ * called once per compared value by sort, join, set operations and indexes.
+ */
+
+/**
+ * @author Unknown
+ * @brief Function that finalizes a 32 bit hash so that every input bit affects every output bit
+ * @param h hash to mix
+ * @return mixed hash
+ */
+static AK_INLINE unsigned int AK_hash_mix(unsigned int h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two stored integers (also used for dates, times and intervals)
+ * @return negative, zero or positive number if a is less than, equal to or greater than b
+ */
+static AK_INLINE int AK_compare_int(const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    int x, y;
+    memcpy(&x, a, sizeof (int));
+    memcpy(&y, b, sizeof (int));
+    return (x > y) - (x < y);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two stored floats. Only the first sizeof(float) bytes hold the value,
+ *        AK_type_size reserves sizeof(double) for TYPE_FLOAT.
+ * @return negative, zero or positive number if a is less than, equal to or greater than b
+ */
+static AK_INLINE int AK_compare_float(const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    float x, y;
+    memcpy(&x, a, sizeof (float));
+    memcpy(&y, b, sizeof (float));
+    return (x > y) - (x < y);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two stored numbers (doubles)
+ * @return negative, zero or positive number if a is less than, equal to or greater than b
+ */
+static AK_INLINE int AK_compare_number(const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    double x, y;
+    memcpy(&x, a, sizeof (double));
+    memcpy(&y, b, sizeof (double));
+    return (x > y) - (x < y);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two stored booleans, every non zero byte is true
+ * @return negative, zero or positive number if a is less than, equal to or greater than b
+ */
+static AK_INLINE int AK_compare_bool(const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    return (a[0] != 0) - (b[0] != 0);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two byte strings (varchars), a proper prefix sorts first
+ * @return negative, zero or positive number if a is less than, equal to or greater than b
+ */
+static AK_INLINE int AK_compare_bytes(const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    int result = memcmp(a, b, a_size < b_size ? a_size : b_size);
+    return result != 0 ? result : (a_size > b_size) - (a_size < b_size);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a stored integer
+ * @return hash value
+ */
+static AK_INLINE unsigned int AK_hash_int(const unsigned char *value, int size) {
+    unsigned int x;
+    memcpy(&x, value, sizeof (int));
+    return AK_hash_mix(x);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a stored float, 0.0 and -0.0 compare equal so they hash equal too
+ * @return hash value
+ */
+static AK_INLINE unsigned int AK_hash_float(const unsigned char *value, int size) {
+    float f;
+    unsigned int x;
+    memcpy(&f, value, sizeof (float));
+    if (f == 0.0f)
+        f = 0.0f;
+    memcpy(&x, &f, sizeof (float));
+    return AK_hash_mix(x);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a stored number (double), 0.0 and -0.0 hash equal
+ * @return hash value
+ */
+static AK_INLINE unsigned int AK_hash_number(const unsigned char *value, int size) {
+    double d;
+    unsigned int x[2];
+    memcpy(&d, value, sizeof (double));
+    if (d == 0.0)
+        d = 0.0;
+    memcpy(x, &d, sizeof (double));
+    return AK_hash_mix(x[0] ^ AK_hash_mix(x[1]));
+}
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a stored boolean
+ * @return hash value
+ */
+static AK_INLINE unsigned int AK_hash_bool(const unsigned char *value, int size) {
+    return AK_hash_mix(value[0] != 0);
+}
+
+/*
+ * Primes of the 32 bit xxHash algorithm used by AK_hash_bytes
+ */
+#define AK_HASH_PRIME1 2654435761U
+#define AK_HASH_PRIME2 2246822519U
+#define AK_HASH_PRIME3 3266489917U
+#define AK_HASH_PRIME4 668265263U
+#define AK_HASH_PRIME5 374761393U
+
+/**
+ * @author Unknown
+ * @brief Function that rotates a 32 bit value left
+ * @return rotated value
+ */
+static AK_INLINE unsigned int AK_hash_rotl(unsigned int x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads 4 bytes of a string as a little endian 32 bit value
+ * @return value read
+ */
+static AK_INLINE unsigned int AK_hash_read32(const unsigned char *p) {
+    return (unsigned int) p[0] | (unsigned int) p[1] << 8 | (unsigned int) p[2] << 16 | (unsigned int) p[3] << 24;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a byte string with the 32 bit xxHash algorithm (seed 0). Strings of 16 bytes or more
+ *        are read 16 bytes at a time into four independent lanes, the rest 4 bytes and then 1 byte at a time, so
+ *        that every input bit affects every output bit with a few multiplies per 4 bytes.
+ * @return hash value
+ */
+static AK_INLINE unsigned int AK_hash_bytes(const unsigned char *value, int size) {
+    const unsigned char *p = value, *end = value + size;
+    unsigned int h, v1, v2, v3, v4;
+    if (size >= 16) {
+        v1 = AK_HASH_PRIME1 + AK_HASH_PRIME2;
+        v2 = AK_HASH_PRIME2;
+        v3 = 0;
+        v4 = 0U - AK_HASH_PRIME1;
+        do {
+            v1 = AK_hash_rotl(v1 + AK_hash_read32(p) * AK_HASH_PRIME2, 13) * AK_HASH_PRIME1;
+            v2 = AK_hash_rotl(v2 + AK_hash_read32(p + 4) * AK_HASH_PRIME2, 13) * AK_HASH_PRIME1;
+            v3 = AK_hash_rotl(v3 + AK_hash_read32(p + 8) * AK_HASH_PRIME2, 13) * AK_HASH_PRIME1;
+            v4 = AK_hash_rotl(v4 + AK_hash_read32(p + 12) * AK_HASH_PRIME2, 13) * AK_HASH_PRIME1;
+            p += 16;
+        } while (end - p >= 16);
+        h = AK_hash_rotl(v1, 1) + AK_hash_rotl(v2, 7) + AK_hash_rotl(v3, 12) + AK_hash_rotl(v4, 18);
+    } else {
+        h = AK_HASH_PRIME5;
+    }
+    h += (unsigned int) size;
+    for (; end - p >= 4; p += 4)
+        h = AK_hash_rotl(h + AK_hash_read32(p) * AK_HASH_PRIME3, 17) * AK_HASH_PRIME4;
+    for (; p < end; p++)
+        h = AK_hash_rotl(h + *p * AK_HASH_PRIME5, 11) * AK_HASH_PRIME1;
+    h ^= h >> 15;
+    h *= AK_HASH_PRIME2;
+    h ^= h >> 13;
+    h *= AK_HASH_PRIME3;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that combines the hash of the next column of a key with the hash of the columns before it, the
+ *        result depends on the order of the columns
+ * @param seed hash of the columns before, 0 for the first column
+ * @param h hash of the column
+ * @return combined hash
+ */
+static AK_INLINE unsigned int AK_hash_combine(unsigned int seed, unsigned int h) {
+    return AK_hash_mix(AK_hash_rotl(seed, 5) * AK_HASH_PRIME1 + h);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two stored values of the given type with the registered comparator
+ * @param type data type of both values
+ * @param a first value
+ * @param a_size size of the first value in bytes
+ * @param b second value
+ * @param b_size size of the second value in bytes
+ * @return negative, zero or positive number if a is less than, equal to or greater than b
+ */
+static AK_INLINE int AK_compare_values(int type, const unsigned char *a, int a_size, const unsigned char *b, int b_size) {
+    return AK_type_registry[(unsigned) type < MAX_TYPE_OPS ? type : TYPE_VARCHAR].compare(a, a_size, b, b_size);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a stored value of the given type with the registered hash function
+ * @param type data type of the value
+ * @param value stored value
+ * @param size size of the value in bytes
+ * @return hash value
+ */
+static AK_INLINE unsigned int AK_hash_value(int type, const unsigned char *value, int size) {
+    return AK_type_registry[(unsigned) type < MAX_TYPE_OPS ? type : TYPE_VARCHAR].hash(value, size);
+}
+
+AK_type_ops *AK_get_type_ops(int type);
+int AK_register_type_ops(int type, AK_compare_fn compare, AK_hash_fn hash);
+TestResult AK_comparator_test();
+
+#endif
@@ -70,6 +70,36 @@
   * @brief Constant declaring extent growth factor for temporary segments
  */
 #define EXTENT_GROWTH_TEMP (iniparser_getdouble(AK_config,"extents:extent_growth_temp",0.5))
+/**
+  * @def SORT_MEMORY_BUDGET
+  * @brief Constant declaring how many bytes of rows the sort operator keeps in memory before spilling a run
+ */
+#define SORT_MEMORY_BUDGET (iniparser_getint(AK_config,"sort:memory_budget",1048576))
+/**
+  * @def BTREE_FILL_FACTOR
+  * @brief Constant declaring the percentage of a page a B+tree bulk load fills
+ */
+#define BTREE_FILL_FACTOR (iniparser_getint(AK_config,"btree:fill_factor",90))
+/**
+  * @def HASH_LOAD_FACTOR
+  * @brief Constant declaring the percentage of the bucket pages of a hash index filled before a bucket is split
+ */
+#define HASH_LOAD_FACTOR (iniparser_getint(AK_config,"hash:load_factor",75))
+/**
+  * @def INDEX_SCAN_MAX_SELECTIVITY
+  * @brief Constant declaring the largest percentage of the rows of a table a selection reads through an index
+ */
+#define INDEX_SCAN_MAX_SELECTIVITY (iniparser_getint(AK_config,"index:max_selectivity",20))
+/**
+  * @def VACUUM_INTERVAL
+  * @brief Constant declaring how many seconds the background vacuum waits between two rounds
+ */
+#define VACUUM_INTERVAL (iniparser_getint(AK_config,"vacuum:interval",60))
+/**
+  * @def VACUUM_THRESHOLD
+  * @brief Constant declaring the percentage of dead space at which the background vacuum compacts a table
+ */
+#define VACUUM_THRESHOLD (iniparser_getint(AK_config,"vacuum:threshold",20))
 /**
  * @def ARCHIVELOG_PATH
  * @brief Constant declaring the path of archivelog folder
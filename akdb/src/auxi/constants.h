@@ -76,6 +76,16 @@
  * @brief Constant declaring lenght of data entry in sizeof( int )
  */
 #define DATA_ENTRY_SIZE 10
+/**
+ * @def BLOOM_FILTER_SIZE
+ * @brief Constant declaring the size in bytes of the Bloom filter of a block (used in AK_block->bloom_filter)
+ */
+#define BLOOM_FILTER_SIZE 1024
+/**
+ * @def BLOOM_FILTER_HASHES
+ * @brief Constant declaring the number of bits a value sets in a Bloom filter
+ */
+#define BLOOM_FILTER_HASHES 3
 /**
  * @def MAX_QUERY_LIB_MEMORY
  * @brief Constant declaring the maximum size of query lib memory
@@ -103,21 +113,6 @@
  * relation equivalence function
  */
 #define MAX_TOKENS 255
-/**
- * @def MAX_MAIN_BUCKETS
- * @brief Constant declaring the maximum number of main buckets
- */
-#define MAX_MAIN_BUCKETS 512
-/**
- * @def MAIN_BUCKET_SIZE
- * @brief Constant declaring the size of main buckets
- */
-#define MAIN_BUCKET_SIZE 4
-/**
- * @def HASH_BUCKET_SIZE
- * @brief Constant declaring the size of hash buckets
- */
-#define HASH_BUCKET_SIZE 4
 /**
  * @def NUMBER_OF_KEYS
  * @brief Constant declaring the number of buckets in hash table
@@ -197,6 +192,21 @@
  * @brief Constant declaring temporary segment type (used in system catalog)
  */
 #define SEGMENT_TYPE_TEMP 4
+/**
+ * @def SEGMENT_TYPE_PAX_TABLE
+ * @brief Constant declaring table segment type whose blocks keep the values of every column together (PAX layout)
+ */
+#define SEGMENT_TYPE_PAX_TABLE 5
+/**
+ * @def SEGMENT_TYPE_APPEND_TABLE
+ * @brief Constant declaring append-only table segment type: rows are only inserted at the tail of the last extent
+ */
+#define SEGMENT_TYPE_APPEND_TABLE 6
+/**
+ * @def BLOCK_COMPRESSED_MAGIC
+ * @brief Constant marking a place in the db file that holds a compressed block (a block address is never negative)
+ */
+#define BLOCK_COMPRESSED_MAGIC -19290
 /**
  * @def TYPE_INTERNAL
  * @brief Constant declaring internal data type (used in AK_header->type and
@@ -312,11 +322,6 @@
  * @brief Constant indicating attributes escape section
  */
 #define ATTR_ESCAPE '`'
-/**
- * @def NULLL
- * @brief Constant declaring null value for tables
- */
-#define NULLL "asdfgXYZ"
 /**
  * @def relational operators
  */
@@ -365,20 +370,13 @@
 #define FIND 2
 /**
  * @def INFO_BUCKET
- * @brief Constant declaring the type of bucket as "info bucket" when inserting
- * bucket to block
+ * @brief Constant declaring the type of the first block of a hash index, which
+ * holds the hash_info
  */
 #define INFO_BUCKET 0
-/**
- * @def MAIN_BUCKET
- * @brief Constant declaring the type of bucket as "main bucket" when inserting
- * bucket to block
- */
-#define MAIN_BUCKET 1
 /**
  * @def HASH_BUCKET
- * @brief Constant declaring the type of bucket as "hash bucket" when inserting
- * bucket to block
+ * @brief Constant declaring the type of a bucket page of a hash index
  */
 #define HASH_BUCKET 2
 /**
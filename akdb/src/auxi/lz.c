@@ -0,0 +1,276 @@
+/**
+@file lz.c Provides a small LZ codec in the style of LZ4, used to store blocks compressed on disk. The output is
+a list of sequences: a token with the number of literals (high four bits) and the match length minus LZ_MIN_MATCH
+(low four bits), longer counts continued in following bytes of 255, the literals, and a two byte offset of the
+match. The last sequence has literals only.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "lz.h"
+
+/**
+ * @author Unknown
+ * @brief Function that hashes the four bytes at a position of the input
+ * @param p pointer to the bytes
+ * @return hash of LZ_HASH_BITS bits
+ */
+static int AK_lz_hash(const unsigned char *p) {
+    unsigned int value = p[0] | p[1] << 8 | p[2] << 16 | (unsigned int) p[3] << 24;
+    return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that writes the part of a count that does not fit into its four bits of the token
+ * @param dst output
+ * @param out position in the output
+ * @param dst_capacity size of the output
+ * @param count rest of the count
+ * @return position after the count, EXIT_ERROR if the output is full
+ */
+static int AK_lz_put_count(unsigned char *dst, int out, int dst_capacity, int count) {
+    for (; count >= 255; count -= 255) {
+        if (out >= dst_capacity)
+            return EXIT_ERROR;
+        dst[out++] = 255;
+    }
+    if (out >= dst_capacity)
+        return EXIT_ERROR;
+    dst[out++] = count;
+    return out;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that writes one sequence of literals and a match
+ * @param dst output
+ * @param out position in the output
+ * @param dst_capacity size of the output
+ * @param literals literal bytes
+ * @param num_literals number of literal bytes
+ * @param offset distance of the match
+ * @param match length of the match, 0 for the last sequence
+ * @return position after the sequence, EXIT_ERROR if the output is full
+ */
+static int AK_lz_put_sequence(unsigned char *dst, int out, int dst_capacity, const unsigned char *literals,
+        int num_literals, int offset, int match) {
+    int match_code = match > 0 ? match - LZ_MIN_MATCH : 0;
+    if (out >= dst_capacity)
+        return EXIT_ERROR;
+    dst[out++] = (num_literals < 15 ? num_literals : 15) << 4 | (match_code < 15 ? match_code : 15);
+    if (num_literals >= 15 && (out = AK_lz_put_count(dst, out, dst_capacity, num_literals - 15)) == EXIT_ERROR)
+        return EXIT_ERROR;
+    if (out + num_literals > dst_capacity)
+        return EXIT_ERROR;
+    memcpy(dst + out, literals, num_literals);
+    out += num_literals;
+    if (match == 0)
+        return out;
+    if (out + 2 > dst_capacity)
+        return EXIT_ERROR;
+    dst[out++] = offset & 0xFF;
+    dst[out++] = offset >> 8;
+    if (match_code >= 15 && (out = AK_lz_put_count(dst, out, dst_capacity, match_code - 15)) == EXIT_ERROR)
+        return EXIT_ERROR;
+    return out;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compresses a buffer. Repeated runs of four or more bytes found through a hash of their
+ *        first four bytes are replaced by references to their earlier occurrence.
+ * @param src input
+ * @param src_size size of the input
+ * @param dst output
+ * @param dst_capacity size of the output
+ * @return size of the compressed data, EXIT_ERROR if it does not fit into the output
+ */
+int AK_lz_compress(const unsigned char *src, int src_size, unsigned char *dst, int dst_capacity) {
+    int table[1 << LZ_HASH_BITS];
+    int i = 0, anchor = 0, out = 0, h, ref, match;
+    AK_PRO;
+    memset(table, -1, sizeof (table));
+    while (i + LZ_MIN_MATCH <= src_size) {
+        h = AK_lz_hash(src + i);
+        ref = table[h];
+        table[h] = i;
+        if (ref < 0 || i - ref > LZ_MAX_OFFSET || memcmp(src + ref, src + i, LZ_MIN_MATCH) != 0) {
+            i++;
+            continue;
+        }
+        for (match = LZ_MIN_MATCH; i + match < src_size && src[ref + match] == src[i + match]; match++)
+            ;
+        out = AK_lz_put_sequence(dst, out, dst_capacity, src + anchor, i - anchor, i - ref, match);
+        if (out == EXIT_ERROR) {
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+        i += match;
+        anchor = i;
+    }
+    out = AK_lz_put_sequence(dst, out, dst_capacity, src + anchor, src_size - anchor, 0, 0);
+    AK_EPI;
+    return out;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads a count continued in bytes of 255
+ * @param src input
+ * @param in position in the input, moved past the count
+ * @param src_size size of the input
+ * @param count count from the token
+ * @return whole count, EXIT_ERROR if the input ends
+ */
+static int AK_lz_get_count(const unsigned char *src, int *in, int src_size, int count) {
+    unsigned char byte;
+    if (count < 15)
+        return count;
+    do {
+        if (*in >= src_size)
+            return EXIT_ERROR;
+        byte = src[(*in)++];
+        count += byte;
+    } while (byte == 255);
+    return count;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that decompresses data written by AK_lz_compress
+ * @param src compressed data
+ * @param src_size size of the compressed data
+ * @param dst output
+ * @param dst_capacity size of the output
+ * @return size of the decompressed data, EXIT_ERROR if the data is damaged or does not fit into the output
+ */
+int AK_lz_decompress(const unsigned char *src, int src_size, unsigned char *dst, int dst_capacity) {
+    int in = 0, out = 0, token, literals, offset, match;
+    AK_PRO;
+    while (in < src_size) {
+        token = src[in++];
+        literals = AK_lz_get_count(src, &in, src_size, token >> 4);
+        if (literals == EXIT_ERROR || in + literals > src_size || out + literals > dst_capacity) {
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+        memcpy(dst + out, src + in, literals);
+        in += literals;
+        out += literals;
+        if (in == src_size)
+            break;
+        if (in + 2 > src_size) {
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+        offset = src[in] | src[in + 1] << 8;
+        in += 2;
+        match = AK_lz_get_count(src, &in, src_size, token & 15);
+        if (match == EXIT_ERROR || offset == 0 || offset > out || out + match + LZ_MIN_MATCH > dst_capacity) {
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+        //byte by byte, a match may overlap the bytes it produces
+        for (match += LZ_MIN_MATCH; match > 0; match--, out++)
+            dst[out] = dst[out - offset];
+    }
+    AK_EPI;
+    return out;
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing the LZ codec
+ * @return TestResult
+ */
+TestResult AK_lz_test() {
+    const int size = 20000;
+    unsigned char *src, *packed, *unpacked;
+    unsigned int seed = 7;
+    int i, packed_size, unpacked_size, passed = 0, failed = 0;
+    AK_PRO;
+    src = AK_malloc(size);
+    packed = AK_malloc(size + size / 255 + 16);
+    unpacked = AK_malloc(size);
+
+    /* 1: text with repetitions shrinks and comes back unchanged */
+    printf("\nLZ text test\n");
+    for (i = 0; i < size; i++)
+        src[i] = "AK_block images are mostly empty padding. "[i % 42] + (i % 1000 == 0);
+    packed_size = AK_lz_compress(src, size, packed, size);
+    unpacked_size = packed_size > 0 ? AK_lz_decompress(packed, packed_size, unpacked, size) : EXIT_ERROR;
+    if (packed_size > 0 && packed_size < size / 10 && unpacked_size == size && memcmp(src, unpacked, size) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 2: a block image of zeros and short runs */
+    printf("\nLZ padding test\n");
+    memset(src, 0, size);
+    for (i = 0; i < 300; i++)
+        src[4000 + i] = i * 7;
+    packed_size = AK_lz_compress(src, size, packed, size);
+    unpacked_size = packed_size > 0 ? AK_lz_decompress(packed, packed_size, unpacked, size) : EXIT_ERROR;
+    if (packed_size > 0 && packed_size < 400 && unpacked_size == size && memcmp(src, unpacked, size) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 3: random bytes do not fit into their own size, but round trip with room for the tokens */
+    printf("\nLZ random data test\n");
+    for (i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        src[i] = seed >> 16;
+    }
+    i = AK_lz_compress(src, size, packed, size / 2);
+    packed_size = AK_lz_compress(src, size, packed, size + size / 255 + 16);
+    unpacked_size = packed_size > 0 ? AK_lz_decompress(packed, packed_size, unpacked, size) : EXIT_ERROR;
+    if (i == EXIT_ERROR && unpacked_size == size && memcmp(src, unpacked, size) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 4: damaged data is rejected */
+    printf("\nLZ damaged data test\n");
+    memset(src, 'a', size);
+    packed_size = AK_lz_compress(src, size, packed, size);
+    i = AK_lz_decompress(packed, packed_size, unpacked, size / 2);
+    //the first sequence is one literal and a match, point the match before the start of the output
+    packed[2] = packed[3] = 0xFF;
+    if (i == EXIT_ERROR && AK_lz_decompress(packed, packed_size, unpacked, size) == EXIT_ERROR) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_free(src);
+    AK_free(packed);
+    AK_free(unpacked);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
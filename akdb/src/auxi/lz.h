@@ -0,0 +1,48 @@
+/**
+@file lz.h Header file that provides declarations of functions for the LZ block codec
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef LZ
+#define LZ
+
+#include <string.h>
+#include "constants.h"
+#include "test.h"
+#include "mempro.h"
+
+/**
+ * @def LZ_HASH_BITS
+ * @brief number of bits of the hash of four bytes used to find earlier occurrences
+ */
+#define LZ_HASH_BITS 12
+/**
+ * @def LZ_MIN_MATCH
+ * @brief shortest match that is coded as a reference instead of literals
+ */
+#define LZ_MIN_MATCH 4
+/**
+ * @def LZ_MAX_OFFSET
+ * @brief largest distance of a match, it is stored in two bytes
+ */
+#define LZ_MAX_OFFSET 65535
+
+int AK_lz_compress(const unsigned char *src, int src_size, unsigned char *dst, int dst_capacity);
+int AK_lz_decompress(const unsigned char *src, int src_size, unsigned char *dst, int dst_capacity);
+TestResult AK_lz_test();
+
+#endif
@@ -23,6 +23,7 @@
 //todo: We should have true/false values, one way is to include the boolean header but a more sensible
 //      solution is to (#define false 0) and (#define true !false) in this header, or even better in the constants
 //      header
+#define _GNU_SOURCE /* for fallocate */
 #include "dbman.h"
 #include "../mm/memoman.h"
 pthread_mutex_t fileLockMutex = PTHREAD_MUTEX_INITIALIZER;
@@ -663,11 +664,24 @@ AK_init_block()
     {
       block->data[i] = FREE_CHAR;
     }
+  memset(block->null_bitmap, 0, sizeof (block->null_bitmap));
+  memset(block->zone_map, 0, sizeof (block->zone_map));
+  block->zone_map_stale = 0;
+  memset(block->bloom_filter, 0, sizeof (block->bloom_filter));
+  block->bloom_filter_stale = 0;
+  block->pax = 0;
+  memset(block->minipage, 0, sizeof (block->minipage));
+  block->append_only = 0;
+  block->sealed = 0;
+  block->append_tail = 0;
+  block->compressed = 0;
+  block->indexed = 0;
 
   block->type               = BLOCK_TYPE_FREE;
   block->chained_with       = NOT_CHAINED;
   block->AK_free_space      = DATA_BLOCK_SIZE * DATA_ENTRY_SIZE * sizeof (int);
   block->last_tuple_dict_id = 0;
+  block->num_records        = FREE_INT;
 
   AK_EPI;
   return block;
@@ -741,6 +755,7 @@ AK_print_block(AK_block * block, int num, char* gg, FILE *fpp)
 
   fprintf(fp, "block->AK_free_space =%d\n", DATA_BLOCK_SIZE * DATA_ENTRY_SIZE * sizeof (int));
   fprintf(fp, "block->last_tuple_dict_id = %d\n", block->last_tuple_dict_id);
+  fprintf(fp, "block->num_records = %d\n", block->num_records);
 
 
   fprintf(fp, "\n\n\t\tHEADER\n\n");
@@ -995,11 +1010,57 @@ char test_lastCharacterWritten = '\0';
 */
 int test_threadSafeBlockAccessSucceeded = 1;
 
+/**
+ * @author Unknown
+ * @brief  Function that writes a block compressed to its place in the DB file. The place starts with
+ * BLOCK_COMPRESSED_MAGIC and the size of the compressed image, the rest of it is given back to the file system.
+ * @param database DB file opened for writing
+ * @param block block to write
+ * @return EXIT_SUCCESS if the block was written, EXIT_ERROR if it does not compress (nothing is written then)
+ */
+static int
+AK_write_compressed_block(FILE *database, AK_block *block)
+{
+  int marker[2];
+  long position = block->address * sizeof(AK_block) + AK_ALLOCATION_TABLE_SIZE;
+  unsigned char *packed;
+  AK_PRO;
+
+  packed = AK_malloc(sizeof(AK_block));
+
+  marker[0] = BLOCK_COMPRESSED_MAGIC;
+  marker[1] = AK_lz_compress((unsigned char *) block, sizeof(AK_block), packed, sizeof(AK_block) - sizeof(marker));
+  if (marker[1] == EXIT_ERROR)
+    {
+      AK_free(packed);
+      AK_EPI;
+      return EXIT_ERROR;
+    }
+
+  if (fseek(database, position, SEEK_SET) != 0 || AK_fwrite(marker, sizeof(marker), 1, database) != 1
+      || AK_fwrite(packed, marker[1], 1, database) != 1)
+    {
+      printf("AK_write_compressed_block: ERROR. Cannot write block at provided address %d.\n", block->address);
+      AK_EPI;
+      exit(EXIT_ERROR);
+    }
+  fflush(database);
+#ifdef __linux__
+  // the rest of the place holds no data now, file systems that can punch holes release its space
+  fallocate(fileno(database), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, position + sizeof(marker) + marker[1],
+	    sizeof(AK_block) - sizeof(marker) - marker[1]);
+#endif
+  AK_free(packed);
+  AK_EPI;
+  return EXIT_SUCCESS;
+}
+
 /**
  * @author Markus Schatten, updated by dv and Domagoj Šitum (thread-safe enabled)
  * @brief  Function that reads a block at a given address (block number less than db_file_size).
  * New block is allocated. Database file is opened. Position is set to provided address block.
- * At the end function reads file from that position. Completely thread-safe.
+ * At the end function reads file from that position. A block written compressed is read in its compressed size and
+ * decompressed into the new block. Completely thread-safe.
  * @param address block number (address)
  * @return pointer to block allocated in memory
  */
@@ -1064,15 +1125,42 @@ AK_read_block(int address)
     }
   //ERROR: a value of type "void *" cannot be used to initialize an entity of type "AK_block *"   
   AK_block * block = AK_malloc(sizeof(AK_block));
+  int marker[2];
+  unsigned char *packed;
 
-  // then we simply read block from the disk
-  if (AK_fread(block, sizeof(AK_block), 1, database) == 0)
+  // then we read the block from the disk, a compressed block starts with its marker and size
+  if (AK_fread(marker, sizeof(marker), 1, database) == 0)
     {
       printf("AK_read_block: ERROR. Cannot read block %d.\n", address);
 	  AK_free(block);
       AK_EPI;
       exit(EXIT_ERROR);
     }
+  if (marker[0] == BLOCK_COMPRESSED_MAGIC)
+    {
+      packed = AK_malloc(marker[1]);
+      if (AK_fread(packed, marker[1], 1, database) == 0
+	  || AK_lz_decompress(packed, marker[1], (unsigned char *) block, sizeof(AK_block)) != sizeof(AK_block))
+	{
+	  printf("AK_read_block: ERROR. Cannot decompress block %d.\n", address);
+	  AK_free(packed);
+	  AK_free(block);
+	  AK_EPI;
+	  exit(EXIT_ERROR);
+	}
+      AK_free(packed);
+    }
+  else
+    {
+      memcpy(block, marker, sizeof(marker));
+      if (AK_fread((unsigned char *) block + sizeof(marker), sizeof(AK_block) - sizeof(marker), 1, database) == 0)
+	{
+	  printf("AK_read_block: ERROR. Cannot read block %d.\n", address);
+	  AK_free(block);
+	  AK_EPI;
+	  exit(EXIT_ERROR);
+	}
+    }
     
   // block of code below is used only for testing purposes!
   // it is executed only when testMode is ON 
@@ -1109,7 +1197,7 @@ AK_read_block(int address)
 /**
 * @author Markus Schatten, updated by Domagoj Šitum (thread-safe enabled)
 * @brief  Function that writes a block to the DB file. Database file is opened. Position is set to provided address block. Block is
-  written to provided address. Completely thread-safe.
+  written to provided address, compressed if its compressed flag is set and the image gets smaller. Completely thread-safe.
 * @param block poiner to block allocated in memory to write
 * @return EXIT_SUCCESS if successful, EXIT_ERROR otherwise
 */
@@ -1174,22 +1262,24 @@ AK_write_block(AK_block * block)
       test_lastCharacterWritten = block->data[0];
     }
     
-  // now we can safely write it to the disk
-
-  // first we have to set position in file for new block writing
-  if (fseek(database, block->address * sizeof(AK_block)+AK_ALLOCATION_TABLE_SIZE, SEEK_SET) != 0)
+  // now we can safely write it to the disk, compressed blocks are written by their own function
+  if (!block->compressed || AK_write_compressed_block(database, block) == EXIT_ERROR)
     {
-      printf("AK_write_block: ERROR. Cannot set position to provided address block %d.\n", block->address);
-      AK_EPI;
-      exit(EXIT_ERROR);
-    }
+      // first we have to set position in file for new block writing
+      if (fseek(database, block->address * sizeof(AK_block)+AK_ALLOCATION_TABLE_SIZE, SEEK_SET) != 0)
+	{
+	  printf("AK_write_block: ERROR. Cannot set position to provided address block %d.\n", block->address);
+	  AK_EPI;
+	  exit(EXIT_ERROR);
+	}
 
-  // then we simply write block to the disk
-  if (AK_fwrite(block, sizeof (*block), 1, database) != 1)
-    {
-      printf("AK_write_block: ERROR. Cannot write block at provided address %d.\n", block->address);
-      AK_EPI;
-      exit(EXIT_ERROR);
+      // then we simply write block to the disk
+      if (AK_fwrite(block, sizeof (*block), 1, database) != 1)
+	{
+	  printf("AK_write_block: ERROR. Cannot write block at provided address %d.\n", block->address);
+	  AK_EPI;
+	  exit(EXIT_ERROR);
+	}
     }
         
   // after writing is done, we unlock this block for reading and/or writing
@@ -1237,7 +1327,8 @@ AK_copy_header(AK_header *header, int* blockSet, int blockSetSize)
   
   AK_PRO;
   
-  while(header[atts].type != TYPE_INTERNAL){
+  //a header taken from a block ends with unused (FREE_INT) entries instead of TYPE_INTERNAL
+  while(header[atts].type != TYPE_INTERNAL && header[atts].type != FREE_INT){
   		atts++;
   }
   blocks_per_row = 1 + (atts - 1) / MAX_ATTRIBUTES;
@@ -1250,6 +1341,9 @@ AK_copy_header(AK_header *header, int* blockSet, int blockSetSize)
   		for(k = 0; k < MAX_ATTRIBUTES && (i * MAX_ATTRIBUTES + k < atts); k++){
 	  		temp = (AK_header*) AK_create_header(header[cur_attr].att_name, header[cur_attr].type, FREE_INT, FREE_CHAR, FREE_CHAR);
 			memcpy(t_header[i] + k, temp, sizeof ( AK_header));
+			//storage options declared on the attribute hold for new extents too
+			t_header[i][k].has_bloom_filter = header[cur_attr].has_bloom_filter;
+			t_header[i][k].dictionary_encoded = header[cur_attr].dictionary_encoded;
 			cur_attr++;
 	  	}
 	  	temp = (AK_header*) AK_create_header("test", TYPE_INTERNAL, FREE_INT, FREE_CHAR, FREE_CHAR);
@@ -1275,6 +1369,19 @@ AK_copy_header(AK_header *header, int* blockSet, int blockSetSize)
       block->type = BLOCK_TYPE_NORMAL;
       block->AK_free_space = 0;
       block->last_tuple_dict_id = 0;
+      block->num_records = 0;
+      memset(block->null_bitmap, 0, sizeof (block->null_bitmap));
+      memset(block->zone_map, 0, sizeof (block->zone_map));
+      block->zone_map_stale = 0;
+      memset(block->bloom_filter, 0, sizeof (block->bloom_filter));
+      block->bloom_filter_stale = 0;
+      block->pax = 0;
+      memset(block->minipage, 0, sizeof (block->minipage));
+      block->append_only = 0;
+      block->sealed = 0;
+      block->append_tail = 0;
+      block->compressed = 0;
+      block->indexed = 0;
       if(j % blocks_per_row != (blocks_per_row - 1) && blocks_per_row > 1){
       		block->chained_with = next_block->address;
       }
@@ -1475,7 +1582,9 @@ SEGMENT_TYPE_SYSTEM_TABLE,
 SEGMENT_TYPE_TABLE,
 SEGMENT_TYPE_INDEX,
 SEGMENT_TYPE_TRANSACTION,
-SEGMENT_TYPE_TEMP
+SEGMENT_TYPE_TEMP,
+SEGMENT_TYPE_PAX_TABLE,
+SEGMENT_TYPE_APPEND_TABLE
 * @param header pointer to header that should be written to the new extent (all blocks)
 * @return address (block number) of new extent if successful, EXIT_ERROR otherwise
 */
@@ -1497,6 +1606,8 @@ AK_new_extent(int start_address, int old_size, int extent_type, AK_header *heade
       switch (extent_type)
 	{
 	case SEGMENT_TYPE_TABLE:
+	case SEGMENT_TYPE_PAX_TABLE:
+	case SEGMENT_TYPE_APPEND_TABLE:
 	  scale_factor = EXTENT_GROWTH_TABLE;
 	  break;
 	case SEGMENT_TYPE_INDEX:
@@ -1551,6 +1662,19 @@ AK_new_extent(int start_address, int old_size, int extent_type, AK_header *heade
       return (EXIT_ERROR);
     }
 
+  /// blocks of PAX tables group their values by column, blocks of append-only tables only take rows at the tail
+  if (extent_type == SEGMENT_TYPE_PAX_TABLE || extent_type == SEGMENT_TYPE_APPEND_TABLE)
+    {
+      for (i = 0; i < requested_space_in_blocks; i++)
+	{
+	  block = AK_read_block(allocation_set[i]);
+	  block->pax = extent_type == SEGMENT_TYPE_PAX_TABLE;
+	  block->append_only = extent_type == SEGMENT_TYPE_APPEND_TABLE;
+	  AK_write_block(block);
+	  AK_free(block);
+	}
+    }
+
   for (i = 0; i < requested_space_in_blocks; i++)
     {
       BITSET(allocationBit->bittable, allocation_set[i]);
@@ -1583,7 +1707,9 @@ SEGMENT_TYPE_SYSTEM_TABLE,
 SEGMENT_TYPE_TABLE,
 SEGMENT_TYPE_INDEX,
 SEGMENT_TYPE_TRANSACTION,
-SEGMENT_TYPE_TEMP)
+SEGMENT_TYPE_TEMP,
+SEGMENT_TYPE_PAX_TABLE,
+SEGMENT_TYPE_APPEND_TABLE)
 * @param header (header pointer) pointer to header that should be written to the new extent (all blocks)
 * @return EXIT_SUCCESS for success or EXIT_ERROR if some error occurs
 */
@@ -1708,6 +1834,10 @@ AK_insert_entry(AK_block* block_address, int type, void* entry_data, int i)
   /// copy tuple_dict to block->tuple_dict[i]
   /// must use & becouse tuple_dict[i] is value and catalog_tuple_dict adress
   memcpy(&block_address->tuple_dict[i], catalog_tuple_dict, sizeof (*catalog_tuple_dict));
+  AK_CLEAR_NULL(block_address, i);
+  /// the entry is not summarised in the zone maps and the Bloom filter of the block
+  block_address->zone_map_stale = 1;
+  block_address->bloom_filter_stale = 1;
 	AK_free(catalog_tuple_dict);
   AK_EPI;
 }
@@ -1831,6 +1961,7 @@ AK_init_system_tables_catalog(int relation, int attribute, int index, int view,
   AK_insert_entry(catalog_block, TYPE_INT, &reference, i);
 
   catalog_block->last_tuple_dict_id = i;
+  catalog_block->num_records = FREE_INT;
 
   if (AK_write_block(catalog_block) == EXIT_SUCCESS)
     {
@@ -2101,6 +2232,8 @@ AK_register_system_tables(int relation, int attribute, int index, int view, int
     i++;
 
     relationTable->last_tuple_dict_id = j;
+    // rows were written directly, the count is computed on first use
+    relationTable->num_records = FREE_INT;
 
     AK_write_block(relationTable);
     AK_EPI;
@@ -2603,6 +2736,19 @@ AK_delete_block(int address)
     block->chained_with  = NOT_CHAINED;
     block->AK_free_space = DATA_BLOCK_SIZE * DATA_ENTRY_SIZE * sizeof (int);
     block->last_tuple_dict_id = 0;
+    block->num_records = FREE_INT;
+    memset(block->null_bitmap, 0, sizeof (block->null_bitmap));
+    memset(block->zone_map, 0, sizeof (block->zone_map));
+    block->zone_map_stale = 0;
+    memset(block->bloom_filter, 0, sizeof (block->bloom_filter));
+    block->bloom_filter_stale = 0;
+    block->pax = 0;
+    memset(block->minipage, 0, sizeof (block->minipage));
+    block->append_only = 0;
+    block->sealed = 0;
+    block->append_tail = 0;
+    block->compressed = 0;
+    block->indexed = 0;
     memcpy(block->header, head, sizeof (*head));
     memcpy(block->tuple_dict, tuple_dict, sizeof (*tuple_dict));
     memcpy(block->data, data, sizeof (*data));
@@ -2652,6 +2798,30 @@ AK_delete_extent(int begin, int end)
   return (EXIT_SUCCESS);
 }
 
+/**
+ * @author Unknown
+ * @brief  Function that marks the blocks of a cold extent to be stored compressed. The blocks are compressed when
+ * they are next written to the DB file and decompressed when they are read.
+ * @param begin address of extent's first block
+ * @param end address of extent's last block
+ * @return EXIT_SUCCESS
+ */
+int
+AK_compress_extent(int begin, int end)
+{
+  int address;
+  AK_mem_block *mem_block;
+  AK_PRO;
+  for (address = begin; address < end + 1; address++)
+    {
+      mem_block = AK_get_block(address);
+      mem_block->block->compressed = 1;
+      AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    }
+  AK_EPI;
+  return (EXIT_SUCCESS);
+}
+
 /**
  * @author Mislav Èakariæ, fixed by Josip Susnjara
  * @param name name of the segment
@@ -2682,6 +2852,8 @@ AK_delete_segment(char * name, int type)
   switch (type)
     {
     case SEGMENT_TYPE_TABLE:
+    case SEGMENT_TYPE_PAX_TABLE:
+    case SEGMENT_TYPE_APPEND_TABLE:
       system_table = "AK_relation";
       break;
     case SEGMENT_TYPE_INDEX:
@@ -2694,10 +2866,8 @@ AK_delete_segment(char * name, int type)
       return EXIT_ERROR;
       break;
     case SEGMENT_TYPE_TEMP:
-      //todo
-      printf("Not implemented yet!\n");
-      AK_EPI;
-      return EXIT_ERROR;
+      /* temporary segments are registered in AK_relation by AK_initialize_new_segment */
+      system_table = "AK_relation";
       break;
     default:
       AK_EPI;
@@ -2958,3 +3128,117 @@ void* AK_write_block_for_testing(void *block)
     AK_EPI;
     return 0;
 }
+
+/**
+ * @author Unknown
+ * @brief Function that reads the first two integers of the place of a block in the DB file, the compression marker
+ * and size of a compressed block or the start of a plain one
+ * @param address block address
+ * @param marker array of two integers to read into
+ * @return EXIT_SUCCESS if read, EXIT_ERROR otherwise
+ */
+static int AK_read_block_marker(int address, int *marker)
+{
+    FILE *database;
+    int result = EXIT_ERROR;
+    AK_PRO;
+    if ((database = fopen(DB_FILE, "rb")) != NULL)
+    {
+        if (fseek(database, address * sizeof(AK_block) + AK_ALLOCATION_TABLE_SIZE, SEEK_SET) == 0
+                && AK_fread(marker, sizeof(int), 2, database) == 2)
+            result = EXIT_SUCCESS;
+        fclose(database);
+    }
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing compressed blocks. A block is written compressed and plain, then a cold extent is
+ * compressed through the cache.
+ * @return TestResult
+ */
+TestResult AK_block_compression_test()
+{
+    AK_header header[2] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+    AK_block *block, *copy;
+    int address, i, marker[2], passed = 0, failed = 0, ok;
+    AK_PRO;
+
+    address = AK_new_extent(1, 0, SEGMENT_TYPE_TABLE, header);
+    if (address == EXIT_ERROR)
+    {
+        AK_EPI;
+        return TEST_result(0, 1);
+    }
+
+    /* 1: a compressed block takes a fraction of its place and reads back unchanged */
+    printf("\nCompressed block write test\n");
+    block = AK_read_block(address);
+    for (i = 0; i < 50; i++)
+        AK_insert_entry(block, TYPE_INT, &i, i);
+    block->compressed = 1;
+    AK_write_block(block);
+    copy = AK_read_block(address);
+    if (AK_read_block_marker(address, marker) == EXIT_SUCCESS && marker[0] == BLOCK_COMPRESSED_MAGIC
+            && marker[1] < (int) sizeof(AK_block) / 10 && memcmp(copy, block, sizeof(AK_block)) == 0)
+    {
+        printf("SUCCESS\n");
+        passed++;
+    }
+    else
+    {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_free(copy);
+
+    /* 2: without the flag the block is written plain again */
+    printf("\nPlain block write test\n");
+    block->compressed = 0;
+    AK_write_block(block);
+    copy = AK_read_block(address);
+    if (AK_read_block_marker(address, marker) == EXIT_SUCCESS && marker[0] == address
+            && memcmp(copy, block, sizeof(AK_block)) == 0)
+    {
+        printf("SUCCESS\n");
+        passed++;
+    }
+    else
+    {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_free(copy);
+    AK_free(block);
+
+    /* 3: blocks of a cold extent are compressed when the cache writes them */
+    printf("\nCold extent compression test\n");
+    AK_compress_extent(address + 1, address + 3);
+    AK_flush_cache();
+    ok = 1;
+    for (i = address + 1; i <= address + 3; i++)
+    {
+        copy = AK_read_block(i);
+        ok = ok && AK_read_block_marker(i, marker) == EXIT_SUCCESS && marker[0] == BLOCK_COMPRESSED_MAGIC
+                && copy->compressed && strcmp(copy->header[0].att_name, "id") == 0;
+        AK_free(copy);
+    }
+    if (ok)
+    {
+        printf("SUCCESS\n");
+        passed++;
+    }
+    else
+    {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
@@ -33,6 +33,7 @@ of Kalashnikov DB
 #include "../auxi/mempro.h"
 #include "../auxi/ptrcontainer.h"
 #include "../auxi/test.h"
+#include "../auxi/lz.h"
 #include "sys/time.h"
 
 // #define false 0
@@ -46,6 +47,11 @@ of Kalashnikov DB
 #define BITNSLOTS(nb) ((int)(nb + CHAR_BIT - 1) / CHAR_BIT)
 #define SEGMENTLENGTH() (BITNSLOTS(DB_FILE_BLOCKS_NUM) + 2 * sizeof(int))
 
+/* NULL flags of tuple_dict entries, one bit per entry in AK_block.null_bitmap */
+#define AK_IS_NULL(block, id) (BITTEST((block)->null_bitmap, (id)) != 0)
+#define AK_SET_NULL(block, id) BITSET((block)->null_bitmap, (id))
+#define AK_CLEAR_NULL(block, id) BITCLEAR((block)->null_bitmap, (id))
+
 /**
  * @author Markus Schatten
  * @struct AK_header
@@ -63,6 +69,10 @@ typedef struct {
     char constr_name[MAX_CONSTRAINTS][MAX_CONSTR_NAME];
     /// extra integrity costraint codes
     char constr_code[MAX_CONSTRAINTS][MAX_CONSTR_CODE];
+    /// 1 if values of the attribute are added to the Bloom filter of the block (see AK_bloom_declare)
+    int has_bloom_filter;
+    /// 1 if equal values of the attribute are stored once per block and shared by their rows (see AK_encoding_declare)
+    int dictionary_encoded;
 } AK_header;
 
 /**
@@ -80,6 +90,26 @@ typedef struct {
     int size;
 } AK_tuple_dict;
 
+/**
+ * @author Unknown
+ * @struct AK_zone_map
+ * @brief Structure that summarises the values one column has in a block, scans use it to skip blocks
+ that cannot hold a matching row. It is only widened by inserts and updates and made tight again by
+ AK_zone_map_rebuild.
+ */
+typedef struct {
+    /// type of the values, set by the first non NULL value
+    int type;
+    /// number of non NULL values; min and max are valid only if it is greater than 0
+    int count;
+    /// number of NULL values
+    int null_count;
+    /// smallest value, for orderable types only
+    unsigned char min[sizeof (double)];
+    /// largest value, for orderable types only
+    unsigned char max[sizeof (double)];
+} AK_zone_map;
+
 /**
   * @author Markus Schatten
   * @struct AK_block
@@ -96,10 +126,36 @@ typedef struct {
     /// AK_free space in block
     int AK_free_space;
     int last_tuple_dict_id;
+    /// number of live rows in the segment, kept only in the first block of the segment (FREE_INT if not known yet)
+    int num_records;
     /// attribute definitions
     AK_header header[MAX_ATTRIBUTES];
     /// dictionary of data entries
     AK_tuple_dict tuple_dict[DATA_BLOCK_SIZE];
+    /// one bit per tuple_dict entry, set if the entry holds NULL (the entry keeps the type of its column)
+    unsigned char null_bitmap[BITNSLOTS(DATA_BLOCK_SIZE)];
+    /// min/max/NULL summary of every column of the block
+    AK_zone_map zone_map[MAX_ATTRIBUTES];
+    /// 1 if entries were written without updating zone_map, which then must not be used to skip the block
+    int zone_map_stale;
+    /// Bloom filter over the values of the attributes whose header has has_bloom_filter set
+    unsigned char bloom_filter[BLOOM_FILTER_SIZE];
+    /// 1 if entries were written without adding them to bloom_filter
+    int bloom_filter_stale;
+    /// 1 if the values in data are grouped by column (block of a SEGMENT_TYPE_PAX_TABLE segment)
+    int pax;
+    /// end of the data area of every column in a PAX block, the area of a column starts where the one before ends
+    int minipage[MAX_ATTRIBUTES];
+    /// 1 if the block belongs to a SEGMENT_TYPE_APPEND_TABLE segment
+    int append_only;
+    /// 1 once the extent of an append-only block is full, no rows are written to a sealed block
+    int sealed;
+    /// block that takes the next insert of an append-only segment, kept only in the first block of the segment (0 if it is that block)
+    int append_tail;
+    /// 1 if the block is written to the db file compressed (blocks of sealed or cold extents)
+    int compressed;
+    /// 1 once an index of the segment is registered in AK_index, kept only in the first block of the segment
+    int indexed;
     /// actual data entries
     unsigned char data[DATA_BLOCK_SIZE * DATA_ENTRY_SIZE];
 } AK_block;
@@ -243,6 +299,7 @@ void AK_blocktable_dump(int zz);
 int AK_blocktable_flush();
 // void AK_allocate_array_currently_accessed_blocks(); // ne postoji nikakva implementacija
 TestResult AK_thread_safe_block_access_test();
+TestResult AK_block_compression_test();
 void *AK_read_block_for_testing(void *address);
 void *AK_write_block_for_testing(void *block);
 int AK_blocktable_get();
@@ -251,6 +308,7 @@ int AK_init_allocation_table();
 int AK_init_db_file(int size);
 AK_block *AK_read_block(int address);
 int AK_write_block(AK_block *block);
+int AK_compress_extent(int begin, int end);
 int AK_new_extent(int start_address, int old_size, int extent_type, AK_header *header);
 int AK_new_segment(char *name, int type, AK_header *header);
 AK_header *AK_create_header(char *name, int type, int integrity, char *constr_name, char *contr_code);
@@ -0,0 +1,235 @@
+/**
+@file append.c Provides functions for append-only tables. Rows of a SEGMENT_TYPE_APPEND_TABLE segment are only
+inserted, always into the tail block of the last extent, so an insert does not search the segment for free space.
+When the last extent is full it is sealed: its zone maps and Bloom filters are rebuilt once and stay exact, because
+rows of the table are never updated or deleted, and its blocks are stored compressed.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "append.h"
+#include "fileio.h"
+#include "filesearch.h"
+#include "vacuum.h"
+
+/**
+ * @author Unknown
+ * @brief Function that checks if a segment is an append-only table
+ * @param addresses addresses of the extents of the segment
+ * @return 1 if the segment is an append-only table, otherwise 0
+ */
+int AK_append_only(table_addresses *addresses) {
+    int append_only;
+    AK_PRO;
+    if (addresses == NULL || addresses->address_from[0] == 0) {
+        AK_EPI;
+        return 0;
+    }
+    append_only = AK_get_block(addresses->address_from[0])->block->append_only;
+    AK_EPI;
+    return append_only;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that seals a full extent of an append-only table. The zone maps and Bloom filters of its blocks
+ *        are rebuilt from the rows, values of dictionary encoded columns are shared and the dead space this leaves
+ *        is compacted. The blocks are written to the DB file compressed from then on.
+ * @param from first block of the extent
+ * @param to end of the extent (first block after it)
+ */
+void AK_append_seal_extent(int from, int to) {
+    AK_mem_block *mem_block;
+    AK_block *block;
+    int i, num_attr;
+    AK_PRO;
+    for (i = from; i < to; i++) {
+        mem_block = AK_get_block(i);
+        block = mem_block->block;
+        for (num_attr = 0; num_attr < MAX_ATTRIBUTES && block->header[num_attr].att_name[0] != FREE_CHAR; num_attr++)
+            ;
+        AK_encoding_encode_block(block);
+        if (AK_encoding_shared_bytes(block) > 0)
+            AK_vacuum_block(block, num_attr);
+        AK_zone_map_rebuild(block);
+        AK_bloom_rebuild(block);
+        block->sealed = 1;
+        block->compressed = 1;
+        AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that gives the block the next row of an append-only table is inserted into. It is the tail block
+ *        kept in the first block of the segment while it has room, then the next block of the same extent. When the
+ *        last extent is full it is sealed and a new extent is allocated.
+ * @param table name of the table
+ * @param addresses addresses of the extents of the table
+ * @return address of the block to write in, EXIT_ERROR if no new extent could be allocated
+ */
+int AK_append_find_tail(char *table, table_addresses *addresses) {
+    AK_mem_block *mem_block;
+    int j, tail;
+    AK_PRO;
+    mem_block = AK_get_block(addresses->address_from[0]);
+    tail = mem_block->block->append_tail != 0 ? mem_block->block->append_tail : addresses->address_from[0];
+
+    mem_block = AK_get_block(tail);
+    if (mem_block->block->AK_free_space < MAX_FREE_SPACE_SIZE
+            && mem_block->block->last_tuple_dict_id < MAX_LAST_TUPLE_DICT_SIZE_TO_USE) {
+        AK_EPI;
+        return tail;
+    }
+
+    for (j = 0; j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0; j++)
+        if (tail >= addresses->address_from[j] && tail < addresses->address_to[j])
+            break;
+    if (j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0 && tail + 1 < addresses->address_to[j]) {
+        tail++;
+    } else {
+        if (j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0)
+            AK_append_seal_extent(addresses->address_from[j], addresses->address_to[j]);
+        tail = AK_init_new_extent(table, SEGMENT_TYPE_APPEND_TABLE);
+        if (tail == EXIT_ERROR) {
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+    }
+
+    mem_block = AK_get_block(addresses->address_from[0]);
+    mem_block->block->append_tail = tail;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    AK_EPI;
+    return tail;
+}
+
+static int append_test_run_count = 0;
+
+/**
+ * @author Unknown
+ * @brief Function for testing append-only tables. Rows are appended until the first extent is sealed, then
+ *        deletes are rejected and a time range is searched.
+ * @return TestResult
+ */
+TestResult AK_append_test() {
+    char table[MAX_ATT_NAME], payload[MAX_VARCHAR_LENGTH];
+    table_addresses *addresses;
+    AK_block *block;
+    search_params sp;
+    search_result sr;
+    struct list_node *row_root;
+    int i, k, ts, lower, upper, expected, sealed, ordered, passed = 0, failed = 0;
+    AK_PRO;
+
+    AK_header header[3] = {
+        {TYPE_INT, "ts", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "payload", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    sprintf(table, "append_test_%d", append_test_run_count++);
+    if (AK_initialize_new_segment(table, SEGMENT_TYPE_APPEND_TABLE, header) == EXIT_ERROR) {
+        AK_EPI;
+        return TEST_result(0, 1);
+    }
+
+    memset(payload, 'x', 190);
+    payload[190] = '\0';
+    row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row_root);
+    for (ts = 0; ts < 330; ts++) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &ts, table, "ts", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, payload, table, "payload", row_root);
+        AK_insert_row(row_root);
+    }
+    addresses = AK_get_table_addresses(table);
+
+    /* 1: the first extent was filled block by block, in insert order */
+    printf("\nAppend tail test\n");
+    expected = 0;
+    ordered = addresses->address_from[1] != 0;
+    for (i = addresses->address_from[0]; ordered && i < addresses->address_to[0]; i++) {
+        block = AK_get_block(i)->block;
+        ordered = block->tuple_dict[0].type != FREE_INT;
+        for (k = 0; ordered && k < DATA_BLOCK_SIZE && block->tuple_dict[k].type != FREE_INT; k += 2)
+            ordered = *(int *) (block->data + block->tuple_dict[k].address) == expected++;
+    }
+    block = AK_get_block(addresses->address_from[0])->block;
+    if (ordered && block->append_tail >= addresses->address_from[1] && block->append_tail < addresses->address_to[1]) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 2: the full extent is sealed with exact zone maps and compressed, the new one is not */
+    printf("\nAppend seal test\n");
+    sealed = 1;
+    for (i = addresses->address_from[0]; i < addresses->address_to[0]; i++) {
+        block = AK_get_block(i)->block;
+        sealed = sealed && block->sealed && block->compressed && !block->zone_map_stale;
+    }
+    block = AK_get_block(addresses->address_from[1])->block;
+    if (sealed && block->append_only && !block->sealed && !block->compressed) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_free(addresses);
+
+    /* 3: rows can not be deleted or updated */
+    printf("\nAppend delete test\n");
+    ts = 5;
+    AK_DeleteAll_L3(&row_root);
+    AK_Update_Existing_Element(TYPE_INT, &ts, table, "ts", row_root);
+    if (AK_delete_row(row_root) == EXIT_ERROR && AK_get_num_records(table) == 330) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 4: a time range is found in sealed and open blocks */
+    printf("\nAppend range search test\n");
+    lower = 300;
+    upper = 319;
+    sp.szAttribute = "ts";
+    sp.pData_lower = &lower;
+    sp.pData_upper = &upper;
+    sp.iSearchType = SEARCH_RANGE;
+    sr = AK_search_unsorted(table, &sp, 1);
+    k = sr.iNum_tuple_addresses;
+    AK_deallocate_search_result(sr);
+    if (k == 20) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_DeleteAll_L3(&row_root);
+    AK_free(row_root);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
@@ -0,0 +1,33 @@
+/**
+@file append.h Header file that provides declarations of functions for append-only tables
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef APPEND
+#define APPEND
+
+#include "../auxi/test.h"
+#include "../dm/dbman.h"
+#include "../mm/memoman.h"
+#include "../auxi/mempro.h"
+
+int AK_append_only(table_addresses *addresses);
+int AK_append_find_tail(char *table, table_addresses *addresses);
+void AK_append_seal_extent(int from, int to);
+TestResult AK_append_test();
+
+#endif
@@ -18,6 +18,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
  */
 
+#define _GNU_SOURCE /* for copy_file_range */
+
 #include <dirent.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,11 +30,16 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 
 #ifdef _WIN32
 #include <direct.h>
 #endif
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
 #include "../auxi/configuration.h" // blobs folder path is specified here
 #include "../dm/dbman.h"           // system catalog
 #include "blobs.h"
@@ -57,7 +64,12 @@ AK_File_Metadata AK_File_Metadata_malloc() {
  * @return returns globaly universal identifier based on kernel implementation
  */
 char *AK_GUID() {
-  srand(clock());
+  static int seeded = 0;
+  if (!seeded) {
+    // seeded once, reseeding with clock() gave objects imported in a row the same OID
+    srand(clock() ^ time(NULL) ^ getpid());
+    seeded = 1;
+  }
   char *GUID = (char *)AK_malloc(sizeof(char) * 40);
   int t = 0;
   char *szTemp = "xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx";
@@ -123,33 +135,73 @@ int AK_mkdir(const char *path) {
 #endif
 }
 
-int AK_copy(const char *from, const char *to) {
-  // printf("Copying %s\n to %s\n", from, to);
-  FILE *ptr_old, *ptr_new;
-  char ch;
+/**
+ * @author Unknown
+ * @brief Function that copies the rest of one open file into another. The data is copied inside the kernel with
+ * copy_file_range, or sendfile where the file system does not support it, and through a large buffer otherwise.
+ * @param in file descriptor to copy from, read from its current offset to the end
+ * @param out file descriptor to copy to, written at its current offset
+ * @return returns 0 for true and -1 for false
+ */
+static int AK_copy_fd(int in, int out) {
+  struct stat st;
+  off_t remaining = 0;
+  ssize_t n, written;
+  char *buffer;
+
+  if (fstat(in, &st) == 0)
+    remaining = st.st_size - lseek(in, 0, SEEK_CUR);
+
+#ifdef __linux__
+  while (remaining > 0 && (n = copy_file_range(in, NULL, out, NULL, remaining, 0)) > 0)
+    remaining -= n;
+  while (remaining > 0 && (n = sendfile(out, in, NULL, remaining)) > 0)
+    remaining -= n;
+#endif
 
-  ptr_old = fopen(from, "rb");
+  buffer = AK_malloc(LO_COPY_BUFFER_SIZE);
+  while ((n = read(in, buffer, LO_COPY_BUFFER_SIZE)) > 0) {
+    for (written = 0; written < n;) {
+      ssize_t w = write(out, buffer + written, n - written);
+      if (w <= 0) {
+        AK_free(buffer);
+        return -1;
+      }
+      written += w;
+    }
+  }
+  AK_free(buffer);
+  return n < 0 ? -1 : 0;
+}
+
+/**
+ * @author Samuel Picek, updated by Unknown (copying in the kernel instead of byte by byte)
+ * @brief Function that copies a file
+ * @return returns 0 for true and -1 for false
+ */
+int AK_copy(const char *from, const char *to) {
+  int in, out, result;
 
   printf("[INFO] Copying file from %s to %s\n", from, to);
-  // printf("ptr_old %s\n", ptr_old);
-  if (ptr_old == NULL) {
+  in = open(from, O_RDONLY);
+  if (in < 0) {
     perror("[ERROR]");
     return -1;
   }
 
-  ptr_new = fopen(to, "wb");
-  if (ptr_new == NULL) {
+  out = open(to, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) {
     perror("[ERROR]");
+    close(in);
     return -1;
   }
 
-  while ((ch = fgetc(ptr_old)) != EOF)
-    fputc(ch, ptr_new);
+  result = AK_copy_fd(in, out);
 
-  fclose(ptr_new);
-  fclose(ptr_old);
+  close(out);
+  close(in);
   printf("[INFO] Files closed.\n");
-  return 0;
+  return result;
 }
 
 /**
@@ -170,7 +222,7 @@ char *AK_concat(char *s1, char *s2) {
 
 char *AK_clear_all_newline(char *s) {
 
-  char *n = malloc(strlen(s ? s : "\n"));
+  char *n = malloc(strlen(s ? s : "\n") + 1);
   if (s)
     strcpy(n, s);
   n[strlen(n) - 1] = '\0';
@@ -260,13 +312,13 @@ int AK_write_metadata(char *oid, AK_File_Metadata meta) {
  * @author Unknown
  * @brief Opens file based on given object id, copies metadata from it and
  * returns as result.
- * @return If the given file can't be open it returns -1, else it returns
+ * @return If the given file can't be open it returns NULL, else it returns
  * fetched metadata.
  */
 AK_File_Metadata AK_read_metadata(char *oid) {
 
   if (oid == 0x0)
-    return -1;
+    return 0x0;
 
   AK_File_Metadata meta = AK_File_Metadata_malloc();
 
@@ -284,7 +336,7 @@ AK_File_Metadata AK_read_metadata(char *oid) {
 
   if (fp == NULL) {
     printf("\t[+] Cannot open file.\n");
-    return -1;
+    return 0x0;
   } else {
     printf("\t[+] File opened.\n");
   }
@@ -318,6 +370,13 @@ AK_File_Metadata AK_read_metadata(char *oid) {
   if (meta->old_path == 0x0)
     return 0x0;
 
+  if (fgets(line, sizeof(line), fp) != NULL) {
+    strcpy(meta->checksum, line);
+    meta->checksum = AK_clear_all_newline(meta->checksum);
+  } else {
+    meta->checksum[0] = '\0';
+  }
+
   fclose(fp);
   printf("\t[+] File closed.\n");
 
@@ -325,8 +384,112 @@ AK_File_Metadata AK_read_metadata(char *oid) {
 }
 
 /**
- * @author Samuel Picek
- * @brief Function that imports  large objects to database
+ * @author Unknown
+ * @brief Function that computes the content hash of a file: 64-bit FNV-1a of the bytes followed by the size
+ * @param path path of the file
+ * @param checksum set to the hash as text, at least 40 characters
+ * @return returns 0 for true and -1 for false
+ */
+static int AK_lo_checksum(const char *path, char *checksum) {
+  unsigned long long hash = 14695981039346656037ULL;
+  long long size = 0;
+  unsigned char *buffer;
+  ssize_t n, i;
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0)
+    return -1;
+  buffer = AK_malloc(LO_COPY_BUFFER_SIZE);
+  while ((n = read(fd, buffer, LO_COPY_BUFFER_SIZE)) > 0) {
+    for (i = 0; i < n; i++)
+      hash = (hash ^ buffer[i]) * 1099511628211ULL;
+    size += n;
+  }
+  AK_free(buffer);
+  close(fd);
+  if (n < 0)
+    return -1;
+  sprintf(checksum, "%016llx-%lld", hash, size);
+  return 0;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares the contents of two files
+ * @return returns 1 if the files have the same bytes, otherwise 0
+ */
+static int AK_lo_same_content(const char *path1, const char *path2) {
+  char *buffer1, *buffer2;
+  ssize_t n1, n2;
+  int same = 1;
+  int fd1 = open(path1, O_RDONLY);
+  int fd2 = open(path2, O_RDONLY);
+
+  if (fd1 < 0 || fd2 < 0)
+    same = 0;
+  buffer1 = AK_malloc(LO_COPY_BUFFER_SIZE);
+  buffer2 = AK_malloc(LO_COPY_BUFFER_SIZE);
+  while (same) {
+    n1 = read(fd1, buffer1, LO_COPY_BUFFER_SIZE);
+    // a regular file returns whole buffers until its end
+    n2 = read(fd2, buffer2, LO_COPY_BUFFER_SIZE);
+    if (n1 != n2 || n1 < 0 || memcmp(buffer1, buffer2, n1) != 0)
+      same = 0;
+    if (n1 <= 0)
+      break;
+  }
+  AK_free(buffer1);
+  AK_free(buffer2);
+  if (fd1 >= 0)
+    close(fd1);
+  if (fd2 >= 0)
+    close(fd2);
+  return same;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that looks in the blobs folder for a stored object with the given contents
+ * @param checksum content hash of the file
+ * @param filepath the file
+ * @param found_path set to the path of the stored object, at least 512 characters
+ * @return returns 1 if an object with the same contents is found, otherwise 0
+ */
+static int AK_lo_find_duplicate(char *checksum, char *filepath, char *found_path) {
+  DIR *dir = opendir(AK_BLOBS_PATH);
+  struct dirent *entry;
+  char meta_path[1024], line[512];
+  int i, len, found = 0;
+  FILE *f;
+
+  if (dir == NULL)
+    return 0;
+  while (!found && (entry = readdir(dir)) != NULL) {
+    len = strlen(entry->d_name);
+    if (len < 5 || strcmp(entry->d_name + len - 5, ".meta") != 0)
+      continue;
+    snprintf(meta_path, sizeof(meta_path), "%s/%s", AK_BLOBS_PATH, entry->d_name);
+    f = fopen(meta_path, "r");
+    if (f == NULL)
+      continue;
+    // new name, new path, old name, old path, checksum
+    for (i = 0; i < 5 && fgets(line, sizeof(line), f) != NULL; i++) {
+      line[strcspn(line, "\n")] = '\0';
+      if (i == 1)
+        strcpy(found_path, line);
+    }
+    fclose(f);
+    found = i == 5 && strcmp(line, checksum) == 0 && AK_lo_same_content(found_path, filepath);
+  }
+  closedir(dir);
+  return found;
+}
+
+/**
+ * @author Samuel Picek, updated by Unknown (deduplication)
+ * @brief Function that imports  large objects to database. A file with the same contents as an object already in
+ * the blobs folder is not copied, the new object is a hard link to the stored one (AK_lo_open separates them before
+ * either is written).
  * @return OID (object ID)
  */
 char *AK_lo_import(char *filepath) {
@@ -337,7 +500,8 @@ char *AK_lo_import(char *filepath) {
 
   AK_File_Metadata meta = AK_File_Metadata_malloc();
   char *oid = AK_GUID();
-  meta->checksum = "";
+  char duplicate[512];
+  int copied;
 
   char *old_name = (char)AK_malloc(sizeof(char) * 128); // filename
   char *old_path = (char)AK_malloc(
@@ -352,7 +516,20 @@ char *AK_lo_import(char *filepath) {
 
   meta->new_path = AK_concat(AK_concat(AK_BLOBS_PATH, "/"), oid);
 
-  if (AK_copy(filepath, meta->new_path) == 0) {
+  if (AK_lo_checksum(filepath, meta->checksum) != 0)
+    meta->checksum[0] = '\0';
+
+  if (meta->checksum[0] != '\0' &&
+      AK_lo_find_duplicate(meta->checksum, filepath, duplicate) &&
+      link(duplicate, meta->new_path) == 0) {
+    printf("[INFO] Same contents as %s, linked instead of copied.\n",
+           duplicate);
+    copied = 0;
+  } else {
+    copied = AK_copy(filepath, meta->new_path);
+  }
+
+  if (copied == 0) {
     printf(
         "[INFO] Large object imported successfully.\n\t[+] Object is at %s\n",
         meta->new_path);
@@ -431,6 +608,189 @@ int AK_lo_unlink(char *oid) {
   return 0;
 }
 
+/**
+ * @author Unknown
+ * @brief Function that creates an empty large object, to be filled through AK_lo_open and AK_lo_write
+ * @return OID (object ID), NULL if the object could not be created
+ */
+char *AK_lo_create() {
+  AK_File_Metadata meta = AK_File_Metadata_malloc();
+  char *oid = AK_GUID();
+  int fd;
+
+  strcpy(meta->new_name, oid);
+  meta->old_name[0] = '\0';
+  meta->old_path[0] = '\0';
+  meta->new_path = AK_concat(AK_concat(AK_BLOBS_PATH, "/"), oid);
+
+  fd = open(meta->new_path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    perror("[ERROR]");
+    return NULL;
+  }
+  close(fd);
+
+  if (AK_lo_checksum(meta->new_path, meta->checksum) != 0 ||
+      AK_write_metadata(oid, meta) != 0) {
+    remove(meta->new_path);
+    return NULL;
+  }
+  return oid;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that opens a large object for streaming reads and writes. An object opened for writing that
+ * shares its file with a deduplicated object gets its own copy first.
+ * @param oid object ID
+ * @param mode LO_READ, LO_WRITE or both
+ * @return handle of the object, NULL if it does not exist or can not be opened
+ */
+AK_lo_handle *AK_lo_open(char *oid, int mode) {
+  AK_lo_handle *lo;
+  struct stat st;
+  char path[512], copy[520];
+  int fd;
+
+  if (oid == NULL || strlen(oid) >= sizeof(lo->oid) ||
+      (mode & (LO_READ | LO_WRITE)) == 0)
+    return NULL;
+
+  snprintf(path, sizeof(path), "%s/%s", AK_BLOBS_PATH, oid);
+  if (stat(path, &st) != 0)
+    return NULL;
+
+  if ((mode & LO_WRITE) && st.st_nlink > 1) {
+    snprintf(copy, sizeof(copy), "%s.tmp", path);
+    if (AK_copy(path, copy) != 0 || rename(copy, path) != 0) {
+      remove(copy);
+      return NULL;
+    }
+  }
+
+  if (mode & LO_WRITE)
+    fd = open(path, (mode & LO_READ) ? O_RDWR : O_WRONLY);
+  else
+    fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  lo = AK_malloc(sizeof(AK_lo_handle));
+  lo->fd = fd;
+  lo->mode = mode;
+  lo->position = 0;
+  strcpy(lo->oid, oid);
+  return lo;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads from a large object at its current position and moves the position past the bytes read
+ * @param lo handle from AK_lo_open
+ * @param buffer buffer for the bytes
+ * @param size number of bytes to read
+ * @return number of bytes read, 0 at the end of the object, -1 on error
+ */
+int AK_lo_read(AK_lo_handle *lo, void *buffer, int size) {
+  ssize_t n;
+
+  if (lo == NULL || (lo->mode & LO_READ) == 0 || size < 0)
+    return -1;
+  n = pread(lo->fd, buffer, size, lo->position);
+  if (n < 0)
+    return -1;
+  lo->position += n;
+  return n;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that writes to a large object at its current position and moves the position past the bytes
+ * written. Writing past the end extends the object.
+ * @param lo handle from AK_lo_open
+ * @param buffer bytes to write
+ * @param size number of bytes to write
+ * @return number of bytes written, -1 on error
+ */
+int AK_lo_write(AK_lo_handle *lo, const void *buffer, int size) {
+  ssize_t n;
+  int written = 0;
+
+  if (lo == NULL || (lo->mode & LO_WRITE) == 0 || size < 0)
+    return -1;
+  while (written < size) {
+    n = pwrite(lo->fd, (const char *)buffer + written, size - written,
+               lo->position);
+    if (n <= 0)
+      return -1;
+    written += n;
+    lo->position += n;
+  }
+  return written;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that moves the position of the next read or write of a large object
+ * @param lo handle from AK_lo_open
+ * @param offset offset from the origin
+ * @param whence origin: SEEK_SET, SEEK_CUR or SEEK_END
+ * @return new position, -1 on error
+ */
+long AK_lo_seek(AK_lo_handle *lo, long offset, int whence) {
+  struct stat st;
+  long base;
+
+  if (lo == NULL)
+    return -1;
+  switch (whence) {
+  case SEEK_SET:
+    base = 0;
+    break;
+  case SEEK_CUR:
+    base = lo->position;
+    break;
+  case SEEK_END:
+    if (fstat(lo->fd, &st) != 0)
+      return -1;
+    base = st.st_size;
+    break;
+  default:
+    return -1;
+  }
+  if (base + offset < 0)
+    return -1;
+  lo->position = base + offset;
+  return lo->position;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that closes a large object. The content hash of an object opened for writing is updated.
+ * @param lo handle from AK_lo_open
+ * @return returns 0 for true and -1 for false
+ */
+int AK_lo_close(AK_lo_handle *lo) {
+  AK_File_Metadata meta;
+  char checksum[64];
+  int result = 0;
+
+  if (lo == NULL)
+    return -1;
+  close(lo->fd);
+  if (lo->mode & LO_WRITE) {
+    meta = AK_read_metadata(lo->oid);
+    if (meta == NULL || AK_lo_checksum(meta->new_path, checksum) != 0) {
+      result = -1;
+    } else {
+      meta->checksum = checksum;
+      result = AK_write_metadata(lo->oid, meta);
+    }
+  }
+  AK_free(lo);
+  return result;
+}
+
 /**
  * @author Samuel Picek
  * @brief  Tests
@@ -441,6 +801,11 @@ TestResult AK_lo_test() {
   FILE *f2;
   long size;
   long size2;
+  AK_lo_handle *lo;
+  struct stat st1, st2;
+  char path1[512], path2[512], *chunk, back[100], *oid2;
+  unsigned char first;
+  int i, ok;
 
   printf("[INFO] Starting AK_lo_test.\n");
   char *oid = AK_lo_import("./config.ini");
@@ -467,5 +832,61 @@ TestResult AK_lo_test() {
     printf("config.ini in temp and orginal are same\n");
   }
 
+  if (AK_lo_same_content("./config.ini", "/tmp/config.ini"))
+    success++;
+  else
+    failed++;
+
+  printf("[INFO] Streaming test\n");
+  chunk = AK_malloc(100000);
+  for (i = 0; i < 100000; i++)
+    chunk[i] = i % 251;
+  oid = AK_lo_create();
+  lo = AK_lo_open(oid, LO_WRITE);
+  ok = lo != NULL;
+  for (i = 0; ok && i < 3; i++)
+    ok = AK_lo_write(lo, chunk, 100000) == 100000;
+  ok = AK_lo_close(lo) == 0 && ok;
+  lo = AK_lo_open(oid, LO_READ);
+  ok = ok && lo != NULL && AK_lo_seek(lo, 0, SEEK_END) == 300000 &&
+       AK_lo_seek(lo, 250000, SEEK_SET) == 250000 &&
+       AK_lo_read(lo, back, 100) == 100 &&
+       memcmp(back, chunk + 50000, 100) == 0 &&
+       AK_lo_seek(lo, -50, SEEK_END) == 299950 &&
+       AK_lo_read(lo, back, 100) == 50 && AK_lo_read(lo, back, 100) == 0 &&
+       AK_lo_write(lo, chunk, 1) == -1;
+  AK_lo_close(lo);
+  AK_lo_unlink(oid);
+  AK_free(chunk);
+  if (ok)
+    success++;
+  else
+    failed++;
+
+  printf("[INFO] Deduplication test\n");
+  oid = AK_lo_import("./config.ini");
+  oid2 = AK_lo_import("./config.ini");
+  snprintf(path1, sizeof(path1), "%s/%s", AK_BLOBS_PATH, oid);
+  snprintf(path2, sizeof(path2), "%s/%s", AK_BLOBS_PATH, oid2);
+  ok = stat(path1, &st1) == 0 && stat(path2, &st2) == 0 &&
+       st1.st_ino == st2.st_ino;
+  // writing one of them must not change the other
+  lo = AK_lo_open(oid2, LO_READ | LO_WRITE);
+  ok = ok && lo != NULL && AK_lo_read(lo, &first, 1) == 1;
+  first = ~first;
+  ok = ok && AK_lo_seek(lo, 0, SEEK_SET) == 0 &&
+       AK_lo_write(lo, &first, 1) == 1;
+  ok = AK_lo_close(lo) == 0 && ok;
+  ok = ok && stat(path1, &st1) == 0 && stat(path2, &st2) == 0 &&
+       st1.st_ino != st2.st_ino &&
+       AK_lo_same_content("./config.ini", path1) &&
+       !AK_lo_same_content("./config.ini", path2);
+  AK_lo_unlink(oid);
+  AK_lo_unlink(oid2);
+  if (ok)
+    success++;
+  else
+    failed++;
+
   return TEST_result(success, failed);
 }
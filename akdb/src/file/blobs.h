@@ -38,6 +38,44 @@ struct _file_metadata {
 typedef struct _file_metadata AK_Metadata;
 typedef struct _file_metadata *AK_File_Metadata;
 
+/**
+ * @def LO_READ
+ * @brief large object is opened for reading
+ */
+#define LO_READ 1
+/**
+ * @def LO_WRITE
+ * @brief large object is opened for writing
+ */
+#define LO_WRITE 2
+/**
+ * @def LO_COPY_BUFFER_SIZE
+ * @brief size of the buffer used when a large object can not be copied inside the kernel
+ */
+#define LO_COPY_BUFFER_SIZE (1024 * 1024)
+
+/**
+ * @author Unknown
+ * @struct _lo_handle
+ * @brief Structure for a large object opened for streaming reads and writes
+ * @var _lo_handle::fd
+ * file descriptor of the object file
+ * @var _lo_handle::mode
+ * LO_READ, LO_WRITE or both
+ * @var _lo_handle::position
+ * offset of the next read or write
+ * @var _lo_handle::oid
+ * object ID
+ */
+struct _lo_handle {
+  int fd;
+  int mode;
+  long position;
+  char oid[40];
+};
+
+typedef struct _lo_handle AK_lo_handle;
+
 AK_File_Metadata AK_File_Metadata_malloc();
 
 /* Helper functions */
@@ -111,6 +149,13 @@ int AK_lo_export(char *oid, char *filepath);
  */
 int AK_lo_unlink(char *oid);
 
+char *AK_lo_create();
+AK_lo_handle *AK_lo_open(char *oid, int mode);
+int AK_lo_read(AK_lo_handle *lo, void *buffer, int size);
+int AK_lo_write(AK_lo_handle *lo, const void *buffer, int size);
+long AK_lo_seek(AK_lo_handle *lo, long offset, int whence);
+int AK_lo_close(AK_lo_handle *lo);
+
 TestResult AK_lo_test();
 
 #endif
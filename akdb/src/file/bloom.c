@@ -0,0 +1,314 @@
+/**
+@file bloom.c Provides functions for per-block Bloom filters. Values of the columns declared with AK_bloom_declare
+are hashed into a filter kept in every block, so equality lookups can skip blocks that surely do not hold the value.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "bloom.h"
+#include "fileio.h"
+
+/**
+ * @author Unknown
+ * @brief Function that hashes a value of a column for the Bloom filter. The column takes part in the hash because
+ *        all declared columns of a block share one filter. A varchar is hashed up to its terminating zero, so a
+ *        value overwritten in place by a shorter one hashes the same as the value inserted on its own.
+ * @param column index of the column in the block header
+ * @param type data type of the value
+ * @param value value in its block representation
+ * @param size size of the value in bytes
+ * @return hash value
+ */
+static unsigned int AK_bloom_hash(int column, int type, unsigned char *value, int size) {
+    if (type == TYPE_VARCHAR)
+        size = strnlen((char *) value, size);
+    return AK_hash_value(type, value, size) ^ AK_hash_mix(column + 1);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds a value to the Bloom filter of a block if its column is declared, otherwise it does nothing
+ * @param block block the value was written to
+ * @param column index of the column in the block header
+ * @param type data type of the value
+ * @param value value in its block representation
+ * @param size size of the value in bytes
+ */
+void AK_bloom_add(AK_block *block, int column, int type, unsigned char *value, int size) {
+    unsigned int h1, h2;
+    int i;
+    AK_PRO;
+    if (column < 0 || column >= MAX_ATTRIBUTES || !block->header[column].has_bloom_filter) {
+        AK_EPI;
+        return;
+    }
+    h1 = AK_bloom_hash(column, type, value, size);
+    h2 = AK_hash_mix(h1) | 1;
+    for (i = 0; i < BLOOM_FILTER_HASHES; i++)
+        BITSET(block->bloom_filter, (h1 + i * h2) % (BLOOM_FILTER_SIZE * CHAR_BIT));
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds the non NULL values of one row to the Bloom filter of a block
+ * @param block block the row was written to
+ * @param id index of the first tuple_dict entry of the row
+ * @param num_attr number of attributes of the row
+ */
+void AK_bloom_add_row(AK_block *block, int id, int num_attr) {
+    int l;
+    AK_PRO;
+    for (l = 0; l < num_attr && id + l < DATA_BLOCK_SIZE; l++) {
+        if (!AK_IS_NULL(block, id + l))
+            AK_bloom_add(block, l, block->tuple_dict[id + l].type, block->data + block->tuple_dict[id + l].address,
+                    block->tuple_dict[id + l].size);
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that computes the Bloom filter of a block again from its live rows. Deleted and overwritten
+ *        values leave their bits set until the filter is rebuilt.
+ * @param block block
+ */
+void AK_bloom_rebuild(AK_block *block) {
+    int i, num_attr = 0;
+    AK_PRO;
+    memset(block->bloom_filter, 0, sizeof (block->bloom_filter));
+    block->bloom_filter_stale = 0;
+    while (num_attr < MAX_ATTRIBUTES && block->header[num_attr].att_name[0] != FREE_CHAR)
+        num_attr++;
+    if (num_attr == 0) {
+        AK_EPI;
+        return;
+    }
+    for (i = 0; i + num_attr <= DATA_BLOCK_SIZE && block->tuple_dict[i + num_attr - 1].type != FREE_INT; i += num_attr) {
+        //deleted rows have all entries cleared
+        if (block->tuple_dict[i].type == 0 && block->tuple_dict[i].size == 0)
+            continue;
+        AK_bloom_add_row(block, i, num_attr);
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if a block may hold a value in a column
+ * @param block block
+ * @param column index of the column in the block header
+ * @param type data type of the value
+ * @param value value
+ * @param size size of the value in bytes
+ * @return 0 if the block surely does not hold the value, 1 if it may, or if the column has no filter
+ */
+int AK_bloom_may_contain(AK_block *block, int column, int type, unsigned char *value, int size) {
+    unsigned int h1, h2;
+    int i;
+    AK_PRO;
+    if (block->bloom_filter_stale || column < 0 || column >= MAX_ATTRIBUTES || !block->header[column].has_bloom_filter) {
+        AK_EPI;
+        return 1;
+    }
+    h1 = AK_bloom_hash(column, type, value, size);
+    h2 = AK_hash_mix(h1) | 1;
+    for (i = 0; i < BLOOM_FILTER_HASHES; i++) {
+        if (!BITTEST(block->bloom_filter, (h1 + i * h2) % (BLOOM_FILTER_SIZE * CHAR_BIT))) {
+            AK_EPI;
+            return 0;
+        }
+    }
+    AK_EPI;
+    return 1;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that declares a Bloom filter on a column of a table. The column is marked in the header of every
+ *        block of the table, so blocks of new extents inherit it, and the filters of the existing blocks are built.
+ * @param table table name
+ * @param attribute attribute name
+ * @return EXIT_SUCCESS or EXIT_ERROR if the table has no such attribute
+ */
+int AK_bloom_declare(char *table, char *attribute) {
+    table_addresses *addresses;
+    AK_mem_block *mem_block;
+    int i, j, column;
+    AK_PRO;
+    column = AK_get_attr_index(table, attribute);
+    if (column < 0 || column >= MAX_ATTRIBUTES) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    addresses = AK_get_table_addresses(table);
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            mem_block = AK_get_block(j);
+            mem_block->block->header[column].has_bloom_filter = 1;
+            AK_bloom_rebuild(mem_block->block);
+            AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if some row of a table holds a string in an attribute. Values are compared as C strings,
+ *        the way the constraint checks compare them, and the rows of blocks whose Bloom filter rules the string out
+ *        are not looked at.
+ * @param table table name
+ * @param attribute attribute name
+ * @param value string to look for
+ * @return 1 if a row holds the value, 0 otherwise
+ */
+int AK_bloom_find_string(char *table, char *attribute, char *value) {
+    table_addresses *addresses = AK_get_table_addresses(table);
+    AK_block *block;
+    int i, j, k, column, num_attr, found = 0, length = strlen(value);
+    AK_PRO;
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0 && !found; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i] && !found; j++) {
+            block = AK_get_block(j)->block;
+            if (block->tuple_dict[0].type == FREE_INT)
+                continue;
+            column = -1;
+            for (num_attr = 0; num_attr < MAX_ATTRIBUTES && block->header[num_attr].att_name[0] != FREE_CHAR; num_attr++) {
+                if (strcmp(block->header[num_attr].att_name, attribute) == 0)
+                    column = num_attr;
+            }
+            if (column < 0)
+                break;
+            //only a varchar is stored the way the string is given
+            if (block->header[column].type == TYPE_VARCHAR
+                    && !AK_bloom_may_contain(block, column, TYPE_VARCHAR, (unsigned char *) value, length))
+                continue;
+            for (k = column; k < DATA_BLOCK_SIZE && block->tuple_dict[k - column].type != FREE_INT; k += num_attr) {
+                if (block->tuple_dict[k].size <= 0 || AK_IS_NULL(block, k))
+                    continue;
+                if (strnlen((char *) block->data + block->tuple_dict[k].address, block->tuple_dict[k].size) == length
+                        && memcmp(block->data + block->tuple_dict[k].address, value, length) == 0) {
+                    found = 1;
+                    break;
+                }
+            }
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return found;
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing Bloom filters
+ * @return TestResult
+ */
+TestResult AK_bloom_test() {
+    char table[MAX_ATT_NAME], key[MAX_VARCHAR_LENGTH];
+    static int run_count = 0;
+    table_addresses *addresses;
+    AK_block *block;
+    struct list_node *row_root;
+    int i, j, id, used = 0, candidates = 0, passed = 0, failed = 0;
+    AK_PRO;
+
+    AK_header header[3] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "code", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    sprintf(table, "bloom_test_%d", run_count++);
+    if (AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, header) == EXIT_ERROR) {
+        AK_EPI;
+        return TEST_result(0, 1);
+    }
+    row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row_root);
+    for (id = 0; id < 100; id++) {
+        sprintf(key, "code-%04d", id);
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, key, table, "code", row_root);
+        AK_insert_row(row_root);
+    }
+
+    /* 1: declaring builds the filters of the existing rows */
+    printf("\nBloom filter declare test\n");
+    addresses = AK_get_table_addresses(table);
+    block = AK_get_block(addresses->address_from[0])->block;
+    AK_free(addresses);
+    if (AK_bloom_declare(table, "code") == EXIT_SUCCESS && AK_bloom_declare(table, "missing") == EXIT_ERROR
+            && block->header[1].has_bloom_filter && !block->header[0].has_bloom_filter
+            && AK_bloom_may_contain(block, 1, TYPE_VARCHAR, (unsigned char *) "code-0042", strlen("code-0042"))
+            && AK_bloom_may_contain(block, 0, TYPE_INT, (unsigned char *) &id, sizeof (int))) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 2: rows inserted later are added on insert, most blocks are ruled out for a single key */
+    printf("\nBloom filter insert test\n");
+    for (id = 100; id < 600; id++) {
+        sprintf(key, "code-%04d", id);
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, key, table, "code", row_root);
+        AK_insert_row(row_root);
+    }
+    addresses = AK_get_table_addresses(table);
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            block = AK_get_block(j)->block;
+            if (block->tuple_dict[0].type == FREE_INT)
+                continue;
+            used++;
+            if (AK_bloom_may_contain(block, 1, TYPE_VARCHAR, (unsigned char *) "code-0550", strlen("code-0550")))
+                candidates++;
+        }
+    }
+    AK_free(addresses);
+    printf("%d of %d blocks may hold code-0550\n", candidates, used);
+    if (used > 1 && candidates == 1) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 3: lookups find present strings and no absent ones */
+    printf("\nBloom filter lookup test\n");
+    if (AK_bloom_find_string(table, "code", "code-0007") && AK_bloom_find_string(table, "code", "code-0599")
+            && !AK_bloom_find_string(table, "code", "code-0600") && !AK_bloom_find_string(table, "code", "code-00")) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_DeleteAll_L3(&row_root);
+    AK_free(row_root);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
@@ -0,0 +1,37 @@
+/**
+@file bloom.h Header file that provides declarations of functions for per-block Bloom filters on declared columns
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef BLOOM
+#define BLOOM
+
+#include "../auxi/test.h"
+#include "../auxi/comparator.h"
+#include "../dm/dbman.h"
+#include "../mm/memoman.h"
+#include "../auxi/mempro.h"
+
+int AK_bloom_declare(char *table, char *attribute);
+void AK_bloom_add(AK_block *block, int column, int type, unsigned char *value, int size);
+void AK_bloom_add_row(AK_block *block, int id, int num_attr);
+void AK_bloom_rebuild(AK_block *block);
+int AK_bloom_may_contain(AK_block *block, int column, int type, unsigned char *value, int size);
+int AK_bloom_find_string(char *table, char *attribute, char *value);
+TestResult AK_bloom_test();
+
+#endif
@@ -0,0 +1,350 @@
+/**
+@file encoding.c Provides functions for dictionary encoded varchar columns. A block keeps every distinct value of
+such a column once in its data and the tuple_dict entries of all rows holding the value point to it, so the address
+of the value is its code in the block. Readers follow tuple_dict as for any other column, equality lookups find the
+code of the searched value once per block and then compare codes instead of strings.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "encoding.h"
+#include "fileio.h"
+#include "filesearch.h"
+#include "vacuum.h"
+
+/**
+ * @author Unknown
+ * @brief Function that counts the attributes of the rows of a block
+ * @param block block
+ * @return number of attributes
+ */
+static int AK_encoding_num_attr(AK_block *block) {
+    int num_attr = 0;
+    while (num_attr < MAX_ATTRIBUTES && block->header[num_attr].att_name[0] != FREE_CHAR)
+        num_attr++;
+    return num_attr;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that finds the code of a value of a dictionary encoded column in a block
+ * @param block block
+ * @param column index of the column in the block header
+ * @param value value
+ * @param size size of the value in bytes
+ * @return address of the value in the data of the block, or -1 if no row of the block holds it or the column
+ *         is not dictionary encoded
+ */
+int AK_encoding_find(AK_block *block, int column, unsigned char *value, int size) {
+    int k, num_attr, code = -1;
+    AK_PRO;
+    num_attr = AK_encoding_num_attr(block);
+    if (column < 0 || column >= num_attr || !block->header[column].dictionary_encoded || size <= 0) {
+        AK_EPI;
+        return -1;
+    }
+    for (k = column; k < DATA_BLOCK_SIZE && block->tuple_dict[k - column].type != FREE_INT; k += num_attr) {
+        //deleted entries have size 0
+        if (block->tuple_dict[k].size != size || AK_IS_NULL(block, k))
+            continue;
+        if (memcmp(block->data + block->tuple_dict[k].address, value, size) == 0) {
+            code = block->tuple_dict[k].address;
+            break;
+        }
+    }
+    AK_EPI;
+    return code;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if the value of a tuple_dict entry is also used by another row of the block, in
+ *        which case it must not be overwritten or cleared in place
+ * @param block block
+ * @param id index of the tuple_dict entry
+ * @return 1 if another live entry points to the same value, otherwise 0
+ */
+int AK_encoding_shared(AK_block *block, int id) {
+    int k, num_attr, column, shared = 0;
+    AK_PRO;
+    num_attr = AK_encoding_num_attr(block);
+    if (num_attr == 0 || block->tuple_dict[id].size <= 0) {
+        AK_EPI;
+        return 0;
+    }
+    column = id % num_attr;
+    if (!block->header[column].dictionary_encoded) {
+        AK_EPI;
+        return 0;
+    }
+    for (k = column; k < DATA_BLOCK_SIZE && block->tuple_dict[k - column].type != FREE_INT; k += num_attr) {
+        if (k != id && block->tuple_dict[k].size > 0 && block->tuple_dict[k].address == block->tuple_dict[id].address) {
+            shared = 1;
+            break;
+        }
+    }
+    AK_EPI;
+    return shared;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that counts how many bytes the sizes of the tuple_dict entries of a block overstate its stored
+ *        values by, because entries of dictionary encoded columns share them
+ * @param block block
+ * @return number of bytes counted more than once
+ */
+int AK_encoding_shared_bytes(AK_block *block) {
+    int k, l, column, num_attr, bytes = 0;
+    AK_PRO;
+    num_attr = AK_encoding_num_attr(block);
+    for (column = 0; column < num_attr; column++) {
+        if (!block->header[column].dictionary_encoded)
+            continue;
+        for (k = column; k < DATA_BLOCK_SIZE && block->tuple_dict[k - column].type != FREE_INT; k += num_attr) {
+            if (block->tuple_dict[k].size <= 0)
+                continue;
+            for (l = column; l < k && (block->tuple_dict[l].size <= 0 || block->tuple_dict[l].address != block->tuple_dict[k].address); l += num_attr)
+                ;
+            if (l < k)
+                bytes += block->tuple_dict[k].size;
+        }
+    }
+    AK_EPI;
+    return bytes;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that encodes the rows a block already holds: entries of dictionary encoded columns are pointed
+ *        to the first entry with the same value. The bytes of the other copies become dead space that VACUUM
+ *        reclaims.
+ * @param block block
+ */
+void AK_encoding_encode_block(AK_block *block) {
+    int k, code, column, num_attr;
+    AK_PRO;
+    num_attr = AK_encoding_num_attr(block);
+    for (column = 0; column < num_attr; column++) {
+        if (!block->header[column].dictionary_encoded)
+            continue;
+        for (k = column; k < DATA_BLOCK_SIZE && block->tuple_dict[k - column].type != FREE_INT; k += num_attr) {
+            if (block->tuple_dict[k].size <= 0 || AK_IS_NULL(block, k))
+                continue;
+            //the first entry holding the value is found first, so it is its own code
+            code = AK_encoding_find(block, column, block->data + block->tuple_dict[k].address, block->tuple_dict[k].size);
+            if (code >= 0)
+                block->tuple_dict[k].address = code;
+        }
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that declares dictionary encoding on a varchar column of a table. The column is marked in the
+ *        header of every block of the table, so blocks of new extents inherit it, and the rows already stored
+ *        are encoded.
+ * @param table table name
+ * @param attribute attribute name
+ * @return EXIT_SUCCESS or EXIT_ERROR if the table has no such varchar attribute
+ */
+int AK_encoding_declare(char *table, char *attribute) {
+    table_addresses *addresses;
+    AK_mem_block *mem_block;
+    int i, j, column;
+    AK_PRO;
+    column = AK_get_attr_index(table, attribute);
+    if (column < 0 || column >= MAX_ATTRIBUTES) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    addresses = AK_get_table_addresses(table);
+    if (AK_get_block(addresses->address_from[0])->block->header[column].type != TYPE_VARCHAR) {
+        AK_free(addresses);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            mem_block = AK_get_block(j);
+            mem_block->block->header[column].dictionary_encoded = 1;
+            AK_encoding_encode_block(mem_block->block);
+            AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that checks that every row of an encoding test table still reads the status it was given
+ * @param table table name
+ * @return number of rows whose status is wrong
+ */
+static int AK_encoding_check_rows(char *table) {
+    static char *statuses[] = {"active", "inactive", "suspended"};
+    struct list_node *row, *id, *status;
+    int i, wrong = 0, num_rows = AK_get_num_records(table);
+    AK_PRO;
+    for (i = 0; i < num_rows; i++) {
+        row = AK_get_row(i, table);
+        id = AK_GetNth_L2(1, row);
+        status = AK_GetNth_L2(2, row);
+        if (id == NULL || status == NULL || status->is_null || strcmp(status->data, statuses[*(int *) id->data % 3]) != 0)
+            wrong++;
+        AK_DeleteAll_L3(&row);
+        AK_free(row);
+    }
+    AK_EPI;
+    return wrong;
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing dictionary encoded columns
+ * @return TestResult
+ */
+TestResult AK_encoding_test() {
+    static char *statuses[] = {"active", "inactive", "suspended"};
+    static int run_count = 0;
+    char table[MAX_ATT_NAME];
+    table_addresses *addresses;
+    AK_block *block;
+    struct list_node *row_root;
+    search_params sp;
+    search_result sr;
+    int i, j, k, l, id, distinct, plain = 0, encoded = 0, passed = 0, failed = 0;
+    AK_PRO;
+
+    AK_header header[3] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "status", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    sprintf(table, "encoding_test_%d", run_count++);
+    if (AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, header) == EXIT_ERROR) {
+        AK_EPI;
+        return TEST_result(0, 1);
+    }
+    row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row_root);
+    for (id = 0; id < 30; id++) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, statuses[id % 3], table, "status", row_root);
+        AK_insert_row(row_root);
+    }
+
+    /* 1: declaring encodes the rows already stored */
+    printf("\nDictionary encoding declare test\n");
+    addresses = AK_get_table_addresses(table);
+    block = AK_get_block(addresses->address_from[0])->block;
+    AK_free(addresses);
+    plain = block->AK_free_space;
+    if (AK_encoding_declare(table, "status") == EXIT_SUCCESS && AK_encoding_declare(table, "id") == EXIT_ERROR
+            && block->header[1].dictionary_encoded && block->tuple_dict[1].address == block->tuple_dict[7].address
+            && block->tuple_dict[1].address != block->tuple_dict[3].address && AK_encoding_check_rows(table) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 2: new rows store every status once per block */
+    printf("\nDictionary encoding insert test\n");
+    for (id = 30; id < 60; id++) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, statuses[id % 3], table, "status", row_root);
+        AK_insert_row(row_root);
+    }
+    encoded = block->AK_free_space - plain;
+    distinct = 0;
+    for (k = 1; k < DATA_BLOCK_SIZE && block->tuple_dict[k - 1].type != FREE_INT; k += 2) {
+        for (l = 1; l < k && block->tuple_dict[l].address != block->tuple_dict[k].address; l += 2)
+            ;
+        if (l == k)
+            distinct++;
+    }
+    printf("30 rows took %d bytes after %d bytes before encoding, %d distinct codes\n", encoded, plain, distinct);
+    if (encoded < plain && distinct == 3 && AK_encoding_check_rows(table) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 3: equality search compares codes */
+    printf("\nDictionary encoding search test\n");
+    sp.szAttribute = "status";
+    sp.pData_lower = "inactive";
+    sp.pData_upper = NULL;
+    sp.iSearchType = SEARCH_PARTICULAR;
+    sr = AK_search_unsorted(table, &sp, 1);
+    j = sr.iNum_tuple_addresses;
+    AK_deallocate_search_result(sr);
+    sp.pData_lower = "unknown";
+    sr = AK_search_unsorted(table, &sp, 1);
+    i = sr.iNum_tuple_addresses;
+    AK_deallocate_search_result(sr);
+    if (j == 20 && i == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 4: deleting, updating and vacuuming leave the shared values of other rows intact */
+    printf("\nDictionary encoding maintenance test\n");
+    AK_DeleteAll_L3(&row_root);
+    id = 1;
+    AK_Update_Existing_Element(TYPE_INT, &id, table, "id", row_root);
+    AK_delete_row(row_root);
+    AK_DeleteAll_L3(&row_root);
+    id = 4;
+    AK_Update_Existing_Element(TYPE_INT, &id, table, "id", row_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "on hold", table, "status", row_root);
+    AK_update_row(row_root);
+    AK_DeleteAll_L3(&row_root);
+    id = 4;
+    AK_Update_Existing_Element(TYPE_INT, &id, table, "id", row_root);
+    AK_delete_row(row_root);
+    AK_vacuum_table(table, NULL);
+    sp.pData_lower = "inactive";
+    sr = AK_search_unsorted(table, &sp, 1);
+    j = sr.iNum_tuple_addresses;
+    AK_deallocate_search_result(sr);
+    if (AK_get_num_records(table) == 58 && AK_encoding_check_rows(table) == 0 && j == 18
+            && AK_vacuum_dead_space(table) == 0) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_DeleteAll_L3(&row_root);
+    AK_free(row_root);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
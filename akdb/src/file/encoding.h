@@ -0,0 +1,35 @@
+/**
+@file encoding.h Header file that provides declarations of functions for dictionary encoded varchar columns
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef ENCODING
+#define ENCODING
+
+#include "../auxi/test.h"
+#include "../dm/dbman.h"
+#include "../mm/memoman.h"
+#include "../auxi/mempro.h"
+
+int AK_encoding_declare(char *table, char *attribute);
+int AK_encoding_find(AK_block *block, int column, unsigned char *value, int size);
+int AK_encoding_shared(AK_block *block, int id);
+int AK_encoding_shared_bytes(AK_block *block);
+void AK_encoding_encode_block(AK_block *block);
+TestResult AK_encoding_test();
+
+#endif
@@ -17,6 +17,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
  17 */
 #include "fileio.h"
+#include "../rel/expression_check.h"
+#include "idx/index.h"
+#include "idx/btree.h"
+#include "idx/hash.h"
+#include "idx/bitmap.h"
 
 //START SPECIAL FUNCTIONS FOR WORK WITH row_element_structure
 
@@ -27,7 +32,7 @@
             is allocated. Type, data, attribute name and constraint of new elemets are set according to function arguments. Pointers
             are changed so that before element points to new element.
    * @param newtype type of the data
-   * @param data the data
+   * @param data the data, NULL for a NULL value
    * @param table table name
    * @param attribute_name attribute name
    * @param element element after we which insert the new element
@@ -38,12 +43,18 @@ void AK_Insert_New_Element_For_Update(int newtype, void *data, char *table, char
 {
     AK_PRO;
 
-    struct list_node *newElement = (struct list_node *)AK_malloc(sizeof(struct list_node));
+    struct list_node *newElement = (struct list_node *)AK_temp_alloc(sizeof(struct list_node));
+    memset(newElement, 0, sizeof(struct list_node));
     newElement->type = newtype;
-    memcpy(newElement->data, data, AK_type_size(newtype, data));
+    if (data == NULL)
+        newElement->is_null = 1;
+    else
+    {
+        memcpy(newElement->data, data, AK_type_size(newtype, data));
 
-    if (newtype == TYPE_VARCHAR)
-        newElement->data[AK_type_size(newtype, data)] = '\0';
+        if (newtype == TYPE_VARCHAR)
+            newElement->data[AK_type_size(newtype, data)] = '\0';
+    }
 
     memcpy(newElement->table, table, strlen(table));
     newElement->table[strlen(table)] = '\0';
@@ -99,7 +110,8 @@ void AK_Insert_New_Element(int newtype, void *data, char *table, char *attribute
 
 /** @author Matija Novak, updated by Dino Laktašić
         @brief Function inserts one row into some block.  Firstly it checks wether block contain attributes from the list. Then
-               data, type, size and last_tuple_id are put in temp_block.
+               data, type, size and last_tuple_id are put in temp_block. Attributes missing from the list and elements marked
+               is_null are written as NULL: the entry keeps the column type and its bit in null_bitmap is set.
         @param row_root list of elements to insert
         @param temp_block block in which we insert data
         @return EXIT SUCCES if success
@@ -111,6 +123,9 @@ int AK_insert_row_to_block(struct list_node *row_root, AK_block *temp_block)
     int id = 0;      //id tuple dict in which is inserted next data
     int head = 0;    //index of header which is curently inserted
     int search_elem; //serch for tuple dict id and searc for data in list
+    int is_null;     //1 if NULL is written for the current header
+    int size;        //size of entry data
+    int code;        //address of an equal value of a dictionary encoded attribute
     char entry_data[MAX_VARCHAR_LENGTH];
     AK_PRO;
 
@@ -131,9 +146,11 @@ int AK_insert_row_to_block(struct list_node *row_root, AK_block *temp_block)
             if ((strcmp(some_element->attribute_name, temp_block->header[head].att_name) == 0) && (some_element->constraint == 0))
             { //found correct element
                 type = some_element->type;
+                is_null = some_element->is_null;
 
                 memset(entry_data, '\0', MAX_VARCHAR_LENGTH);
-                memcpy(entry_data, some_element->data, AK_type_size(type, some_element->data));
+                if (!is_null)
+                    memcpy(entry_data, some_element->data, AK_type_size(type, some_element->data));
 
                 search_elem = 0;
             }
@@ -142,23 +159,51 @@ int AK_insert_row_to_block(struct list_node *row_root, AK_block *temp_block)
                 some_element = (struct list_node *)AK_Next_L2(some_element);
                 if (some_element == 0)
                 { //no data exist for this header write null
-                    some_element = 1;
-                    memcpy(entry_data, "null", strlen("null"));
-                    type = TYPE_VARCHAR;
+                    memset(entry_data, '\0', MAX_VARCHAR_LENGTH);
+                    type = temp_block->header[head].type;
+                    is_null = 1;
                     search_elem = 0;
                 }
             }
         }
 
-        memcpy(temp_block->data + temp_block->AK_free_space, entry_data, (int)AK_type_size(type, entry_data));
-        temp_block->tuple_dict[id].address = temp_block->AK_free_space;
-        temp_block->AK_free_space += AK_type_size(type, entry_data);
+        size = AK_type_size(type, entry_data);
+        if (is_null)
+        { //NULL keeps the column type, its data is zeroed and at least one byte long so that row scans see the entry
+            if (size == 0)
+                size = 1;
+            AK_SET_NULL(temp_block, id);
+        }
+        else
+            AK_CLEAR_NULL(temp_block, id);
+
+        code = -1;
+        if (!is_null && temp_block->header[head].dictionary_encoded)
+            code = AK_encoding_find(temp_block, head, entry_data, size);
+        if (code >= 0)
+        { //the value is already stored in the block, the entry takes its code
+            temp_block->tuple_dict[id].address = code;
+        }
+        else
+        { //a PAX block writes the value into the area of its column
+            code = AK_pax_alloc(temp_block, head, size);
+            if (code == EXIT_ERROR)
+            {
+                AK_EPI;
+                return EXIT_ERROR;
+            }
+            memcpy(temp_block->data + code, entry_data, size);
+            temp_block->tuple_dict[id].address = code;
+        }
         temp_block->tuple_dict[id].type = type;
-        temp_block->tuple_dict[id].size = AK_type_size(type, entry_data);
+        temp_block->tuple_dict[id].size = size;
+        AK_zone_map_add(temp_block, head, type, temp_block->data + temp_block->tuple_dict[id].address, size, is_null);
+        if (!is_null)
+            AK_bloom_add(temp_block, head, type, temp_block->data + temp_block->tuple_dict[id].address, size);
 
         memcpy(entry_data, temp_block->data + temp_block->tuple_dict[id].address, temp_block->tuple_dict[id].size);
 
-        AK_dbg_messg(HIGH, FILE_MAN, "insert_row_to_block: Insert: data: %s, size: %d\n", entry_data, AK_type_size(type, entry_data));
+        AK_dbg_messg(HIGH, FILE_MAN, "insert_row_to_block: Insert: data: %s, size: %d, null: %d\n", entry_data, size, is_null);
         head++; //go to next header
     }
     //writes the last used tuple dict id
@@ -168,9 +213,120 @@ int AK_insert_row_to_block(struct list_node *row_root, AK_block *temp_block)
     return EXIT_SUCCESS;
 }
 
+/**
+ * @author Unknown
+ * @brief Function that stores the number of live rows of a table. The count is kept in the first block of the segment.
+ * @param table table name
+ * @param num_records number of rows, FREE_INT marks the count as unknown so it is recomputed on next use
+ * @return EXIT_SUCCESS if success, EXIT_WARNING if the table has no extents
+ */
+int AK_set_num_records(char *table, int num_records)
+{
+    AK_PRO;
+    table_addresses *addresses = AK_get_table_addresses(table);
+    int first = addresses->address_from[0];
+    AK_free(addresses);
+
+    if (first == 0)
+    {
+        AK_EPI;
+        return EXIT_WARNING;
+    }
+
+    AK_mem_block *mem_block = AK_get_block(first);
+    mem_block->block->num_records = num_records;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds delta to the number of live rows of a table. Nothing is done while the count is unknown.
+ * @param table table name
+ * @param delta number of inserted (positive) or deleted (negative) rows
+ * @return EXIT_SUCCESS if the count was updated, EXIT_WARNING if it is not known
+ */
+int AK_update_num_records(char *table, int delta)
+{
+    AK_PRO;
+    table_addresses *addresses = AK_get_table_addresses(table);
+    int first = addresses->address_from[0];
+    AK_free(addresses);
+
+    if (first == 0 || delta == 0)
+    {
+        AK_EPI;
+        return EXIT_WARNING;
+    }
+
+    AK_mem_block *mem_block = AK_get_block(first);
+    if (mem_block->block->num_records == FREE_INT)
+    {
+        AK_EPI;
+        return EXIT_WARNING;
+    }
+    mem_block->block->num_records += delta;
+    if (mem_block->block->num_records < 0)
+        mem_block->block->num_records = FREE_INT;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that lists the indexes registered for a table in AK_index. Only a table flagged in its first
+ *        block by AK_initialize_new_index_segment is looked up, other tables have no indexes.
+ * @param table table name
+ * @param first first block of the table, 0 to look it up
+ * @param indexes array of MAX_TABLE_INDEXES the indexes are written to
+ * @return number of indexes
+ */
+static int AK_table_indexes(char *table, int first, AK_index_info *indexes)
+{
+    table_addresses *addresses;
+    int num = 0;
+    AK_PRO;
+    if (first == 0)
+    {
+        addresses = AK_get_table_addresses(table);
+        first = addresses->address_from[0];
+        AK_free(addresses);
+    }
+    if (first != 0 && AK_get_block(first)->block->indexed)
+        num = AK_get_table_indexes(table, indexes, MAX_TABLE_INDEXES);
+    AK_EPI;
+    return num;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds a row to every index of its table or removes its entries. It is called for every row
+ *        written or cleared by an insert, update or delete, before the change is committed in the redo log, so the
+ *        indexes change within the same logged operation.
+ * @param indexes indexes of the table
+ * @param num_indexes number of indexes
+ * @param block block the row is in
+ * @param row tuple_dict index of the first attribute of the row
+ * @param delete if 0 the row is added else it is removed
+ * @return No return value
+ */
+static void AK_maintain_indexes(AK_index_info *indexes, int num_indexes, AK_block *block, int row, int delete)
+{
+    int i;
+    AK_PRO;
+    for (i = 0; i < num_indexes; i++)
+    {
+        if (AK_index_row(&indexes[i], block, row, delete) == EXIT_ERROR)
+            AK_dbg_messg(LOW, FILE_MAN, "maintain_indexes: index %s not updated for row %d of block %d\n", indexes[i].name, row, block->address);
+    }
+    AK_EPI;
+}
+
 /** @author Matija Novak, updated by Matija Šestak (function now uses caching), updated by Dejan Frankovic (added reference check), updated by Dino         Laktašić (removed variable AK_free, variable table initialized using memset), updated by Josip Šušnjara (chained blocks support)
         @brief Function inserts a one row into table. Firstly it is checked whether inserted row would violite reference integrity.
-        Then it is checked in which table should row be inserted. If there is no AK_free space for new table, new extent is allocated. New block is            allocated on given address. Row is inserted in this block and dirty flag is set to BLOCK_DIRTY.
+        Then it is checked in which table should row be inserted. If there is no AK_free space for new table, new extent is allocated. New block is            allocated on given address. Row is inserted in this block and dirty flag is set to BLOCK_DIRTY. The row is then added to every index of the table.
         @param row_root list of elements which contain data of one row
         @return EXIT_SUCCESS if success else EXIT_ERROR
 
@@ -198,19 +354,19 @@ int AK_insert_row(struct list_node *row_root)
     memset(table, '\0', MAX_ATT_NAME);
     memcpy(&table, some_element->table, strlen(some_element->table));
     AK_dbg_messg(HIGH, FILE_MAN, "insert_row: Insert into table: %s\n", table);
-    int adr_to_write;
+    int adr_to_write, first, row;
+    AK_index_info indexes[MAX_TABLE_INDEXES];
     table_addresses_return = AK_get_table_addresses(table);
-    adr_to_write = (int)AK_find_AK_free_space(table_addresses_return);
+    first = table_addresses_return->address_from[0];
+    //rows of an append-only table go to its tail block, no search for free space
+    if (AK_append_only(table_addresses_return))
+        adr_to_write = AK_append_find_tail(table, table_addresses_return);
+    else
+        adr_to_write = (int)AK_find_AK_free_space(table_addresses_return);
     AK_free(table_addresses_return);
 
     if (adr_to_write == -1)
         adr_to_write = (int)AK_init_new_extent(table, SEGMENT_TYPE_TABLE);
-    if (strstr(some_element->table, "_bmapIndex"))
-    {
-        table_addresses_return = AK_get_index_addresses(table);
-        adr_to_write = (int)AK_find_AK_free_space(table_addresses_return);
-        AK_free(table_addresses_return);
-    }
 
     if (adr_to_write == 0)
     {
@@ -218,8 +374,6 @@ int AK_insert_row(struct list_node *row_root)
         return EXIT_ERROR;
     }
 
-    table_addresses *addresses = (table_addresses *)AK_get_table_addresses(table);
-    
     /*for(int i = 0; i < blocks_per_row; i++){
     	AK_dbg_messg(HIGH, FILE_MAN, "insert_row: Insert into block on adress: %d\n", adr_to_write);
     	AK_mem_block *mem_block = (AK_mem_block *)AK_get_block(adr_to_write);
@@ -230,6 +384,11 @@ int AK_insert_row(struct list_node *row_root)
     int end;
     AK_mem_block *mem_block;
     int l = 0;
+    int row_block = adr_to_write;
+    //the row starts at the first free entry of the block
+    mem_block = (AK_mem_block *)AK_get_block(adr_to_write);
+    for (row = 0; row < DATA_BLOCK_SIZE && mem_block->block->tuple_dict[row].size != FREE_INT; row++)
+        ;
     do{
     	mem_block = (AK_mem_block *)AK_get_block(adr_to_write);
     	end = (int)AK_insert_row_to_block(row_root, mem_block->block);
@@ -239,8 +398,12 @@ int AK_insert_row(struct list_node *row_root)
     while(mem_block->block->chained_with != NOT_CHAINED);
 
     if (end == EXIT_SUCCESS)
+    {
+        AK_update_num_records(table, 1);
+        AK_maintain_indexes(indexes, AK_table_indexes(table, first, indexes), AK_get_block(row_block)->block, row, 0);
         AK_redolog_commit();
-        
+    }
+
 
     AK_EPI;
     return end;
@@ -248,7 +411,8 @@ int AK_insert_row(struct list_node *row_root)
 
 /**
    * @author Matija Novak, updated by Dino Laktašić, updated by Mario Peroković - separated from deletion, updated by Antun Tkalčec (fixed SIGSEGV)
-   * @brief Function updates row from table in given block if the data in the table is equal to data in attribute used for search. 
+   * @brief Function updates row from table in given block if the data in the table is equal to data in attribute used for search.
+            The entries of the row are removed from the indexes of the table and added again with the new values.
    * @param temp_block block to work with
    * @param row_list list of elements which contain data for delete or update
    * @return Returns an "EXIT_SUCCESS"
@@ -259,6 +423,8 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root)
     int attPlace = 0;                    //place of attribute which are same
     int del = 1;                         //if can delete gorup of tuple dicts which are in the same row of table
     int exists_equal_attrib = 0;         //if we found at least one header in the list
+    int num_indexes = -1;                //number of indexes of the table, looked up for the first row found
+    AK_index_info indexes[MAX_TABLE_INDEXES];
     char entry_data[MAX_VARCHAR_LENGTH]; //entry data when haeader is found in list which is copied to compare with data in block
     AK_PRO;
     struct list_node *new_data = (struct list_node *)AK_malloc(sizeof(struct list_node));
@@ -293,8 +459,8 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root)
                         memset(entry_data, '\0', MAX_VARCHAR_LENGTH);
                         memcpy(entry_data, temp_block->data + address, size);
 
-                        // if the data in table isn't equal to data in attribute which is used for search, it won't be updated
-                        if (strcmp(entry_data, some_element->data) != 0)
+                        // if the data in table isn't equal to data in attribute which is used for search, it won't be updated, NULL is never equal
+                        if (AK_IS_NULL(temp_block, i) || strcmp(entry_data, some_element->data) != 0)
                             del = 0;
                     }
                     else
@@ -308,6 +474,9 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root)
         if (exists_equal_attrib == 1 && del == 1)
         {
             int j;
+            if (num_indexes == -1)
+                num_indexes = AK_table_indexes(((struct list_node *)AK_First_L2(row_root))->table, 0, indexes);
+            AK_maintain_indexes(indexes, num_indexes, temp_block, i - attPlace, 1);
             for (j = i - attPlace; j < i + head - attPlace; j++)
             {
                 AK_DeleteAll_L3(&new_data);
@@ -325,34 +494,62 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root)
                     AK_Insert_New_Element(temp_block->tuple_dict[j].type, some_element->data, some_element->table, some_element->attribute_name, new_data);
                     if (strcmp(some_element->attribute_name, temp_block->header[j % head].att_name) == 0 && some_element->constraint == NEW_VALUE)
                     {
+                        int code = -1;
+                        if (!some_element->is_null && temp_block->header[j % head].dictionary_encoded)
+                            code = AK_encoding_find(temp_block, j % head, some_element->data, strlen(some_element->data));
+                        // the new value of a dictionary encoded attribute is already in the block, the row takes its code
+                        if (code >= 0) {
+                            AK_CLEAR_NULL(temp_block, j);
+                            temp_block->tuple_dict[j].address = code;
+                            temp_block->tuple_dict[j].size = strlen(some_element->data);
+                            AK_zone_map_add(temp_block, j % head, temp_block->tuple_dict[j].type, temp_block->data + code, temp_block->tuple_dict[j].size, 0);
+                            AK_bloom_add(temp_block, j % head, temp_block->tuple_dict[j].type, temp_block->data + code, temp_block->tuple_dict[j].size);
+                        }
                         // we need to delete and insert row, because size of new data is larger than size of old data
-                        if (strlen(some_element->data) > s)
+                        // or because other rows share the old value
+                        else if (strlen(some_element->data) > s || (!some_element->is_null && AK_encoding_shared(temp_block, j)))
                         {
+                            int live = 0;
                             for (int k = i - attPlace; k < i + head - attPlace; k++)
                             {
+                                if (temp_block->tuple_dict[k].size > 0)
+                                    live = 1;
                                 int o = temp_block->tuple_dict[k].address;
                                 int p = temp_block->tuple_dict[k].size;
                                 memset(entry_data, '\0', MAX_VARCHAR_LENGTH);
                                 memcpy(entry_data, temp_block->data + o, p);
                                 // if att_names are different, this is old data, and we need to insert it again
                                 if (strcmp(some_element->attribute_name, temp_block->header[k % head].att_name) != 0)
-                                    AK_Insert_New_Element(temp_block->tuple_dict[k].type, entry_data, some_element->table, temp_block->header[k % head].att_name, new_data);
+                                    AK_Insert_New_Element(temp_block->tuple_dict[k].type, AK_IS_NULL(temp_block, k) ? NULL : entry_data, some_element->table, temp_block->header[k % head].att_name, new_data);
 
+                                AK_CLEAR_NULL(temp_block, k);
                                 temp_block->tuple_dict[k].size = 0;
                                 temp_block->tuple_dict[k].type = 0;
                                 temp_block->tuple_dict[k].address = 0;
                             }
+                            // the row is counted again when it is reinserted
+                            if (live)
+                                AK_update_num_records(some_element->table, -1);
                             // insert new data
                             AK_insert_row(new_data);
                         }
                         // we need to update row
+                        else if (some_element->is_null) {
+                            if (!AK_encoding_shared(temp_block, j))
+                                memset(temp_block->data + a, 0, s);
+                            AK_SET_NULL(temp_block, j);
+                            AK_zone_map_add(temp_block, j % head, temp_block->tuple_dict[j].type, temp_block->data + a, s, 1);
+                        }
                         else { 
+                            AK_CLEAR_NULL(temp_block, j);
                             if (s > 0) {
                                 memcpy(temp_block->data + a, some_element->data, s);
                             }
                             else {
                                 memcpy(temp_block->data + a, some_element->data, strlen(some_element->data) + 1);
                             }
+                            AK_zone_map_add(temp_block, j % head, temp_block->tuple_dict[j].type, temp_block->data + a, s, 0);
+                            AK_bloom_add(temp_block, j % head, temp_block->tuple_dict[j].type, temp_block->data + a, s);
                             
                         }
                             // memcpy(temp_block->data + a, some_element->data, s);
@@ -361,6 +558,9 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root)
                     some_element = some_element->next;
                 }
             }
+            // a row updated in place goes back into the indexes, a reinserted row was added by AK_insert_row
+            if (temp_block->tuple_dict[i - attPlace].type != TYPE_INTERNAL)
+                AK_maintain_indexes(indexes, num_indexes, temp_block, i - attPlace, 0);
         }
         del = 1;
     }
@@ -373,17 +573,21 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root)
 
 /**
    * @author Matija Novak, updated by Dino Laktašić, changed by Davorin Vukelic, updated by Mario Peroković
-   * @brief Function deletes row from table in given block. Given list of elements is firstly back-upped.
+   * @brief Function deletes row from table in given block. Given list of elements is firstly back-upped. The entries of
+            a deleted row are removed from the indexes of the table.
    * @param temp_block block to work with
    * @param row_list list of elements which contain data for delete or update
-   * @return No return value
+   * @return number of deleted rows
 */
-void AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root)
+int AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root)
 {
+    int deleted = 0;                     //number of rows removed from the block
     int head = 0;                        //counting headers
     int attPlace = 0;                    //place of attribute which are same
     int del = 1;                         //if can delete gorup of tuple dicts which are in the same row of table
     int exists_equal_attrib = 0;         //if we found at least one header in the list
+    int num_indexes = -1;                //number of indexes of the table, looked up for the first row found
+    AK_index_info indexes[MAX_TABLE_INDEXES];
     char entry_data[MAX_VARCHAR_LENGTH]; //entry data when haeader is found in list which is copied to compare with data in block
     AK_PRO;
     struct list_node *row_root_backup = (struct list_node *)AK_malloc(sizeof(struct list_node));
@@ -393,7 +597,7 @@ void AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root)
 
     while (some_element)
     { //make a copy of list
-        AK_Insert_New_Element_For_Update(some_element->type, some_element->data, some_element->table, some_element->attribute_name, row_root_backup, some_element->constraint);
+        AK_Insert_New_Element_For_Update(some_element->type, some_element->is_null ? NULL : some_element->data, some_element->table, some_element->attribute_name, row_root_backup, some_element->constraint);
         //some_element = (struct list_node *) AK_Next_L2(some_element);
         some_element = some_element->next;
     }
@@ -427,8 +631,8 @@ void AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root)
                         memset(entry_data, '\0', MAX_VARCHAR_LENGTH);
                         memcpy(entry_data, temp_block->data + address, size);
 
-                        if (strcmp(entry_data, some_element->data) != 0)
-                            del = 0; //if one constraint doesn't metch we dont delete or update
+                        if (AK_IS_NULL(temp_block, i) || strcmp(entry_data, some_element->data) != 0)
+                            del = 0; //if one constraint doesn't metch we dont delete or update, NULL never matches
                     }
                     else
                         del = 0;
@@ -440,25 +644,37 @@ void AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root)
 
         if ((exists_equal_attrib == 1) && (del == 1))
         {
+            int live = 0;
+            if (num_indexes == -1)
+                num_indexes = AK_table_indexes(((struct list_node *)AK_First_L2(row_root))->table, 0, indexes);
+            if (temp_block->tuple_dict[i - attPlace].type != TYPE_INTERNAL)
+                AK_maintain_indexes(indexes, num_indexes, temp_block, i - attPlace, 1);
             for (int j = i - attPlace; j < i + head - attPlace; j++)
             { //delete one row
+                if (temp_block->tuple_dict[j].size > 0)
+                    live = 1;
 
                 int k = temp_block->tuple_dict[j].address;
                 int l = temp_block->tuple_dict[j].size;
-                memset(temp_block->data + k, '\0', l);
+                // a value shared with other rows stays in the block
+                if (!AK_encoding_shared(temp_block, j))
+                    memset(temp_block->data + k, '\0', l);
                 AK_dbg_messg(HIGH, FILE_MAN, "update_delete_row_from_block: from: %d, to: %d\n", k, l + k);
 
                 //clean tuple dict
+                AK_CLEAR_NULL(temp_block, j);
                 temp_block->tuple_dict[j].size = 0;
                 temp_block->tuple_dict[j].type = 0;
                 temp_block->tuple_dict[j].address = 0;
             }
+            deleted += live;
         }
         del = 1;
         exists_equal_attrib = 0;
     }
     AK_free(row_root_backup);
     AK_EPI;
+    return deleted;
 }
 
 /**
@@ -467,7 +683,7 @@ void AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root)
         in extent row is updated or deleted according to operator del.
       * @param row_root elements of one row
       * @param del - DELETE or UPDATE
-      * @return EXIT_SUCCESS if success
+      * @return EXIT_SUCCESS if success, EXIT_ERROR if the table is append-only
 */
 int AK_delete_update_segment(struct list_node *row_root, int del)
 {
@@ -481,8 +697,17 @@ int AK_delete_update_segment(struct list_node *row_root, int del)
 
     table_addresses *addresses = (table_addresses *)AK_get_table_addresses(table);
 
+    if (AK_append_only(addresses))
+    {
+        AK_dbg_messg(LOW, FILE_MAN, "delete_update_segment: rows of append-only table %s can not be deleted or updated\n", table);
+        AK_free(addresses);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+
     AK_mem_block *mem_block;
     int startAddress, j, i;
+    int deleted = 0;
 
     for (j = 0; j < MAX_EXTENTS_IN_SEGMENT; j++)
     { //going through extent
@@ -491,13 +716,13 @@ int AK_delete_update_segment(struct list_node *row_root, int del)
         {
             AK_dbg_messg(HIGH, FILE_MAN, "delete_update_segment: delete_update extent: %d\n", j);
 
-            for (i = startAddress; i <= addresses->address_to[j]; i++)
+            for (i = startAddress; i < addresses->address_to[j]; i++)
             { //going through blocks
                 AK_dbg_messg(HIGH, FILE_MAN, "delete_update_segment: delete_update block: %d\n", i);
                 mem_block = (AK_mem_block *)AK_get_block(i);
 
                 if (del == DELETE)
-                    AK_delete_row_from_block(mem_block->block, row_root);
+                    deleted += AK_delete_row_from_block(mem_block->block, row_root);
                 else
                     AK_update_row_from_block(mem_block->block, row_root);
                 AK_mem_block_modify(mem_block, BLOCK_DIRTY);
@@ -507,6 +732,7 @@ int AK_delete_update_segment(struct list_node *row_root, int del)
             break;
     }
     AK_free(addresses);
+    AK_update_num_records(table, -deleted);
     AK_EPI;
     return EXIT_SUCCESS;
 }
@@ -514,7 +740,7 @@ int AK_delete_update_segment(struct list_node *row_root, int del)
 /** @author Matija Novak, Dejan Frankovic (added referential integrity)
         @brief Function deletes rows
         @param row_root elements of one row
-        @returs EXIT_SUCCESS if success
+        @returs EXIT_SUCCESS if success, EXIT_ERROR if the row can not be deleted
  */
 int AK_delete_row(struct list_node *row_root)
 {
@@ -530,7 +756,11 @@ int AK_delete_row(struct list_node *row_root)
     if (AK_reference_check_if_update_needed(row_root, DELETE) == EXIT_SUCCESS)
         AK_reference_update(row_root, DELETE);
 
-    AK_delete_update_segment(row_root, DELETE);
+    if (AK_delete_update_segment(row_root, DELETE) == EXIT_ERROR)
+    {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
     AK_EPI;
     return EXIT_SUCCESS;
 }
@@ -568,7 +798,7 @@ void AK_delete_row_by_id(int id, char *tableName)
 /** @author Matija Novak, Dejan Frankovic (added referential integrity)
         @brief Function updates rows of some table
         @param row_root elements of one row
-        @return EXIT_SUCCESS if success
+        @return EXIT_SUCCESS if success, EXIT_ERROR if the rows can not be updated
 */
 int AK_update_row(struct list_node *row_root)
 {
@@ -584,11 +814,50 @@ int AK_update_row(struct list_node *row_root)
 
     if (AK_reference_check_if_update_needed(row_root, UPDATE) == EXIT_SUCCESS)
         AK_reference_update(row_root, UPDATE);
-    AK_delete_update_segment(row_root, UPDATE);
+    if (AK_delete_update_segment(row_root, UPDATE) == EXIT_ERROR)
+    {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
     AK_EPI;
     return EXIT_SUCCESS;
 }
 
+static int fileio_test_run_count = 0;
+
+/**
+ * @author Unknown
+ * @brief Function that searches an index of the test table for one value and checks that every row found holds it
+ * @param index index to search
+ * @param type type of the value
+ * @param value value to search for
+ * @param size size of the value
+ * @param position position of the indexed attribute in the table
+ * @return number of rows found, EXIT_ERROR if a row found does not hold the value
+ */
+static int AK_fileio_test_index_search(AK_index_info *index, int type, char *value, int size, int position)
+{
+    struct list_node *values = (struct list_node *)AK_malloc(sizeof(struct list_node));
+    struct_add *rows;
+    AK_block *block;
+    int found, i, n;
+    AK_Init_L3(&values);
+    AK_InsertAtEnd_L3(type, value, size, values);
+    found = AK_index_search(index, values, NULL, &rows);
+    for (i = 0; i < found; i++)
+    {
+        block = AK_get_block(rows[i].addBlock)->block;
+        n = rows[i].indexTd + position;
+        if (block->tuple_dict[n].size != size || memcmp(block->data + block->tuple_dict[n].address, value, size) != 0)
+            found = EXIT_ERROR;
+    }
+    if (rows != NULL)
+        AK_free(rows);
+    AK_DeleteAll_L3(&values);
+    AK_free(values);
+    return found;
+}
+
 TestResult AK_fileio_test()
 {
     AK_PRO;
@@ -695,6 +964,158 @@ TestResult AK_fileio_test()
 
     AK_print_table("testna");
 
+    // the maintained row count has to match a full scan, also after deleting
+    int num_records = AK_get_num_records("testna");
+    printf("\nNumber of records: %d (scan: %d)\n", num_records, AK_scan_num_records("testna"));
+    if (num_records == AK_scan_num_records("testna"))
+        ok++;
+    else
+        fail++;
+
+    AK_DeleteAll_L3(&row_root);
+    AK_Update_Existing_Element(TYPE_VARCHAR, "Matija", "testna", "Ime", row_root);
+    AK_delete_row(row_root);
+
+    printf("\nNumber of records after delete: %d (scan: %d)\n", AK_get_num_records("testna"), AK_scan_num_records("testna"));
+    if (AK_get_num_records("testna") == AK_scan_num_records("testna") && AK_get_num_records("testna") < num_records)
+        ok++;
+    else
+        fail++;
+
+    // NULLs keep the column type, are flagged in the null bitmap and never satisfy a comparison
+    AK_DeleteAll_L3(&row_root);
+    AK_Insert_New_Element(TYPE_INT, NULL, "testna", "Redni_broj", row_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "Nepoznat", "testna", "Ime", row_root);
+    AK_insert_row(row_root);
+
+    int null_ok = 0;
+    for (int i = 0; i < AK_get_num_records("testna") && !null_ok; i++)
+    {
+        struct list_node *row = AK_get_row(i, "testna");
+        struct list_node *broj = AK_First_L2(row);
+        struct list_node *ime = AK_Next_L2(broj);
+        struct list_node *prezime = AK_Next_L2(ime);
+        if (!ime->is_null && strcmp(ime->data, "Nepoznat") == 0)
+        {
+            char *prezime_string = AK_tuple_to_string(prezime);
+            null_ok = broj->is_null && broj->type == TYPE_INT && prezime->is_null && prezime->type == TYPE_VARCHAR && prezime_string == NULL;
+        }
+        AK_DeleteAll_L3(&row);
+        AK_free(row);
+    }
+
+    struct list_node *expr = (struct list_node *)AK_malloc(sizeof(struct list_node));
+    AK_Init_L3(&expr);
+    number = 100;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "Redni_broj", sizeof("Redni_broj"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *)&number, sizeof(int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "<", sizeof("<"), expr);
+    AK_DeleteAll_L3(&row_root);
+    AK_Insert_New_Element(TYPE_INT, NULL, "testna", "Redni_broj", row_root);
+    if (AK_check_if_row_satisfies_expression(AK_First_L2(row_root), expr))
+        null_ok = 0;
+    AK_DeleteAll_L3(&row_root);
+    number = 1;
+    AK_Insert_New_Element(TYPE_INT, &number, "testna", "Redni_broj", row_root);
+    if (!AK_check_if_row_satisfies_expression(AK_First_L2(row_root), expr))
+        null_ok = 0;
+    AK_DeleteAll_L3(&expr);
+    AK_free(expr);
+
+    printf("\nNULL bitmap test: %s\n", null_ok ? "SUCCESS" : "FAIL");
+    if (null_ok)
+        ok++;
+    else
+        fail++;
+
+    // B+tree, hash and bitmap indexes follow inserts, in place and moving updates and deletes of their table
+    char table[MAX_ATT_NAME], btree_name[MAX_ATT_NAME], hash_name[MAX_ATT_NAME], bitmap_name[MAX_ATT_NAME], name[MAX_VARCHAR_LENGTH];
+    AK_index_info indexes[MAX_TABLE_INDEXES];
+    int num_indexes, found, index_ok = 1;
+    AK_header i_header[3] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "name", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}};
+    sprintf(table, "testna_index_%d", fileio_test_run_count++);
+    sprintf(btree_name, "%s_btree", table);
+    sprintf(hash_name, "%s_hash", table);
+    sprintf(bitmap_name, "%sname_bmapIndex", table);
+    AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, i_header);
+
+    for (int i = 0; i < 20; i++)
+    {
+        // the indexes are created after the first rows, the rest is added by the inserts
+        if (i == 4)
+        {
+            AK_DeleteAll_L3(&row_root);
+            AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof("id"), row_root);
+            AK_btree_create(table, row_root, btree_name);
+            AK_create_hash_index(table, row_root, hash_name);
+            AK_DeleteAll_L3(&row_root);
+            AK_Insert_New_Element(TYPE_VARCHAR, "name", table, "name", row_root);
+            AK_create_Index_Table(table, row_root);
+        }
+        AK_DeleteAll_L3(&row_root);
+        sprintf(name, "name %d", i % 4);
+        AK_Insert_New_Element(TYPE_INT, &i, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, name, table, "name", row_root);
+        AK_insert_row(row_root);
+    }
+
+    // updated in place, to a value the bitmap index has no bitmap for
+    AK_DeleteAll_L3(&row_root);
+    number = 5;
+    AK_Update_Existing_Element(TYPE_INT, &number, table, "id", row_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "name 9", table, "name", row_root);
+    AK_update_row(row_root);
+    // moved to a new place by the update
+    AK_DeleteAll_L3(&row_root);
+    number = 6;
+    AK_Update_Existing_Element(TYPE_INT, &number, table, "id", row_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "a longer name 6", table, "name", row_root);
+    AK_update_row(row_root);
+    AK_DeleteAll_L3(&row_root);
+    number = 7;
+    AK_Update_Existing_Element(TYPE_INT, &number, table, "id", row_root);
+    AK_delete_row(row_root);
+
+    num_indexes = AK_get_table_indexes(table, indexes, MAX_TABLE_INDEXES);
+    if (num_indexes != 3)
+        index_ok = 0;
+    for (int i = 0; i < num_indexes; i++)
+    {
+        if (indexes[i].kind == INDEX_KIND_BITMAP)
+        {
+            found = AK_fileio_test_index_search(&indexes[i], TYPE_VARCHAR, "name 3", strlen("name 3"), 1);
+            printf("\nIndex %s: name 3 in %d rows\n", indexes[i].name, found);
+            if (found != 4
+                    || AK_fileio_test_index_search(&indexes[i], TYPE_VARCHAR, "name 9", strlen("name 9"), 1) != 1
+                    || AK_fileio_test_index_search(&indexes[i], TYPE_VARCHAR, "a longer name 6", strlen("a longer name 6"), 1) != 1
+                    || AK_fileio_test_index_search(&indexes[i], TYPE_VARCHAR, "name 2", strlen("name 2"), 1) != 4)
+                index_ok = 0;
+            continue;
+        }
+        found = 0;
+        for (int j = 0; j < 20; j++)
+        {
+            if (AK_fileio_test_index_search(&indexes[i], TYPE_INT, (char *)&j, sizeof(int), 0) == (j == 7 ? 0 : 1))
+                found++;
+        }
+        printf("\nIndex %s: %d of 20 keys found as expected\n", indexes[i].name, found);
+        if (found != 20)
+            index_ok = 0;
+    }
+
+    printf("\nIndex maintenance test: %s\n", index_ok ? "SUCCESS" : "FAIL");
+    if (index_ok)
+        ok++;
+    else
+        fail++;
+    AK_btree_delete(btree_name);
+    AK_delete_hash_index(hash_name);
+    AK_delete_bitmap_index(bitmap_name);
+    AK_delete_segment(table, SEGMENT_TYPE_TABLE);
+
     AK_DeleteAll_L3(&row_root);
     AK_free(row_root);
     AK_EPI;
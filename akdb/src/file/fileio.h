@@ -27,6 +27,11 @@
 #include "../rec/archive_log.h"
 #include "../rec/redo_log.h"
 #include "files.h"
+#include "zonemap.h"
+#include "bloom.h"
+#include "encoding.h"
+#include "pax.h"
+#include "append.h"
 #include "../auxi/mempro.h"
 
 /**
@@ -68,6 +73,24 @@ void AK_Insert_New_Element(int newtype, void * data, char * table, char * attrib
  */
 int AK_insert_row_to_block(struct list_node *row_root, AK_block *temp_block);
 
+/**
+ * @author Unknown
+ * @brief Function that stores the number of live rows of a table. The count is kept in the first block of the segment.
+ * @param table table name
+ * @param num_records number of rows, FREE_INT marks the count as unknown so it is recomputed on next use
+ * @return EXIT_SUCCESS if success, EXIT_WARNING if the table has no extents
+ */
+int AK_set_num_records(char *table, int num_records);
+
+/**
+ * @author Unknown
+ * @brief Function that adds delta to the number of live rows of a table. Nothing is done while the count is unknown.
+ * @param table table name
+ * @param delta number of inserted (positive) or deleted (negative) rows
+ * @return EXIT_SUCCESS if the count was updated, EXIT_WARNING if it is not known
+ */
+int AK_update_num_records(char *table, int delta);
+
 /** @author Matija Novak, updated by Matija Šestak (function now uses caching), updated by Dejan Frankovic (added reference check), updated by Dino         Laktašić (removed variable AK_free, variable table initialized using memset)
         @brief Function inserts a one row into table. Firstly it is checked whether inserted row would violite reference integrity.
         Then it is checked in which table should row be inserted. If there is no AK_free space for new table, new extent is allocated. New block is            allocated on given address. Row is inserted in this block and dirty flag is set to BLOCK_DIRTY.
@@ -91,9 +114,9 @@ int AK_update_row_from_block(AK_block *temp_block, struct list_node *row_root);
    * @brief Function deletes row from table in given block. Given list of elements is firstly back-upped.
    * @param temp_block block to work with
    * @param row_list list of elements which contain data for delete or update
-   * @return No return value
+   * @return number of deleted rows
 */
-void AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root);
+int AK_delete_row_from_block(AK_block *temp_block, struct list_node *row_root);
 
 /**
       * @author Matija Novak, updated by Matija Šestak (function now uses caching)
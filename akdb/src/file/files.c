@@ -72,17 +72,46 @@ int AK_initialize_new_segment(char *name, int type, AK_header *header) {
     AK_EPI;
 }
 
+/**
+ * @author Unknown
+ * @brief Function that flags the first block of a table once an index of it is registered in AK_index. Inserts,
+ *        updates and deletes look for the indexes of a table only if it is flagged.
+ * @param table_id obj_id of the table
+ * @return No return value
+ */
+static void AK_mark_indexed_table(int table_id) {
+    struct list_node *row;
+    AK_mem_block *mem_block;
+    int i, obj_id, start_address = 0;
+    AK_PRO;
+    for (i = 0; start_address == 0 && (row = AK_get_row(i, "AK_relation")) != NULL; i++) {
+        memcpy(&obj_id, get_row_attr_data(0, row), sizeof (int));
+        if (obj_id == table_id)
+            memcpy(&start_address, get_row_attr_data(2, row), sizeof (int));
+        AK_DeleteAll_L3(&row);
+        AK_free(row);
+    }
+    if (start_address > 0) {
+        mem_block = AK_get_block(start_address);
+        mem_block->block->indexed = 1;
+        AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    }
+    AK_EPI;
+}
+
 /**
  * @author Tomislav Fotak, updated by Matija Šestak (function now uses caching), reused by Lovro Predovan
  * @brief Function that initializes a new segment and writes its start and finish address in system catalog table.
- *  For creting new table, index, temporary table, etc. call this function
+ *  For creting new table, index, temporary table, etc. call this function. The indexed table is flagged so that its
+ *  rows are kept in the index from then on.
  * @param name segment name
- * @param type segment type
+ * @param table_id obj_id of the indexed table
+ * @param attr_id position of the indexed attribute in the table
  * @param header pointer to header that should be written to the new extent (all blocks)
  * @return start address of new segment
  */
 
-int AK_initialize_new_index_segment(char *name, char *table_id, int attr_id , AK_header *header) {
+int AK_initialize_new_index_segment(char *name, int table_id, int attr_id , AK_header *header) {
 
     int start_address = -1;
     int end_address = INITIAL_EXTENT_SIZE;
@@ -113,10 +142,11 @@ int AK_initialize_new_index_segment(char *name, char *table_id, int attr_id , AK
         AK_Insert_New_Element(TYPE_VARCHAR, name, sys_table, "name", row_root);
         AK_Insert_New_Element(TYPE_INT, &start_address, sys_table, "start_address", row_root);
         AK_Insert_New_Element(TYPE_INT, &end_address, sys_table, "end_address", row_root);
-        AK_Insert_New_Element(TYPE_VARCHAR, table_id, sys_table, "table_id", row_root);
+        AK_Insert_New_Element(TYPE_INT, &table_id, sys_table, "table_id", row_root);
         AK_Insert_New_Element(TYPE_INT, &attr_id, sys_table, "attribute_id", row_root);
 
         AK_insert_row(row_root);
+        AK_mark_indexed_table(table_id);
 
         AK_dbg_messg(LOW, FILE_MAN, "AK_init_new_segment__NOTIFICATION: New segment initialized at %d\n", start_address);
         AK_EPI;
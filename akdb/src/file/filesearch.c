@@ -44,7 +44,8 @@ search_result AK_search_unsorted(char *szRelation, search_params *aspParams,
   int iBlock;
   AK_mem_block *mem_block = NULL, tmp;
   int i, j, k;
-  int iTupleMatches;
+  int iTupleMatches, iBlockMatches;
+  int aiCodes[iNum_search_params > 0 ? iNum_search_params : 1];
   search_result srResult;
   table_addresses *taAddresses;
 
@@ -64,7 +65,7 @@ search_result AK_search_unsorted(char *szRelation, search_params *aspParams,
   for (k = 0; k < MAX_EXTENTS_IN_SEGMENT && taAddresses->address_from[k] > 0;
        k++) { // 200 == Novak's magic number :)
     for (iBlock = taAddresses->address_from[k];
-         iBlock <= taAddresses->address_to[k]; iBlock++) {
+         iBlock < taAddresses->address_to[k]; iBlock++) {
       // mem_block = AK_get_block(iBlock);
       mem_block = &tmp;
       mem_block->block = AK_read_block(iBlock);
@@ -104,6 +105,56 @@ search_result AK_search_unsorted(char *szRelation, search_params *aspParams,
       if (srResult.iNum_search_attributes != iNum_search_params)
         return srResult;
 
+      /// skip the block if its zone maps or its Bloom filter show that no
+      /// tuple can match
+      iBlockMatches = 1;
+      for (j = 0; j < iNum_search_params && iBlockMatches; j++) {
+        i = srResult.aiSearch_attributes[j];
+        switch (aspParams[j].iSearchType) {
+        case SEARCH_PARTICULAR:
+          iBlockMatches = AK_zone_map_may_contain(
+              mem_block->block, i, mem_block->block->header[i].type,
+              aspParams[j].pData_lower, aspParams[j].pData_lower);
+          if (iBlockMatches)
+            iBlockMatches = AK_bloom_may_contain(
+                mem_block->block, i, mem_block->block->header[i].type,
+                aspParams[j].pData_lower,
+                AK_type_size(mem_block->block->header[i].type,
+                             aspParams[j].pData_lower));
+          break;
+        case SEARCH_RANGE:
+          /// the scan reads floats as doubles, the zone maps hold them as
+          /// floats
+          if (mem_block->block->header[i].type != TYPE_FLOAT)
+            iBlockMatches = AK_zone_map_may_contain(
+                mem_block->block, i, mem_block->block->header[i].type,
+                aspParams[j].pData_lower, aspParams[j].pData_upper);
+          break;
+        case SEARCH_NULL:
+          iBlockMatches = AK_zone_map_may_contain_null(mem_block->block, i);
+          break;
+        }
+      }
+
+      /// equality on a dictionary encoded attribute compares codes, a block
+      /// without a code for the value holds no matching tuple
+      for (j = 0; j < iNum_search_params && iBlockMatches; j++) {
+        i = srResult.aiSearch_attributes[j];
+        aiCodes[j] = -1;
+        if (aspParams[j].iSearchType == SEARCH_PARTICULAR &&
+            mem_block->block->header[i].dictionary_encoded) {
+          aiCodes[j] = AK_encoding_find(
+              mem_block->block, i, aspParams[j].pData_lower,
+              AK_type_size(mem_block->block->header[i].type,
+                           aspParams[j].pData_lower));
+          iBlockMatches = aiCodes[j] >= 0;
+        }
+      }
+      if (!iBlockMatches) {
+        AK_free(mem_block->block);
+        continue;
+      }
+
       /// in every tuple, for all required attributes, compare attribute value
       /// with searched-for value and store matched tuple addresses
       for (i = 0; i < DATA_BLOCK_SIZE &&
@@ -112,13 +163,29 @@ search_result AK_search_unsorted(char *szRelation, search_params *aspParams,
         iTupleMatches = 1;
 
         for (j = 0; j < iNum_search_params && iTupleMatches; j++) {
+          /// NULL matches neither a particular value nor a range
+          if ((aspParams[j].iSearchType == SEARCH_PARTICULAR ||
+               aspParams[j].iSearchType == SEARCH_RANGE) &&
+              AK_IS_NULL(mem_block->block,
+                         i + srResult.aiSearch_attributes[j])) {
+            iTupleMatches = 0;
+            continue;
+          }
           switch (aspParams[j].iSearchType) {
           case SEARCH_PARTICULAR: {
             size_t iSearchAttributeValueSize = AK_type_size(
                 mem_block->block->header[srResult.aiSearch_attributes[j]].type,
                 (char *)aspParams[j].pData_lower);
 
-            if (mem_block->block
+            if (aiCodes[j] >= 0) {
+              if (mem_block->block
+                          ->tuple_dict[i + srResult.aiSearch_attributes[j]]
+                          .address != aiCodes[j] ||
+                  mem_block->block
+                          ->tuple_dict[i + srResult.aiSearch_attributes[j]]
+                          .size != iSearchAttributeValueSize)
+                iTupleMatches = 0;
+            } else if (mem_block->block
                         ->tuple_dict[i + srResult.aiSearch_attributes[j]]
                         .size != iSearchAttributeValueSize ||
                 memcmp(mem_block->block->data +
@@ -178,22 +245,11 @@ search_result AK_search_unsorted(char *szRelation, search_params *aspParams,
           case SEARCH_ALL: // iTupleMatches is already == 1, no action needed
             break;
 
-          case SEARCH_NULL: {
-            size_t iSearchAttributeValueSize = AK_type_size(
-                mem_block->block->header[srResult.aiSearch_attributes[j]].type,
-                (char *)aspParams[j].pData_lower);
-
-            if (mem_block->block
-                        ->tuple_dict[i + srResult.aiSearch_attributes[j]]
-                        .type != TYPE_VARCHAR ||
-                iSearchAttributeValueSize != strlen("NULL") ||
-                memcmp(mem_block->block->data +
-                           mem_block->block
-                               ->tuple_dict[i + srResult.aiSearch_attributes[j]]
-                               .address,
-                       "NULL", strlen("NULL")))
+          case SEARCH_NULL:
+            if (!AK_IS_NULL(mem_block->block,
+                            i + srResult.aiSearch_attributes[j]))
               iTupleMatches = 0;
-          } break;
+            break;
 
           default:
             iTupleMatches = 0;
@@ -23,6 +23,9 @@
 #include "../auxi/test.h"
 #include "../mm/memoman.h"
 #include "files.h"
+#include "zonemap.h"
+#include "bloom.h"
+#include "encoding.h"
 #include "../auxi/mempro.h"
 
 #define SEARCH_NULL       0
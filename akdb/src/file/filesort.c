@@ -85,92 +85,753 @@ int AK_get_num_of_tuples(AK_block *iBlock) {
     return (i / max_header_num);
 }
 
+/**
+ * @author Unknown
+ * @brief Function that translates an ordering list into sort keys. Every TYPE_ATTRIBS node is one key,
+ *        a TYPE_OPERATOR node "ASC" or "DESC" right after it sets the direction (ASC is the default).
+ * @param header table header
+ * @param num_attr number of attributes in the header
+ * @param ordering ordering list
+ * @param keys array of at least MAX_ATTRIBUTES keys that is filled
+ * @return number of keys or EXIT_ERROR if an attribute does not exist
+ */
+int AK_sort_parse_keys(AK_header *header, int num_attr, struct list_node *ordering, AK_sort_key *keys) {
+    int num_keys = 0;
+    int i;
+    struct list_node *el;
+    AK_PRO;
+    for (el = AK_First_L2(ordering); el != NULL; el = el->next) {
+        if (el->type == TYPE_OPERATOR && num_keys > 0) {
+            if (strcasecmp(el->data, "DESC") == 0)
+                keys[num_keys - 1].descending = 1;
+            else if (strcasecmp(el->data, "ASC") == 0)
+                keys[num_keys - 1].descending = 0;
+            continue;
+        }
+        if (el->type != TYPE_ATTRIBS || num_keys == MAX_ATTRIBUTES)
+            continue;
+        for (i = 0; i < num_attr; i++) {
+            if (strcmp(header[i].att_name, el->data) == 0)
+                break;
+        }
+        if (i == num_attr) {
+            printf("AK_sort_parse_keys: ERROR: in this table does not exist atribute: %s\n", el->data);
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+        keys[num_keys].attribute = i;
+        keys[num_keys].type = header[i].type;
+        keys[num_keys].descending = 0;
+        num_keys++;
+    }
+    AK_EPI;
+    return num_keys;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that compares two rows on the sort keys. NULLs come last in ascending and first in
+ *        descending order.
+ * @param a first row
+ * @param b second row
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return negative, zero or positive number if a comes before, together with or after b
+ */
+int AK_sort_compare_rows(AK_sort_row *a, AK_sort_row *b, AK_sort_key *keys, int num_keys) {
+    int i, att, a_null, b_null, result;
+    AK_PRO;
+    for (i = 0; i < num_keys; i++) {
+        att = keys[i].attribute;
+        a_null = a->null[att];
+        b_null = b->null[att];
+        if (a_null || b_null)
+            result = a_null - b_null;
+        else
+            result = AK_compare_values(keys[i].type, a->data[att], a->size[att], b->data[att], b->size[att]);
+        if (result != 0) {
+            AK_EPI;
+            return keys[i].descending ? -result : result;
+        }
+    }
+    AK_EPI;
+    return 0;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that opens a cursor on the first row of a segment
+ * @param cursor cursor to open
+ * @param segment table or temporary segment name
+ * @param num_attr number of attributes of a row
+ * @return EXIT_SUCCESS or EXIT_ERROR if the segment does not exist
+ */
+int AK_segment_cursor_open(AK_segment_cursor *cursor, char *segment, int num_attr) {
+    AK_PRO;
+    cursor->addresses = (table_addresses *) AK_get_table_addresses(segment);
+    cursor->num_attr = num_attr;
+    cursor->extent = 0;
+    cursor->block = cursor->addresses->address_from[0];
+    cursor->tuple = 0;
+    if (cursor->block == 0 || num_attr <= 0) {
+        AK_free(cursor->addresses);
+        cursor->addresses = NULL;
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads the next row of the segment. Deleted rows are skipped. Values are copied
+ *        into the arena if one is given (so they outlive the cursor), otherwise into the cursor buffer
+ *        where they stay valid until the next call.
+ * @param cursor open cursor
+ * @param row row to fill
+ * @param arena arena that receives the values or NULL
+ * @return 1 if a row was read, 0 at the end of the segment
+ */
+int AK_segment_cursor_next(AK_segment_cursor *cursor, AK_sort_row *row, AK_arena *arena) {
+    AK_mem_block *mem_block;
+    AK_tuple_dict *tuple;
+    int l, size;
+    AK_PRO;
+    if (cursor->addresses == NULL) {
+        AK_EPI;
+        return 0;
+    }
+    while (cursor->addresses->address_from[cursor->extent] != 0) {
+        if (cursor->block >= cursor->addresses->address_to[cursor->extent]) {
+            cursor->extent++;
+            cursor->block = cursor->addresses->address_from[cursor->extent];
+            cursor->tuple = 0;
+            continue;
+        }
+        mem_block = (AK_mem_block *) AK_get_block(cursor->block);
+        while (cursor->tuple + cursor->num_attr <= DATA_BLOCK_SIZE && mem_block->block->last_tuple_dict_id != 0) {
+            tuple = &mem_block->block->tuple_dict[cursor->tuple];
+            if (tuple->type == FREE_INT)
+                break;
+            cursor->tuple += cursor->num_attr;
+            if (tuple->type == 0 && tuple->size == 0)
+                continue;
+            for (l = 0; l < cursor->num_attr; l++) {
+                size = tuple[l].size > MAX_VARCHAR_LENGTH ? MAX_VARCHAR_LENGTH : tuple[l].size;
+                row->type[l] = tuple[l].type;
+                row->size[l] = size;
+                row->null[l] = AK_IS_NULL(mem_block->block, cursor->tuple - cursor->num_attr + l);
+                row->data[l] = arena != NULL ? (unsigned char *) AK_arena_alloc(arena, size + 1) : cursor->buffer[l];
+                memcpy(row->data[l], mem_block->block->data + tuple[l].address, size);
+                row->data[l][size] = '\0';
+            }
+            AK_EPI;
+            return 1;
+        }
+        cursor->block++;
+        cursor->tuple = 0;
+    }
+    AK_EPI;
+    return 0;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that closes a segment cursor
+ * @param cursor cursor to close
+ * @return No return value
+ */
+void AK_segment_cursor_close(AK_segment_cursor *cursor) {
+    AK_PRO;
+    if (cursor->addresses != NULL)
+        AK_free(cursor->addresses);
+    cursor->addresses = NULL;
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that prepares appending rows to a freshly initialized segment
+ * @param writer writer to open
+ * @param segment segment name
+ * @param segment_type SEGMENT_TYPE_TABLE or SEGMENT_TYPE_TEMP, used when a new extent is needed
+ * @param num_attr number of attributes of a row
+ * @return EXIT_SUCCESS or EXIT_ERROR if the segment does not exist
+ */
+int AK_segment_writer_open(AK_segment_writer *writer, char *segment, int segment_type, int num_attr) {
+    AK_PRO;
+    memset(writer->segment, '\0', MAX_ATT_NAME);
+    strncpy(writer->segment, segment, MAX_ATT_NAME - 1);
+    writer->segment_type = segment_type;
+    writer->num_attr = num_attr;
+    writer->addresses = (table_addresses *) AK_get_table_addresses(segment);
+    writer->extent = 0;
+    writer->block = writer->addresses->address_from[0];
+    if (writer->block == 0) {
+        AK_free(writer->addresses);
+        writer->addresses = NULL;
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that appends a row to the segment. The row is written into the current block while it
+ *        passes the same free space limits AK_insert_row uses, then the writer moves on to the next block
+ *        and, after the last one, to a new extent. Unlike AK_insert_row there is no redo log entry and no
+ *        constraint check, so it is meant for segments the caller has just created. The row count
+ *        of the segment is kept up to date.
+ * @param writer open writer
+ * @param row row to append
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_segment_writer_put(AK_segment_writer *writer, AK_sort_row *row) {
+    AK_mem_block *mem_block;
+    AK_block *block;
+    int l, id, code, need = 0;
+    AK_PRO;
+    if (writer->addresses == NULL) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (l = 0; l < writer->num_attr; l++)
+        need += row->size[l];
+
+    while (1) {
+        if (writer->block >= writer->addresses->address_to[writer->extent]) {
+            if (writer->addresses->address_from[writer->extent + 1] == 0) {
+                if (AK_init_new_extent(writer->segment, writer->segment_type) == EXIT_ERROR) {
+                    AK_EPI;
+                    return EXIT_ERROR;
+                }
+                AK_free(writer->addresses);
+                writer->addresses = (table_addresses *) AK_get_table_addresses(writer->segment);
+                if (writer->addresses->address_from[writer->extent + 1] == 0) {
+                    AK_EPI;
+                    return EXIT_ERROR;
+                }
+            }
+            writer->extent++;
+            writer->block = writer->addresses->address_from[writer->extent];
+        }
+        mem_block = (AK_mem_block *) AK_get_block(writer->block);
+        block = mem_block->block;
+        id = block->tuple_dict[0].size == FREE_INT ? 0 : block->last_tuple_dict_id + 1;
+        while (id < DATA_BLOCK_SIZE && block->tuple_dict[id].size != FREE_INT)
+            id++;
+        if (block->AK_free_space < MAX_FREE_SPACE_SIZE && id < MAX_LAST_TUPLE_DICT_SIZE_TO_USE
+                && id + writer->num_attr <= DATA_BLOCK_SIZE
+                && block->AK_free_space + need <= DATA_BLOCK_SIZE * DATA_ENTRY_SIZE)
+            break;
+        writer->block++;
+    }
+
+    for (l = 0; l < writer->num_attr; l++) {
+        code = row->null[l] ? -1 : AK_encoding_find(block, l, row->data[l], row->size[l]);
+        if (code >= 0) {
+            block->tuple_dict[id + l].address = code;
+        } else {
+            code = AK_pax_alloc(block, l, row->size[l]);
+            memcpy(block->data + code, row->data[l], row->size[l]);
+            block->tuple_dict[id + l].address = code;
+        }
+        block->tuple_dict[id + l].type = row->type[l];
+        block->tuple_dict[id + l].size = row->size[l];
+        if (row->null[l])
+            AK_SET_NULL(block, id + l);
+        else
+            AK_CLEAR_NULL(block, id + l);
+    }
+    block->last_tuple_dict_id = id + writer->num_attr - 1;
+    AK_zone_map_add_row(block, id, writer->num_attr);
+    AK_bloom_add_row(block, id, writer->num_attr);
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+
+    mem_block = (AK_mem_block *) AK_get_block(writer->addresses->address_from[0]);
+    if (mem_block->block->num_records != FREE_INT) {
+        mem_block->block->num_records++;
+        AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+    }
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that closes a segment writer
+ * @param writer writer to close
+ * @return No return value
+ */
+void AK_segment_writer_close(AK_segment_writer *writer) {
+    AK_PRO;
+    if (writer->addresses != NULL)
+        AK_free(writer->addresses);
+    writer->addresses = NULL;
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that sorts an array of rows with a stable bottom-up merge sort
+ * @param rows rows to sort
+ * @param tmp scratch array of the same length
+ * @param n number of rows
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return No return value
+ */
+static void AK_sort_rows(AK_sort_row **rows, AK_sort_row **tmp, int n, AK_sort_key *keys, int num_keys) {
+    int width, lo, mid, hi, i, j, k;
+    AK_sort_row **src = rows, **dst = tmp, **swap;
+    AK_PRO;
+    for (width = 1; width < n; width *= 2) {
+        for (lo = 0; lo < n; lo += 2 * width) {
+            mid = lo + width < n ? lo + width : n;
+            hi = lo + 2 * width < n ? lo + 2 * width : n;
+            i = lo; j = mid; k = lo;
+            while (i < mid && j < hi)
+                dst[k++] = AK_sort_compare_rows(src[j], src[i], keys, num_keys) < 0 ? src[j++] : src[i++];
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+        swap = src; src = dst; dst = swap;
+    }
+    if (src != rows)
+        memcpy(rows, src, n * sizeof (AK_sort_row *));
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that writes sorted rows into a new segment
+ * @param name segment name
+ * @param type segment type
+ * @param header table header
+ * @param rows sorted rows
+ * @param n number of rows
+ * @param num_attr number of attributes of a row
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+static int AK_sort_write_rows(char *name, int type, AK_header *header, AK_sort_row **rows, int n, int num_attr) {
+    AK_segment_writer writer;
+    int i, result = EXIT_SUCCESS;
+    AK_PRO;
+    if (AK_initialize_new_segment(name, type, header) == EXIT_ERROR
+            || AK_segment_writer_open(&writer, name, type, num_attr) == EXIT_ERROR) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (i = 0; i < n && result == EXIT_SUCCESS; i++)
+        result = AK_segment_writer_put(&writer, rows[i]);
+    AK_segment_writer_close(&writer);
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that restores the heap property of the merge heap below position i
+ * @param heap cursor indexes ordered by their current row
+ * @param n heap size
+ * @param i position to sift down
+ * @param cursors run cursors
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return No return value
+ */
+static void AK_sort_heap_down(int *heap, int n, int i, AK_segment_cursor *cursors, AK_sort_key *keys, int num_keys) {
+    int child, tmp, cmp;
+    AK_PRO;
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n) {
+            cmp = AK_sort_compare_rows(&cursors[heap[child + 1]].row, &cursors[heap[child]].row, keys, num_keys);
+            if (cmp < 0 || (cmp == 0 && heap[child + 1] < heap[child]))
+                child++;
+        }
+        cmp = AK_sort_compare_rows(&cursors[heap[child]].row, &cursors[heap[i]].row, keys, num_keys);
+        if (cmp > 0 || (cmp == 0 && heap[child] > heap[i]))
+            break;
+        tmp = heap[i]; heap[i] = heap[child]; heap[child] = tmp;
+        i = child;
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that merges sorted runs into one segment with a k-way heap merge. Ties are resolved
+ *        by run order, which keeps the sort stable.
+ * @param runs run segment names
+ * @param count number of runs
+ * @param output name of the output segment
+ * @param output_type segment type of the output
+ * @param header table header
+ * @param num_attr number of attributes of a row
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+static int AK_sort_merge_runs(char (*runs)[MAX_ATT_NAME], int count, char *output, int output_type, AK_header *header,
+        int num_attr, AK_sort_key *keys, int num_keys) {
+    AK_segment_cursor *cursors = (AK_segment_cursor *) AK_malloc(count * sizeof (AK_segment_cursor));
+    int *heap = (int *) AK_malloc(count * sizeof (int));
+    AK_segment_writer writer;
+    int i, n = 0, result = EXIT_SUCCESS;
+    AK_PRO;
+
+    if (AK_initialize_new_segment(output, output_type, header) == EXIT_ERROR
+            || AK_segment_writer_open(&writer, output, output_type, num_attr) == EXIT_ERROR) {
+        AK_free(cursors);
+        AK_free(heap);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (i = 0; i < count; i++) {
+        AK_segment_cursor_open(&cursors[i], runs[i], num_attr);
+        if (AK_segment_cursor_next(&cursors[i], &cursors[i].row, NULL))
+            heap[n++] = i;
+    }
+    for (i = n / 2 - 1; i >= 0; i--)
+        AK_sort_heap_down(heap, n, i, cursors, keys, num_keys);
+
+    while (n > 0 && result == EXIT_SUCCESS) {
+        result = AK_segment_writer_put(&writer, &cursors[heap[0]].row);
+        if (!AK_segment_cursor_next(&cursors[heap[0]], &cursors[heap[0]].row, NULL))
+            heap[0] = heap[--n];
+        AK_sort_heap_down(heap, n, 0, cursors, keys, num_keys);
+    }
+
+    for (i = 0; i < count; i++)
+        AK_segment_cursor_close(&cursors[i]);
+    AK_segment_writer_close(&writer);
+    AK_free(cursors);
+    AK_free(heap);
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that sorts a table with an external merge sort. Rows are collected in an arena until
+ *        memory_budget bytes are used, sorted in memory and spilled to a temporary segment (a run).
+ *        Runs are merged SORT_MERGE_FANIN at a time until the last pass writes the destination table.
+ *        When the whole table fits into the budget nothing is spilled.
+ * @param srcTable table to sort
+ * @param destTable table that receives the sorted rows
+ * @param attributes ordering list (see AK_sort_parse_keys)
+ * @param memory_budget number of bytes a run may occupy
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_external_sort(char *srcTable, char *destTable, struct list_node *attributes, int memory_budget) {
+    AK_sort_key keys[MAX_ATTRIBUTES];
+    AK_header header[MAX_ATTRIBUTES];
+    AK_header *table_header;
+    AK_segment_cursor *cursor;
+    AK_arena arena;
+    AK_sort_row **rows = NULL, **tmp = NULL, *row;
+    char (*runs)[MAX_ATT_NAME] = NULL;
+    int num_attr, num_keys, capacity = 0, n = 0, num_runs = 0, runs_capacity = 0, next_run = 0;
+    int i, group, merged, result = EXIT_SUCCESS;
+    AK_PRO;
+
+    num_attr = AK_num_attr(srcTable);
+    table_header = AK_get_header(srcTable);
+    if (num_attr <= 0 || table_header == NULL) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    memset(header, 0, sizeof (header));
+    memcpy(header, table_header, num_attr * sizeof (AK_header));
+    AK_free(table_header);
+
+    num_keys = AK_sort_parse_keys(header, num_attr, attributes, keys);
+    if (num_keys <= 0) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+
+    cursor = (AK_segment_cursor *) AK_malloc(sizeof (AK_segment_cursor));
+    AK_segment_cursor_open(cursor, srcTable, num_attr);
+    AK_arena_init(&arena, 0);
+
+    while (result == EXIT_SUCCESS) {
+        row = (AK_sort_row *) AK_arena_alloc(&arena, sizeof (AK_sort_row));
+        int more = AK_segment_cursor_next(cursor, row, &arena);
+        if (more) {
+            if (n == capacity) {
+                capacity = capacity ? capacity * 2 : 256;
+                rows = (AK_sort_row **) AK_realloc(rows, capacity * sizeof (AK_sort_row *));
+                tmp = (AK_sort_row **) AK_realloc(tmp, capacity * sizeof (AK_sort_row *));
+            }
+            rows[n++] = row;
+        }
+        if (more && arena.allocated + 2 * n * sizeof (AK_sort_row *) < (size_t) memory_budget)
+            continue;
+        if (!more && num_runs == 0) {
+            /* everything fit into memory, no runs needed */
+            AK_sort_rows(rows, tmp, n, keys, num_keys);
+            result = AK_sort_write_rows(destTable, SEGMENT_TYPE_TABLE, header, rows, n, num_attr);
+            break;
+        }
+        if (n > 0) {
+            if (num_runs == runs_capacity) {
+                runs_capacity = runs_capacity ? runs_capacity * 2 : SORT_MERGE_FANIN;
+                runs = AK_realloc(runs, runs_capacity * MAX_ATT_NAME);
+            }
+            snprintf(runs[num_runs], MAX_ATT_NAME, "%s__run%d", destTable, next_run++);
+            AK_sort_rows(rows, tmp, n, keys, num_keys);
+            result = AK_sort_write_rows(runs[num_runs], SEGMENT_TYPE_TEMP, header, rows, n, num_attr);
+            AK_dbg_messg(MIDDLE, FILE_MAN, "AK_external_sort: run %s with %d rows\n", runs[num_runs], n);
+            num_runs++;
+            n = 0;
+            AK_arena_reset(&arena);
+        }
+        if (!more)
+            break;
+    }
+    AK_segment_cursor_close(cursor);
+    AK_free(cursor);
+    AK_arena_destroy(&arena);
+    AK_free(rows);
+    AK_free(tmp);
+
+    /* merge passes, the last one writes the destination table */
+    while (result == EXIT_SUCCESS && num_runs > 0) {
+        if (num_runs <= SORT_MERGE_FANIN) {
+            result = AK_sort_merge_runs(runs, num_runs, destTable, SEGMENT_TYPE_TABLE, header, num_attr, keys, num_keys);
+            for (i = 0; i < num_runs; i++)
+                AK_delete_segment(runs[i], SEGMENT_TYPE_TEMP);
+            num_runs = 0;
+            break;
+        }
+        merged = 0;
+        for (group = 0; group < num_runs && result == EXIT_SUCCESS; group += SORT_MERGE_FANIN) {
+            int count = num_runs - group < SORT_MERGE_FANIN ? num_runs - group : SORT_MERGE_FANIN;
+            char output[MAX_ATT_NAME];
+            snprintf(output, MAX_ATT_NAME, "%s__run%d", destTable, next_run++);
+            result = AK_sort_merge_runs(runs + group, count, output, SEGMENT_TYPE_TEMP, header, num_attr, keys, num_keys);
+            for (i = group; i < group + count; i++)
+                AK_delete_segment(runs[i], SEGMENT_TYPE_TEMP);
+            memcpy(runs[merged++], output, MAX_ATT_NAME);
+        }
+        num_runs = merged;
+    }
+    for (i = 0; i < num_runs; i++)
+        AK_delete_segment(runs[i], SEGMENT_TYPE_TEMP);
+    AK_free(runs);
+    AK_EPI;
+    return result;
+}
+
 /**
  * @author Tomislav Bobinac, updated by Filip Žmuk
- * @todo Make it to suport multiple sort atributes and ASC|DESC ordering
- * @brief Function that sorts a segment
- * @return No return value.
+ * @brief Function that sorts a segment. Ordering is a list of TYPE_ATTRIBS nodes, each one optionally
+ *        followed by a TYPE_OPERATOR node "ASC" or "DESC". Sorting is done by AK_external_sort
+ *        with SORT_MEMORY_BUDGET bytes of memory.
+ * @param srcTable table to sort
+ * @param destTable table that receives the sorted rows
+ * @param attributes ordering list
+ * @return EXIT_SUCCESS or EXIT_ERROR
  */
 int AK_sort_segment(char *srcTable, char *destTable, struct list_node* attributes) {
-	//initialize variables
-	register int i, j;
-	int blocks_addr[MAX_NUM_OF_BLOCKS];	//array with block addresses
-	int num_blocks = 0;	//number of blocks in segment
-
+	int result;
 	AK_PRO;
+	result = AK_external_sort(srcTable, destTable, attributes, SORT_MEMORY_BUDGET);
+	AK_EPI;
+	return result;
+}
 
-	//Get number of blocks for given table
-	table_addresses *addresses = (table_addresses *) AK_get_table_addresses(srcTable);
-	for (i = 0; addresses->address_from[i] != 0; i++) {
-		for (j = addresses->address_from[i]; j <= addresses->address_to[i]; j++) {
-			blocks_addr[num_blocks] = j;
-			num_blocks++;
-		}
-	}
+/**
+ * @struct AK_top_n_entry
+ * @brief Row kept by the Top-N operator together with its position in the input
+ */
+typedef struct {
+    AK_sort_row row;
+    int capacity[MAX_ATTRIBUTES];
+    int seq;
+} AK_top_n_entry;
 
-	AK_header *head = AK_get_header(srcTable);
-	AK_initialize_new_segment(destTable, SEGMENT_TYPE_TABLE, head);
+/**
+ * @author Unknown
+ * @brief Function that compares two Top-N entries, equal rows are ordered by their input position
+ * @param a first entry
+ * @param b second entry
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return negative, zero or positive number if a comes before, together with or after b
+ */
+static int AK_top_n_compare(AK_top_n_entry *a, AK_top_n_entry *b, AK_sort_key *keys, int num_keys) {
+    int result;
+    AK_PRO;
+    result = AK_sort_compare_rows(&a->row, &b->row, keys, num_keys);
+    if (result == 0)
+        result = a->seq < b->seq ? -1 : a->seq > b->seq;
+    AK_EPI;
+    return result;
+}
 
-	//SORTING ...
-	char x[DATA_ROW_SIZE]; 		//needed data
-	char y[DATA_ROW_SIZE]; 		//data needed for comparison
-	char data[DATA_TUPLE_SIZE]; //data to be copied
+/**
+ * @author Unknown
+ * @brief Function that restores the max-heap property of the Top-N heap below position i, so the
+ *        row that would be output last is always on top
+ * @param heap entries
+ * @param n heap size
+ * @param i position to sift down
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return No return value
+ */
+static void AK_top_n_heap_down(AK_top_n_entry **heap, int n, int i, AK_sort_key *keys, int num_keys) {
+    int child;
+    AK_top_n_entry *tmp;
+    AK_PRO;
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n && AK_top_n_compare(heap[child + 1], heap[child], keys, num_keys) > 0)
+            child++;
+        if (AK_top_n_compare(heap[child], heap[i], keys, num_keys) <= 0)
+            break;
+        tmp = heap[i]; heap[i] = heap[child]; heap[child] = tmp;
+        i = child;
+    }
+    AK_EPI;
+}
 
-	AK_mem_block * real_table = (AK_mem_block*) AK_get_block(blocks_addr[0]);
+/**
+ * @author Unknown
+ * @brief Function that restores the max-heap property of the Top-N heap above position i
+ * @param heap entries
+ * @param i position to sift up
+ * @param keys sort keys
+ * @param num_keys number of sort keys
+ * @return No return value
+ */
+static void AK_top_n_heap_up(AK_top_n_entry **heap, int i, AK_sort_key *keys, int num_keys) {
+    int parent;
+    AK_top_n_entry *tmp;
+    AK_PRO;
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (AK_top_n_compare(heap[i], heap[parent], keys, num_keys) <= 0)
+            break;
+        tmp = heap[i]; heap[i] = heap[parent]; heap[parent] = tmp;
+        i = parent;
+    }
+    AK_EPI;
+}
 
-	//get total number of headers and the number of header used to sort segment
-	int num_headers = AK_get_total_headers(real_table->block);
-	int num_sort_header = AK_get_header_number(real_table->block, AK_First_L2(attributes)->data);
-	int num_records = AK_get_num_records(srcTable);
+/**
+ * @author Unknown
+ * @brief Function that copies a row read by a cursor into a Top-N entry, reusing the entry buffers
+ * @param entry entry that receives the row
+ * @param row row to copy
+ * @param num_attr number of attributes of a row
+ * @param seq position of the row in the input
+ * @return No return value
+ */
+static void AK_top_n_store(AK_top_n_entry *entry, AK_sort_row *row, int num_attr, int seq) {
+    int i;
+    AK_PRO;
+    for (i = 0; i < num_attr; i++) {
+        if (entry->capacity[i] < row->size[i]) {
+            entry->row.data[i] = AK_realloc(entry->row.data[i], row->size[i]);
+            entry->capacity[i] = row->size[i];
+        }
+        memcpy(entry->row.data[i], row->data[i], row->size[i]);
+        entry->row.type[i] = row->type[i];
+        entry->row.size[i] = row->size[i];
+        entry->row.null[i] = row->null[i];
+    }
+    entry->seq = seq;
+    AK_EPI;
+}
 
-	int type, temp, address, size, temp_field[num_records];
-	for (i = 0; i<num_records; i++) {
-		temp_field[i]=i;
-	}
+/**
+ * @author Unknown
+ * @brief Function that writes the first limit rows of a table in the given order into a new table.
+ *        Rows are fed from a scan into a bounded max-heap of limit entries, so the operator needs
+ *        O(n log limit) time, memory for limit rows only and no temporary segments. Equal rows keep
+ *        their input order. Without an ordering the first limit rows are copied and the scan stops early.
+ * @param srcTable table to read
+ * @param destTable table that receives at most limit rows
+ * @param attributes ordering list (see AK_sort_parse_keys), may be NULL
+ * @param limit maximum number of rows in destTable
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_top_n(char *srcTable, char *destTable, struct list_node *attributes, int limit) {
+    AK_sort_key keys[MAX_ATTRIBUTES];
+    AK_header header[MAX_ATTRIBUTES];
+    AK_header *table_header;
+    AK_segment_cursor *cursor;
+    AK_top_n_entry *entries, **heap;
+    AK_sort_row **rows;
+    int num_attr, num_keys = 0, n = 0, seq = 0, i, j, result;
+    AK_PRO;
 
-	for (i = 0; i < num_records - 1; i++) {
-		for (j = i + 1; j < num_records; j++) {
-			//first data -> x
-			address = real_table->block->tuple_dict[(temp_field[i] * num_headers) + num_sort_header].address;
-			size = real_table->block->tuple_dict[(temp_field[i] * num_headers) + num_sort_header].size;
-			memset(x, '\0', MAX_VARCHAR_LENGTH);
-			memcpy(x, real_table->block->data + address, size);
-			//second data -> y
-			address = real_table->block->tuple_dict[(temp_field[j] * num_headers) + num_sort_header].address;
-			size = real_table->block->tuple_dict[(temp_field[j] * num_headers) + num_sort_header].size;
-			memset(y, '\0', MAX_VARCHAR_LENGTH);
-			memcpy(y, real_table->block->data + address, size);
-
-			//comparison (x > y) ASC
-			if (strcmp(x, y) >= 0) {
-				temp=temp_field[i];
-				temp_field[i]=temp_field[j];
-				temp_field[j]=temp;
-			}//end: if(strcmp(x,y) >= 0)
-		}
-	}
+    num_attr = AK_num_attr(srcTable);
+    table_header = AK_get_header(srcTable);
+    if (num_attr <= 0 || table_header == NULL || limit < 0) {
+        AK_free(table_header);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    memset(header, 0, sizeof (header));
+    memcpy(header, table_header, num_attr * sizeof (AK_header));
+    AK_free(table_header);
 
-	for (i = 0; i<num_records; i++) {
-		//initialize a new row
-		struct list_node *row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
-		AK_Init_L3(&row_root);
-		for (j = 0; j < num_headers; j++) {
-			//get data from column 'j' orginal table -> data
-			address = real_table->block->tuple_dict[j + (temp_field[i] * num_headers)].address;
-			size = real_table->block->tuple_dict[j + (temp_field[i] * num_headers)].size;
-			type = real_table->block->tuple_dict[j + (temp_field[i] * num_headers)].type;
-			memset(data, '\0', MAX_VARCHAR_LENGTH);
-			memcpy(data, real_table->block->data + address, size);
-			//add column 'j' data into struct row_root
-			AK_Insert_New_Element(type, data, destTable, real_table->block->header[j].att_name, row_root);
-		}
-		//add row to new sorted table
-		AK_insert_row(row_root);
-		AK_DeleteAll_L3(&row_root);
-	}
+    if (attributes != NULL && (num_keys = AK_sort_parse_keys(header, num_attr, attributes, keys)) < 0) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
 
-	AK_EPI;
-	return EXIT_SUCCESS;
+    entries = (AK_top_n_entry *) AK_calloc(limit + 1, sizeof (AK_top_n_entry));
+    heap = (AK_top_n_entry **) AK_malloc((limit + 1) * sizeof (AK_top_n_entry *));
+    cursor = (AK_segment_cursor *) AK_malloc(sizeof (AK_segment_cursor));
+    AK_segment_cursor_open(cursor, srcTable, num_attr);
+
+    while (limit > 0 && AK_segment_cursor_next(cursor, &cursor->row, NULL)) {
+        if (n < limit) {
+            heap[n] = &entries[n];
+            AK_top_n_store(heap[n], &cursor->row, num_attr, seq++);
+            AK_top_n_heap_up(heap, n++, keys, num_keys);
+            if (num_keys == 0 && n == limit)
+                break;
+            continue;
+        }
+        /* the row replaces the heap top only if it comes before it, later rows lose ties */
+        if (AK_sort_compare_rows(&cursor->row, &heap[0]->row, keys, num_keys) < 0) {
+            AK_top_n_store(heap[0], &cursor->row, num_attr, seq);
+            AK_top_n_heap_down(heap, n, 0, keys, num_keys);
+        }
+        seq++;
+    }
+    AK_segment_cursor_close(cursor);
+    AK_free(cursor);
+
+    /* pop the heap from the back to get the rows in output order */
+    rows = (AK_sort_row **) AK_malloc((n + 1) * sizeof (AK_sort_row *));
+    for (i = n - 1; i >= 0; i--) {
+        rows[i] = &heap[0]->row;
+        heap[0] = heap[i];
+        AK_top_n_heap_down(heap, i, 0, keys, num_keys);
+    }
+    result = AK_sort_write_rows(destTable, SEGMENT_TYPE_TABLE, header, rows, n, num_attr);
+    AK_dbg_messg(MIDDLE, FILE_MAN, "AK_top_n: %d of %d rows written to %s\n", n, seq, destTable);
+
+    for (i = 0; i <= limit; i++) {
+        for (j = 0; j < num_attr; j++)
+            AK_free(entries[i].row.data[j]);
+    }
+    AK_free(rows);
+    AK_free(heap);
+    AK_free(entries);
+    AK_EPI;
+    return result;
 }
 
 /**
@@ -343,7 +1004,9 @@ void AK_block_sort(AK_block * iBlock, char* attribute_name) {
                 AK_dbg_messg(HIGH, FILE_MAN, "slogovi: %s , %s   , head: %i \n", x, y, num_sort_header);
 
                 //comparison
-                if (strcmp(x, y) <= 0) {
+                if (AK_compare_values(cTemp1->tuple_dict[br1 * max_header_num + num_sort_header].type, (unsigned char *) x,
+                        cTemp1->tuple_dict[br1 * max_header_num + num_sort_header].size, (unsigned char *) y,
+                        cTemp2->tuple_dict[br2 * max_header_num + num_sort_header].size) <= 0) {
                     AK_dbg_messg(HIGH, FILE_MAN, "manji je: %s\n", x);
 
                     //insert data
@@ -485,25 +1148,111 @@ void AK_block_sort(AK_block * iBlock, char* attribute_name) {
 }
 
 //extern int address_of_tempBlock = 0;
+/**
+ * @author Unknown
+ * @brief Function that checks that the first rows of two tables are equal, used by AK_filesort_test
+ * @param first first table
+ * @param second second table
+ * @param rows number of rows to compare
+ * @return 1 if the first rows rows of both tables are equal, otherwise 0
+ */
+static int AK_filesort_check_prefix(char *first, char *second, int rows) {
+    AK_segment_cursor *a = (AK_segment_cursor *) AK_malloc(sizeof (AK_segment_cursor));
+    AK_segment_cursor *b = (AK_segment_cursor *) AK_malloc(sizeof (AK_segment_cursor));
+    int num_attr = AK_num_attr(first);
+    int equal = num_attr == AK_num_attr(second), i, l;
+    AK_PRO;
+
+    AK_segment_cursor_open(a, first, num_attr);
+    AK_segment_cursor_open(b, second, num_attr);
+    for (i = 0; i < rows && equal; i++) {
+        if (!AK_segment_cursor_next(a, &a->row, NULL) || !AK_segment_cursor_next(b, &b->row, NULL)) {
+            equal = 0;
+            break;
+        }
+        for (l = 0; l < num_attr; l++) {
+            if (a->row.type[l] != b->row.type[l] || a->row.size[l] != b->row.size[l] || a->row.null[l] != b->row.null[l]
+                    || memcmp(a->row.data[l], b->row.data[l], a->row.size[l]) != 0)
+                equal = 0;
+        }
+    }
+    AK_segment_cursor_close(a);
+    AK_segment_cursor_close(b);
+    AK_free(a);
+    AK_free(b);
+    AK_EPI;
+    return equal;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that checks that a table is ordered by the given keys and holds the expected number of rows
+ * @param table table to check
+ * @param ordering ordering list
+ * @param expected_rows expected number of rows
+ * @return 1 if the table is sorted, 0 otherwise
+ */
+static int AK_filesort_check_sorted(char *table, struct list_node *ordering, int expected_rows) {
+    AK_sort_key keys[MAX_ATTRIBUTES];
+    AK_sort_row previous;
+    unsigned char buffer[MAX_ATTRIBUTES][MAX_VARCHAR_LENGTH + 1];
+    AK_segment_cursor *cursor = (AK_segment_cursor *) AK_malloc(sizeof (AK_segment_cursor));
+    int num_attr = AK_num_attr(table);
+    AK_header *header = AK_get_header(table);
+    int num_keys = AK_sort_parse_keys(header, num_attr, ordering, keys);
+    int rows = 0, sorted = 1, l;
+    AK_PRO;
+
+    AK_segment_cursor_open(cursor, table, num_attr);
+    while (AK_segment_cursor_next(cursor, &cursor->row, NULL)) {
+        if (rows > 0 && AK_sort_compare_rows(&previous, &cursor->row, keys, num_keys) > 0)
+            sorted = 0;
+        for (l = 0; l < num_attr; l++) {
+            previous.type[l] = cursor->row.type[l];
+            previous.size[l] = cursor->row.size[l];
+            previous.null[l] = cursor->row.null[l];
+            previous.data[l] = buffer[l];
+            memcpy(buffer[l], cursor->row.data[l], cursor->row.size[l] + 1);
+        }
+        rows++;
+    }
+    AK_segment_cursor_close(cursor);
+    AK_free(cursor);
+    AK_free(header);
+    AK_EPI;
+    return sorted && num_keys > 0 && rows == expected_rows;
+}
+
 /*
  * @author Unknown, updated Tomislav Bobinac, Filip Žmuk
  * @brief Function that sorts files
  * @return No return value
  */
+static int filesort_test_run_count = 1;
+
 TestResult AK_filesort_test() {
 	AK_PRO;
 	printf("filesort_test: Present!\n");
     int success=0;
     int failed=0;
 	char *srcTable="student";
-	char *destTable="student_sorted";
+	char destTable[MAX_ATT_NAME];
+	char extTable[MAX_ATT_NAME];
+	char topTable[MAX_ATT_NAME];
+	int num_rows = AK_get_num_records(srcTable);
+
+	sprintf(destTable, "student_sorted_%d", filesort_test_run_count);
+	sprintf(extTable, "student_sorted_ext_%d", filesort_test_run_count);
+	sprintf(topTable, "student_top_%d", filesort_test_run_count);
+	filesort_test_run_count++;
 
 	AK_print_table(srcTable);
 
     struct list_node* attributes = (struct list_node*) AK_malloc(sizeof(struct list_node));
+    AK_Init_L3(&attributes);
     AK_InsertAtBegin_L3(TYPE_ATTRIBS, "firstname", sizeof("firstname"), attributes); 
 
-	if (AK_sort_segment(srcTable, destTable,  attributes) == EXIT_SUCCESS)
+	if (AK_sort_segment(srcTable, destTable,  attributes) == EXIT_SUCCESS && AK_filesort_check_sorted(destTable, attributes, num_rows))
     {
         AK_print_table(destTable);
         success++;
@@ -512,6 +1261,39 @@ TestResult AK_filesort_test() {
     {
         failed++;
     }    
+    AK_DeleteAll_L3(&attributes);
+
+    /* ORDER BY year DESC, weight with a budget so small that every row becomes a run, which also forces more than one merge pass */
+    printf("filesort_test: ORDER BY year DESC, weight with external runs\n");
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "year", sizeof("year"), attributes);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "DESC", sizeof("DESC"), attributes);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "weight", sizeof("weight"), attributes);
+	if (AK_external_sort(srcTable, extTable, attributes, 256) == EXIT_SUCCESS
+            && AK_filesort_check_sorted(extTable, attributes, num_rows))
+    {
+        AK_print_table(extTable);
+        success++;
+    }
+    else
+    {
+        failed++;
+    }
+
+    /* the same ordering with LIMIT 5 has to give the first five rows of the full sort */
+    printf("filesort_test: ORDER BY year DESC, weight LIMIT 5 with the Top-N heap\n");
+	if (AK_top_n(srcTable, topTable, attributes, 5) == EXIT_SUCCESS
+            && AK_filesort_check_sorted(topTable, attributes, num_rows < 5 ? num_rows : 5)
+            && AK_filesort_check_prefix(topTable, extTable, num_rows < 5 ? num_rows : 5))
+    {
+        AK_print_table(topTable);
+        success++;
+    }
+    else
+    {
+        failed++;
+    }
+    AK_DeleteAll_L3(&attributes);
+    AK_free(attributes);
 
 	AK_EPI;
     return TEST_result(success,failed);
@@ -26,6 +26,7 @@
 #include "files.h"
 #include "fileio.h"
 #include "../auxi/mempro.h"
+#include "../auxi/comparator.h"
 /**
   * @def DATA_ROW_SIZE
   * @brief Constatnt declaring size of data to be compared
@@ -39,6 +40,60 @@
 
 #define DATA_TUPLE_SIZE 500
 
+/**
+  * @def SORT_MERGE_FANIN
+  * @brief Maximum number of runs merged in one pass of the external sort
+  */
+#define SORT_MERGE_FANIN 16
+
+/**
+ * @struct AK_sort_key
+ * @brief One ORDER BY key: index of the attribute in the table header, its type and direction
+ */
+typedef struct {
+    int attribute;
+    int type;
+    int descending;
+} AK_sort_key;
+
+/**
+ * @struct AK_sort_row
+ * @brief Row as seen by the sort operator. Values point to memory owned by the sort (arena or cursor buffer).
+ */
+typedef struct {
+    int type[MAX_ATTRIBUTES];
+    int size[MAX_ATTRIBUTES];
+    int null[MAX_ATTRIBUTES];
+    unsigned char *data[MAX_ATTRIBUTES];
+} AK_sort_row;
+
+/**
+ * @struct AK_segment_cursor
+ * @brief Sequential reader over all rows of a table or temporary segment
+ */
+typedef struct {
+    table_addresses *addresses;
+    int num_attr;
+    int extent;
+    int block;
+    int tuple;
+    AK_sort_row row;
+    unsigned char buffer[MAX_ATTRIBUTES][MAX_VARCHAR_LENGTH + 1];
+} AK_segment_cursor;
+
+/**
+ * @struct AK_segment_writer
+ * @brief Appends rows straight into the blocks of a segment, allocating new extents when needed
+ */
+typedef struct {
+    char segment[MAX_ATT_NAME];
+    int segment_type;
+    int num_attr;
+    table_addresses *addresses;
+    int extent;
+    int block;
+} AK_segment_writer;
+
 
 /**
  * @author Unknown
@@ -61,11 +116,22 @@ int AK_get_header_number(AK_block *iBlock, char *attribute_name);
  */
 int AK_get_num_of_tuples(AK_block *iBlock);
 
+int AK_sort_parse_keys(AK_header *header, int num_attr, struct list_node *ordering, AK_sort_key *keys);
+int AK_sort_compare_rows(AK_sort_row *a, AK_sort_row *b, AK_sort_key *keys, int num_keys);
+int AK_segment_cursor_open(AK_segment_cursor *cursor, char *segment, int num_attr);
+int AK_segment_cursor_next(AK_segment_cursor *cursor, AK_sort_row *row, AK_arena *arena);
+void AK_segment_cursor_close(AK_segment_cursor *cursor);
+int AK_segment_writer_open(AK_segment_writer *writer, char *segment, int segment_type, int num_attr);
+int AK_segment_writer_put(AK_segment_writer *writer, AK_sort_row *row);
+void AK_segment_writer_close(AK_segment_writer *writer);
+int AK_external_sort(char *srcTable, char *destTable, struct list_node *attributes, int memory_budget);
+int AK_top_n(char *srcTable, char *destTable, struct list_node *attributes, int limit);
+
 /**
  * @author Tomislav Bobinac, updated by Filip Žmuk
- * @todo Make it to suport multiple sort atributes and ASC|DESC ordering
- * @brief Function that sorts a segment
- * @return No return value.
+ * @brief Function that sorts a segment. Ordering is a list of TYPE_ATTRIBS nodes, each one optionally
+ *        followed by a TYPE_OPERATOR node "ASC" or "DESC".
+ * @return EXIT_SUCCESS or EXIT_ERROR
  */
 int AK_sort_segment(char *srcTable, char *destTable, struct list_node* attributes);
 
@@ -19,16 +19,31 @@
 
 #include "id.h"
 
+static pthread_mutex_t idCacheMut = PTHREAD_MUTEX_INITIALIZER;
+static int id_last = 0;
+static int id_remaining = 0;
+
 /**
- * @author Saša Vukšić, updated by Mislav Čakarić, changed by Mario Peroković, now uses AK_update_row, updated by Nenad Makar
- * @brief Function that fetches unique ID for any object, stored in a sequence
+ * @author Saša Vukšić, updated by Mislav Čakarić, changed by Mario Peroković, now uses AK_update_row, updated by Nenad Makar,
+ * updated by Unknown (IDs reserved in ranges)
+ * @brief Function that fetches unique ID for any object, stored in a sequence. ID_CACHE_SIZE IDs are reserved with one
+ *        update of AK_sequence and handed out from memory.
  * @return objectID
  */
 int AK_get_id() {
     int obj_id = 0;
-    char name = "objectID";
+    char name[] = "objectID";
     int current_value;
     AK_PRO;
+    pthread_mutex_lock(&idCacheMut);
+    if (id_remaining > 0) {
+        id_remaining--;
+        current_value = ++id_last;
+        pthread_mutex_unlock(&idCacheMut);
+        AK_EPI;
+        return current_value;
+    }
+
     struct list_node *row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
     AK_Init_L3(&row_root); 
     
@@ -46,35 +61,37 @@ int AK_get_id() {
         AK_DeleteAll_L3(&row);
         
         current_value++;
+        int reserved = current_value + ID_CACHE_SIZE - 1;
         
         //TODO: this is a temporary solution that should be fixed after the memory management is fixed
-		AK_Update_Existing_Element(TYPE_VARCHAR, &name, "AK_sequence", "name", row_root);
-        AK_Insert_New_Element(TYPE_VARCHAR, &name, "AK_sequence", "name", row_root);
-        AK_Insert_New_Element(TYPE_INT, &current_value, "AK_sequence", "current_value", row_root);
+		AK_Update_Existing_Element(TYPE_VARCHAR, name, "AK_sequence", "name", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, name, "AK_sequence", "name", row_root);
+        AK_Insert_New_Element(TYPE_INT, &reserved, "AK_sequence", "current_value", row_root);
         int result = AK_update_row(row_root);
         AK_DeleteAll_L3(&row_root);
         
         if (result != EXIT_SUCCESS) {
+            pthread_mutex_unlock(&idCacheMut);
             AK_EPI;
             return EXIT_ERROR;
         }
-        AK_EPI;
-        return current_value;
     } else {
 	    // No existing rows found for AK_sequence table, creating new row
         AK_Insert_New_Element(TYPE_INT, &obj_id, "AK_sequence", "obj_id", row_root);
-        AK_Insert_New_Element(TYPE_VARCHAR, &name, "AK_sequence", "name", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, name, "AK_sequence", "name", row_root);
         current_value = ID_START_VALUE;
-        AK_Insert_New_Element(TYPE_INT, &current_value, "AK_sequence", "current_value", row_root);
+        int reserved = current_value + ID_CACHE_SIZE - 1;
+        AK_Insert_New_Element(TYPE_INT, &reserved, "AK_sequence", "current_value", row_root);
         int increment = 1;
         AK_Insert_New_Element(TYPE_INT, &increment, "AK_sequence", "increment", row_root);
         AK_insert_row(row_root);
         AK_DeleteAll_L3(&row_root);
-        AK_EPI;
-        return current_value;
     }
+    id_last = current_value;
+    id_remaining = ID_CACHE_SIZE - 1;
+    pthread_mutex_unlock(&idCacheMut);
     AK_EPI;
-    //return 100;
+    return current_value;
 }
 /**
  * @author Lovro Predovan, updated by Jakov Gatarić
@@ -115,6 +132,8 @@ char AK_get_table_id(char *tableName) {
 TestResult AK_id_test() {
     AK_PRO;
     int result;
+    int previous;
+    int reserved;
     int failed = 0;
     int success = 0;
     printf("\nCurrent value of objectID (depends on number of AK_get_id() calls (when objects are created...) before call of AK_id_test()):\n\n");
@@ -128,6 +147,7 @@ TestResult AK_id_test() {
 
     printf("\nIncremented value of objectID:\n\n");
     AK_print_table("AK_sequence");
+    previous = result;
     result = AK_get_id();
     if (result == EXIT_ERROR) {
         failed++;
@@ -136,6 +156,18 @@ TestResult AK_id_test() {
     }
     printf("\nIncremented value of objectID:\n\n");
     AK_print_table("AK_sequence");
+
+    /* IDs are handed out one after another from a range already reserved in AK_sequence */
+    struct list_node *row = AK_get_row(0, "AK_sequence");
+    memcpy(&reserved, AK_GetNth_L2(3, row)->data, sizeof (int));
+    AK_DeleteAll_L3(&row);
+    AK_free(row);
+    printf("\nLast reserved objectID: %d\n", reserved);
+    if (result == previous + 1 && reserved >= result) {
+        success++;
+    } else {
+        failed++;
+    }
     printf("\nTest succeeded.\nIt's clear that objectID was created after the first call of AK_get_id() function (when ./akdb test created the first DB object) then incremented after other calls.\n");
     AK_EPI;
     return TEST_result(success, failed);
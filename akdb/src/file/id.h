@@ -24,12 +24,18 @@
 #include "table.h"
 #include "fileio.h"
 #include "../auxi/mempro.h"
+#include <pthread.h>
 
 /**
  * @def ID_START_VALUE
  * @brief Constant declaring start value of id 
 */
 #define ID_START_VALUE 100
+/**
+ * @def ID_CACHE_SIZE
+ * @brief Number of object IDs reserved in AK_sequence with one update
+*/
+#define ID_CACHE_SIZE 50
 
 /**
  * @author Saša Vukšić, updated by Mislav Čakarić, changed by Mario Peroković, now uses AK_update_row, updated by Nenad Makar
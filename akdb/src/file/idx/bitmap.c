@@ -1,5 +1,8 @@
 /**
-@file bitmap.c Provides functions for bitmap indexes
+@file bitmap.c Provides functions for bitmap indexes. A bitmap index keeps a compressed bitmap of the rows of every
+value of an attribute. Rows are numbered by row ids derived from their addresses, a bitmap is split into containers
+of 65536 row ids that are sparse sorted arrays or dense words, and predicates over several bitmap indexes are
+combined word by word before the table is read.
  */
 /*
  * This program is free software; you can redistribute it and/or modify
@@ -20,6 +23,22 @@
 #include "bitmap.h"
 #include "../../auxi/iniparser.h"
 #include "../../auxi/constants.h"
+#include "../filesort.h"
+
+//operations on two bitmaps
+#define BITMAP_AND 0
+#define BITMAP_OR 1
+#define BITMAP_ANDNOT 2
+
+/**
+  * @author Unknown
+  * @struct bitmap_node
+  * @brief Directory page read into memory
+ */
+typedef struct {
+    bitmap_page header;
+    bitmap_entry entry[BITMAP_PAGE_ENTRIES];
+} bitmap_node;
 
 /**
   @author Saša Vukšić
@@ -47,410 +66,1275 @@
 }
 
 /**
- * @author Saša Vukšić, Lovro Predovan
- * @brief Function that reads table on which we create index and call functions for creating index
-           Elements that will be in index are put in list indexLista and headerAttributes. According to those elements new indexes
-           are created.
-
- * @param tblName name of table
- * @param attributes list of attributes on which we will create indexes
- * @return No return value
- * */
- void AK_create_Index_Table(char *tblName, struct list_node *attributes)
- {
-    int num_attr;
-    int i, j, k;
+  * @author Unknown
+  * @brief Function that allocates room for the values of a sparse container. The room is a power of two, so values
+  *        added one by one need a larger array only when the container holds a power of two values.
+  * @param n number of values
+  * @return array of values
+ */
+static unsigned short *AK_bitmap_alloc_values(int n) {
+    int capacity = 4;
+    while (capacity < n)
+        capacity *= 2;
+    return (unsigned short *) AK_malloc(capacity * sizeof (unsigned short));
+}
 
-    table_addresses *addresses;
-    AK_header *temp_head;
-    int temp_int;
-    char temp_char[ MAX_VARCHAR_LENGTH ];
+/**
+  * @author Unknown
+  * @brief Function that spreads the values of a sparse container into words
+  * @param c sparse container
+  * @return BITMAP_CONTAINER_WORDS words
+ */
+static uint64_t *AK_bitmap_spread(AK_bitmap_container *c) {
+    uint64_t *words = (uint64_t *) AK_calloc(BITMAP_CONTAINER_WORDS, sizeof (uint64_t));
+    int i;
+    for (i = 0; i < c->cardinality; i++)
+        words[c->values[i] >> 6] |= (uint64_t) 1 << (c->values[i] & 63);
+    return words;
+}
 
-    struct list_node *some_element;
-    struct list_node *e, *ee;
-    struct list_node *headerAtributes;
-    int br;
-    char * indexName;
-    int indexed_attr_position;
+/**
+  * @author Unknown
+  * @brief Function that makes a container sparse or dense, whichever is smaller for its number of rows
+  * @param c container
+ */
+static void AK_bitmap_normalize(AK_bitmap_container *c) {
+    uint64_t word;
+    int i, n = 0;
+    if (c->words == NULL && c->cardinality > BITMAP_ARRAY_MAX) {
+        c->words = AK_bitmap_spread(c);
+        AK_free(c->values);
+        c->values = NULL;
+    } else if (c->words != NULL && c->cardinality <= BITMAP_ARRAY_MAX) {
+        c->values = AK_bitmap_alloc_values(c->cardinality);
+        for (i = 0; i < BITMAP_CONTAINER_WORDS; i++) {
+            for (word = c->words[i]; word != 0; word &= word - 1)
+                c->values[n++] = (unsigned short) (i * 64 + __builtin_ctzll(word));
+        }
+        AK_free(c->words);
+        c->words = NULL;
+    }
+}
 
+/**
+  * @author Unknown
+  * @brief Function that frees the values or words of a container
+  * @param c container
+ */
+static void AK_bitmap_container_free(AK_bitmap_container *c) {
+    if (c->values != NULL)
+        AK_free(c->values);
+    if (c->words != NULL)
+        AK_free(c->words);
+}
 
-    AK_header t_header[ MAX_ATTRIBUTES ];
-    AK_header t_headerr[ MAX_ATTRIBUTES ];
-    AK_header* tempHeader;
+/**
+  * @author Unknown
+  * @brief Function that binary searches the containers of a bitmap for a key
+  * @param bitmap bitmap
+  * @param key high 16 bits of a row id
+  * @param pos set to the position of the container, or the position a container with the key is inserted at
+  * @return 1 if the bitmap has a container with the key, otherwise 0
+ */
+static int AK_bitmap_find(AK_bitmap *bitmap, int key, int *pos) {
+    int low = 0, high = bitmap->num_containers, mid;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (bitmap->containers[mid].key < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    *pos = low;
+    return low < bitmap->num_containers && bitmap->containers[low].key == key;
+}
 
-    AK_PRO;
+/**
+  * @author Unknown
+  * @brief Function that binary searches the values of a sparse container
+  * @param c sparse container
+  * @param value low 16 bits of a row id
+  * @return position of the first value not below the value
+ */
+static int AK_bitmap_find_value(AK_bitmap_container *c, unsigned short value) {
+    int low = 0, high = c->cardinality, mid;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (c->values[mid] < value)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
 
-    addresses = (table_addresses*) AK_get_table_addresses(tblName);
-    num_attr = AK_num_attr(tblName);
-    temp_head = (AK_header *) AK_get_header(tblName);
-    headerAtributes = (struct list_node *) AK_malloc(sizeof (struct list_node));
+/**
+  * @author Unknown
+  * @brief Function that makes room for one more container at the end of a bitmap
+  * @param bitmap bitmap
+  * @return the new container, not yet initialised
+ */
+static AK_bitmap_container *AK_bitmap_append(AK_bitmap *bitmap) {
+    if (bitmap->num_containers == bitmap->capacity) {
+        bitmap->capacity *= 2;
+        bitmap->containers = (AK_bitmap_container *) AK_realloc(bitmap->containers,
+                bitmap->capacity * sizeof (AK_bitmap_container));
+    }
+    return bitmap->containers + bitmap->num_containers++;
+}
 
+/**
+  * @author Unknown
+  * @brief Function that adds a row id to a bitmap or removes it
+  * @param bitmap bitmap
+  * @param id row id
+  * @param delete if 0 the row id is added else it is removed
+  * @return 1 if the bitmap changed, otherwise 0
+ */
+static int AK_bitmap_change(AK_bitmap *bitmap, unsigned int id, int delete) {
+    AK_bitmap_container *c;
+    unsigned short low = id & 0xFFFF;
+    uint64_t bit = (uint64_t) 1 << (low & 63);
+    int pos, i;
+
+    if (!AK_bitmap_find(bitmap, id >> 16, &pos)) {
+        if (delete)
+            return 0;
+        AK_bitmap_append(bitmap);
+        memmove(bitmap->containers + pos + 1, bitmap->containers + pos,
+                (bitmap->num_containers - 1 - pos) * sizeof (AK_bitmap_container));
+        c = bitmap->containers + pos;
+        c->key = id >> 16;
+        c->cardinality = 0;
+        c->values = AK_bitmap_alloc_values(0);
+        c->words = NULL;
+    }
+    c = bitmap->containers + pos;
+
+    if (c->words != NULL) {
+        if (((c->words[low >> 6] & bit) != 0) != (delete != 0))
+            return 0;
+        c->words[low >> 6] ^= bit;
+        c->cardinality += delete ? -1 : 1;
+    } else {
+        i = AK_bitmap_find_value(c, low);
+        if ((i < c->cardinality && c->values[i] == low) != (delete != 0))
+            return 0;
+        if (delete) {
+            memmove(c->values + i, c->values + i + 1, (c->cardinality - i - 1) * sizeof (unsigned short));
+            c->cardinality--;
+        } else {
+            if (c->cardinality >= 4 && (c->cardinality & (c->cardinality - 1)) == 0)
+                c->values = (unsigned short *) AK_realloc(c->values, 2 * c->cardinality * sizeof (unsigned short));
+            memmove(c->values + i + 1, c->values + i, (c->cardinality - i) * sizeof (unsigned short));
+            c->values[i] = low;
+            c->cardinality++;
+        }
+    }
 
-    for (i = 0; i < num_attr; i++)
-    {
-        some_element = AK_First_L2(attributes);
-        while (some_element != 0)
-        {
-            if (strcmp((temp_head + i)->att_name, some_element->attribute_name) == 0)
-            {
-                indexed_attr_position = i;
-                AK_Init_L3(&headerAtributes);
-                br = 0;
-
-                while (addresses->address_from[ br ] != 0)
-                {
-                    for (j = addresses->address_from[ br ]; j < addresses->address_to[ br ]; j++)
-                    {
-                        AK_block *temp = (AK_block*) AK_read_block(j);
-                        for (k = i; k < DATA_BLOCK_SIZE; k = k + num_attr)
-                        {
-                            if (temp->tuple_dict[ k ].size > 0)
-                            {
-                                switch (temp->tuple_dict[ k ].type)
-                                {
-
-
-                                    case TYPE_INT:
-                                    memcpy(&temp_int, &(temp->data[ temp->tuple_dict[ k ].address]),
-                                     temp->tuple_dict[k].size);
-                                    temp_int = sprintf(temp_char, "%d", temp_int);
-
-                                    ee = (struct list_node *) AK_First_L2(headerAtributes);
-                                    if (ee == 0)
-                                    {
-                                        AK_Insert_New_Element(TYPE_VARCHAR, temp_char, "indexLista", temp_char, headerAtributes);
-                                    }
-                                    else
-                                    {
-                                        if (AK_If_ExistOp(headerAtributes, temp_char) == 0)
-                                        {
-                                            ee = (struct list_node *) AK_End_L2(headerAtributes);
-                                            AK_Insert_New_Element(TYPE_VARCHAR, temp_char, "indexLista", temp_char, ee);
-                                        }
-                                    }
-                                    //printf("TEMP %-10s \n", temp_char);
-                                    break;
-
-                                //FLOAT VALUES ARE USUALLY NOT BEING INDEXED
-                                    case TYPE_FLOAT:
-                                    break;
-
-
-                                    case TYPE_VARCHAR:
-                                    memcpy(temp_char, &(temp->data[ temp->tuple_dict[ k ].address]),
-                                     temp->tuple_dict[k].size);
-                                    temp_char[ temp->tuple_dict[k].size ] = '\0';
-
-                                    ee = (struct list_node *) AK_First_L2(headerAtributes);
-                                    if (ee == 0)
-                                    {
-                                        AK_Insert_New_Element(TYPE_VARCHAR, temp_char, "indexLista", temp_char, headerAtributes);
-                                    }
-                                    else
-                                    {
-                                        if (AK_If_ExistOp(headerAtributes, temp_char) == 0)
-                                        {
-                                            ee = (struct list_node *) AK_End_L2(headerAtributes);
-                                            AK_Insert_New_Element(TYPE_VARCHAR, temp_char, "indexLista", temp_char, ee);
-                                        }
-                                    }
-                                    break;
-                                }
-
-                            }
-                        }
-                    }
-                    br++;
-                }
+    if (c->cardinality == 0) {
+        AK_bitmap_container_free(c);
+        memmove(c, c + 1, (bitmap->num_containers - pos - 1) * sizeof (AK_bitmap_container));
+        bitmap->num_containers--;
+    } else {
+        AK_bitmap_normalize(c);
+    }
+    return 1;
+}
 
+/**
+  * @author Unknown
+  * @brief Function that combines two containers with the same key. Two sparse containers are merged, otherwise
+  *        the containers are combined as words, in loops over whole words the compiler can vectorise.
+  * @param a first container
+  * @param b second container
+  * @param op BITMAP_AND, BITMAP_OR or BITMAP_ANDNOT
+  * @param result set to the combined container
+ */
+static void AK_bitmap_container_op(AK_bitmap_container *a, AK_bitmap_container *b, int op, AK_bitmap_container *result) {
+    uint64_t *x, *y, *words;
+    int i, j, n = 0;
+
+    result->key = a->key;
+    result->values = NULL;
+    result->words = NULL;
+    if (a->words == NULL && b->words == NULL) {
+        result->values = AK_bitmap_alloc_values(op == BITMAP_OR ? a->cardinality + b->cardinality : a->cardinality);
+        for (i = 0, j = 0; i < a->cardinality || (op == BITMAP_OR && j < b->cardinality);) {
+            if (j == b->cardinality || (i < a->cardinality && a->values[i] < b->values[j])) {
+                if (op != BITMAP_AND)
+                    result->values[n++] = a->values[i];
+                i++;
+            } else if (i == a->cardinality || b->values[j] < a->values[i]) {
+                if (op == BITMAP_OR)
+                    result->values[n++] = b->values[j];
+                j++;
+            } else {
+                if (op != BITMAP_ANDNOT)
+                    result->values[n++] = a->values[i];
+                i++;
+                j++;
+            }
+        }
+        result->cardinality = n;
+        AK_bitmap_normalize(result);
+        return;
+    }
 
-                //PART WHERE WE CHECK EVERY ATTRIBUTE
-                int brr;
-                int z;
-                char inde[50];
-                int startAddress;
-                switch ((temp_head + i)->type)
-                {
-                    case TYPE_VARCHAR:
-                    brr = 2; //3 First two places are reserved for block and row pointers
-                    e = (struct list_node *) AK_First_L2(headerAtributes);
-                    while (e != 0)
-                    {
-                        tempHeader = (AK_header*) AK_create_header(e->attribute_name, TYPE_VARCHAR, FREE_INT, FREE_CHAR, FREE_CHAR);
-                        memcpy(t_header + brr, tempHeader, sizeof ( AK_header));
-                        e = (struct list_node *) AK_Next_L2(e);
-                        brr++;
-                    }
-                    //ADDITIONAL ATTRIBTE IS PRESENT FOR BLOCK ADDRESS
-                    tempHeader = (AK_header*) AK_create_header("addBlock", TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
-                    memcpy(t_header, tempHeader, sizeof ( AK_header));
-                    tempHeader = (AK_header*) AK_create_header("indexTd", TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
-                    memcpy(t_header + 1, tempHeader, sizeof ( AK_header));
-
-                    for (z = brr; z < MAX_ATTRIBUTES; z++)
-                    {
-                        memcpy(t_header + z, "\0", sizeof ( "\0"));
-                    }
+    x = a->words != NULL ? a->words : AK_bitmap_spread(a);
+    y = b->words != NULL ? b->words : AK_bitmap_spread(b);
+    words = (uint64_t *) AK_malloc(BITMAP_CONTAINER_WORDS * sizeof (uint64_t));
+    switch (op) {
+        case BITMAP_AND:
+            for (i = 0; i < BITMAP_CONTAINER_WORDS; i++)
+                words[i] = x[i] & y[i];
+            break;
+        case BITMAP_OR:
+            for (i = 0; i < BITMAP_CONTAINER_WORDS; i++)
+                words[i] = x[i] | y[i];
+            break;
+        default:
+            for (i = 0; i < BITMAP_CONTAINER_WORDS; i++)
+                words[i] = x[i] & ~y[i];
+            break;
+    }
+    for (i = 0; i < BITMAP_CONTAINER_WORDS; i++)
+        n += __builtin_popcountll(words[i]);
+    if (x != a->words)
+        AK_free(x);
+    if (y != b->words)
+        AK_free(y);
+    result->words = words;
+    result->cardinality = n;
+    AK_bitmap_normalize(result);
+}
 
-                    //INITIALIZATION OF NEW HEADER FILE
-                    strcpy(inde, tblName);
-                    indexName = strcat(inde, (temp_head + i)->att_name);
-                    indexName = strcat(indexName, "_bmapIndex");
-                //Error: argument of type "char" is incompatible with parameter of type "char *"
-                    startAddress = AK_initialize_new_index_segment(indexName,AK_get_table_id(tblName),indexed_attr_position, t_header);
+/**
+  * @author Unknown
+  * @brief Function that copies a container
+  * @param c container
+  * @param copy set to the copy
+ */
+static void AK_bitmap_container_copy(AK_bitmap_container *c, AK_bitmap_container *copy) {
+    *copy = *c;
+    if (c->words != NULL) {
+        copy->words = (uint64_t *) AK_malloc(BITMAP_CONTAINER_WORDS * sizeof (uint64_t));
+        memcpy(copy->words, c->words, BITMAP_CONTAINER_WORDS * sizeof (uint64_t));
+    } else {
+        copy->values = AK_bitmap_alloc_values(c->cardinality);
+        memcpy(copy->values, c->values, c->cardinality * sizeof (unsigned short));
+    }
+}
 
+/**
+  * @author Unknown
+  * @brief Function that combines two bitmaps container by container. Containers with a key in only one bitmap are
+  *        copied or dropped without looking at their rows.
+  * @param a first bitmap
+  * @param b second bitmap
+  * @param op BITMAP_AND, BITMAP_OR or BITMAP_ANDNOT
+  * @return new bitmap
+ */
+static AK_bitmap *AK_bitmap_op(AK_bitmap *a, AK_bitmap *b, int op) {
+    AK_bitmap *result = AK_bitmap_new();
+    AK_bitmap_container *c;
+    int i = 0, j = 0;
+    while (i < a->num_containers || (op == BITMAP_OR && j < b->num_containers)) {
+        if (j == b->num_containers || (i < a->num_containers && a->containers[i].key < b->containers[j].key)) {
+            if (op != BITMAP_AND)
+                AK_bitmap_container_copy(a->containers + i, AK_bitmap_append(result));
+            i++;
+        } else if (i == a->num_containers || b->containers[j].key < a->containers[i].key) {
+            if (op == BITMAP_OR)
+                AK_bitmap_container_copy(b->containers + j, AK_bitmap_append(result));
+            j++;
+        } else {
+            c = AK_bitmap_append(result);
+            AK_bitmap_container_op(a->containers + i, b->containers + j, op, c);
+            if (c->cardinality == 0) {
+                AK_bitmap_container_free(c);
+                result->num_containers--;
+            }
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
 
-                    if (startAddress != EXIT_ERROR)
-                    {
-                        printf("\nINDEX %s CREATED!\n", indexName);
-                        //funtion that fills index with attribute values
-                        AK_create_Index(tblName, indexName, (temp_head + i)->att_name, i, num_attr, t_header);
-                    }
+/**
+ * @author Unknown
+ * @brief Function that creates an empty bitmap
+ * @return bitmap
+ */
+AK_bitmap *AK_bitmap_new() {
+    AK_bitmap *bitmap;
+    AK_PRO;
+    bitmap = (AK_bitmap *) AK_malloc(sizeof (AK_bitmap));
+    bitmap->num_containers = 0;
+    bitmap->capacity = 4;
+    bitmap->containers = (AK_bitmap_container *) AK_malloc(bitmap->capacity * sizeof (AK_bitmap_container));
+    AK_EPI;
+    return bitmap;
+}
 
-                    break;
+/**
+ * @author Unknown
+ * @brief Function that frees a bitmap
+ * @param bitmap bitmap
+ */
+void AK_bitmap_free(AK_bitmap *bitmap) {
+    int i;
+    AK_PRO;
+    for (i = 0; i < bitmap->num_containers; i++)
+        AK_bitmap_container_free(bitmap->containers + i);
+    AK_free(bitmap->containers);
+    AK_free(bitmap);
+    AK_EPI;
+}
 
-                    case TYPE_INT:
-                    brr = 2; //3 First two places are reserved for block and row pointers
+/**
+ * @author Unknown
+ * @brief Function that adds a row id to a bitmap
+ * @param bitmap bitmap
+ * @param id row id
+ * @return 1 if the row id was added, 0 if it was in the bitmap
+ */
+int AK_bitmap_add(AK_bitmap *bitmap, unsigned int id) {
+    int result;
+    AK_PRO;
+    result = AK_bitmap_change(bitmap, id, 0);
+    AK_EPI;
+    return result;
+}
 
-                    tempHeader = (AK_header*) AK_create_header("addBlock", TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
-                    memcpy(t_headerr, tempHeader, sizeof ( AK_header));
+/**
+ * @author Unknown
+ * @brief Function that removes a row id from a bitmap
+ * @param bitmap bitmap
+ * @param id row id
+ * @return 1 if the row id was removed, 0 if it was not in the bitmap
+ */
+int AK_bitmap_remove(AK_bitmap *bitmap, unsigned int id) {
+    int result;
+    AK_PRO;
+    result = AK_bitmap_change(bitmap, id, 1);
+    AK_EPI;
+    return result;
+}
 
-                    tempHeader = (AK_header*) AK_create_header("indexTd", TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
-                    memcpy(t_headerr + 1, tempHeader, sizeof ( AK_header));
+/**
+ * @author Unknown
+ * @brief Function that checks if a row id is in a bitmap
+ * @param bitmap bitmap
+ * @param id row id
+ * @return 1 if the row id is in the bitmap, otherwise 0
+ */
+int AK_bitmap_contains(AK_bitmap *bitmap, unsigned int id) {
+    AK_bitmap_container *c;
+    unsigned short low = id & 0xFFFF;
+    int pos, i, found = 0;
+    AK_PRO;
+    if (AK_bitmap_find(bitmap, id >> 16, &pos)) {
+        c = bitmap->containers + pos;
+        if (c->words != NULL) {
+            found = (c->words[low >> 6] >> (low & 63)) & 1;
+        } else {
+            i = AK_bitmap_find_value(c, low);
+            found = i < c->cardinality && c->values[i] == low;
+        }
+    }
+    AK_EPI;
+    return found;
+}
 
-                    e = (struct list_node *) AK_First_L2(headerAtributes);
-                    while (e != 0)
-                    {
-                        tempHeader = (AK_header*) AK_create_header(e->attribute_name, TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
-                        memcpy(t_headerr + brr, tempHeader, sizeof ( AK_header));
-                        e = (struct list_node *) AK_Next_L2(e);
-                        brr++;
-                    }
+/**
+ * @author Unknown
+ * @brief Function that counts the row ids of a bitmap
+ * @param bitmap bitmap
+ * @return number of row ids
+ */
+int AK_bitmap_cardinality(AK_bitmap *bitmap) {
+    int i, n = 0;
+    AK_PRO;
+    for (i = 0; i < bitmap->num_containers; i++)
+        n += bitmap->containers[i].cardinality;
+    AK_EPI;
+    return n;
+}
 
+/**
+ * @author Unknown
+ * @brief Function that intersects two bitmaps
+ * @param a first bitmap
+ * @param b second bitmap
+ * @return new bitmap of the row ids in both bitmaps
+ */
+AK_bitmap *AK_bitmap_and(AK_bitmap *a, AK_bitmap *b) {
+    AK_bitmap *result;
+    AK_PRO;
+    result = AK_bitmap_op(a, b, BITMAP_AND);
+    AK_EPI;
+    return result;
+}
 
-                    for (z = brr; z < MAX_ATTRIBUTES; z++)
-                    {
-                        memcpy(t_headerr + z, "\0", sizeof ( "\0"));
-                    }
+/**
+ * @author Unknown
+ * @brief Function that unites two bitmaps
+ * @param a first bitmap
+ * @param b second bitmap
+ * @return new bitmap of the row ids in either bitmap
+ */
+AK_bitmap *AK_bitmap_or(AK_bitmap *a, AK_bitmap *b) {
+    AK_bitmap *result;
+    AK_PRO;
+    result = AK_bitmap_op(a, b, BITMAP_OR);
+    AK_EPI;
+    return result;
+}
 
-                    strcpy(inde, tblName);
-                    indexName = strcat(inde, (temp_head + i)->att_name);
-                    indexName = strcat(indexName, "_bmapIndex");
-                //Error: argument of type "char" is incompatible with parameter of type "char *"
-                    startAddress = AK_initialize_new_index_segment(indexName,AK_get_table_id(tblName),indexed_attr_position, t_headerr);
-                    if (startAddress != EXIT_ERROR)
-                    {
-                        printf("\nINDEX %s CREATED!\n", indexName);
-                        AK_create_Index(tblName, indexName, (temp_head + i)->att_name, i, num_attr, t_header);
-                    }
-                    break;
-                }
+/**
+ * @author Unknown
+ * @brief Function that subtracts a bitmap from another
+ * @param a first bitmap
+ * @param b second bitmap
+ * @return new bitmap of the row ids in the first bitmap and not in the second
+ */
+AK_bitmap *AK_bitmap_andnot(AK_bitmap *a, AK_bitmap *b) {
+    AK_bitmap *result;
+    AK_PRO;
+    result = AK_bitmap_op(a, b, BITMAP_ANDNOT);
+    AK_EPI;
+    return result;
+}
 
+/**
+ * @author Unknown
+ * @brief Function that gives the addresses of the rows of a bitmap, in the order of their row ids
+ * @param bitmap bitmap
+ * @param num_attr number of attributes of the table
+ * @param rows set to an array of the addresses of the rows
+ * @return number of rows
+ */
+int AK_bitmap_rows(AK_bitmap *bitmap, int num_attr, struct_add **rows) {
+    AK_bitmap_container *c;
+    unsigned int per_block = DATA_BLOCK_SIZE / num_attr, id;
+    uint64_t word;
+    int i, j, n = 0;
+    AK_PRO;
+    *rows = (struct_add *) AK_malloc((AK_bitmap_cardinality(bitmap) + 1) * sizeof (struct_add));
+    for (i = 0; i < bitmap->num_containers; i++) {
+        c = bitmap->containers + i;
+        for (j = 0; j < (c->words != NULL ? BITMAP_CONTAINER_WORDS : c->cardinality); j++) {
+            word = c->words != NULL ? c->words[j] : 1;
+            for (; word != 0; word &= word - 1) {
+                id = ((unsigned int) c->key << 16) | (c->words != NULL ? j * 64 + __builtin_ctzll(word) : c->values[j]);
+                (*rows)[n].addBlock = id / per_block;
+                (*rows)[n].indexTd = id % per_block * num_attr;
+                n++;
             }
-            some_element = (struct list_node *) AK_Next_L2(some_element);
         }
     }
-
-    AK_DeleteAll_L3(&headerAtributes);
-    AK_free(headerAtributes);
-    AK_free(tempHeader);
-    AK_free(temp_head);
     AK_EPI;
+    return n;
+}
 
+/**
+  * @author Unknown
+  * @brief Function that gives the size of a serialized bitmap
+  * @param bitmap bitmap
+  * @return number of bytes
+ */
+static int AK_bitmap_serialized_size(AK_bitmap *bitmap) {
+    int i, size = sizeof (int);
+    for (i = 0; i < bitmap->num_containers; i++) {
+        size += 2 * sizeof (int);
+        if (bitmap->containers[i].words != NULL)
+            size += BITMAP_CONTAINER_WORDS * sizeof (uint64_t);
+        else
+            size += bitmap->containers[i].cardinality * sizeof (unsigned short);
+    }
+    return size;
 }
 
+/**
+  * @author Unknown
+  * @brief Function that serializes a bitmap: the number of containers, then the key, the number of rows and the
+  *        values or words of every container. The number of rows tells if a container is sparse or dense.
+  * @param bitmap bitmap
+  * @param buffer buffer of AK_bitmap_serialized_size bytes
+ */
+static void AK_bitmap_serialize(AK_bitmap *bitmap, unsigned char *buffer) {
+    AK_bitmap_container *c;
+    int i;
+    memcpy(buffer, &bitmap->num_containers, sizeof (int));
+    buffer += sizeof (int);
+    for (i = 0; i < bitmap->num_containers; i++) {
+        c = bitmap->containers + i;
+        memcpy(buffer, &c->key, sizeof (int));
+        memcpy(buffer + sizeof (int), &c->cardinality, sizeof (int));
+        buffer += 2 * sizeof (int);
+        if (c->words != NULL) {
+            memcpy(buffer, c->words, BITMAP_CONTAINER_WORDS * sizeof (uint64_t));
+            buffer += BITMAP_CONTAINER_WORDS * sizeof (uint64_t);
+        } else {
+            memcpy(buffer, c->values, c->cardinality * sizeof (unsigned short));
+            buffer += c->cardinality * sizeof (unsigned short);
+        }
+    }
+}
 
 /**
- * @author Saša Vukšić, Lovro Predovan
- * @brief Function that loads index table with the value of particulary atribute
- * @param tblName source table
- * @param tblNameIndex new name of index table
- * @param attributeName attribute on which we make index
- * @param positionTbl position of attribute in header of table
- * @param numAtributes number of attributes in table
- * @param headerIndex header of index table
- * @return No return value
+  * @author Unknown
+  * @brief Function that reads a serialized bitmap
+  * @param buffer serialized bitmap
+  * @param size number of bytes, 0 for an empty bitmap
+  * @return new bitmap
  */
- void AK_create_Index(char *tblName, char *tblNameIndex, char *attributeName, int positionTbl, int numAtributes, AK_header *headerIndex)
- {
+static AK_bitmap *AK_bitmap_deserialize(unsigned char *buffer, int size) {
+    AK_bitmap *bitmap = AK_bitmap_new();
+    AK_bitmap_container *c;
+    int num_containers = 0, i;
+    if (size >= (int) sizeof (int))
+        memcpy(&num_containers, buffer, sizeof (int));
+    buffer += sizeof (int);
+    for (i = 0; i < num_containers; i++) {
+        c = AK_bitmap_append(bitmap);
+        memcpy(&c->key, buffer, sizeof (int));
+        memcpy(&c->cardinality, buffer + sizeof (int), sizeof (int));
+        buffer += 2 * sizeof (int);
+        if (c->cardinality > BITMAP_ARRAY_MAX) {
+            c->values = NULL;
+            c->words = (uint64_t *) AK_malloc(BITMAP_CONTAINER_WORDS * sizeof (uint64_t));
+            memcpy(c->words, buffer, BITMAP_CONTAINER_WORDS * sizeof (uint64_t));
+            buffer += BITMAP_CONTAINER_WORDS * sizeof (uint64_t);
+        } else {
+            c->words = NULL;
+            c->values = AK_bitmap_alloc_values(c->cardinality);
+            memcpy(c->values, buffer, c->cardinality * sizeof (unsigned short));
+            buffer += c->cardinality * sizeof (unsigned short);
+        }
+    }
+    return bitmap;
+}
 
-    table_addresses *addresses;
-    AK_block *temp;
+/**
+  * @author Unknown
+  * @brief Function that writes a page of the index
+  * @param address block of the page
+  * @param header header of the page
+  * @param data entries or bytes that follow the header
+  * @param size size of the data
+ */
+static void AK_bitmap_write_page(int address, bitmap_page *header, void *data, int size) {
+    AK_mem_block *mem_block = AK_get_block(address);
+    memcpy(mem_block->block->data, header, sizeof (bitmap_page));
+    if (size > 0)
+        memcpy(mem_block->block->data + sizeof (bitmap_page), data, size);
+    mem_block->block->tuple_dict[0].type = header->type;
+    mem_block->block->tuple_dict[0].address = 0;
+    mem_block->block->tuple_dict[0].size = sizeof (bitmap_page) + size;
+    mem_block->block->AK_free_space = sizeof (bitmap_page) + size;
+    mem_block->block->last_tuple_dict_id = 0;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+}
 
-    int i, j, k;
-    int temp_int;
-    int temp_indexTd;
-    char temp_char[ MAX_VARCHAR_LENGTH ];
-    i = 0;
-    struct list_node *row_root;
+/**
+  * @author Unknown
+  * @brief Function that reads the header of a page
+  * @param address block of the page
+  * @param header set to the header
+ */
+static void AK_bitmap_read_header(int address, bitmap_page *header) {
+    memcpy(header, AK_get_block(address)->block->data, sizeof (bitmap_page));
+}
 
-    AK_PRO;
+/**
+  * @author Unknown
+  * @brief Function that reads a directory page into memory
+  * @param address block of the page
+  * @param node set to the page
+ */
+static void AK_bitmap_read_node(int address, bitmap_node *node) {
+    unsigned char *data = AK_get_block(address)->block->data;
+    memcpy(&node->header, data, sizeof (bitmap_page));
+    memcpy(node->entry, data + sizeof (bitmap_page), node->header.num_entries * sizeof (bitmap_entry));
+}
 
-    addresses = (table_addresses*) AK_get_table_addresses(tblName);
-    temp = (AK_block*) AK_read_block(addresses->address_from[0]);
+/**
+  * @author Unknown
+  * @brief Function that writes a node to its directory page
+  * @param address block of the page
+  * @param node page
+ */
+static void AK_bitmap_write_node(int address, bitmap_node *node) {
+    AK_bitmap_write_page(address, &node->header, node->entry, node->header.num_entries * sizeof (bitmap_entry));
+}
 
-    while (addresses->address_from[ i ] != 0)
-    {
-        for (j = addresses->address_from[ i ]; j < addresses->address_to[ i ]; j++)
-        {
-            AK_block *temp = (AK_block*) AK_read_block(j);
-            for (k = positionTbl; k < DATA_BLOCK_SIZE; k = k + numAtributes)
-            {
-
-                if (temp->tuple_dict[ k ].size > 0)
-                {
-                    switch (temp->tuple_dict[ k ].type)
-                    {
-
-                        case TYPE_INT:
-                            memcpy(&temp_int, &(temp->data[ temp->tuple_dict[ k ].address]),
-                             temp->tuple_dict[k].size);
-                            temp_int = sprintf(temp_char, "%d", temp_int);
-                            row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
-                            AK_Init_L3(&row_root);
-                            temp_indexTd = k - positionTbl;
-
-                            AK_Insert_New_Element(TYPE_INT, &(temp->address), tblNameIndex, "addBlock", row_root);
-                            AK_Insert_New_Element(TYPE_INT, &temp_indexTd, tblNameIndex, "indexTd", row_root);
-                            //Error: argument of type "const char *" is incompatible with parameter of type "void *"
-                            AK_Insert_New_Element(TYPE_VARCHAR, "1", tblNameIndex, temp_char, row_root);
-
-                            AK_insert_row(row_root);
-                            AK_DeleteAll_L3(&row_root);
-                            AK_free(row_root);
-                        break;
+/**
+  * @author Unknown
+  * @brief Function that reads the first block of a bitmap index
+  * @param indexName name of index
+  * @param meta set to the meta data of the index
+  * @return address of the first block, EXIT_ERROR if there is no such bitmap index
+ */
+static int AK_bitmap_get_meta(char *indexName, bitmap_meta *meta) {
+    table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
+    int address = addresses->address_from[0];
+    AK_free(addresses);
+    if (address == 0)
+        return EXIT_ERROR;
+    memcpy(meta, AK_get_block(address)->block->data, sizeof (bitmap_meta));
+    return meta->magic == BITMAP_MAGIC ? address : EXIT_ERROR;
+}
 
+/**
+  * @author Unknown
+  * @brief Function that writes the first block of a bitmap index
+  * @param address address of the first block
+  * @param meta meta data of the index
+ */
+static void AK_bitmap_put_meta(int address, bitmap_meta *meta) {
+    AK_mem_block *mem_block = AK_get_block(address);
+    memcpy(mem_block->block->data, meta, sizeof (bitmap_meta));
+    mem_block->block->tuple_dict[0].type = BITMAP_META;
+    mem_block->block->tuple_dict[0].address = 0;
+    mem_block->block->tuple_dict[0].size = sizeof (bitmap_meta);
+    mem_block->block->AK_free_space = sizeof (bitmap_meta);
+    mem_block->block->last_tuple_dict_id = 0;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+}
 
-                        case TYPE_FLOAT:
-                        break;
+/**
+  * @author Unknown
+  * @brief Function that gives a page to the index, a freed page if there is one, otherwise the next block of the
+  *        segment. The segment gets a new extent when its blocks are used up.
+  * @return address of the page, EXIT_ERROR if no block is left
+ */
+static int AK_bitmap_alloc_page(char *indexName, bitmap_meta *meta) {
+    bitmap_page page;
+    table_addresses *addresses;
+    int j, address = EXIT_ERROR;
+    if (meta->free_page != 0) {
+        address = meta->free_page;
+        AK_bitmap_read_header(address, &page);
+        meta->free_page = page.next;
+        meta->num_pages++;
+        return address;
+    }
+    addresses = (table_addresses*) AK_get_index_addresses(indexName);
+    for (j = 0; j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0; j++) {
+        if (meta->last_page >= addresses->address_from[j] && meta->last_page < addresses->address_to[j])
+            break;
+    }
+    if (j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0 && meta->last_page + 1 < addresses->address_to[j])
+        address = meta->last_page + 1;
+    else if (j + 1 < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j + 1] != 0)
+        address = addresses->address_from[j + 1];
+    else
+        address = AK_init_new_extent(indexName, SEGMENT_TYPE_INDEX);
+    AK_free(addresses);
+    if (address == EXIT_ERROR || address == 0)
+        return EXIT_ERROR;
+    meta->last_page = address;
+    meta->num_pages++;
+    return address;
+}
 
-                        case TYPE_VARCHAR:
-                            memcpy(temp_char, &(temp->data[ temp->tuple_dict[ k ].address]),
-                             temp->tuple_dict[k].size);
-                            temp_char[ temp->tuple_dict[k].size ] = '\0';
-                            row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
-                            AK_Init_L3(&row_root);
-                            temp_indexTd = k - positionTbl;
+/**
+  * @author Unknown
+  * @brief Function that puts the pages of a chain on the list of free pages
+  * @param address first page of the chain, 0 for none
+  * @param meta meta data of the index
+ */
+static void AK_bitmap_free_chain(int address, bitmap_meta *meta) {
+    bitmap_page page;
+    int next;
+    while (address != 0) {
+        AK_bitmap_read_header(address, &page);
+        next = page.next;
+        page.type = BITMAP_FREE_PAGE;
+        page.num_entries = 0;
+        page.size = 0;
+        page.next = meta->free_page;
+        AK_bitmap_write_page(address, &page, NULL, 0);
+        meta->free_page = address;
+        meta->num_pages--;
+        address = next;
+    }
+}
 
-                            AK_Insert_New_Element(TYPE_INT, &(temp->address), tblNameIndex, "addBlock", row_root);
-                            AK_Insert_New_Element(TYPE_INT, &temp_indexTd, tblNameIndex, "indexTd", row_root);
-                            AK_Insert_New_Element(TYPE_VARCHAR, "1", tblNameIndex, temp_char, row_root);
+/**
+  * @author Unknown
+  * @brief Function that starts the chain of an empty bitmap on a new page
+  * @param indexName name of index
+  * @param meta meta data of the index
+  * @return address of the page, EXIT_ERROR if no block is left
+ */
+static int AK_bitmap_new_chain(char *indexName, bitmap_meta *meta) {
+    bitmap_page page;
+    int address = AK_bitmap_alloc_page(indexName, meta);
+    if (address == EXIT_ERROR)
+        return EXIT_ERROR;
+    page.type = BITMAP_WORDS;
+    page.num_entries = 0;
+    page.size = 0;
+    page.next = 0;
+    AK_bitmap_write_page(address, &page, NULL, 0);
+    return address;
+}
 
-                            AK_insert_row(row_root);
+/**
+  * @author Unknown
+  * @brief Function that reads the bitmap serialized into a chain of pages
+  * @param address first page of the chain
+  * @return new bitmap
+ */
+static AK_bitmap *AK_bitmap_read(int address) {
+    AK_bitmap *bitmap;
+    AK_block *block;
+    bitmap_page page;
+    unsigned char *buffer;
+    int size = 0, capacity = BITMAP_PAGE_BYTES;
+    buffer = (unsigned char *) AK_malloc(capacity);
+    while (address != 0) {
+        block = AK_get_block(address)->block;
+        memcpy(&page, block->data, sizeof (bitmap_page));
+        if (size + page.size > capacity) {
+            capacity = 2 * (size + page.size);
+            buffer = (unsigned char *) AK_realloc(buffer, capacity);
+        }
+        memcpy(buffer + size, block->data + sizeof (bitmap_page), page.size);
+        size += page.size;
+        address = page.next;
+    }
+    bitmap = AK_bitmap_deserialize(buffer, size);
+    AK_free(buffer);
+    return bitmap;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that serializes a bitmap into a chain of pages. The pages of the chain are written over, more
+  *        pages are allocated as needed and the pages left over are freed.
+  * @param indexName name of index
+  * @param meta meta data of the index
+  * @param address first page of the chain
+  * @param bitmap bitmap
+  * @return EXIT_SUCCESS, EXIT_ERROR if no block is left
+ */
+static int AK_bitmap_write(char *indexName, bitmap_meta *meta, int address, AK_bitmap *bitmap) {
+    bitmap_page page, old;
+    unsigned char *buffer;
+    int size = AK_bitmap_serialized_size(bitmap), offset = 0, rest;
+
+    buffer = (unsigned char *) AK_malloc(size);
+    AK_bitmap_serialize(bitmap, buffer);
+    AK_bitmap_read_header(address, &old);
+    rest = old.next;
+    do {
+        page.type = BITMAP_WORDS;
+        page.num_entries = 0;
+        page.size = size - offset < BITMAP_PAGE_BYTES ? size - offset : BITMAP_PAGE_BYTES;
+        page.next = 0;
+        if (offset + page.size < size) {
+            if (rest != 0) {
+                page.next = rest;
+                AK_bitmap_read_header(rest, &old);
+                rest = old.next;
+            } else if ((page.next = AK_bitmap_alloc_page(indexName, meta)) == EXIT_ERROR) {
+                page.next = 0;
+                AK_bitmap_write_page(address, &page, buffer + offset, page.size);
+                AK_free(buffer);
+                return EXIT_ERROR;
+            }
+        }
+        AK_bitmap_write_page(address, &page, buffer + offset, page.size);
+        offset += page.size;
+        address = page.next;
+    } while (offset < size);
+    AK_bitmap_free_chain(rest, meta);
+    AK_free(buffer);
+    return EXIT_SUCCESS;
+}
 
+/**
+  * @author Unknown
+  * @brief Function that looks a value up in the directory
+  * @param meta meta data of the index
+  * @param value value as stored in a table block
+  * @param size size of the value
+  * @param page set to the directory page of the value, the last directory page if the value is not there
+  * @param previous set to the directory page before page, 0 if page is the first one
+  * @param node set to page read into memory
+  * @return entry of the value in the page, EXIT_ERROR if the value is not in the directory
+ */
+static int AK_bitmap_lookup(bitmap_meta *meta, unsigned char *value, int size, int *page, int *previous,
+        bitmap_node *node) {
+    int i;
+    *previous = 0;
+    *page = meta->directory;
+    for (;;) {
+        AK_bitmap_read_node(*page, node);
+        for (i = 0; i < node->header.num_entries; i++) {
+            if (node->entry[i].size == size && memcmp(node->entry[i].value, value, size) == 0)
+                return i;
+        }
+        if (node->header.next == 0)
+            return EXIT_ERROR;
+        *previous = *page;
+        *page = node->header.next;
+    }
+}
 
-                            AK_DeleteAll_L3(&row_root);
-                            AK_free(row_root);
-                        break;
-                    }
-                }
+/**
+  * @author Unknown
+  * @brief Function that adds a row id to the bitmap of a value or removes it. A value gets a directory entry with
+  *        its first row, the entry and the bitmap pages of a value are freed with its last row.
+  * @param indexName name of index
+  * @param meta meta data of the index
+  * @param value value as stored in a table block
+  * @param size size of the value
+  * @param id row id
+  * @param delete if 0 the row id is added else it is removed
+  * @return EXIT_SUCCESS, EXIT_ERROR if no block is left
+ */
+static int AK_bitmap_change_row(char *indexName, bitmap_meta *meta, unsigned char *value, int size, unsigned int id,
+        int delete) {
+    bitmap_node node;
+    AK_bitmap *bitmap;
+    int page, previous, slot, next, result = EXIT_SUCCESS;
+
+    slot = AK_bitmap_lookup(meta, value, size, &page, &previous, &node);
+    if (slot == EXIT_ERROR) {
+        if (delete)
+            return EXIT_SUCCESS;
+        if (node.header.num_entries == BITMAP_PAGE_ENTRIES) {
+            next = AK_bitmap_alloc_page(indexName, meta);
+            if (next == EXIT_ERROR)
+                return EXIT_ERROR;
+            node.header.next = next;
+            AK_bitmap_write_node(page, &node);
+            previous = page;
+            page = next;
+            node.header.type = BITMAP_DIRECTORY;
+            node.header.num_entries = 0;
+            node.header.size = 0;
+            node.header.next = 0;
+        }
+        slot = node.header.num_entries;
+        memset(node.entry + slot, 0, sizeof (bitmap_entry));
+        node.entry[slot].first_page = AK_bitmap_new_chain(indexName, meta);
+        if (node.entry[slot].first_page == EXIT_ERROR) {
+            AK_bitmap_write_node(page, &node);
+            return EXIT_ERROR;
+        }
+        node.entry[slot].size = size;
+        memcpy(node.entry[slot].value, value, size);
+        node.header.num_entries++;
+        meta->num_values++;
+        bitmap = AK_bitmap_new();
+    } else {
+        bitmap = AK_bitmap_read(node.entry[slot].first_page);
+    }
+
+    if (AK_bitmap_change(bitmap, id, delete)) {
+        meta->num_rows += delete ? -1 : 1;
+        node.entry[slot].cardinality = AK_bitmap_cardinality(bitmap);
+        if (node.entry[slot].cardinality == 0) {
+            //the last entry of the page takes the place of the value, a directory page left empty is unlinked
+            AK_bitmap_free_chain(node.entry[slot].first_page, meta);
+            node.entry[slot] = node.entry[--node.header.num_entries];
+            meta->num_values--;
+            if (node.header.num_entries == 0 && previous != 0) {
+                next = node.header.next;
+                node.header.next = 0;
+                AK_bitmap_write_node(page, &node);
+                AK_bitmap_free_chain(page, meta);
+                AK_bitmap_read_node(previous, &node);
+                node.header.next = next;
+                page = previous;
             }
+        } else {
+            result = AK_bitmap_write(indexName, meta, node.entry[slot].first_page, bitmap);
         }
-        i++;
     }
+    AK_bitmap_write_node(page, &node);
+    AK_bitmap_free(bitmap);
+    return result;
+}
 
-    AK_free(addresses);
-    AK_free(temp);
-    // AK_free(t_header);
-    AK_EPI;
+/**
+  * @author Unknown
+  * @brief Function that gives the size of a searched value, varchar constants may hold their terminating zero
+  * @param value value
+  * @return size of the value as stored in a table block
+ */
+static int AK_bitmap_value_size(struct list_node *value) {
+    if (value->type == TYPE_VARCHAR)
+        return strnlen(value->data, value->size);
+    return value->size > 0 ? value->size : (int) AK_type_size(value->type, value->data);
 }
 
 /**
- * @author Saša Vukšić, Lovro Predovan
- * @brief Function that gets adresses of the particuliar attribute from bitmap index. It fetches addresses of indexes and header
-          of index table.  Using while loop it goes through index and gets necessary data. That data is put in a list called
-          add_root.
- * @param indexName name of index
- * @param attribute name of attribute
- * @return list of adresses
- **/
- list_ad* AK_get_attribute(char *indexName, char *attribute)
- {
-    int num_attr;
-    int i, j, k;
+  * @author Unknown
+  * @brief Function that reads a value of the indexed attribute from text, int values are numbers and other values
+  *        are the text itself
+  * @param meta meta data of the index
+  * @param text value written as text
+  * @param value set to the value as stored in a table block
+  * @return size of the value
+ */
+static int AK_bitmap_text_value(bitmap_meta *meta, char *text, unsigned char *value) {
+    int number, size;
+    if (meta->column_type == TYPE_INT) {
+        number = atoi(text);
+        memcpy(value, &number, sizeof (int));
+        return sizeof (int);
+    }
+    size = strnlen(text, MAX_VARCHAR_LENGTH);
+    memcpy(value, text, size);
+    return size;
+}
 
-    //start and end addresses of segment's
+/**
+  * @author Unknown
+  * @struct AK_bitmap_build
+  * @brief Value of the attribute with the bitmap of its rows, while an index is built in memory
+ */
+typedef struct {
+    bitmap_entry entry;
+    AK_bitmap *bitmap;
+} AK_bitmap_build;
+
+/**
+ * @author Unknown
+ * @brief Function that creates a bitmap index on an attribute of a table and adds every row of the table to it. The
+ *        bitmaps of all values are built in memory in one scan of the table, with the values found through a hash
+ *        table, and then written out once each. Rows with a NULL value are not indexed.
+ * @param tblName name of the table
+ * @param attribute name of the attribute
+ * @param indexName name of the index
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_bitmap_create(char *tblName, char *attribute, char *indexName) {
+    bitmap_meta meta;
+    bitmap_node node;
+    AK_header i_header[MAX_ATTRIBUTES];
+    AK_header *table_header, *temp;
     table_addresses *addresses;
-    AK_header *temp_head;
-    int temp_int;
-    char temp_char[ MAX_VARCHAR_LENGTH ];
-    float temp_float;
-    int b, br = 0;
-    int addBlock, indexTd;
-    list_ad *add_root;
+    AK_block *block;
+    AK_bitmap_build *values;
+    int *slots;
+    unsigned char *value;
+    int num_attr, position, startAddress, page, next, num_slots = 64, capacity = 16, num_values = 0;
+    int i, j, k, n, size, slot, result = EXIT_SUCCESS;
     AK_PRO;
 
+    num_attr = AK_num_attr(tblName);
+    table_header = (AK_header *) AK_get_header(tblName);
+    if (num_attr <= 0 || table_header == NULL) {
+        printf("Table %s does not exist!\n", tblName);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (position = 0; position < num_attr && strcmp(table_header[position].att_name, attribute) != 0; position++)
+        ;
+    if (position == num_attr || table_header[position].type == TYPE_BLOB) {
+        printf("Attribute %s of table %s can not be indexed!\n", attribute, tblName);
+        AK_free(table_header);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
     addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    num_attr = AK_num_index_attr(indexName);
-    temp_head = (AK_header *) AK_get_index_header(indexName);
-
-    add_root = (list_ad *) AK_malloc(sizeof (list_ad));
-    AK_InitializelistAd(add_root);
-
-    for (b = 0; b < num_attr; b++)
-    {
-        if (strcmp((temp_head + b)->att_name, attribute) == 0)
-        {
-            br = b;
-        }
+    n = addresses->address_from[0];
+    AK_free(addresses);
+    if (n != 0) {
+        printf("Index %s already exists!\n", indexName);
+        AK_free(table_header);
+        AK_EPI;
+        return EXIT_ERROR;
     }
-    AK_free(temp_head);
-    i = 0;
 
-    while (addresses->address_from[ i ] != 0)
-    {
+    memset(&meta, 0, sizeof (bitmap_meta));
+    meta.magic = BITMAP_MAGIC;
+    meta.column_type = table_header[position].type;
+    meta.column_position = position;
+    meta.num_attr = num_attr;
+    strncpy(meta.table, tblName, MAX_ATT_NAME - 1);
+    temp = (AK_header*) AK_create_header(table_header[position].att_name, table_header[position].type, FREE_INT,
+            FREE_CHAR, FREE_CHAR);
+    memcpy(i_header, temp, sizeof (AK_header));
+    memset(i_header + 1, 0, (MAX_ATTRIBUTES - 1) * sizeof (AK_header));
+    AK_free(temp);
+    AK_free(table_header);
 
-        for (j = addresses->address_from[ i ]; j < addresses->address_to[ i ]; j++)
-        {
+    //registered in AK_index, where the planner looks for indexes of the table
+    startAddress = AK_initialize_new_index_segment(indexName, AK_get_table_obj_id(tblName), position, i_header);
+    if (startAddress == EXIT_ERROR) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    printf("\nINDEX %s CREATED!\n", indexName);
+    meta.last_page = startAddress;
+    meta.directory = AK_bitmap_alloc_page(indexName, &meta);
+    if (meta.directory == EXIT_ERROR) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
 
-            AK_block *temp = (AK_block*) AK_read_block(j);
-            for (k = br; k < DATA_BLOCK_SIZE; k = k + num_attr)
-            {
-                if (temp->tuple_dict[ k ].size > 0)
-                {
-
-                    switch (temp->tuple_dict[ k ].type)
-                    {
-                        case TYPE_INT:
-                        memcpy(&temp_int, &(temp->data[ temp->tuple_dict[ k ].address]),
-                         temp->tuple_dict[k].size);
-                        break;
-                        case TYPE_FLOAT:
-                        memcpy(&temp_float, &(temp->data[ temp->tuple_dict[ k ].address]),
-                         temp->tuple_dict[k].size);
-                        printf("float: %-10.2f", temp_float);
+    values = (AK_bitmap_build *) AK_malloc(capacity * sizeof (AK_bitmap_build));
+    slots = (int *) AK_malloc(num_slots * sizeof (int));
+    memset(slots, -1, num_slots * sizeof (int));
+    addresses = (table_addresses*) AK_get_table_addresses(tblName);
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            block = AK_get_block(j)->block;
+            for (k = 0; k + num_attr <= DATA_BLOCK_SIZE && block->tuple_dict[k].type != FREE_INT; k += num_attr) {
+                //deleted rows and NULL values are not indexed
+                n = k + position;
+                if (block->tuple_dict[k].type == TYPE_INTERNAL || AK_IS_NULL(block, n)
+                        || block->tuple_dict[n].size > MAX_VARCHAR_LENGTH)
+                    continue;
+                value = block->data + block->tuple_dict[n].address;
+                size = block->tuple_dict[n].size;
+                for (slot = AK_hash_bytes(value, size) & (num_slots - 1); slots[slot] != -1; slot = (slot + 1) & (num_slots - 1)) {
+                    if (values[slots[slot]].entry.size == size && memcmp(values[slots[slot]].entry.value, value, size) == 0)
                         break;
+                }
+                if (slots[slot] == -1) {
+                    if (num_values == capacity) {
+                        capacity *= 2;
+                        values = (AK_bitmap_build *) AK_realloc(values, capacity * sizeof (AK_bitmap_build));
+                    }
+                    memset(&values[num_values].entry, 0, sizeof (bitmap_entry));
+                    values[num_values].entry.size = size;
+                    memcpy(values[num_values].entry.value, value, size);
+                    values[num_values].bitmap = AK_bitmap_new();
+                    slots[slot] = num_values++;
+                }
+                AK_bitmap_change(values[slots[slot]].bitmap, AK_bitmap_row_id(j, k, num_attr), 0);
+                //the hash table is kept at most half full
+                if (2 * num_values > num_slots) {
+                    num_slots *= 2;
+                    slots = (int *) AK_realloc(slots, num_slots * sizeof (int));
+                    memset(slots, -1, num_slots * sizeof (int));
+                    for (n = 0; n < num_values; n++) {
+                        for (slot = AK_hash_bytes(values[n].entry.value, values[n].entry.size) & (num_slots - 1);
+                                slots[slot] != -1; slot = (slot + 1) & (num_slots - 1))
+                            ;
+                        slots[slot] = n;
+                    }
+                }
+            }
+        }
+    }
+    AK_free(addresses);
+    AK_free(slots);
+
+    page = meta.directory;
+    node.header.type = BITMAP_DIRECTORY;
+    node.header.num_entries = 0;
+    node.header.size = 0;
+    node.header.next = 0;
+    for (n = 0; n < num_values; n++) {
+        if (result == EXIT_SUCCESS) {
+            values[n].entry.cardinality = AK_bitmap_cardinality(values[n].bitmap);
+            values[n].entry.first_page = AK_bitmap_new_chain(indexName, &meta);
+            result = values[n].entry.first_page == EXIT_ERROR ? EXIT_ERROR
+                    : AK_bitmap_write(indexName, &meta, values[n].entry.first_page, values[n].bitmap);
+        }
+        if (result == EXIT_SUCCESS && node.header.num_entries == BITMAP_PAGE_ENTRIES) {
+            next = AK_bitmap_alloc_page(indexName, &meta);
+            if (next == EXIT_ERROR) {
+                result = EXIT_ERROR;
+            } else {
+                node.header.next = next;
+                AK_bitmap_write_node(page, &node);
+                page = next;
+                node.header.num_entries = 0;
+                node.header.next = 0;
+            }
+        }
+        if (result == EXIT_SUCCESS) {
+            node.entry[node.header.num_entries++] = values[n].entry;
+            meta.num_values++;
+            meta.num_rows += values[n].entry.cardinality;
+        }
+        AK_bitmap_free(values[n].bitmap);
+    }
+    AK_bitmap_write_node(page, &node);
+    AK_free(values);
+    AK_bitmap_put_meta(startAddress, &meta);
+    AK_EPI;
+    return result;
+}
 
-                        case TYPE_VARCHAR:
-                        memcpy(temp_char, &(temp->data[ temp->tuple_dict[ k ].address]),
-                         temp->tuple_dict[k].size);
-
-                        memcpy(&addBlock, &(temp->data[ temp->tuple_dict[ k - br ].address]),
-                         temp->tuple_dict[0].size);
-
-                        memcpy(&indexTd, &(temp->data[ temp->tuple_dict[ k - (br - 1) ].address]),
-                         temp->tuple_dict[1].size);
+/**
+ * @author Unknown
+ * @brief Function that reads the bitmap of a value from a bitmap index. The rows of all values are the union of
+ *        the bitmaps in the directory.
+ * @param indexName name of index
+ * @param value value, NULL for the rows of all values
+ * @return new bitmap of the rows, NULL if there is no such index or the value is not of the type of the attribute
+ */
+AK_bitmap *AK_bitmap_index_get(char *indexName, struct list_node *value) {
+    bitmap_meta meta;
+    bitmap_node node;
+    AK_bitmap *bitmap, *part, *all;
+    int page, previous, slot, size;
+    AK_PRO;
+    if (AK_bitmap_get_meta(indexName, &meta) == EXIT_ERROR || (value != NULL && value->type != meta.column_type)) {
+        AK_EPI;
+        return NULL;
+    }
+    if (value == NULL) {
+        bitmap = AK_bitmap_new();
+        for (page = meta.directory; page != 0; page = node.header.next) {
+            AK_bitmap_read_node(page, &node);
+            for (slot = 0; slot < node.header.num_entries; slot++) {
+                part = AK_bitmap_read(node.entry[slot].first_page);
+                all = AK_bitmap_op(bitmap, part, BITMAP_OR);
+                AK_bitmap_free(part);
+                AK_bitmap_free(bitmap);
+                bitmap = all;
+            }
+        }
+        AK_EPI;
+        return bitmap;
+    }
+    size = AK_bitmap_value_size(value);
+    slot = size > MAX_VARCHAR_LENGTH ? EXIT_ERROR
+            : AK_bitmap_lookup(&meta, (unsigned char *) value->data, size, &page, &previous, &node);
+    bitmap = slot == EXIT_ERROR ? AK_bitmap_new() : AK_bitmap_read(node.entry[slot].first_page);
+    AK_EPI;
+    return bitmap;
+}
 
-                        temp_char[ temp->tuple_dict[k].size ] = '\0';
+/**
+ * @author Unknown
+ * @brief Function that searches a bitmap index for the rows with a value
+ * @param indexName name of index
+ * @param value value to search for
+ * @param rows set to an array of the addresses of the rows found
+ * @return number of rows found, EXIT_ERROR if there is no such index or the value is not of the type of the attribute
+ */
+int AK_bitmap_search(char *indexName, struct list_node *value, struct_add **rows) {
+    bitmap_meta meta;
+    AK_bitmap *bitmap;
+    int found;
+    AK_PRO;
+    *rows = NULL;
+    bitmap = AK_bitmap_index_get(indexName, value);
+    if (bitmap == NULL) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    AK_bitmap_get_meta(indexName, &meta);
+    found = AK_bitmap_rows(bitmap, meta.num_attr, rows);
+    AK_bitmap_free(bitmap);
+    AK_EPI;
+    return found;
+}
 
-                        if (strcmp(temp_char, "1") == 0)
-                        {             
-                            AK_Insert_NewelementAd(addBlock, indexTd, attribute, add_root);
-                        }
-                        break;
-                    }
-                    if ((k + 1) % num_attr == 0)
-                        printf("\n");
-                }
+/**
+ * @author Unknown
+ * @brief Function that prints the values of a bitmap index with the number of their rows and containers
+ * @param indexName name of index
+ * @return No return value
+ */
+void AK_bitmap_print(char *indexName) {
+    bitmap_meta meta;
+    bitmap_node node;
+    AK_bitmap *bitmap;
+    int page, slot, number;
+    char text[MAX_VARCHAR_LENGTH + 1];
+    AK_PRO;
+    if (AK_bitmap_get_meta(indexName, &meta) == EXIT_ERROR) {
+        printf("Bitmap index %s does not exist!\n", indexName);
+        AK_EPI;
+        return;
+    }
+    printf("Bitmap index %s on table %s: %d values, %d rows, %d pages\n", indexName, meta.table, meta.num_values,
+            meta.num_rows, meta.num_pages);
+    for (page = meta.directory; page != 0; page = node.header.next) {
+        AK_bitmap_read_node(page, &node);
+        for (slot = 0; slot < node.header.num_entries; slot++) {
+            if (meta.column_type == TYPE_INT) {
+                memcpy(&number, node.entry[slot].value, sizeof (int));
+                sprintf(text, "%d", number);
+            } else if (meta.column_type == TYPE_VARCHAR) {
+                memcpy(text, node.entry[slot].value, node.entry[slot].size);
+                text[node.entry[slot].size] = '\0';
+            } else {
+                sprintf(text, "(%d bytes)", node.entry[slot].size);
             }
+            bitmap = AK_bitmap_read(node.entry[slot].first_page);
+            printf("%-30s rows: %-8d containers: %d\n", text, node.entry[slot].cardinality, bitmap->num_containers);
+            AK_bitmap_free(bitmap);
         }
-        i++;
     }
     AK_EPI;
-    return add_root;
-    AK_free(add_root);
 }
 
+/**
+ * @author Saša Vukšić, Lovro Predovan, updated by Unknown (compressed bitmaps)
+ * @brief Function that creates a bitmap index, named by the table, the attribute and "_bmapIndex", on every
+ *        attribute of the list that the table has
+ * @param tblName name of table
+ * @param attributes list of attributes on which we will create indexes
+ * @return No return value
+ * */
+void AK_create_Index_Table(char *tblName, struct list_node *attributes) {
+    struct list_node *some_element;
+    char indexName[MAX_ATT_NAME];
+    AK_PRO;
+    for (some_element = (struct list_node *) AK_First_L2(attributes); some_element != 0;
+            some_element = (struct list_node *) AK_Next_L2(some_element)) {
+        if (strlen(tblName) + strlen(some_element->attribute_name) + strlen("_bmapIndex") >= MAX_ATT_NAME)
+            continue;
+        sprintf(indexName, "%s%s_bmapIndex", tblName, some_element->attribute_name);
+        AK_bitmap_create(tblName, some_element->attribute_name, indexName);
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Saša Vukšić, Lovro Predovan, updated by Unknown (compressed bitmaps)
+ * @brief Function that gets adresses of the rows with a value from bitmap index
+ * @param indexName name of index
+ * @param attribute value written as text
+ * @return list of adresses
+ **/
+list_ad* AK_get_attribute(char *indexName, char *attribute) {
+    bitmap_meta meta;
+    bitmap_node node;
+    AK_bitmap *bitmap;
+    struct_add *rows;
+    unsigned char value[MAX_VARCHAR_LENGTH];
+    list_ad *add_root;
+    int page, previous, slot, size, found, i;
+    AK_PRO;
+
+    add_root = (list_ad *) AK_malloc(sizeof (list_ad));
+    AK_InitializelistAd(add_root);
+    if (AK_bitmap_get_meta(indexName, &meta) == EXIT_ERROR) {
+        AK_EPI;
+        return add_root;
+    }
+    size = AK_bitmap_text_value(&meta, attribute, value);
+    slot = AK_bitmap_lookup(&meta, value, size, &page, &previous, &node);
+    if (slot != EXIT_ERROR) {
+        bitmap = AK_bitmap_read(node.entry[slot].first_page);
+        found = AK_bitmap_rows(bitmap, meta.num_attr, &rows);
+        for (i = 0; i < found; i++)
+            AK_Insert_NewelementAd(rows[i].addBlock, rows[i].indexTd, attribute, add_root);
+        AK_free(rows);
+        AK_bitmap_free(bitmap);
+    }
+    AK_EPI;
+    return add_root;
+}
 
 /**
  * @author Saša Vukšić, Lovro Predovan
@@ -473,33 +1357,25 @@
 }
 
 /**
- * @author Saša Vukšić
+ * @author Saša Vukšić, updated by Unknown (compressed bitmaps)
  * @brief Function that fetches the values from the bitmap index if there is one for a given table.
  * It should be started when we are making selection on the table with bitmap index.
  * @param tableName name of table
  * @param attributeValue value of attribute
  * @return list of adresses
  **/
- list_ad* AK_get_Attribute(char *tableName, char *attributeName, char *attributeValue)
- {
+list_ad* AK_get_Attribute(char *tableName, char *attributeName, char *attributeValue) {
     list_ad *list;
-    char inde[50];
-    char *indexName;
+    char indexName[MAX_ATT_NAME];
+    bitmap_meta meta;
     AK_PRO;
 
-    list = (list_ad *) AK_malloc(sizeof (list_ad));
-    AK_InitializelistAd(list);
-    strcpy(inde, tableName);
-    indexName = strcat(inde, attributeName);
-    indexName = strcat(indexName, "_bmapIndex");
-
-    table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    if (addresses->address_from[ 0 ] == 0)
-    {
+    snprintf(indexName, MAX_ATT_NAME, "%s%s_bmapIndex", tableName, attributeName);
+    if (AK_bitmap_get_meta(indexName, &meta) == EXIT_ERROR) {
         printf("There is no index for table: %s on attribute: %s", tableName, attributeName);
-    }
-    else
-    {
+        list = (list_ad *) AK_malloc(sizeof (list_ad));
+        AK_InitializelistAd(list);
+    } else {
         list = AK_get_attribute(indexName, attributeValue);
     }
     AK_EPI;
@@ -507,9 +1383,9 @@
 }
 
 /**
- * @author Saša Vukšić
- * @brief Function that updates the index, only on values that alredy exist. 
- * If there is no value in bitmap index or bitmap index on this value, warning is showed to the user. Otherwise, bitmap index is updated with new attribute value.
+ * @author Saša Vukšić, updated by Unknown (compressed bitmaps)
+ * @brief Function that moves a row of the index from the bitmap of one value to the bitmap of another. The new
+ *        value gets a bitmap of its own if it had none.
  * @param addBlock adress of block
  * @param addTD adress of tuple dict
  * @param tableName name of table
@@ -518,98 +1394,30 @@
  * @param newAttributeValue new value of updated attribute
  * @return No return value
  **/
- void AK_update(int addBlock, int addTd, char *tableName, char *attributeName, char *attributeValue, char *newAttributeValue)
- {
-    char inde[50];
-    char *indexName;
-    int b, num_attr, k, j;
-    int i = 0;
-    int temp_adr_block;
-    int temp_adr_Td;
-    int pos;
-    int posNew = -1;
+void AK_update(int addBlock, int addTd, char *tableName, char *attributeName, char *attributeValue, char *newAttributeValue) {
+    char indexName[MAX_ATT_NAME];
+    unsigned char value[MAX_VARCHAR_LENGTH];
+    bitmap_meta meta;
+    unsigned int id;
+    int address, size;
     AK_PRO;
-    strcpy(inde, tableName);
-    indexName = strcat(inde, attributeName);
-    indexName = strcat(indexName, "_bmapIndex");
-
-    AK_header *temp_head = AK_get_index_header(indexName);
-    num_attr = AK_num_index_attr(indexName);
-
-    for (i = 0; i < num_attr; i++)
-    {
-        if (strcmp((temp_head + i)->att_name, attributeValue) == 0)
-        {
-            pos = i;
-        }
-    }
-
-    i = 0;
-    for (i = 0; i < num_attr; i++)
-    {
-            if (strcmp((temp_head + i)->att_name, attributeValue) == 0)
-            {
-                posNew = i;
-            }
-        }
 
-        if (posNew == -1)
-        {
-            printf("Update is posible ONLY for existing values! \n");
-            AK_EPI;
-            exit(1);
-        }
-
-        table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
-        if (addresses->address_from[ 0 ] == 0)
-        {
-            printf("There is no index for table : %s on attribute: %s", tableName, attributeName);
-        }
-        else
-        {
-            for (b = 0; b < num_attr; b++)
-            {
-                if (strcmp((temp_head + b)->att_name, attributeValue) == 0)
-                {
-                    i = 0;
-                    while (addresses->address_from[ i ] != 0)
-                    {
-                        for (j = addresses->address_from[ i ]; j < addresses->address_to[ i ]; j++)
-                        {
-                            AK_block *temp = (AK_block*) AK_read_block(j);
-
-                            for (k = 0; k < DATA_BLOCK_SIZE; k = k + num_attr)
-                            {
-                                if (temp->tuple_dict[ k ].size > 0)
-                                {
-                                    memcpy(&temp_adr_block, &(temp->data[ temp->tuple_dict[ k ].address]), temp->tuple_dict[k].size);
-                                    memcpy(&temp_adr_Td, &(temp->data[ temp->tuple_dict[ k + 1 ].address]), temp->tuple_dict[k + 1].size);
-                                    printf("%i vs.%i, %i vs %i\n",temp_adr_block,addBlock,temp_adr_Td,addTd);
-
-                                    if ((temp_adr_block == addBlock) && (temp_adr_Td == addTd))
-                                    {
-                                        printf( "Block address: %d, Td address: %d segment:%i \n", temp_adr_block, temp_adr_Td, temp->address );
-
-                                        memcpy(&(temp->data[ temp->tuple_dict[ k + pos ].address]), "n", 1);
-                                        memset(&(temp->data[ temp->tuple_dict[ k + posNew ].address]), 0, 4);
-                                        memcpy(&(temp->data[ temp->tuple_dict[ k + posNew ].address]), "1", 1);                                
-                                        
-					AK_PRO;
-
-                                        AK_write_block(temp);
-                                    }
-                                }
-                            }
-
-                        }
-                        i++;
-                    }
-                }
-            }
-        }
-        printf("Index %s updated for %s table\n",indexName,tableName);
+    snprintf(indexName, MAX_ATT_NAME, "%s%s_bmapIndex", tableName, attributeName);
+    address = AK_bitmap_get_meta(indexName, &meta);
+    if (address == EXIT_ERROR) {
+        printf("There is no index for table : %s on attribute: %s", tableName, attributeName);
         AK_EPI;
+        return;
     }
+    id = AK_bitmap_row_id(addBlock, addTd, meta.num_attr);
+    size = AK_bitmap_text_value(&meta, attributeValue, value);
+    AK_bitmap_change_row(indexName, &meta, value, size, id, 1);
+    size = AK_bitmap_text_value(&meta, newAttributeValue, value);
+    AK_bitmap_change_row(indexName, &meta, value, size, id, 0);
+    AK_bitmap_put_meta(address, &meta);
+    printf("Index %s updated for %s table\n", indexName, tableName);
+    AK_EPI;
+}
 
 /**
  * @author Saša Vukšić
@@ -653,41 +1461,68 @@
     }
     }*/
 
-
 /**
- * @author Lovro Predovan
- * @brief Function that updates the index. Function deletes and recreates the index values again if different number of params is detected 
+ * @author Lovro Predovan, updated by Unknown (compressed bitmaps)
+ * @brief Function that updates the index. Function deletes and recreates the index if the table has rows that are
+ *        not in it, or creates it if there is none.
  * @param tableName name of table
  * @param attributeName name of attribute
- * @param newAttributeValue new value of updated attribute
  * @return No return value
  **/
- void AK_add_to_bitmap_index(char *tableName, char *attributeName)
- {
-    char inde[50];
-    char *tblNameIndex;
-    int tbl_num_rows, idx_num_rows;
-
+void AK_add_to_bitmap_index(char *tableName, char *attributeName) {
+    char indexName[MAX_ATT_NAME];
+    bitmap_meta meta;
+    int address;
     AK_PRO;
-    strcpy(inde, tableName);
-    tblNameIndex = strcat(inde, attributeName);
-    tblNameIndex = strcat(tblNameIndex, "_bmapIndex");
-
-    idx_num_rows = AK_get_index_num_records(tblNameIndex);
-    tbl_num_rows = AK_get_num_records(tableName);
-
-    //This may not be the best method but it's damn effective one
-    if(tbl_num_rows > idx_num_rows){
-        AK_delete_bitmap_index(tblNameIndex);
-        struct list_node *att_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
-        AK_Init_L3(&att_root);
-        AK_Insert_New_Element(TYPE_VARCHAR, attributeName, tableName, attributeName, att_root);
-        AK_create_Index_Table(tableName, att_root);
-    }
-    printf("Index %s updated for %s table\n",tblNameIndex,tableName);
+
+    snprintf(indexName, MAX_ATT_NAME, "%s%s_bmapIndex", tableName, attributeName);
+    address = AK_bitmap_get_meta(indexName, &meta);
+    if (address == EXIT_ERROR || AK_get_num_records(tableName) > meta.num_rows) {
+        if (address != EXIT_ERROR)
+            AK_delete_bitmap_index(indexName);
+        AK_bitmap_create(tableName, attributeName, indexName);
+    }
+    printf("Index %s updated for %s table\n", indexName, tableName);
     AK_EPI;
 }
 
+/**
+ * @author Unknown
+ * @brief Function that adds a row of the indexed table to the bitmap index or removes it. Only the bitmap of the
+ *        value of the row is read and written.
+ * @param indexName name of index
+ * @param attribute position of the indexed attribute in the table
+ * @param block block of the table the row is in
+ * @param row tuple_dict index of the first attribute of the row
+ * @param delete if 0 the row is added else it is removed
+ * @return EXIT_SUCCESS, EXIT_ERROR if there is no such index or no page is left
+ **/
+int AK_bitmap_index_row(char *indexName, int attribute, AK_block *block, int row, int delete) {
+    unsigned char value[MAX_VARCHAR_LENGTH];
+    bitmap_meta meta;
+    unsigned int id;
+    int address, size, n = row + attribute, table_block = block->address, result;
+    AK_PRO;
+
+    //NULLs are not indexed
+    if (AK_IS_NULL(block, n) || block->tuple_dict[n].size > MAX_VARCHAR_LENGTH) {
+        AK_EPI;
+        return EXIT_SUCCESS;
+    }
+    //the value is copied first, reading the index may take the block out of the cache
+    size = block->tuple_dict[n].size;
+    memcpy(value, block->data + block->tuple_dict[n].address, size);
+    address = AK_bitmap_get_meta(indexName, &meta);
+    if (address == EXIT_ERROR) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    id = AK_bitmap_row_id(table_block, row, meta.num_attr);
+    result = AK_bitmap_change_row(indexName, &meta, value, size, id, delete);
+    AK_bitmap_put_meta(address, &meta);
+    AK_EPI;
+    return result;
+}
 
 /**
  * @author Saša Vukšić
@@ -725,20 +1560,53 @@
     AK_EPI;
 }
 
+static int bitmap_test_run_count = 0;
 
+/**
+ * @author Unknown
+ * @brief Function that counts the rows of a value in a bitmap index for the test
+ * @param indexName name of index
+ * @param type type of the value
+ * @param value value, NULL for the rows of all values
+ * @return number of rows, EXIT_ERROR if the index could not be read
+ */
+static int AK_bitmap_test_count(char *indexName, int type, void *value) {
+    struct list_node *values = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_bitmap *bitmap;
+    int count = EXIT_ERROR;
+    AK_Init_L3(&values);
+    if (value != NULL)
+        AK_InsertAtEnd_L3(type, value, type == TYPE_INT ? sizeof (int) : strlen(value), values);
+    bitmap = AK_bitmap_index_get(indexName, value != NULL ? (struct list_node *) AK_First_L2(values) : NULL);
+    if (bitmap != NULL) {
+        count = AK_bitmap_cardinality(bitmap);
+        AK_bitmap_free(bitmap);
+    }
+    AK_DeleteAll_L3(&values);
+    AK_free(values);
+    return count;
+}
 
 /**
- * @author Saša Vukšić updated by Lovro Predovan
+ * @author Saša Vukšić updated by Lovro Predovan, updated by Unknown (compressed bitmaps)
  * @brief Function that creates test table and makes index on test table,
-    also prints original tables indexes tables and indexes, tests updating into tables
+    also prints original tables indexes tables and indexes, tests updating into tables.
+    It then tests the operations on bitmaps, the indexes of a larger table, predicates over two indexes and the
+    upkeep of the indexes on insert, update and delete.
  * @return No return value
  * */
- TestResult AK_bitmap_test()
- {
+TestResult AK_bitmap_test() {
     int id_prof;
+    int passedTest = 0;
+    int failedTest = 0;
+    char *colors[3] = {"red", "green", "blue"};
+    char table[MAX_ATT_NAME], color_index[MAX_ATT_NAME], size_index[MAX_ATT_NAME];
+    AK_bitmap *a, *b, *c, *red, *blue, *size3, *all;
+    AK_segment_writer writer;
+    AK_sort_row load_row;
+    bitmap_meta meta;
+    int i, n, ok, expected, color_size, not_red;
     struct list_node *row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
-
-
     AK_PRO;
     printf("\n********** BITMAP INDEX TEST **********\n\n");
 
@@ -748,69 +1616,222 @@
     //CREATING BITMAP INDEXES ON ATTRIBUTES FIRSTNAME AND TEL
     struct list_node *att_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
     AK_Init_L3(&att_root);
-    //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_VARCHAR, "firstname", tblName, "firstname", att_root);
-    
-
     struct list_node *some_element;
     some_element = (struct list_node *) AK_First_L2(att_root);
-    //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_VARCHAR, "tel", tblName, "tel", some_element);
     AK_create_Index_Table(tblName, att_root);
 
-
     AK_print_table(tblName);
     AK_print_table("AK_index");
 
     printf("\n************Index tables******************\n\n");
-    AK_print_index_table("assistantfirstname_bmapIndex");
-    AK_print_index_table("assistanttel_bmapIndex");
+    AK_bitmap_print("assistantfirstname_bmapIndex");
+    AK_bitmap_print("assistanttel_bmapIndex");
 
     printf("Bitmap index tables should be now visible\n");
 
-
     //Test value that doesn't passes
     printf("\n\n************Printing non existing index table******************\n\n");
-    AK_print_index_table("assistanrandom_bmapIndex");
+    AK_bitmap_print("assistanrandom_bmapIndex");
     printf("\n\n***************************************\n\n");
 
-
     printf("\n\n************Updating table indexes******************\n\n");
     AK_Init_L3(&row_root);
     id_prof = 35890;
     AK_DeleteAll_L3(&row_root);
     AK_Insert_New_Element(TYPE_INT, &id_prof, tblName, "id_prof", row_root);
-    //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_VARCHAR, "Miran", tblName, "firstname", row_root);
-        //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_VARCHAR, "Zlatović", tblName, "lastname", row_root);
-        //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_INT, "042390858", tblName, "tel", row_root);
-        //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_VARCHAR, "miran.zlatovic@foi.hr", tblName, "email", row_root);
-        //Error: argument of type "const char *" is incompatible with parameter of type "void *"
     AK_Insert_New_Element(TYPE_VARCHAR, "www.foi.hr/nastavnici/zlatovic.miran/index.html", tblName, "web_page", row_root);
     AK_insert_row(row_root);
     AK_DeleteAll_L3(&row_root);
-    AK_free(row_root);
 
     AK_add_to_bitmap_index(tblName, "firstname");
 
     AK_print_table(tblName);
-    AK_print_index_table("assistantfirstname_bmapIndex");
-    
+    AK_bitmap_print("assistantfirstname_bmapIndex");
+
     printf("\n\n************Searching index locations******************\n\n");
     AK_print_Att_Test(AK_get_Attribute(tblName,"firstname","Markus"));
     AK_print_Att_Test(AK_get_Attribute(tblName,"tel","858928176"));
-    
-     printf("\n\n************Deleting bitmap index******************\n\n");
+
+    printf("\n\n************Deleting bitmap index******************\n\n");
     AK_delete_bitmap_index("assistantfirstname_bmapIndex");
 
     AK_print_table("AK_index");
 
+    /* 1: operations on bitmaps with sparse and dense containers */
+    printf("\nBitmap operations test\n");
+    a = AK_bitmap_new();
+    b = AK_bitmap_new();
+    for (i = 0; i < 20000; i++) {
+        if (i % 2 == 0)
+            AK_bitmap_add(a, i);
+        if (i % 3 == 0)
+            AK_bitmap_add(b, i);
+    }
+    for (i = 70000; i < 70010; i++)
+        AK_bitmap_add(a, i);
+    for (i = 70005; i < 70020; i++)
+        AK_bitmap_add(b, i);
+    ok = a->num_containers == 2 && a->containers[0].words != NULL && a->containers[1].words == NULL
+            && AK_bitmap_cardinality(a) == 10010 && AK_bitmap_contains(a, 70009) && !AK_bitmap_contains(a, 70010);
+    c = AK_bitmap_and(a, b);
+    ok = ok && AK_bitmap_cardinality(c) == 3339;
+    AK_bitmap_free(c);
+    c = AK_bitmap_or(a, b);
+    ok = ok && AK_bitmap_cardinality(c) == 13353;
+    AK_bitmap_free(c);
+    c = AK_bitmap_andnot(a, b);
+    ok = ok && AK_bitmap_cardinality(c) == 6671 && AK_bitmap_contains(c, 2) && !AK_bitmap_contains(c, 6);
+    AK_bitmap_free(c);
+    // below BITMAP_ARRAY_MAX rows the container of a is sparse again
+    for (i = 4000; i < 20000; i += 2)
+        AK_bitmap_remove(a, i);
+    ok = ok && a->containers[0].words == NULL && AK_bitmap_cardinality(a) == 2010 && !AK_bitmap_remove(a, 4000);
+    printf("Containers of a:%d, Rows of a:%d\n", a->num_containers, AK_bitmap_cardinality(a));
+    AK_bitmap_free(a);
+    AK_bitmap_free(b);
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
+    }
+
+    /* 2: indexes on two attributes of a larger table, created in one scan */
+    printf("\nBitmap index create test\n");
+    AK_header header[4] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "color", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_INT, "size", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+    sprintf(table, "bitmap_test_%d", bitmap_test_run_count++);
+    sprintf(color_index, "%scolor_bmapIndex", table);
+    sprintf(size_index, "%ssize_bmapIndex", table);
+    memset(&load_row, 0, sizeof (AK_sort_row));
+    load_row.type[0] = load_row.type[2] = TYPE_INT;
+    load_row.type[1] = TYPE_VARCHAR;
+    load_row.size[0] = load_row.size[2] = sizeof (int);
+    load_row.data[0] = (unsigned char *) &i;
+    load_row.data[2] = (unsigned char *) &n;
+    ok = AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, header) != EXIT_ERROR
+            && AK_segment_writer_open(&writer, table, SEGMENT_TYPE_TABLE, 3) == EXIT_SUCCESS;
+    for (i = 0; ok && i < 3000; i++) {
+        n = i % 7;
+        load_row.data[1] = (unsigned char *) colors[i % 3];
+        load_row.size[1] = strlen(colors[i % 3]);
+        ok = AK_segment_writer_put(&writer, &load_row) == EXIT_SUCCESS;
+    }
+    AK_segment_writer_close(&writer);
+    AK_DeleteAll_L3(&att_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "color", table, "color", att_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "size", table, "size", AK_End_L2(att_root));
+    AK_create_Index_Table(table, att_root);
+    AK_bitmap_print(color_index);
+    n = 3;
+    ok = ok && AK_index_kind(color_index) == INDEX_KIND_BITMAP && AK_index_kind(size_index) == INDEX_KIND_BITMAP
+            && AK_bitmap_test_count(color_index, TYPE_VARCHAR, "red") == 1000
+            && AK_bitmap_test_count(color_index, TYPE_VARCHAR, "purple") == 0
+            && AK_bitmap_test_count(size_index, TYPE_INT, &n) == 429
+            && AK_bitmap_test_count(size_index, TYPE_INT, NULL) == 3000
+            && AK_bitmap_test_count(color_index, TYPE_INT, &n) == EXIT_ERROR;
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
+    }
+
+    /* 3: (color = 'red' AND size = 3) OR color = 'blue', and color <> 'red', combined from the bitmaps */
+    printf("\nBitmap index predicate test\n");
+    for (i = 0, color_size = 0, not_red = 0; i < 3000; i++) {
+        if ((i % 3 == 0 && i % 7 == 3) || i % 3 == 2)
+            color_size++;
+        if (i % 3 != 0)
+            not_red++;
+    }
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "red", 3, row_root);
+    red = AK_bitmap_index_get(color_index, AK_First_L2(row_root));
+    AK_DeleteAll_L3(&row_root);
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "blue", 4, row_root);
+    blue = AK_bitmap_index_get(color_index, AK_First_L2(row_root));
+    AK_DeleteAll_L3(&row_root);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &n, sizeof (int), row_root);
+    size3 = AK_bitmap_index_get(size_index, AK_First_L2(row_root));
+    AK_DeleteAll_L3(&row_root);
+    a = AK_bitmap_and(red, size3);
+    b = AK_bitmap_or(a, blue);
+    all = AK_bitmap_index_get(color_index, NULL);
+    c = AK_bitmap_andnot(all, red);
+    printf("Rows:%d, Rows not red:%d\n", AK_bitmap_cardinality(b), AK_bitmap_cardinality(c));
+    ok = AK_bitmap_cardinality(b) == color_size && AK_bitmap_cardinality(c) == not_red;
+    AK_bitmap_free(a);
+    AK_bitmap_free(b);
+    AK_bitmap_free(c);
+    AK_bitmap_free(all);
+    AK_bitmap_free(red);
+    AK_bitmap_free(blue);
+    AK_bitmap_free(size3);
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
+    }
+
+    /* 4: inserted, updated and deleted rows change only the bitmaps of their values */
+    printf("\nBitmap index maintenance test\n");
+    i = 3000;
+    AK_Insert_New_Element(TYPE_INT, &i, table, "id", row_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "purple", table, "color", row_root);
+    AK_Insert_New_Element(TYPE_INT, &n, table, "size", row_root);
+    AK_insert_row(row_root);
+    AK_DeleteAll_L3(&row_root);
+    ok = AK_bitmap_test_count(color_index, TYPE_VARCHAR, "purple") == 1
+            && AK_bitmap_test_count(size_index, TYPE_INT, &n) == 430
+            && AK_bitmap_get_meta(color_index, &meta) != EXIT_ERROR && meta.num_values == 4 && meta.num_rows == 3001;
+    // rows are found by comparing the bytes of the value, 1000 has none in common with the other columns
+    i = 1000;
+    AK_Update_Existing_Element(TYPE_INT, &i, table, "id", row_root);
+    AK_Insert_New_Element(TYPE_VARCHAR, "purple", table, "color", row_root);
+    AK_update_row(row_root);
+    AK_DeleteAll_L3(&row_root);
+    ok = ok && AK_bitmap_test_count(color_index, TYPE_VARCHAR, "purple") == 2
+            && AK_bitmap_test_count(color_index, TYPE_VARCHAR, "green") == 999;
+    for (i = 1000; i <= 3000; i += 2000) {
+        AK_Update_Existing_Element(TYPE_INT, &i, table, "id", row_root);
+        AK_delete_row(row_root);
+        AK_DeleteAll_L3(&row_root);
+    }
+    // the value without rows leaves the directory
+    ok = ok && AK_bitmap_test_count(color_index, TYPE_VARCHAR, "purple") == 0
+            && AK_bitmap_test_count(size_index, TYPE_INT, &n) == 429
+            && AK_bitmap_get_meta(color_index, &meta) != EXIT_ERROR && meta.num_values == 3 && meta.num_rows == 2999;
+    AK_bitmap_print(color_index);
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
+    }
+
+    AK_delete_bitmap_index(color_index);
+    AK_delete_bitmap_index(size_index);
+    AK_delete_segment(table, SEGMENT_TYPE_TABLE);
+    AK_DeleteAll_L3(&att_root);
+    AK_free(att_root);
+    AK_free(row_root);
 
     printf("\n\n********** BITMAP INDEX TEST END**********\n\n");
-    printf("\n\n BITMAP INDEX TEST PASSED\n\n");
     AK_EPI;
-    return TEST_result(0,0);
+    return TEST_result(passedTest, failedTest);
 }
@@ -28,7 +28,145 @@
 #include "../../file/files.h"
 #include "../../auxi/mempro.h"
 #include "../../auxi/constants.h"
+#include "../../auxi/comparator.h"
 
+/**
+ * @def BITMAP_PAGE_SIZE
+ * @brief size of a page of a bitmap index, every page is the data of one block of the index segment
+ */
+#define BITMAP_PAGE_SIZE (DATA_BLOCK_SIZE * DATA_ENTRY_SIZE)
+/**
+ * @def BITMAP_CONTAINER_WORDS
+ * @brief number of 64 bit words of a dense container, one bit for each of the 65536 row ids with the same high
+ *        16 bits
+ */
+#define BITMAP_CONTAINER_WORDS 1024
+/**
+ * @def BITMAP_ARRAY_MAX
+ * @brief largest number of rows of a sparse container. Up to here a sorted array of the low 16 bits of the row ids
+ *        is smaller than the words of a dense container.
+ */
+#define BITMAP_ARRAY_MAX 4096
+/**
+ * @def BITMAP_MAGIC
+ * @brief marks the first block of a bitmap index segment
+ */
+#define BITMAP_MAGIC 0x424D4150
+
+//types for tuple_dict
+#define BITMAP_META 0
+#define BITMAP_DIRECTORY 1
+#define BITMAP_WORDS 2
+#define BITMAP_FREE_PAGE 3
+
+/**
+  * @author Unknown
+  * @struct AK_bitmap_container
+  * @brief Rows of a bitmap whose row ids have the same high 16 bits. A container of up to BITMAP_ARRAY_MAX rows is
+  *        sparse and keeps the low 16 bits of the row ids in order, a larger one is dense and keeps a bit for
+  *        every row id.
+ */
+typedef struct {
+    /// high 16 bits of the row ids
+    int key;
+    /// number of rows
+    int cardinality;
+    /// low 16 bits of the row ids of a sparse container in order, NULL in a dense container
+    unsigned short *values;
+    /// BITMAP_CONTAINER_WORDS words of a dense container, NULL in a sparse container
+    uint64_t *words;
+} AK_bitmap_container;
+
+/**
+  * @author Unknown
+  * @struct AK_bitmap
+  * @brief Compressed bitmap of row ids in the style of Roaring bitmaps, the containers of the row ids that are set
+  *        ordered by key
+ */
+typedef struct {
+    /// number of containers
+    int num_containers;
+    /// number of containers there is room for
+    int capacity;
+    /// containers
+    AK_bitmap_container *containers;
+} AK_bitmap;
+
+/**
+  * @author Unknown
+  * @struct bitmap_meta
+  * @brief Structure stored in the first block of a bitmap index segment. The index keeps one compressed bitmap of
+  *        the rows of every value of the attribute. The directory pages list the values with the first page of
+  *        their bitmaps, a bitmap is serialized into a chain of pages.
+ */
+typedef struct {
+    /// BITMAP_MAGIC
+    int magic;
+    /// type of the indexed attribute
+    int column_type;
+    /// position of the indexed attribute in the table
+    int column_position;
+    /// number of attributes of the table, row ids are numbered by it
+    int num_attr;
+    /// number of values in the directory
+    int num_values;
+    /// number of rows in the bitmaps
+    int num_rows;
+    /// number of pages in use
+    int num_pages;
+    /// block of the page allocated last
+    int last_page;
+    /// first page of the list of freed pages, 0 if the list is empty
+    int free_page;
+    /// first directory page
+    int directory;
+    /// indexed table
+    char table[MAX_ATT_NAME];
+} bitmap_meta;
+
+/**
+  * @author Unknown
+  * @struct bitmap_page
+  * @brief Header at the start of a page of a bitmap index. A directory page is followed by num_entries
+  *        bitmap_entry entries, a bitmap page by size bytes of a serialized bitmap.
+ */
+typedef struct {
+    /// BITMAP_DIRECTORY, BITMAP_WORDS or BITMAP_FREE_PAGE
+    int type;
+    /// number of entries of a directory page
+    int num_entries;
+    /// number of bytes of a bitmap page
+    int size;
+    /// next page of the chain, next free page of a free page, 0 if there is none
+    int next;
+} bitmap_page;
+
+/**
+  * @author Unknown
+  * @struct bitmap_entry
+  * @brief Entry of a directory page, a value of the attribute as stored in a table block
+ */
+typedef struct {
+    /// size of the value
+    int size;
+    /// first page of the bitmap of the value
+    int first_page;
+    /// number of rows with the value
+    int cardinality;
+    /// value
+    unsigned char value[MAX_VARCHAR_LENGTH];
+} bitmap_entry;
+
+/**
+ * @def BITMAP_PAGE_ENTRIES
+ * @brief number of entries that fit into a directory page
+ */
+#define BITMAP_PAGE_ENTRIES ((int) ((BITMAP_PAGE_SIZE - sizeof (bitmap_page)) / sizeof (bitmap_entry)))
+/**
+ * @def BITMAP_PAGE_BYTES
+ * @brief number of bytes of a serialized bitmap that fit into a bitmap page
+ */
+#define BITMAP_PAGE_BYTES ((int) (BITMAP_PAGE_SIZE - sizeof (bitmap_page)))
 
 /**
   @author Saša Vukšić
@@ -40,11 +178,145 @@
 int AK_If_ExistOp(struct list_node *L, char *ele);
 
 /**
- * @author Saša Vukšić, Lovro Predovan
- * @brief Function that reads table on which we create index and call functions for creating index
-           Elements that will be in index are put in list indexLista and headerAttributes. According to those elements new indexes
-           are created.
+ * @author Unknown
+ * @brief Function that creates an empty bitmap
+ * @return bitmap
+ */
+AK_bitmap *AK_bitmap_new();
+
+/**
+ * @author Unknown
+ * @brief Function that frees a bitmap
+ * @param bitmap bitmap
+ */
+void AK_bitmap_free(AK_bitmap *bitmap);
+
+/**
+ * @author Unknown
+ * @brief Function that gives the row id of a row. Rows are numbered by block, every block has a number for each row
+ *        that fits into it, so the bitmaps of all indexes of a table number the rows in the same way.
+ * @param block block of the table the row is in
+ * @param row tuple_dict index of the first attribute of the row
+ * @param num_attr number of attributes of the table
+ * @return row id
+ */
+static AK_INLINE unsigned int AK_bitmap_row_id(int block, int row, int num_attr) {
+    return (unsigned int) block * (DATA_BLOCK_SIZE / num_attr) + row / num_attr;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds a row id to a bitmap
+ * @param bitmap bitmap
+ * @param id row id
+ * @return 1 if the row id was added, 0 if it was in the bitmap
+ */
+int AK_bitmap_add(AK_bitmap *bitmap, unsigned int id);
+
+/**
+ * @author Unknown
+ * @brief Function that removes a row id from a bitmap
+ * @param bitmap bitmap
+ * @param id row id
+ * @return 1 if the row id was removed, 0 if it was not in the bitmap
+ */
+int AK_bitmap_remove(AK_bitmap *bitmap, unsigned int id);
+
+/**
+ * @author Unknown
+ * @brief Function that checks if a row id is in a bitmap
+ * @param bitmap bitmap
+ * @param id row id
+ * @return 1 if the row id is in the bitmap, otherwise 0
+ */
+int AK_bitmap_contains(AK_bitmap *bitmap, unsigned int id);
+
+/**
+ * @author Unknown
+ * @brief Function that counts the row ids of a bitmap
+ * @param bitmap bitmap
+ * @return number of row ids
+ */
+int AK_bitmap_cardinality(AK_bitmap *bitmap);
+
+/**
+ * @author Unknown
+ * @brief Function that intersects two bitmaps
+ * @param a first bitmap
+ * @param b second bitmap
+ * @return new bitmap of the row ids in both bitmaps
+ */
+AK_bitmap *AK_bitmap_and(AK_bitmap *a, AK_bitmap *b);
+
+/**
+ * @author Unknown
+ * @brief Function that unites two bitmaps
+ * @param a first bitmap
+ * @param b second bitmap
+ * @return new bitmap of the row ids in either bitmap
+ */
+AK_bitmap *AK_bitmap_or(AK_bitmap *a, AK_bitmap *b);
+
+/**
+ * @author Unknown
+ * @brief Function that subtracts a bitmap from another
+ * @param a first bitmap
+ * @param b second bitmap
+ * @return new bitmap of the row ids in the first bitmap and not in the second
+ */
+AK_bitmap *AK_bitmap_andnot(AK_bitmap *a, AK_bitmap *b);
+
+/**
+ * @author Unknown
+ * @brief Function that gives the addresses of the rows of a bitmap, in the order of their row ids
+ * @param bitmap bitmap
+ * @param num_attr number of attributes of the table
+ * @param rows set to an array of the addresses of the rows
+ * @return number of rows
+ */
+int AK_bitmap_rows(AK_bitmap *bitmap, int num_attr, struct_add **rows);
+
+/**
+ * @author Unknown
+ * @brief Function that creates a bitmap index on an attribute of a table and adds every row of the table to it
+ * @param tblName name of the table
+ * @param attribute name of the attribute
+ * @param indexName name of the index
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_bitmap_create(char *tblName, char *attribute, char *indexName);
+
+/**
+ * @author Unknown
+ * @brief Function that reads the bitmap of a value from a bitmap index
+ * @param indexName name of index
+ * @param value value, NULL for the rows of all values
+ * @return new bitmap of the rows, NULL if there is no such index or the value is not of the type of the attribute
+ */
+AK_bitmap *AK_bitmap_index_get(char *indexName, struct list_node *value);
+
+/**
+ * @author Unknown
+ * @brief Function that searches a bitmap index for the rows with a value
+ * @param indexName name of index
+ * @param value value to search for
+ * @param rows set to an array of the addresses of the rows found
+ * @return number of rows found, EXIT_ERROR if there is no such index or the value is not of the type of the attribute
+ */
+int AK_bitmap_search(char *indexName, struct list_node *value, struct_add **rows);
+
+/**
+ * @author Unknown
+ * @brief Function that prints the values of a bitmap index with the number of their rows and containers
+ * @param indexName name of index
+ * @return No return value
+ */
+void AK_bitmap_print(char *indexName);
 
+/**
+ * @author Saša Vukšić, Lovro Predovan
+ * @brief Function that creates a bitmap index, named by the table, the attribute and "_bmapIndex", on every
+ *        attribute of the list that the table has
  * @param tblName name of table
  * @param attributes list of attributes on which we will create indexes
  * @return No return value
@@ -61,24 +333,9 @@ void AK_print_Header_Test(char* tblName);
 
 /**
  * @author Saša Vukšić, Lovro Predovan
- * @brief Function that loads index table with the value of particulary atribute
- * @param tblName source table
- * @param tblNameIndex new name of index table
- * @param attributeName attribute on which we make index
- * @param positionTbl position of attribute in header of table
- * @param numAtributes number of attributes in table
- * @param headerIndex header of index table
- * @return No return value
- */
-void AK_create_Index(char *tblName, char *tblNameIndex, char *attributeName, int positionTbl, int numAtributes, AK_header *headerIndex);
-
-/**
- * @author Saša Vukšić, Lovro Predovan
- * @brief Function that gets adresses of the particuliar attribute from bitmap index. It fetches addresses of indexes and header
-          of index table.  Using while loop it goes through index and gets necessary data. That data is put in a list called
-          add_root.
+ * @brief Function that gets adresses of the rows with a value from bitmap index
  * @param indexName name of index
- * @param attribute name of attribute
+ * @param attribute value written as text
  * @return list of adresses
  **/
 list_ad* AK_get_attribute(char *indexName, char *attribute);
@@ -97,7 +354,6 @@ void AK_print_Att_Test(list_ad *list);
 /**
  * @author Saša Vukšić
  * @brief Function that fetches the values from the bitmap index if there is one for a given table.
- * It should be started when we are making selection on the table with bitmap index.
  * @param tableName name of table
  * @param attributeValue value of attribute
  * @return list of adresses
@@ -106,8 +362,7 @@ list_ad* AK_get_Attribute(char *tableName, char *attributeName, char *attributeV
 
 /**
  * @author Saša Vukšić
- * @brief Function that updates the index, only on values that alredy exist. 
- * If there is no value in bitmap index or bitmap index on this value, warning is showed to the user. Otherwise, bitmap index is updated with new attribute value.
+ * @brief Function that moves a row of the index from the bitmap of one value to the bitmap of another
  * @param addBlock adress of block
  * @param addTD adress of tuple dict
  * @param tableName name of table
@@ -144,7 +399,7 @@ void AK_delete_bitmap_index(char *indexName);
 
 /**
  * @author Lovro Predovan
- * @brief Function that updates the index. Function deletes and recreates the index values again if different number of params is detected 
+ * @brief Function that updates the index. Function deletes and recreates the index values again if different number of params is detected
  * @param tableName name of table
  * @param attributeName name of attribute
  * @param newAttributeValue new value of updated attribute
@@ -152,4 +407,16 @@ void AK_delete_bitmap_index(char *indexName);
  **/
 void AK_add_to_bitmap_index(char *tableName, char *attributeName);
 
+/**
+ * @author Unknown
+ * @brief Function that adds a row of the indexed table to the bitmap index or removes it
+ * @param indexName name of index
+ * @param attribute position of the indexed attribute in the table
+ * @param block block of the table the row is in
+ * @param row tuple_dict index of the first attribute of the row
+ * @param delete if 0 the row is added else it is removed
+ * @return EXIT_SUCCESS, EXIT_ERROR if there is no such index or no page is left
+ **/
+int AK_bitmap_index_row(char *indexName, int attribute, AK_block *block, int row, int delete);
+
 #endif
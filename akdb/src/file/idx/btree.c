@@ -1,17 +1,22 @@
 /**
 @file btree.c Header file that provides functions for BTree indices
+
+A B+tree index is a segment of type SEGMENT_TYPE_INDEX registered in AK_index. Its first block holds a btree_meta,
+every other block used by the tree is one page: a btree_page header, the slots of the page in key order and the
+keys. The fan-out follows from the size of the block data and the size of the keys. Leaves are linked to their
+siblings, so a range is read by one descent and a walk to the right.
  */
 /*
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
  * the Free Software Foundation; either version 2 of the License, or
  * (at your option) any later version.
- * 
+ *
  * This program is distributed in the hope that it will be useful,
  * but WITHOUT ANY WARRANTY; without even the implied warranty of
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU Library General Public License for more details.
- * 
+ *
  * You should have received a copy of the GNU General Public License
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
@@ -20,859 +25,1350 @@
 #include "btree.h"
 
 /**
-  * @author Anđelko Spevec
-  * @brief Function that creates new btree index on integer attribute in table
-  * @param tblName - name of the table on which we are creating index
-  * @param attributes - attribute on which we are creating index
+ * @def BTREE_MAX_SLOTS
+ * @brief most entries of two pages taken together, every entry has a slot and a key of at least one field size
+ */
+#define BTREE_MAX_SLOTS (2 * BTREE_PAGE_SIZE / (sizeof (btree_slot) + sizeof (int)) + 1)
+
+/**
+  * @author Unknown
+  * @struct btree_node
+  * @brief Page read into memory. The keys are copied into keys, slot offsets point there. Two pages can be joined
+  *        in one btree_node while they are merged or balanced.
+ */
+typedef struct {
+	btree_page header;
+	btree_slot slot[BTREE_MAX_SLOTS];
+	/// bytes of keys used
+	int used;
+	unsigned char keys[3 * BTREE_PAGE_SIZE];
+} btree_node;
+
+/**
+  * @author Unknown
+  * @brief Function that compares two row addresses
+  * @return negative, zero or positive number
+ */
+static int AK_btree_compare_row(struct_add *a, struct_add *b){
+	if(a->addBlock != b->addBlock)
+		return a->addBlock < b->addBlock ? -1 : 1;
+	return (a->indexTd > b->indexTd) - (a->indexTd < b->indexTd);
+}
+
+/**
+  * @author Unknown
+  * @brief Function that compares two keys field by field with the comparators of the column types. A key that runs
+  *        out of fields first compares equal, so a key of the leading columns matches every key that starts with it.
+  * @param meta - index
+  * @return negative, zero or positive number
+ */
+static int AK_btree_compare_key(btree_meta *meta, const unsigned char *a, int a_size, const unsigned char *b, int b_size){
+	int field, pa = 0, pb = 0, sa, sb, result;
+	for(field = 0; field < meta->num_columns && pa < a_size && pb < b_size; field++){
+		memcpy(&sa, a + pa, sizeof (int));
+		memcpy(&sb, b + pb, sizeof (int));
+		result = AK_type_registry[meta->column_types[field]].compare(a + pa + sizeof (int), sa, b + pb + sizeof (int), sb);
+		if(result != 0)
+			return result;
+		pa += sizeof (int) + sa;
+		pb += sizeof (int) + sb;
+	}
+	return 0;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that compares a key and row with an entry of a page
+  * @return negative, zero or positive number
+ */
+static int AK_btree_compare_entry(btree_meta *meta, const unsigned char *key, int size, struct_add *row, btree_node *node, int i){
+	int result = AK_btree_compare_key(meta, key, size, node->keys + node->slot[i].offset, node->slot[i].size);
+	return result != 0 ? result : AK_btree_compare_row(row, &node->slot[i].row);
+}
+
+/**
+  * @author Unknown
+  * @brief Function that encodes values as a key
+  * @param meta - index
+  * @param values - values of the key columns, extra values are ignored
+  * @param key - set to the key
+  * @return size of the key, EXIT_ERROR if it is larger than BTREE_MAX_KEY_SIZE
+ */
+static int AK_btree_encode_key(btree_meta *meta, struct list_node *values, unsigned char *key){
+	struct list_node *value;
+	int size = 0, n = 0;
+	if(values == NULL)
+		return 0;
+	for(value = (struct list_node *) AK_First_L2(values); value != NULL && n < meta->num_columns; value = value->next, n++){
+		if(size + (int) sizeof (int) + value->size > BTREE_MAX_KEY_SIZE)
+			return EXIT_ERROR;
+		memcpy(key + size, &value->size, sizeof (int));
+		memcpy(key + size + sizeof (int), value->data, value->size);
+		size += sizeof (int) + value->size;
+	}
+	return size;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that gives the number of bytes a node takes as a page
+ */
+static int AK_btree_node_size(btree_node *node){
+	int i, size = sizeof (btree_page) + node->header.num_keys * sizeof (btree_slot);
+	for(i = 0; i < node->header.num_keys; i++)
+		size += node->slot[i].size;
+	return size;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that reads a page into memory
+  * @param address - block of the page
+  * @param node - set to the page
+ */
+static void AK_btree_read_node(int address, btree_node *node){
+	unsigned char *data = AK_get_block(address)->block->data;
+	int i;
+	memcpy(&node->header, data, sizeof (btree_page));
+	memcpy(node->slot, data + sizeof (btree_page), node->header.num_keys * sizeof (btree_slot));
+	node->used = 0;
+	for(i = 0; i < node->header.num_keys; i++){
+		memcpy(node->keys + node->used, data + node->slot[i].offset, node->slot[i].size);
+		node->slot[i].offset = node->used;
+		node->used += node->slot[i].size;
+	}
+}
+
+/**
+  * @author Unknown
+  * @brief Function that writes a node to its page, the node has to fit into BTREE_PAGE_SIZE
+  * @param address - block of the page
+  * @param node - page
+ */
+static void AK_btree_write_node(int address, btree_node *node){
+	AK_mem_block *mem_block = AK_get_block(address);
+	unsigned char *data = mem_block->block->data;
+	btree_slot slot;
+	int i, offset = sizeof (btree_page) + node->header.num_keys * sizeof (btree_slot);
+	memcpy(data, &node->header, sizeof (btree_page));
+	for(i = 0; i < node->header.num_keys; i++){
+		slot = node->slot[i];
+		memcpy(data + offset, node->keys + slot.offset, slot.size);
+		slot.offset = offset;
+		memcpy(data + sizeof (btree_page) + i * sizeof (btree_slot), &slot, sizeof (btree_slot));
+		offset += slot.size;
+	}
+	mem_block->block->tuple_dict[0].type = node->header.type;
+	mem_block->block->tuple_dict[0].address = 0;
+	mem_block->block->tuple_dict[0].size = offset;
+	mem_block->block->AK_free_space = offset;
+	mem_block->block->last_tuple_dict_id = 0;
+	AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+}
+
+/**
+  * @author Unknown
+  * @brief Function that inserts an entry into a node
+  * @param node - node
+  * @param pos - index of the new slot
+  * @param key - key
+  * @param size - size of the key
+  * @param row - row of the entry
+  * @param child - child of an inner entry
+ */
+static void AK_btree_node_insert(btree_node *node, int pos, const unsigned char *key, int size, struct_add *row, int child){
+	memmove(&node->slot[pos + 1], &node->slot[pos], (node->header.num_keys - pos) * sizeof (btree_slot));
+	memcpy(node->keys + node->used, key, size);
+	node->slot[pos].offset = node->used;
+	node->slot[pos].size = size;
+	node->slot[pos].row = *row;
+	node->slot[pos].child = child;
+	node->used += size;
+	node->header.num_keys++;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that removes an entry from a node
+ */
+static void AK_btree_node_remove(btree_node *node, int pos){
+	memmove(&node->slot[pos], &node->slot[pos + 1], (node->header.num_keys - pos - 1) * sizeof (btree_slot));
+	node->header.num_keys--;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that appends entries of one node to another
+  * @param node - node to append to
+  * @param source - node to append from
+  * @param from - first entry of source that is appended
+ */
+static void AK_btree_node_append(btree_node *node, btree_node *source, int from){
+	int i;
+	for(i = from; i < source->header.num_keys; i++)
+		AK_btree_node_insert(node, node->header.num_keys, source->keys + source->slot[i].offset, source->slot[i].size,
+				&source->slot[i].row, source->slot[i].child);
+}
+
+/**
+  * @author Unknown
+  * @brief Function that finds the child of an inner page to descend to
+  * @return index of the last entry not above the key and row, -1 for first_child
+ */
+static int AK_btree_child_index(btree_meta *meta, btree_node *node, const unsigned char *key, int size, struct_add *row){
+	int low = 0, high = node->header.num_keys, mid;
+	while(low < high){
+		mid = (low + high) / 2;
+		if(AK_btree_compare_entry(meta, key, size, row, node, mid) >= 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low - 1;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that finds the first entry of a leaf not below the key and row
+  * @return index of the entry, num_keys if all entries are below
+ */
+static int AK_btree_leaf_position(btree_meta *meta, btree_node *node, const unsigned char *key, int size, struct_add *row){
+	int low = 0, high = node->header.num_keys, mid;
+	while(low < high){
+		mid = (low + high) / 2;
+		if(AK_btree_compare_entry(meta, key, size, row, node, mid) > 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that descends from the root to the leaf where a key and row belong
+  * @param meta - index
+  * @param path_address - set to the pages on the way, path_address[0] is the root
+  * @param path_index - set to the entry taken in every inner page (-1 for first_child)
+  * @param node - set to the leaf
+  * @return level of the leaf in the path
+ */
+static int AK_btree_descend(btree_meta *meta, const unsigned char *key, int size, struct_add *row, int *path_address,
+		int *path_index, btree_node *node){
+	int level = 0, address = meta->root, i;
+	for(;;){
+		AK_btree_read_node(address, node);
+		path_address[level] = address;
+		if(node->header.type == LEAF || level == BTREE_MAX_HEIGHT - 1)
+			return level;
+		i = AK_btree_child_index(meta, node, key, size, row);
+		path_index[level] = i;
+		address = i < 0 ? node->header.first_child : node->slot[i].child;
+		level++;
+	}
+}
+
+/**
+  * @author Unknown
+  * @brief Function that reads the meta block of a B+tree index
   * @param indexName - name of the index
+  * @param meta - set to the meta data
+  * @return address of the meta block, EXIT_ERROR if there is no such B+tree index
  */
-/* 
-NOTES: 1. For now we assume that table is sorted on attribute on which we are
-creating index. We should check that with filesort.c and include it in this function.
-That file had some errors, so I couldn't test it. 2.working with multiple blocks
-*/
-AK_block * AK_btree_create(char *tblName, struct list_node *attributes, char *indexName){
-	int i,n,exist;
+static int AK_btree_get_meta(char *indexName, btree_meta *meta){
+	table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
+	int address = addresses->address_from[0];
+	AK_free(addresses);
+	if(address == 0)
+		return EXIT_ERROR;
+	memcpy(meta, AK_get_block(address)->block->data, sizeof (btree_meta));
+	return meta->magic == BTREE_MAGIC ? address : EXIT_ERROR;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that writes the meta block of a B+tree index
+ */
+static void AK_btree_put_meta(int address, btree_meta *meta){
+	AK_mem_block *mem_block = AK_get_block(address);
+	memcpy(mem_block->block->data, meta, sizeof (btree_meta));
+	mem_block->block->tuple_dict[0].type = BTREE_META;
+	mem_block->block->tuple_dict[0].address = 0;
+	mem_block->block->tuple_dict[0].size = sizeof (btree_meta);
+	mem_block->block->AK_free_space = sizeof (btree_meta);
+	mem_block->block->last_tuple_dict_id = 0;
+	AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+}
+
+/**
+  * @author Unknown
+  * @brief Function that gives a page to the tree, a freed page if there is one, otherwise the next block of the
+  *        segment. The segment gets a new extent when its blocks are used up.
+  * @return address of the page, EXIT_ERROR if no block is left
+ */
+static int AK_btree_alloc_page(char *indexName, btree_meta *meta){
+	btree_page page;
 	table_addresses *addresses;
-	int num_attr;
-	AK_PRO;
-	
-	//get table address
-	addresses = (table_addresses*) AK_get_table_addresses(tblName);
-	num_attr = AK_num_attr(tblName);
+	int j, address = EXIT_ERROR;
+	if(meta->free_page != 0){
+		address = meta->free_page;
+		memcpy(&page, AK_get_block(address)->block->data, sizeof (btree_page));
+		meta->free_page = page.next;
+		meta->num_pages++;
+		return address;
+	}
+	addresses = (table_addresses*) AK_get_index_addresses(indexName);
+	for(j = 0; j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0; j++){
+		if(meta->last_page >= addresses->address_from[j] && meta->last_page < addresses->address_to[j])
+			break;
+	}
+	if(j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0 && meta->last_page + 1 < addresses->address_to[j])
+		address = meta->last_page + 1;
+	else if(j + 1 < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j + 1] != 0)
+		address = addresses->address_from[j + 1];
+	else
+		address = AK_init_new_extent(indexName, SEGMENT_TYPE_INDEX);
+	AK_free(addresses);
+	if(address == EXIT_ERROR || address == 0)
+		return EXIT_ERROR;
+	meta->last_page = address;
+	meta->num_pages++;
+	return address;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that puts a page no longer used by the tree on the list of free pages
+ */
+static void AK_btree_free_page(int address, btree_meta *meta, btree_node *node){
+	memset(&node->header, 0, sizeof (btree_page));
+	node->header.type = BTREE_FREE_PAGE;
+	node->header.next = meta->free_page;
+	node->used = 0;
+	AK_btree_write_node(address, node);
+	meta->free_page = address;
+	meta->num_pages--;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that splits a node in two halves of about the same size. An inner node gives its middle entry to
+  *        the parent, a leaf gives a copy of the first entry of the right half.
+  * @param node - node, keeps the left half
+  * @param right - set to the right half
+  * @param sep_key - set to the key for the parent
+  * @param sep_size - set to the size of that key
+  * @param sep_row - set to the row for the parent
+ */
+static void AK_btree_split_node(btree_node *node, btree_node *right, unsigned char *sep_key, int *sep_size, struct_add *sep_row){
+	int n = node->header.num_keys, half, bytes = 0, mid, leaf = node->header.type == LEAF;
+	half = (AK_btree_node_size(node) - sizeof (btree_page)) / 2;
+	for(mid = 0; mid < n && bytes + (int) sizeof (btree_slot) + node->slot[mid].size <= half; mid++)
+		bytes += sizeof (btree_slot) + node->slot[mid].size;
+	if(mid < 1)
+		mid = 1;
+	if(mid > (leaf ? n - 1 : n - 2))
+		mid = leaf ? n - 1 : n - 2;
 
-	while(addresses->address_from[ i ]){
-		printf("\nAddress of the TABLE is from %u to %u \n",(addresses->address_from[ i ]),(addresses->address_to[ i ]));
-		i++;
+	memset(&right->header, 0, sizeof (btree_page));
+	right->header.type = node->header.type;
+	right->used = 0;
+	*sep_size = node->slot[mid].size;
+	memcpy(sep_key, node->keys + node->slot[mid].offset, *sep_size);
+	*sep_row = node->slot[mid].row;
+	if(leaf){
+		AK_btree_node_append(right, node, mid);
+	}else{
+		right->header.first_child = node->slot[mid].child;
+		AK_btree_node_append(right, node, mid + 1);
 	}
-	
-	//get table header
-	AK_header *table_header = (AK_header *)AK_get_header(tblName);
-    	struct list_node *attribute = (struct list_node *) AK_First_L2(attributes);
-	AK_header i_header[ MAX_ATTRIBUTES ];
-	AK_header* temp;
-    	n = 0;
-    	
-    	//get table attributes
-	while (attribute != 0) {
-		exist = 0;
-		for (i = 0; i < num_attr; i++) {
-		    if (strcmp((table_header + i)->att_name, attribute->data) == 0) {
-			printf("Attribute %s exist in table, found on position: %d\n", (table_header + i)->att_name, i);
-			AK_dbg_messg(HIGH, INDICES, "Attribute %s exist in table, found on position: %d\n", (table_header + i)->att_name, i);
-			exist = 1;
-			temp = (AK_header*) AK_create_header((table_header + i)->att_name, (table_header + i)->type, FREE_INT, FREE_CHAR, FREE_CHAR);
-			memcpy(i_header + n, temp, sizeof ( AK_header));
-			n++;
-			if ((table_header)->type != TYPE_INT) {
-			    printf("Unsupported data type for bree index! Only int!");
-			    AK_EPI;
-			    return NULL;
-			    //return EXIT_ERROR;
-			}
-		    }
-		}
-		if (!exist) {
-		    printf("Attribute %s does not exists in table", attribute->data);
-		    AK_EPI;
-		    return NULL;
-		    //return EXIT_ERROR;
-		}
-		attribute = attribute->next;
-	} 
-	memset(i_header + n, 0, MAX_ATTRIBUTES - n);
+	node->header.num_keys = mid;
+}
 
-	//creating index
-	int startAddress = AK_initialize_new_segment(indexName, SEGMENT_TYPE_INDEX, i_header);
-	if (startAddress != EXIT_ERROR)
-		printf("\nINDEX %s CREATED!\n", indexName);
-        int r;
-	table_addresses *addIndex = (table_addresses*) AK_get_index_addresses(indexName);
-	while(addIndex->address_from[ r ]){
-		printf("\nAddress of the INDEX is from %u to %u \n",(addIndex->address_from[ r ]),(addIndex->address_to[ r ]));
-		r++;
-	}
-	AK_block *block = (AK_block*) AK_read_block(startAddress);
-	int adr_to_write = (int) AK_find_AK_free_space(AK_get_index_addresses(indexName));
-	int number_el = AK_get_num_records(tblName);			
-	root_info *rootEl = (root_info*) AK_malloc(sizeof(root_info));
-
-	//number of LEAFS--------------------B=3---------------number_leaf
-	float x = (float) number_el;
-	float y = x/B;
-	int number_leaf = 0;
-	while(y > 0){
-		y = y - 1;
-		number_leaf = number_leaf + 1;
-	}//instead of ceil function
-	rootEl->level[0] = number_leaf;
-	
-	//number of NODES (level above leafs)--------(B+1)-----number_node
-	float m = (float) number_leaf;
-	float node = m/(B+1);
-	int number_node = 0;
-	while(node > 0){
-		node = node - 1;
-		number_node = number_node + 1;
-	}//instead of ceil function
-	rootEl->level[1] = number_node;
-
-	//number of NODES (remaining nodes)---------(B+1)------number_node
-	float temp_one = (float) number_node;
-	int temp_two = 0;
-	int lvl = 2;
-	int go = 1;
-	while(go == 1){
-		node = temp_one/(B+1);
-		temp_two = 0;
-		while(node > 0){
-			node = node - 1;
-			temp_two = temp_two + 1;
+/**
+  * @author Unknown
+  * @brief Function that adds an entry to a B+tree. Full pages are split from the leaf up, a split root gives the
+  *        tree a new root.
+  * @param indexName - name of the index
+  * @param meta_address - meta block of the index
+  * @param meta - meta data, updated
+  * @param key - key of the entry
+  * @param size - size of the key
+  * @param row - row of the entry
+  * @return EXIT_SUCCESS or EXIT_ERROR if no page could be allocated
+ */
+static int AK_btree_insert_entry(char *indexName, int meta_address, btree_meta *meta, const unsigned char *key,
+		int size, struct_add *row){
+	int path_address[BTREE_MAX_HEIGHT], path_index[BTREE_MAX_HEIGHT];
+	unsigned char sep_key[BTREE_MAX_KEY_SIZE];
+	struct_add sep_row;
+	btree_node *node = (btree_node*) AK_malloc(sizeof (btree_node));
+	btree_node *right = (btree_node*) AK_malloc(sizeof (btree_node));
+	int level, pos, sep_size, right_address, root_address, result = EXIT_SUCCESS;
+
+	level = AK_btree_descend(meta, key, size, row, path_address, path_index, node);
+	pos = AK_btree_leaf_position(meta, node, key, size, row);
+	if(pos < node->header.num_keys && AK_btree_compare_entry(meta, key, size, row, node, pos) == 0){
+		//the row is in the index already
+		AK_free(node);
+		AK_free(right);
+		return EXIT_SUCCESS;
+	}
+	AK_btree_node_insert(node, pos, key, size, row, 0);
+	meta->num_entries++;
+
+	while(AK_btree_node_size(node) > BTREE_PAGE_SIZE){
+		right_address = AK_btree_alloc_page(indexName, meta);
+		if(right_address == EXIT_ERROR){
+			AK_btree_node_remove(node, pos);
+			meta->num_entries--;
+			result = EXIT_ERROR;
+			break;
 		}
-		rootEl->level[lvl] = temp_two;
-		lvl++;
-		number_node = number_node + temp_two;
-		temp_one = (float) temp_two;
-		if(temp_two == 1)
-			go = 0;
-	}
-	
-	//writing root_info
-	rootEl->root = number_leaf + number_node;
-	memcpy(block->data, rootEl, sizeof(root_info));
-	block->tuple_dict[0].address = 0;
-	block->tuple_dict[0].type = BLOCK_TYPE_NORMAL;
-    	block->tuple_dict[0].size = sizeof (root_info);
-	block->AK_free_space += sizeof (root_info);
-	block->last_tuple_dict_id = 0;
-	AK_write_block(block);
-	
-	//writting leafs
-	int id,lf,b,help=0,elements=0;
-	int help_two[number_el];
-	for(lf=1;lf<=(rootEl->level[0]);lf++){
-		btree_node *leaf = (btree_node*) AK_malloc(sizeof(btree_node));
-		i=0;
-		AK_block *temp = (AK_block*) AK_read_block(addresses->address_from[ i ]);
-
-		for(b=0;b<B;b++){
-			if(elements<number_el){
-				leaf->pointers[b].addBlock = addresses->address_from[ i ];
-				leaf->pointers[b].indexTd = help;
-				void *tem = (void *) AK_calloc(MAX_VARCHAR_LENGTH, sizeof (void));
-	      		        memcpy(tem, &(temp->data[temp->tuple_dict[help].address]), sizeof (int));
-				leaf->values[b] = *((int *) tem);
-				help_two[elements] = leaf->values[b];
-				help += num_attr;
-				elements++;
-			}else{
-				leaf->values[b] = -1;
-				elements++;
+		AK_btree_split_node(node, right, sep_key, &sep_size, &sep_row);
+		if(node->header.type == LEAF){
+			right->header.next = node->header.next;
+			right->header.prev = path_address[level];
+			node->header.next = right_address;
+			if(right->header.next != 0){
+				btree_page next;
+				AK_mem_block *mem_block = AK_get_block(right->header.next);
+				memcpy(&next, mem_block->block->data, sizeof (btree_page));
+				next.prev = right_address;
+				memcpy(mem_block->block->data, &next, sizeof (btree_page));
+				AK_mem_block_modify(mem_block, BLOCK_DIRTY);
 			}
 		}
-		if(lf<(rootEl->level[0])){
-			leaf->pointers[B].addBlock = addresses->address_from[ i ];
-			leaf->pointers[B].indexTd = lf+1;
-		}	
-		memcpy(&block->data[block->AK_free_space], leaf, sizeof(btree_node));    
-		id = block->last_tuple_dict_id + 1;
-		block->tuple_dict[id].address = block->AK_free_space;
-		block->tuple_dict[id].type = LEAF;
-		block->AK_free_space += sizeof(btree_node);
-		block->last_tuple_dict_id = id;
-		AK_write_block(block);
-	}
-	
-	//writting nodes
-	int no=1,v=1,d,e=0,f,h,offset,diff,skip=1,check;
-	while(no==1){
-		check=0;
-		offset=1;
-		for(h=0;h<e;h++)////instead of pow function
-			offset = offset*(B+1); 
-		diff = offset * B;//difference WITHIN node
-		offset = offset * B + 1;
-		for(d=0;d<(rootEl->level[v]);d++){
-			btree_node *nodes = (btree_node*) AK_malloc(sizeof(btree_node));
-			for(f=0;f<B;f++){
-				if((offset-1)<number_el){
-					nodes->values[f] = help_two[offset-1];
-				}else{
-					nodes->values[f] = -1;
-				}
-				offset += diff;//difference WITHIN node
-			}
-			offset += diff;//difference BETWEEN nodes is doubled
-			for(f=0;f<=B;f++){
-					if(check<(rootEl->level[v-1])){
-						nodes->pointers[f].indexTd = skip;
-						nodes->pointers[f].addBlock = adr_to_write;
-						skip++;
-						check++;
-					}	
+		AK_btree_write_node(path_address[level], node);
+		AK_btree_write_node(right_address, right);
+
+		if(level == 0){
+			root_address = AK_btree_alloc_page(indexName, meta);
+			if(root_address == EXIT_ERROR){
+				result = EXIT_ERROR;
+				AK_free(node);
+				AK_free(right);
+				AK_btree_put_meta(meta_address, meta);
+				return result;
 			}
-			memcpy(&block->data[block->AK_free_space], nodes, sizeof(btree_node)); 
-			id = block->last_tuple_dict_id + 1;
-			block->tuple_dict[id].address = block->AK_free_space;
-			block->tuple_dict[id].type = NODE;
-			block->AK_free_space += sizeof(btree_node);
-			block->last_tuple_dict_id = id;
-			AK_write_block(block);
-		}		
-		e++;
-		if(rootEl->level[v] == 1)
-			no = 0;
-		v++;
+			memset(&node->header, 0, sizeof (btree_page));
+			node->header.type = NODE;
+			node->header.first_child = path_address[0];
+			node->used = 0;
+			AK_btree_node_insert(node, 0, sep_key, sep_size, &sep_row, right_address);
+			path_address[0] = root_address;
+			meta->root = root_address;
+			meta->height++;
+			break;
+		}
+		level--;
+		AK_btree_read_node(path_address[level], node);
+		pos = path_index[level] + 1;
+		AK_btree_node_insert(node, pos, sep_key, sep_size, &sep_row, right_address);
 	}
-	printf("B tree created succesfully.");
-	AK_EPI;
-	return block;
-	//return EXIT_SUCCESS;
+	AK_btree_write_node(path_address[level], node);
+	AK_btree_put_meta(meta_address, meta);
+	AK_free(node);
+	AK_free(right);
+	return result;
 }
 
 /**
-  * @author unknown
-  * @brief Function that deletes index
-  * @param indexName - name of the index+
+  * @author Unknown
+  * @brief Function that removes an entry from a B+tree. A page left less than a quarter full is merged with a
+  *        sibling when they fit into one page, otherwise their entries are balanced. A root left without keys is
+  *        replaced by its only child.
+  * @param meta_address - meta block of the index
+  * @param meta - meta data, updated
+  * @param key - key of the entry
+  * @param size - size of the key
+  * @param row - row of the entry
+  * @return 1 if the entry was removed, 0 if it is not in the index
  */
-int AK_btree_delete(char *indexName){
-    AK_PRO;
-    AK_delete_segment(indexName, SEGMENT_TYPE_INDEX);
-    printf("INDEX %s DELETED!\n", indexName);
-    AK_EPI;
-}
+static int AK_btree_remove_entry(int meta_address, btree_meta *meta, const unsigned char *key, int size, struct_add *row){
+	int path_address[BTREE_MAX_HEIGHT], path_index[BTREE_MAX_HEIGHT];
+	unsigned char sep_key[BTREE_MAX_KEY_SIZE];
+	struct_add sep_row;
+	btree_node *node = (btree_node*) AK_malloc(sizeof (btree_node));
+	btree_node *parent = (btree_node*) AK_malloc(sizeof (btree_node));
+	btree_node *sibling = (btree_node*) AK_malloc(sizeof (btree_node));
+	btree_node *joined = (btree_node*) AK_malloc(sizeof (btree_node));
+	btree_node *left, *right, *swap;
+	int level, pos, i, sep, sep_size, left_address, right_address, right_next, written = 0, removed = 0;
 
-/**
-  * @author Anđelko Spevec
-  * @brief Function that searches or deletes a value in btree index
-  * @param indexName - name of the index
-  * @param searchValue - value that we are searching in the index
-  * @param endRange - if 0 search is for 0 value, else searching in range
-  * @param toDo - if 0 we just search else we delete the element if we find it
- */
-int AK_btree_search_delete(char *indexName,int *searchValue,int *endRange,int *toDo, AK_block * inputBlock){
-	int contin = 1;
-        AK_PRO;
-	if((searchValue == endRange) || (endRange <= 0)){
-		endRange = 0;
-		contin = 0;
-	}
-	if(searchValue > endRange){
-		int help = *searchValue;
-		searchValue = endRange;
-		endRange = &help;
-	}
-	
-	//finding correct block 
-	int adr_to_read = (int) AK_find_AK_free_space(AK_get_index_addresses(indexName));
-	//AK_block *block = (AK_block*) AK_read_block(adr_to_read);     functions AK_find_AK_free_space, AK_get_index_addresses and AK_read_block should be checked for mistakes
-	AK_block *block = inputBlock;
-	root_info *root = (root_info*) AK_malloc(sizeof (root_info));
-	memset(root, 0, sizeof (root_info));
-	memcpy(root,block->data,sizeof (root_info));
-	btree_node *temp = (btree_node*) AK_malloc(sizeof(btree_node));
-	
-	//navigating through the tree
-	int address= block->tuple_dict[root->root].address;
-	int type = block->tuple_dict[root->root].type; //node == 1, leaf == 0
-	while(type == 1){
-		memset(temp,0,sizeof(btree_node));
-		memcpy(temp,&block->data[address],sizeof(btree_node));
-		int b,goTo = B,done=0;
-		for(b=0;b<B;b++){
-			if((*searchValue<(temp->values[b])) && (done == 0)){
-				goTo=b;
-				done = 1;
-			}
-		
-		}
-		address = block->tuple_dict[temp->pointers[goTo].indexTd].address;
-		type = block->tuple_dict[temp->pointers[goTo].indexTd].type;
-	}
-	memset(temp,0,sizeof(btree_node));
-	memcpy(temp,&block->data[address],sizeof(btree_node));
-	int f,found = 0,idNext;
-	
-	//searching for value
-	for(f=0;f<B;f++){
-		if(*searchValue == (temp->values[f])){
-			found = 1;
+	level = AK_btree_descend(meta, key, size, row, path_address, path_index, node);
+	pos = AK_btree_leaf_position(meta, node, key, size, row);
+	if(pos < node->header.num_keys && AK_btree_compare_entry(meta, key, size, row, node, pos) == 0){
+		AK_btree_node_remove(node, pos);
+		meta->num_entries--;
+		removed = 1;
+	}else{
+		written = 1;
+	}
+
+	while(!written && level > 0 && AK_btree_node_size(node) < BTREE_PAGE_SIZE / 4){
+		AK_btree_read_node(path_address[level - 1], parent);
+		i = path_index[level - 1];
+		if(parent->header.num_keys == 0)
+			break;
+		if(i + 1 < parent->header.num_keys){
+			sep = i + 1;
+			left_address = path_address[level];
+			right_address = parent->slot[sep].child;
+			AK_btree_read_node(right_address, sibling);
+			left = node;
+			right = sibling;
+		}else{
+			sep = i;
+			left_address = i - 1 < 0 ? parent->header.first_child : parent->slot[i - 1].child;
+			right_address = path_address[level];
+			AK_btree_read_node(left_address, sibling);
+			left = sibling;
+			right = node;
 		}
-		if((found == 1) && (temp->values[f] <= *endRange) && (*endRange > 0)) {
-			//printing data after finding node
-			printf("\n Value %i found! Block %u - IDX_TBL = %u", temp->values[f], temp->pointers[f].addBlock, temp->pointers[f].indexTd);
-				
-			//deleting node
-			if(*toDo == 1){
-				btree_delete(temp,block,address,f);
-				AK_write_block(block);
+
+		joined->header = left->header;
+		joined->header.num_keys = 0;
+		joined->used = 0;
+		AK_btree_node_append(joined, left, 0);
+		if(left->header.type != LEAF)
+			AK_btree_node_insert(joined, joined->header.num_keys, parent->keys + parent->slot[sep].offset,
+					parent->slot[sep].size, &parent->slot[sep].row, right->header.first_child);
+		AK_btree_node_append(joined, right, 0);
+
+		if(AK_btree_node_size(joined) <= BTREE_PAGE_SIZE){
+			//merge the right page into the left one
+			if(joined->header.type == LEAF){
+				joined->header.next = right->header.next;
+				if(right->header.next != 0){
+					btree_page next;
+					AK_mem_block *mem_block = AK_get_block(right->header.next);
+					memcpy(&next, mem_block->block->data, sizeof (btree_page));
+					next.prev = left_address;
+					memcpy(mem_block->block->data, &next, sizeof (btree_page));
+					AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+				}
 			}
+			AK_btree_write_node(left_address, joined);
+			AK_btree_free_page(right_address, meta, sibling);
+			AK_btree_node_remove(parent, sep);
+			swap = node;
+			node = parent;
+			parent = swap;
+			level--;
+			continue;
 		}
-		idNext=temp->pointers[B].indexTd;
-	}
-	if(found == 0){
-		printf("\n Value not found!");
-	}
-	while(contin == 1){
-		memset(temp,0,sizeof(btree_node));
-		memcpy(temp,&block->data[block->tuple_dict[idNext].address],sizeof(btree_node));
-		
-		//searching for value
-		for(f=0;f<B;f++){
-			if((temp->values[f]) <= *endRange){
-				//printing data after finding node
-				printf("\n Value %i found! Block %u - IDX_TBL = %u", temp->values[f], temp->pointers[f].addBlock, temp->pointers[f].indexTd);
-				
-				//deleting node
-				if(*toDo == 1){
-					btree_delete(temp,block,idNext,f);
-				}
-			}else
-				contin = 0;
-		idNext=temp->pointers[B].indexTd;
-		AK_write_block(block);
+
+		//balance the two pages, the new first key of the right page goes to the parent
+		right_next = right->header.next;
+		AK_btree_split_node(joined, sibling, sep_key, &sep_size, &sep_row);
+		sibling->header.next = right_next;
+		sibling->header.prev = left_address;
+		AK_btree_node_remove(parent, sep);
+		AK_btree_node_insert(parent, sep, sep_key, sep_size, &sep_row, right_address);
+		if(AK_btree_node_size(parent) <= BTREE_PAGE_SIZE){
+			AK_btree_write_node(left_address, joined);
+			AK_btree_write_node(right_address, sibling);
+			AK_btree_write_node(path_address[level - 1], parent);
+			written = 1;
 		}
+		//a longer separator does not fit into the parent, the page stays less full
+		break;
 	}
-	AK_EPI;
-	return EXIT_SUCCESS;
+
+	if(!written){
+		if(level == 0 && node->header.type == NODE && node->header.num_keys == 0){
+			meta->root = node->header.first_child;
+			meta->height--;
+			AK_btree_free_page(path_address[0], meta, node);
+		}else{
+			AK_btree_write_node(path_address[level], node);
+		}
+	}
+	if(removed)
+		AK_btree_put_meta(meta_address, meta);
+	AK_free(node);
+	AK_free(parent);
+	AK_free(sibling);
+	AK_free(joined);
+	return removed;
 }
 
+/**
+  * @author Unknown
+  * @struct btree_level
+  * @brief Level of a B+tree built bottom up: the page that is filled and the first key below it
+ */
+typedef struct {
+	btree_node node;
+	/// page that is filled, 0 before the first one
+	int address;
+	/// pages of the level that are written
+	int pages;
+	/// first key and row below the page
+	unsigned char low[BTREE_MAX_KEY_SIZE];
+	int low_size;
+	struct_add low_row;
+} btree_level;
 
 /**
-  * @author Anđelko Spevec
-  * @brief Function that deletes a value in btree index
-  * @param temp - node for deletion
-  * @param block - block that contains binary tree
-  * @param idNext - index of the node that is to be deleted
+  * @author Unknown
+  * @brief Function that adds an entry to a level of a tree built bottom up. A page that would grow over the limit is
+  *        written, a new page is started and the first key below the written page goes to the level above.
+  * @param indexName - name of the index
+  * @param meta - meta data, pages are allocated in it
+  * @param levels - levels of the tree, levels[0] are the leaves
+  * @param level - level the entry goes to
+  * @param limit - bytes a page is filled up to
+  * @param key - key of the entry
+  * @param size - size of the key
+  * @param row - row of the entry
+  * @param child - page the entry points to on an inner level
+  * @return EXIT_SUCCESS or EXIT_ERROR
  */
-void btree_delete(btree_node * temp, AK_block * block, int idNext, int i){
-	temp->values[i] = -1;
-	temp->pointers[i].addBlock = 0;
-	temp->pointers[i].indexTd = 0;
-	memcpy(&block->data[idNext],temp,sizeof(btree_node));
-	printf("\n Value deleted!");
+static int AK_btree_load_add(char *indexName, btree_meta *meta, btree_level *levels, int level, int limit,
+		const unsigned char *key, int size, struct_add *row, int child){
+	btree_level *l;
+	int address, previous = 0;
+	if(level == BTREE_MAX_HEIGHT)
+		return EXIT_ERROR;
+	l = &levels[level];
+	if(l->address != 0 && (l->node.header.num_keys == 0 || AK_btree_node_size(&l->node) + (int) sizeof (btree_slot) + size <= limit)){
+		AK_btree_node_insert(&l->node, l->node.header.num_keys, key, size, row, child);
+		return EXIT_SUCCESS;
+	}
+
+	address = AK_btree_alloc_page(indexName, meta);
+	if(address == EXIT_ERROR)
+		return EXIT_ERROR;
+	if(l->address != 0){
+		if(level == 0)
+			l->node.header.next = address;
+		AK_btree_write_node(l->address, &l->node);
+		l->pages++;
+		previous = l->address;
+		if(AK_btree_load_add(indexName, meta, levels, level + 1, limit, l->low, l->low_size, &l->low_row, l->address) == EXIT_ERROR)
+			return EXIT_ERROR;
+	}
+	memset(&l->node.header, 0, sizeof (btree_page));
+	l->node.used = 0;
+	l->address = address;
+	memcpy(l->low, key, size);
+	l->low_size = size;
+	l->low_row = *row;
+	if(level == 0){
+		l->node.header.type = LEAF;
+		l->node.header.prev = previous;
+		AK_btree_node_insert(&l->node, 0, key, size, row, 0);
+	}else{
+		l->node.header.type = NODE;
+		l->node.header.first_child = child;
+	}
+	return EXIT_SUCCESS;
 }
 
 /**
-  * @author unknown
-  * @brief Function that inserts a value in btree index
+  * @author Unknown
+  * @brief Function that writes the key columns and the address of every row of the indexed table into a temporary
+  *        segment. Deleted rows and rows with a NULL key are left out.
+  * @param meta - index
+  * @param segment - name of the temporary segment
+  * @return number of rows written, EXIT_ERROR if the segment could not be written
+ */
+static int AK_btree_load_scan(btree_meta *meta, char *segment){
+	AK_header header[MAX_ATTRIBUTES];
+	AK_header *table_header, *temp;
+	AK_segment_writer writer;
+	AK_sort_row out;
+	table_addresses *addresses;
+	AK_block *block;
+	int i, j, k, n, field, num_attr, count = 0, result = EXIT_SUCCESS;
+
+	num_attr = AK_num_attr(meta->table);
+	table_header = (AK_header *) AK_get_header(meta->table);
+	if(num_attr <= 0 || table_header == NULL)
+		return EXIT_ERROR;
+	memset(header, 0, sizeof (header));
+	for(field = 0; field < meta->num_columns; field++)
+		memcpy(header + field, table_header + meta->column_positions[field], sizeof (AK_header));
+	AK_free(table_header);
+	temp = (AK_header*) AK_create_header("__block", TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
+	memcpy(header + field, temp, sizeof (AK_header));
+	AK_free(temp);
+	temp = (AK_header*) AK_create_header("__tuple", TYPE_INT, FREE_INT, FREE_CHAR, FREE_CHAR);
+	memcpy(header + field + 1, temp, sizeof (AK_header));
+	AK_free(temp);
+
+	if(AK_initialize_new_segment(segment, SEGMENT_TYPE_TEMP, header) == EXIT_ERROR
+			|| AK_segment_writer_open(&writer, segment, SEGMENT_TYPE_TEMP, meta->num_columns + 2) == EXIT_ERROR)
+		return EXIT_ERROR;
+	memset(&out, 0, sizeof (AK_sort_row));
+	out.type[field] = out.type[field + 1] = TYPE_INT;
+	out.size[field] = out.size[field + 1] = sizeof (int);
+	out.data[field] = (unsigned char *) &j;
+	out.data[field + 1] = (unsigned char *) &k;
+
+	addresses = (table_addresses*) AK_get_table_addresses(meta->table);
+	for(i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0 && result == EXIT_SUCCESS; i++){
+		for(j = addresses->address_from[i]; j < addresses->address_to[i] && result == EXIT_SUCCESS; j++){
+			block = AK_get_block(j)->block;
+			for(k = 0; k + num_attr <= DATA_BLOCK_SIZE && block->tuple_dict[k].type != FREE_INT && result == EXIT_SUCCESS; k += num_attr){
+				//deleted row
+				if(block->tuple_dict[k].type == TYPE_INTERNAL)
+					continue;
+				for(field = 0; field < meta->num_columns; field++){
+					n = k + meta->column_positions[field];
+					//NULL keys are not indexed
+					if(AK_IS_NULL(block, n) || block->tuple_dict[n].size > MAX_VARCHAR_LENGTH)
+						break;
+					out.type[field] = block->tuple_dict[n].type;
+					out.size[field] = block->tuple_dict[n].size;
+					out.data[field] = block->data + block->tuple_dict[n].address;
+				}
+				if(field < meta->num_columns)
+					continue;
+				result = AK_segment_writer_put(&writer, &out);
+				count++;
+				block = AK_get_block(j)->block;
+			}
+		}
+	}
+	AK_free(addresses);
+	AK_segment_writer_close(&writer);
+	return result == EXIT_SUCCESS ? count : EXIT_ERROR;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that builds a B+tree anew from the rows of its table. The keys and row addresses are sorted
+  *        with the external sort and the pages are filled in one pass from the leftmost leaf up, each level filled
+  *        to fill_factor percent of a page. The pages are taken from the start of the index segment, so the
+  *        leaves are written one after another.
   * @param indexName - name of the index
-  * @param insertValue - value for insert
-  * @param insertTd - index table destination
-  * @param insertBlock - block address
-  * @param inputBlock - block containing btree
-  * @param EXIT_SUCCESS if successful 
+  * @param fill_factor - percentage of a page filled, later inserts into full pages split them
+  * @return number of entries in the index, EXIT_ERROR if it could not be built
  */
-int AK_btree_insert(char *indexName,int *insertValue, int *insertTd, int *insertBlock, AK_block * inputBlock){
+int AK_btree_rebuild(char *indexName, int fill_factor){
+	char load[MAX_ATT_NAME], sorted[MAX_ATT_NAME];
+	unsigned char key[BTREE_MAX_KEY_SIZE];
+	struct list_node *ordering;
+	AK_segment_cursor cursor;
+	AK_sort_row in;
+	btree_level *levels;
+	btree_meta meta;
+	struct_add row;
+	int meta_address, field, size, level, limit, count, result = EXIT_SUCCESS;
 	AK_PRO;
-	//finding correct block           !!!functions AK_find_AK_free_space, AK_get_index_addresses and AK_read_block should be checked for mistakes!!!
-	int adr_to_read = (int) AK_find_AK_free_space(AK_get_index_addresses(indexName));
-	//AK_block *block = (AK_block*) AK_read_block(adr_to_read);    
-	AK_block *block = inputBlock;
-	
-	//assign root node to root_info variable
-	root_info *root = (root_info*) AK_malloc(sizeof (root_info));
-	memset(root, 0, sizeof (root_info));
-	memcpy(root,block->data,sizeof (root_info));
-	
-	//assign values to properties of root node
-	btree_node *temp = (btree_node*) AK_malloc(sizeof(btree_node));
-	int insertPath[ORDER];//id of the selected node, iP[0] root
-	int insertIndexPath[ORDER];//index of a pointer selected in node, iIP[0] is index selected in root
-	int address = block->tuple_dict[root->root].address;
-	insertPath[0] = root->root;
-	int type = block->tuple_dict[root->root].type;
-	int inc=1;
-	
-	//navigating through the tree
-	while(type == 1){
-		memset(temp,0,sizeof(btree_node));
-		memcpy(temp,&block->data[address],sizeof(btree_node));
-		int b,goTo = B,done=0;
-		for(b=0;b<B;b++){
-			if((*insertValue<(temp->values[b])) && (done == 0)){
-				goTo=b;
-				done = 1;
+
+	meta_address = AK_btree_get_meta(indexName, &meta);
+	if(meta_address == EXIT_ERROR){
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	if(fill_factor < 10 || fill_factor > 100)
+		fill_factor = 100;
+	limit = BTREE_PAGE_SIZE * fill_factor / 100;
+
+	//(key, row) pairs in index order
+	snprintf(load, MAX_ATT_NAME, "%s__load", indexName);
+	snprintf(sorted, MAX_ATT_NAME, "%s__sorted", indexName);
+	count = AK_btree_load_scan(&meta, load);
+	if(count == EXIT_ERROR){
+		AK_delete_segment(load, SEGMENT_TYPE_TEMP);
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	ordering = (struct list_node *) AK_malloc(sizeof (struct list_node));
+	AK_Init_L3(&ordering);
+	AK_header *header = (AK_header *) AK_get_header(load);
+	for(field = 0; field < meta.num_columns + 2; field++)
+		AK_InsertAtEnd_L3(TYPE_ATTRIBS, header[field].att_name, strlen(header[field].att_name) + 1, ordering);
+	AK_free(header);
+	result = AK_external_sort(load, sorted, ordering, SORT_MEMORY_BUDGET);
+	AK_DeleteAll_L3(&ordering);
+	AK_free(ordering);
+	AK_delete_segment(load, SEGMENT_TYPE_TEMP);
+
+	//the old pages are overwritten from the start of the segment
+	meta.root = 0;
+	meta.height = 0;
+	meta.num_entries = 0;
+	meta.num_pages = 0;
+	meta.free_page = 0;
+	meta.last_page = meta_address;
+	levels = (btree_level *) AK_calloc(BTREE_MAX_HEIGHT, sizeof (btree_level));
+	if(result == EXIT_SUCCESS && count > 0 && AK_segment_cursor_open(&cursor, sorted, meta.num_columns + 2) == EXIT_SUCCESS){
+		while(result == EXIT_SUCCESS && AK_segment_cursor_next(&cursor, &in, NULL)){
+			size = 0;
+			for(field = 0; field < meta.num_columns; field++){
+				memcpy(key + size, &in.size[field], sizeof (int));
+				memcpy(key + size + sizeof (int), in.data[field], in.size[field]);
+				size += sizeof (int) + in.size[field];
 			}
+			memcpy(&row.addBlock, in.data[field], sizeof (int));
+			memcpy(&row.indexTd, in.data[field + 1], sizeof (int));
+			if(size > BTREE_MAX_KEY_SIZE)
+				result = EXIT_ERROR;
+			else
+				result = AK_btree_load_add(indexName, &meta, levels, 0, limit, key, size, &row, 0);
+			meta.num_entries++;
 		}
-		insertIndexPath[inc-1] = goTo;
-		insertPath[inc] = temp->pointers[goTo].indexTd;
-		address = block->tuple_dict[temp->pointers[goTo].indexTd].address;
-		type = block->tuple_dict[temp->pointers[goTo].indexTd].type;
-		if(type == 1){
-			inc++;
-		}//node == 1, leaf == 0
-	}
-	
-	//assign values to properties of leaf node
-	int j;
-	int destinationAddress = block->tuple_dict[insertPath[inc]].address;
-	memset(temp,0,sizeof(btree_node));
-	memcpy(temp,&block->data[destinationAddress],sizeof(btree_node));
-	int AK_freeSpace = 0;
-	for(j=0;j<B;j++){
-		if(temp->values[j] == -1){
-			AK_freeSpace++;
-		}
+		AK_segment_cursor_close(&cursor);
 	}
-	int inserted = 0,increase=0;
-	btree_node *temp_help = (btree_node*) AK_malloc(sizeof(btree_node));
-	memset(temp_help,0,sizeof(btree_node));
-	//we have FREE space in LEAF
-	if(AK_freeSpace != 0){ 
-		temp_help = searchValue(inserted, *insertValue, temp, temp_help, *insertTd,*insertBlock,&increase,-1);
-		memset(&block->data[destinationAddress],0,sizeof(btree_node));
-		memcpy(&block->data[destinationAddress],temp_help,sizeof(btree_node));
-		AK_write_block(block);
-		printf("\nNew value is added in leaf with available space");	
-	}
-	//we have to SPLIT the LEAF
-	else{
-		btree_node *temp_help_two = (btree_node*) AK_malloc(sizeof(btree_node));
-		memset(temp_help_two,0,sizeof(btree_node));
-		
-		//assign values to temporary node
-		temp_help = searchValue(inserted, *insertValue, temp, temp_help, *insertTd,*insertBlock,&increase,findCorrectNumber(1));
-		temp_help->pointers[B].indexTd = block->last_tuple_dict_id + 1; //points to new leaf
-		temp_help->pointers[B].addBlock = adr_to_read; //update when fix multiple blocks
-		memset(&block->data[destinationAddress],0,sizeof(btree_node));
-		memcpy(&block->data[destinationAddress],temp_help,sizeof(btree_node)); 
-		
-		//assign values to temporary node
-		temp_help_two = searchValue(inserted, *insertValue, temp, temp_help_two, *insertTd,*insertBlock,&increase,findCorrectNumber(2));
-		temp_help_two->pointers[B].indexTd = temp->pointers[B].indexTd; //points to next leaf
-		temp_help_two->pointers[B].addBlock = temp->pointers[B].addBlock;
-		memcpy(&block->data[block->AK_free_space], temp_help_two, sizeof(btree_node));
-		 
-		//assign values to block
-		int id = block->last_tuple_dict_id + 1;
-		block->tuple_dict[id].address = block->AK_free_space;
-		block->tuple_dict[id].type = LEAF;
-		block->AK_free_space += sizeof(btree_node);
-		block->last_tuple_dict_id = id;
-		
-		//update root_info->level[0] number of leafs
-		root->level[0]++;
-		memcpy(&block->data[0],root,sizeof(root_info));
-		AK_write_block(block);
-		
-		//checking nodes above 
-		int pathIndex = inc - 1;
-		int nodeAddress = block->tuple_dict[insertPath[pathIndex]].address;
-		int pointerIndex = insertIndexPath[pathIndex];
-		memset(temp,0,sizeof(btree_node));
-		memcpy(temp,&block->data[nodeAddress],sizeof(btree_node));
-
-		memset(temp_help,0,sizeof(btree_node));
-		int AK_freePointer = 0;
-		for(j=0;j<B;j++){
-			if(temp->values[j] == -1)
-				AK_freePointer = 1;
+	AK_delete_segment(sorted, SEGMENT_TYPE_TABLE);
+
+	//the last page of every level, the level with one page holds the root
+	for(level = 0; result == EXIT_SUCCESS; level++){
+		if(levels[level].address == 0){
+			levels[level].address = AK_btree_alloc_page(indexName, &meta);
+			levels[level].node.header.type = LEAF;
 		}
-		
-		int startSecond = 0, copyNode = 1,skip = 1;
-		if(AK_freePointer == 1){//in node above we have FREE POINTER to insert NEW LEAF
-			//adding value
-			temp_help = setNodePointers(temp_help,temp,pointerIndex,temp_help_two->values[0],insertPath[inc],id);
-			memset(&block->data[nodeAddress],0,sizeof(btree_node));
-			memcpy(&block->data[nodeAddress],temp_help,sizeof(btree_node)); 
-			AK_write_block(block);
-			printf("\nNew value is added in new leaf. Node above had available space.");
-		}else{//spliting nodes
-			int nodeIncrease,nodeInserted,helpAddress,helpType,nodeAboveAddress;
-			int again = 1,newRoot=0,updateIdx = 1;
-			
-			btree_node *temp_node_one = (btree_node*) AK_malloc(sizeof(btree_node));
-			btree_node *temp_node_two = (btree_node*) AK_malloc(sizeof(btree_node));
-			btree_node *value_help = (btree_node*) AK_malloc(sizeof(btree_node));
-			
-			while(again == 1){
-				memset(temp_node_one,0,sizeof(btree_node));
-				memset(temp_node_two,0,sizeof(btree_node));
-				memset(value_help,0,sizeof(btree_node));
-
-				nodeIncrease = 0;
-				nodeInserted = 0;
-				helpType=NODE;
-				
-				//pointers for first node
-				temp_node_one = findPointers(temp_node_one, temp, id, &nodeInserted, &nodeIncrease, 3, pointerIndex);
-				
-				//values for first node
-				temp_node_one = findValues(temp_node_one, block, &helpAddress, &helpType, value_help);
-				
-				//pointers for second node
-				temp_node_two = findPointers(temp_node_two, temp, id, &nodeInserted, &nodeIncrease, 4, pointerIndex);
-				
-				//values for second node
-				temp_node_two = findValues(temp_node_two, block, &helpAddress, &helpType, value_help);
-				
-				//updating block with btree
-				memset(&block->data[block->tuple_dict[insertPath[pathIndex]].address],0,sizeof(btree_node));
-				memcpy(&block->data[block->tuple_dict[insertPath[pathIndex]].address],temp_node_one,sizeof(btree_node)); 
-				memcpy(&block->data[block->AK_free_space],temp_node_two,sizeof(btree_node)); 
-				id = block->last_tuple_dict_id + 1;
-				block->tuple_dict[id].address = block->AK_free_space;
-				block->tuple_dict[id].type = NODE;
-				block->AK_free_space += sizeof(btree_node);
-				block->last_tuple_dict_id = id;
-				root->level[updateIdx]++;
-				memcpy(&block->data[0],root,sizeof(root_info));
-				updateIdx++;
-				AK_write_block(block);
-
-				if(newRoot == 1){
-					again = 0;
-					memset(temp,0,sizeof(btree_node));
-					temp->pointers[0].indexTd = insertPath[pathIndex];
-					temp->pointers[1].indexTd = id;
-					helpAddress = block->tuple_dict[id].address;
-					helpType = block->tuple_dict[id].type;
-					memset(value_help,0,sizeof(btree_node));
-					memcpy(value_help,&block->data[helpAddress],sizeof(btree_node));			
-					while(helpType == NODE){
-						helpAddress = block->tuple_dict[value_help->pointers[0].indexTd].address;
-						helpType = block->tuple_dict[value_help->pointers[0].indexTd].type;
-						memset(value_help,0,sizeof(btree_node));
-						memcpy(value_help,&block->data[helpAddress],sizeof(btree_node));
-					}
-					temp->values[0] = value_help->values[0];
-					printf("\nNew value is added and tree is updated! New root added, so order of the tree increased!");
-					//updating block with btree
-					memcpy(&block->data[block->AK_free_space],temp,sizeof(btree_node)); 
-					id = block->last_tuple_dict_id + 1;
-					block->tuple_dict[id].address = block->AK_free_space;
-					block->tuple_dict[id].type = NODE;
-					block->AK_free_space += sizeof(btree_node);
-					block->last_tuple_dict_id = id;
-					root->level[updateIdx] = 1;
-					root->root = id;
-					memcpy(&block->data[0],root,sizeof(root_info));
-					AK_write_block(block);	
-				}else{
-					//get above node !
-					if(pathIndex != 0)
-						pathIndex = pathIndex - 1; //0, insertPath[0] = 13 (root)
-					nodeAboveAddress = block->tuple_dict[insertPath[pathIndex]].address;
-					memset(temp,0,sizeof(btree_node));
-					memcpy(temp,&block->data[nodeAboveAddress],sizeof(btree_node));
-					
-					for(j=0;j<B;j++){
-						if(temp->values[j] == -1)
-							AK_freePointer = 1;
-					}
-					if(AK_freePointer == 1){
-						again = 0;
-						increase = 0;
-						memset(temp_help,0,sizeof(btree_node));
-						for(j=0;j<=B;j++){
-							if(j == (insertIndexPath[pathIndex]+1)){
-								temp_help->pointers[j].indexTd = id;
-							}else{
-								temp_help->pointers[j].indexTd = temp->pointers[increase].indexTd;
-								increase++;
-							}	
-						}
-						//updating block with btree
-						temp_help = findValues(temp_help, block, &helpAddress, &helpType, value_help);
-						memcpy(&block->data[block->AK_free_space],temp,sizeof(btree_node)); 
-						id = block->last_tuple_dict_id + 1;
-						block->tuple_dict[id].address = block->AK_free_space;
-						block->tuple_dict[id].type = NODE;
-						block->AK_free_space += sizeof(btree_node);
-						block->last_tuple_dict_id = id;
-						AK_write_block(block);	
-					}else{//if root is full->new root...
-						if(root->root == insertPath[pathIndex])
-							newRoot = 1;
-						else
-							again = 1;
-					}
-				}
-			}
-			if(newRoot != 1)
-				printf("\nNew value is added and tree is updated!");
+		AK_btree_write_node(levels[level].address, &levels[level].node);
+		if(levels[level].pages == 0){
+			meta.root = levels[level].address;
+			meta.height = level + 1;
+			break;
 		}
+		result = AK_btree_load_add(indexName, &meta, levels, level + 1, limit, levels[level].low, levels[level].low_size,
+				&levels[level].low_row, levels[level].address);
 	}
+	AK_free(levels);
+	AK_btree_put_meta(meta_address, &meta);
 	AK_EPI;
-	return EXIT_SUCCESS;
+	return result == EXIT_SUCCESS ? meta.num_entries : EXIT_ERROR;
 }
 
-
 /**
-  * @author unknown
-  * @brief Function that sets values for node
-  * @param temp_help - node that has it's values set
-  * @param insertValue - value for insert
-  * @param insertTd - index table destination
-  * @param insertBlock - block address
-  * @param i - determins the index of element of node
-  * @return  node that has it's values set 
- */
-btree_node * makevalues(btree_node * temp_help, int insertValue, int insertTd, int insertBlock, int i){
-	temp_help->values[i] = insertValue;
-	temp_help->pointers[i].indexTd = insertTd;
-	temp_help->pointers[i].addBlock = insertBlock;
-	return temp_help;
-}
+  * @author Anđelko Spevec, updated by Unknown (paged B+tree)
+  * @brief Function that creates new B+tree index on an attribute of a table and adds every row of the table to it
+  * @param tblName - name of the table on which we are creating index
+  * @param attributes - attribute on which we are creating index
+  * @param indexName - name of the index
+  * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_btree_create(char *tblName, struct list_node *attributes, char *indexName){
+	int i, num_attr, startAddress;
+	btree_meta meta;
+	AK_PRO;
 
-/**
-  * @author unknown
-  * @brief returns data about a leaf
-  * @return required value
- */
-int findCorrectNumber(int number){
-	int amount = B % 2;
-	if(amount == 0){//uneven number of pointers (B+1)%2 = 1
-		//we need to insert B+1 elements in two leafs -> 4+1=3+2
-		if(number == 1)
-			return (B/2) + 1; //B=4,(4/2)+1=3 elements in first leaf
-		if(number == 2)
-			return B/2; //B=4,(4/2)=2 elements in second leaf
-		if(number == 3)
-			return (B + 2)/2;  //B=4, (B+1+1)/2 = 3 pointers in first LEAF
-		if(number == 4)
-			return (B + 2)/2; //B=4, (B+1+1)/2 = 3 pointers in second LEAF
-	}else{//even number of pointers (B+1)%2 = 0
-		//we need to insert B+1 elements in two leafs -> 3+1=2+2
-		if(number == 1)
-			return (B + 1)/2; //B=3,(3+1)/2=2 elements in first leaf
-		if(number == 2)
-			return (B + 1)/2; //B=3,(3+1)/2=2 elements in second leaf 
-		if(number == 3)
-			return ((B + 1)/2) + 1; //B=3, ((3+1)/2)+1= 3 pointers in first leaf
-		if(number == 4)
-			return (B + 1)/2; //B=3 (3+1)/2=2 pointers in second leaf			
+	num_attr = AK_num_attr(tblName);
+	AK_header *table_header = (AK_header *)AK_get_header(tblName);
+	if(num_attr <= 0 || table_header == NULL){
+		printf("Table %s does not exist!\n", tblName);
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	struct list_node *attribute = (struct list_node *) AK_First_L2(attributes);
+	AK_header i_header[ MAX_ATTRIBUTES ];
+	AK_header* temp;
+
+	memset(&meta, 0, sizeof (btree_meta));
+	meta.magic = BTREE_MAGIC;
+	strncpy(meta.table, tblName, MAX_ATT_NAME - 1);
+
+	//get table attributes
+	while (attribute != 0) {
+		for (i = 0; i < num_attr && strcmp((table_header + i)->att_name, attribute->data) != 0; i++)
+			;
+		if (i == num_attr) {
+			printf("Attribute %s does not exists in table", attribute->data);
+			AK_EPI;
+			return EXIT_ERROR;
+		}
+		switch ((table_header + i)->type) {
+			case TYPE_INT:
+			case TYPE_FLOAT:
+			case TYPE_NUMBER:
+			case TYPE_VARCHAR:
+			case TYPE_DATE:
+			case TYPE_DATETIME:
+			case TYPE_TIME:
+			case TYPE_BOOL:
+				break;
+			default:
+				printf("Unsupported data type for btree index!");
+				AK_EPI;
+				return EXIT_ERROR;
+		}
+		if (meta.num_columns == 1) {
+			printf("B+tree index has one key attribute, %s is not indexed!\n", attribute->data);
+			break;
+		}
+		AK_dbg_messg(HIGH, INDICES, "Attribute %s exist in table, found on position: %d\n", (table_header + i)->att_name, i);
+		temp = (AK_header*) AK_create_header((table_header + i)->att_name, (table_header + i)->type, FREE_INT, FREE_CHAR, FREE_CHAR);
+		memcpy(i_header + meta.num_columns, temp, sizeof ( AK_header));
+		AK_free(temp);
+		meta.column_types[meta.num_columns] = (table_header + i)->type;
+		meta.column_positions[meta.num_columns] = i;
+		meta.num_columns++;
+		attribute = attribute->next;
+	}
+	if (meta.num_columns == 0) {
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	memset(i_header + meta.num_columns, 0, (MAX_ATTRIBUTES - meta.num_columns) * sizeof (AK_header));
+
+	//creating index
+	startAddress = AK_initialize_new_index_segment(indexName, AK_get_table_obj_id(tblName), meta.column_positions[0], i_header);
+	if (startAddress == EXIT_ERROR) {
+		AK_EPI;
+		return EXIT_ERROR;
 	}
+	printf("\nINDEX %s CREATED!\n", indexName);
+
+	//the tree is built from the sorted rows of the table
+	meta.last_page = startAddress;
+	AK_btree_put_meta(startAddress, &meta);
+	if (AK_btree_rebuild(indexName, BTREE_FILL_FACTOR) == EXIT_ERROR) {
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	printf("B tree created succesfully.");
+	AK_EPI;
+	return EXIT_SUCCESS;
 }
 
 /**
   * @author unknown
-  * @brief Function that sets values for node
-  * @param inserted - determins if a value in a tree smaller then the value for insert has been found
-  * @param insertValue - value for insert
-  * @param temp - node with data about existing node
-  * @param temp_help - node that has it's values set
-  * @param insertTd - index table destination
-  * @param insertBlock - block address
-  * @param increase - determins the index of element of a node
-  * @param number - gives information about the number of elements in a leaf
-  * @return  node that has it's values set 
- */
-btree_node * searchValue(int inserted, int insertValue, btree_node * temp, btree_node * temp_help, int *insertTd, int *insertBlock,int* increase, int number){
-	int stop = 0;
-	for(int j=0;j<B;j++){
-		if(stop == 0){
-			if(inserted == 0){
-				if(insertValue < temp->values[*increase]){
-					temp_help = makevalues(temp_help,insertValue,*insertTd,*insertBlock,j);
-					inserted = 1;
-				}else{
-					temp_help = makevalues(temp_help,temp->values[*increase],temp->pointers[*increase].indexTd,temp->pointers[*increase].addBlock,j);
-					*increase++;
-				}
-			}else{
-				if(temp->values[*increase] == -1 && number == -1){
-					temp_help = makevalues(temp_help,insertValue,*insertTd,*insertBlock,j);
-					inserted = 1;
-				}else{
-					temp_help = makevalues(temp_help,temp->values[*increase],temp->pointers[*increase].indexTd,temp->pointers[*increase].addBlock,j);
-					*increase++;
-				}	
-			}
-			if((j+1) == number)
-				stop = 1;
-		}else{	
-			if(number != -1) 
-				temp_help = makevalues(temp_help,-1,0,0,j);
-			else{
-				temp_help->values[j] = temp->values[*increase];
-				temp_help->pointers[j] = temp->pointers[*increase];
-				*increase++;
-			}
-		}		
-	}
-	return temp_help;
+  * @brief Function that deletes index
+  * @param indexName - name of the index+
+ */
+int AK_btree_delete(char *indexName){
+    AK_PRO;
+    AK_delete_segment(indexName, SEGMENT_TYPE_INDEX);
+    printf("INDEX %s DELETED!\n", indexName);
+    AK_EPI;
+    return EXIT_SUCCESS;
 }
 
 /**
-  * @author unknown
-  * @brief Function that sets values for node
-  * @param temp - node with data about existing node
-  * @param temp_help - node that has it's values set
-  * @param pointerIndex - indicates what pointer is used
-  * @param secondValue - value of a node
-  * @param firstPointer - value to which a pointer of a node is to be set
-  * @param secondPointer - value to which a pointer of a node is to be set
-  * @return  node that has it's values set 
- */
-btree_node * setNodePointers(btree_node * temp, btree_node * temp_help,int pointerIndex,int secondValue,int firstPointer,int secondPointer){
-	int firstValue = temp_help->values[0];
-	int AK_freePointer = 0;
-	for(int j=0;j<B;j++){
-		if(temp->values[j] == -1)
-			AK_freePointer = 1;
-	}
-	int startSecond = 0, copyNode = 1,skip = 1;
-	int increase = 0;
-	temp_help->pointers[0].indexTd = temp->pointers[0].indexTd;
-	if(pointerIndex == 0){
-		startSecond = 1;
-		copyNode = 0;
-		skip = 0;
-	}
-	for(int j=1;j<=B;j++){
-		if((copyNode == 1) && (j != pointerIndex)){
-			temp_help->values[j-1] = temp->values[increase];
-			temp_help->pointers[j].indexTd = temp->pointers[increase+1].indexTd;
-			increase++;
+  * @author Anđelko Spevec, updated by Unknown (paged B+tree)
+  * @brief Function that searches or deletes values in btree index. The leaf of the first value is found from the
+  *        root, the following values are read along the leaf links.
+  * @param indexName - name of the index
+  * @param searchValue - value that we are searching in the index
+  * @param endRange - upper bound of a range search, NULL to search for searchValue only
+  * @param toDo - if 0 we just search else we delete the elements we find
+  * @param result - set to an array of the addresses of the rows found, NULL if not needed
+  * @return number of elements found, EXIT_ERROR if there is no such index
+ */
+int AK_btree_search_delete(char *indexName, struct list_node *searchValue, struct list_node *endRange, int toDo,
+		struct_add **result){
+	int path_address[BTREE_MAX_HEIGHT], path_index[BTREE_MAX_HEIGHT];
+	unsigned char low[BTREE_MAX_KEY_SIZE], high[BTREE_MAX_KEY_SIZE];
+	int low_size, high_size, meta_address, pos, address, found = 0, capacity = 16, keys_used = 0, i;
+	struct_add first = {-1, -1};
+	struct_add *rows;
+	int *key_offset;
+	unsigned char *keys;
+	btree_meta meta;
+	btree_node *node;
+	AK_PRO;
+
+	meta_address = AK_btree_get_meta(indexName, &meta);
+	if(meta_address == EXIT_ERROR){
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	low_size = AK_btree_encode_key(&meta, searchValue, low);
+	high_size = AK_btree_encode_key(&meta, endRange != NULL ? endRange : searchValue, high);
+	if(low_size == EXIT_ERROR || high_size == EXIT_ERROR){
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+
+	node = (btree_node*) AK_malloc(sizeof (btree_node));
+	rows = (struct_add*) AK_malloc(capacity * sizeof (struct_add));
+	key_offset = (int*) AK_malloc((capacity + 1) * sizeof (int));
+	keys = (unsigned char*) AK_malloc(capacity * BTREE_MAX_KEY_SIZE);
+	key_offset[0] = 0;
+
+	AK_btree_descend(&meta, low, low_size, &first, path_address, path_index, node);
+	pos = AK_btree_leaf_position(&meta, node, low, low_size, &first);
+	for(;;){
+		if(pos == node->header.num_keys){
+			address = node->header.next;
+			if(address == 0)
+				break;
+			AK_btree_read_node(address, node);
+			pos = 0;
+			continue;
 		}
-		if(startSecond == 1){
-			temp_help->values[j-1] = secondValue;
-			temp_help->pointers[j].indexTd = secondPointer;
-			if(skip == 1){
-				increase++;
-			}
-			startSecond = 0;
-			copyNode = 1;
+		if(AK_btree_compare_key(&meta, node->keys + node->slot[pos].offset, node->slot[pos].size, high, high_size) > 0)
+			break;
+		if(found == capacity){
+			capacity *= 2;
+			rows = (struct_add*) AK_realloc(rows, capacity * sizeof (struct_add));
+			key_offset = (int*) AK_realloc(key_offset, (capacity + 1) * sizeof (int));
+			keys = (unsigned char*) AK_realloc(keys, capacity * BTREE_MAX_KEY_SIZE);
 		}
-		if(j == pointerIndex){
-			temp_help->values[j-1] = firstValue;
-			temp_help->pointers[j].indexTd = firstPointer;
-			startSecond = 1;
-			copyNode = 0;
+		rows[found] = node->slot[pos].row;
+		if(toDo){
+			memcpy(keys + keys_used, node->keys + node->slot[pos].offset, node->slot[pos].size);
+			keys_used += node->slot[pos].size;
 		}
+		key_offset[++found] = keys_used;
+		AK_dbg_messg(HIGH, INDICES, "Value found! Block %d - IDX_TBL = %d\n", node->slot[pos].row.addBlock, node->slot[pos].row.indexTd);
+		pos++;
+	}
+
+	if(toDo){
+		for(i = 0; i < found; i++)
+			AK_btree_remove_entry(meta_address, &meta, keys + key_offset[i], key_offset[i + 1] - key_offset[i], &rows[i]);
 	}
-	return temp_help;
+
+	if(result != NULL)
+		*result = rows;
+	else
+		AK_free(rows);
+	AK_free(key_offset);
+	AK_free(keys);
+	AK_free(node);
+	AK_EPI;
+	return found;
 }
 
 /**
-  * @author unknown
-  * @brief Function that sets values for node
-  * @param temp_node_one - node that has it's values set
-  * @param temp - node with data about existing node
-  * @param id - value to which a pointer of a node is to be set
-  * @param nodeInserted - determins if a node has value
-  * @param nodeIncrease - shows node that is currently watched
-  * @param number - determins the way node values are checked
-  * @param pointerIndex - indicates what pointer is used
-  * @return  node that has it's values set 
- */
-btree_node * findPointers(btree_node * temp_node_one, btree_node * temp, int id, int* nodeInserted,int* nodeIncrease, int number, int pointerIndex){
-	for(int j=0;j<findCorrectNumber(number);j++){
-		int compare;
-		if(number == 3)
-			compare = j;
-		else
-			compare = *nodeIncrease;
-		if((compare==(pointerIndex+1)) && (*nodeInserted == 0)){
-			temp_node_one->pointers[j].indexTd = id;
-			temp_node_one->pointers[j].addBlock = 0;//update when fixing blocks
-			if(number == 3)
-				*nodeInserted = 1;
+  * @author unknown, updated by Unknown (paged B+tree)
+  * @brief Function that inserts a value in btree index
+  * @param indexName - name of the index
+  * @param insertValue - values of the key columns
+  * @param add - address of the row
+  * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+int AK_btree_insert(char *indexName, struct list_node *insertValue, struct_add *add){
+	unsigned char key[BTREE_MAX_KEY_SIZE];
+	int meta_address, size, result;
+	btree_meta meta;
+	AK_PRO;
+	meta_address = AK_btree_get_meta(indexName, &meta);
+	size = meta_address == EXIT_ERROR ? EXIT_ERROR : AK_btree_encode_key(&meta, insertValue, key);
+	if(size == EXIT_ERROR){
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	result = AK_btree_insert_entry(indexName, meta_address, &meta, key, size, add);
+	AK_EPI;
+	return result;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that adds a row of the indexed table to the index or removes its entry. The key is read from the
+  *        block the row is in. Rows with a NULL key are not indexed.
+  * @param indexName - name of the index
+  * @param block - block of the table the row is in
+  * @param row - tuple_dict index of the first attribute of the row
+  * @param delete - if 0 the entry is added else it is removed
+  * @return EXIT_SUCCESS, EXIT_ERROR if there is no such index or the key is too large
+ */
+int AK_btree_index_row(char *indexName, AK_block *block, int row, int delete){
+	unsigned char key[BTREE_MAX_KEY_SIZE];
+	int meta_address, field, n, size = 0, result = EXIT_SUCCESS;
+	struct_add add;
+	btree_meta meta;
+	AK_PRO;
+	meta_address = AK_btree_get_meta(indexName, &meta);
+	if(meta_address == EXIT_ERROR){
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	for(field = 0; field < meta.num_columns; field++){
+		n = row + meta.column_positions[field];
+		if(AK_IS_NULL(block, n)){
+			AK_EPI;
+			return EXIT_SUCCESS;
 		}
-		else{
-			temp_node_one->pointers[j].indexTd = temp->pointers[*nodeIncrease].indexTd;
-			temp_node_one->pointers[j].addBlock = temp->pointers[*nodeIncrease].addBlock;
-			*nodeIncrease++;
+		if(size + (int) sizeof (int) + block->tuple_dict[n].size > BTREE_MAX_KEY_SIZE){
+			AK_EPI;
+			return EXIT_ERROR;
 		}
+		memcpy(key + size, &block->tuple_dict[n].size, sizeof (int));
+		memcpy(key + size + sizeof (int), block->data + block->tuple_dict[n].address, block->tuple_dict[n].size);
+		size += sizeof (int) + block->tuple_dict[n].size;
 	}
-	return temp_node_one;
+	add.addBlock = block->address;
+	add.indexTd = row;
+	if(delete)
+		AK_btree_remove_entry(meta_address, &meta, key, size, &add);
+	else
+		result = AK_btree_insert_entry(indexName, meta_address, &meta, key, size, &add);
+	AK_EPI;
+	return result;
 }
 
 /**
-  * @author unknown
-  * @brief Function that sets values for node
-  * @param temp_node_one - node that has it's values set
-   * @param block - block containing btree
-  * @param helpAddress - address of current node
-  * @param helpType - type of current node
-  * @param value_help - node in helpAddress
-  * @return  node that has it's values set 
- */
-btree_node * findValues(btree_node * temp_node_one, AK_block * block, int* helpAddress,int* helpType, btree_node *value_help){
-	for(int j=0;j<B;j++){
-		if(temp_node_one->pointers[j+1].indexTd != 0){
-			*helpAddress = block->tuple_dict[temp_node_one->pointers[j+1].indexTd].address;
-			*helpType = block->tuple_dict[temp_node_one->pointers[j+1].indexTd].type;
-			memset(value_help,0,sizeof(btree_node));
-			memcpy(value_help,&block->data[*helpAddress],sizeof(btree_node));			
-			while(*helpType == NODE){
-				*helpAddress = block->tuple_dict[value_help->pointers[0].indexTd].address;
-				*helpType = block->tuple_dict[value_help->pointers[0].indexTd].type;
-				memset(value_help,0,sizeof(btree_node));
-				memcpy(value_help,&block->data[*helpAddress],sizeof(btree_node));
-			}
-			temp_node_one->values[j] = value_help->values[0];
+  * @author Unknown
+  * @brief Function that checks the structure of a B+tree: every page is in key order, the leaves are linked in key
+  *        order and hold all entries
+  * @param indexName - name of the index
+  * @param meta - set to the meta data of the index
+  * @return number of entries, EXIT_ERROR if the tree is damaged
+ */
+static int AK_btree_check(char *indexName, btree_meta *meta){
+	btree_node *node, *previous;
+	int address, prev = 0, count = 0, level, ok = 1, i;
+	if(AK_btree_get_meta(indexName, meta) == EXIT_ERROR)
+		return EXIT_ERROR;
+	node = (btree_node*) AK_malloc(sizeof (btree_node));
+	previous = (btree_node*) AK_malloc(sizeof (btree_node));
+	previous->header.num_keys = 0;
+	//leftmost leaf
+	address = meta->root;
+	for(level = 1; ; level++){
+		AK_btree_read_node(address, node);
+		if(node->header.type == LEAF || level > meta->height)
+			break;
+		address = node->header.first_child;
+	}
+	ok = level == meta->height;
+	while(ok && address != 0){
+		AK_btree_read_node(address, node);
+		ok = node->header.type == LEAF && node->header.prev == prev;
+		for(i = 0; ok && i < node->header.num_keys; i++){
+			if(i > 0)
+				ok = AK_btree_compare_entry(meta, node->keys + node->slot[i].offset, node->slot[i].size, &node->slot[i].row, node, i - 1) > 0;
+			else if(previous->header.num_keys > 0)
+				ok = AK_btree_compare_entry(meta, node->keys + node->slot[0].offset, node->slot[0].size, &node->slot[0].row,
+						previous, previous->header.num_keys - 1) > 0;
 		}
+		count += node->header.num_keys;
+		if(node->header.num_keys > 0)
+			memcpy(previous, node, sizeof (btree_node));
+		prev = address;
+		address = node->header.next;
 	}
-	return temp_node_one;
+	AK_free(node);
+	AK_free(previous);
+	return ok && count == meta->num_entries ? count : EXIT_ERROR;
 }
 
 /**
- * @author unknown
+ * @author unknown, updated by Unknown (paged B+tree)
  * @brief Returns the amount of successful and failed tests.
  * @return TestResult
- */ 
+ */
 TestResult AK_btree_test() {
 	int passed_tests=0;
-    	int failed_tests=0;
-    	
+	int failed_tests=0;
 	char *tblName = "student";
 	char *indexName = "student_btree_index";
+	char name[MAX_VARCHAR_LENGTH], pad[141];
+	struct list_node *att_list, *values, *end, *row;
+	struct_add *found, add;
+	btree_meta meta;
+	int i, n, ok, num_rec, mbr, height;
 	AK_PRO;
-	struct list_node *att_list = (struct list_node *) AK_malloc(sizeof (struct list_node));
+
+	/* 1: index on an int attribute of a table, every row is found */
+	printf("\nB+tree create test\n");
+	att_list = (struct list_node *) AK_malloc(sizeof (struct list_node));
 	AK_Init_L3(&att_list);
 	AK_InsertAtEnd_L3(TYPE_ATTRIBS, "mbr\0", 4, att_list);
-
-	AK_block * block = AK_btree_create(tblName, att_list, indexName);
-	if(block == NULL){
-		failed_tests++;
+	values = (struct list_node *) AK_malloc(sizeof (struct list_node));
+	AK_Init_L3(&values);
+	end = (struct list_node *) AK_malloc(sizeof (struct list_node));
+	AK_Init_L3(&end);
+	num_rec = AK_get_num_records(tblName);
+	ok = AK_btree_create(tblName, att_list, indexName) == EXIT_SUCCESS && AK_btree_check(indexName, &meta) == num_rec;
+	for (i = 0; ok && i < num_rec; i++) {
+		row = AK_get_row(i, tblName);
+		mbr = *(int *) AK_GetNth_L2(1, row)->data;
+		AK_DeleteAll_L3(&row);
+		AK_free(row);
+		AK_InsertAtEnd_L3(TYPE_INT, (char *) &mbr, sizeof (int), values);
+		n = AK_btree_search_delete(indexName, values, NULL, 0, &found);
+		AK_DeleteAll_L3(&values);
+		ok = n == 1 && *(int *) (AK_get_block(found[0].addBlock)->block->data
+				+ AK_get_block(found[0].addBlock)->block->tuple_dict[found[0].indexTd].address) == mbr;
+		AK_free(found);
 	}
-	else{
+	if (ok) {
+		printf("SUCCESS\n");
 		passed_tests++;
+	} else {
+		printf("FAIL\n");
+		failed_tests++;
 	}
-	printf("\n\n---------------------------");
-	printf("\nInserting new value...\n");
-	int iv=39123;
-	int ii=101;
-	int ib=301;
-	int *insertValue = &iv; //insert in leaf with available space
-	//int *insertValue = 35901; //insert in full leaf -> new leaf, full node above - split
-	int *insertTd = &ii;
-	int *insertBlock = &ib;
-	if(AK_btree_insert(indexName,insertValue,insertTd,insertBlock,block) == EXIT_SUCCESS){
-		passed_tests++;
+
+	/* 2: many long varchar keys spread over pages of three levels */
+	printf("\nB+tree insert test\n");
+	memset(pad, 'x', 140);
+	pad[140] = '\0';
+	AK_DeleteAll_L3(&att_list);
+	AK_InsertAtEnd_L3(TYPE_ATTRIBS, "firstname\0", 10, att_list);
+	ok = AK_btree_create(tblName, att_list, "student_btree_firstname") == EXIT_SUCCESS;
+	for (i = 0; ok && i < 3000; i++) {
+		sprintf(name, "name %05d %s", (i * 7919) % 3000, pad);
+		AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+		add.addBlock = 1000000 + i;
+		add.indexTd = 0;
+		ok = AK_btree_insert("student_btree_firstname", values, &add) == EXIT_SUCCESS;
+		AK_DeleteAll_L3(&values);
 	}
-	else{
+	ok = ok && AK_btree_check("student_btree_firstname", &meta) == num_rec + 3000 && meta.height >= 3;
+	height = meta.height;
+	printf("Height %d, %d pages\n", meta.height, meta.num_pages);
+	if (ok) {
+		printf("SUCCESS\n");
+		passed_tests++;
+	} else {
+		printf("FAIL\n");
 		failed_tests++;
 	}
-	//use insert function for 39123 and again for 39000 to test spliting leaf with AK_free space above
-	iv=39000;
-	insertValue = &iv; //insert in full leaf -> new leaf, AK_free space in node above
-	if(AK_btree_insert(indexName,insertValue,insertTd,insertBlock,block) == EXIT_SUCCESS){
+
+	/* 3: a range is read along the leaf links */
+	printf("\nB+tree range search test\n");
+	sprintf(name, "name %05d", 1000);
+	AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+	sprintf(name, "name %05d", 1999);
+	AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), end);
+	// "name 01999 xx..." is above "name 01999", the range holds 1000 to 1998
+	n = AK_btree_search_delete("student_btree_firstname", values, end, 0, NULL);
+	AK_DeleteAll_L3(&values);
+	AK_DeleteAll_L3(&end);
+	if (n == 999) {
+		printf("SUCCESS\n");
 		passed_tests++;
+	} else {
+		printf("FAIL %d\n", n);
+		failed_tests++;
 	}
-	else{
+
+	/* 4: deleting most keys merges pages and lowers the tree */
+	printf("\nB+tree delete test\n");
+	ok = 1;
+	for (i = 0; ok && i < 3000; i += 100) {
+		if (i == 1000)
+			continue;
+		sprintf(name, "name %05d", i);
+		AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+		sprintf(name, "name %05d", i + 99);
+		AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), end);
+		ok = AK_btree_search_delete("student_btree_firstname", values, end, 1, NULL) == 99;
+		AK_DeleteAll_L3(&values);
+		AK_DeleteAll_L3(&end);
+	}
+	// 1000 to 1099 are left, and the last key of every other hundred
+	sprintf(name, "name %05d %s", 1050, pad);
+	AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+	ok = ok && AK_btree_search_delete("student_btree_firstname", values, NULL, 0, NULL) == 1;
+	AK_DeleteAll_L3(&values);
+	sprintf(name, "name %05d %s", 2599, pad);
+	AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+	ok = ok && AK_btree_search_delete("student_btree_firstname", values, NULL, 0, NULL) == 1;
+	AK_DeleteAll_L3(&values);
+	sprintf(name, "name %05d %s", 2500, pad);
+	AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+	ok = ok && AK_btree_search_delete("student_btree_firstname", values, NULL, 0, NULL) == 0;
+	AK_DeleteAll_L3(&values);
+	ok = ok && AK_btree_check("student_btree_firstname", &meta) == num_rec + 129 && meta.height < height;
+	printf("Height %d, %d pages\n", meta.height, meta.num_pages);
+	if (ok) {
+		printf("SUCCESS\n");
+		passed_tests++;
+	} else {
+		printf("FAIL\n");
 		failed_tests++;
 	}
-	printf("\n\n---------------------------");
-	printf("\nSearching value...\n");
-	int sv=35906;
-	int er=35916;
-	int td=1;
-	int *searchValue = &sv;
-	int *endRange = &er;
-	//int *endRange = 0;
-	int *toDo = &td;//0 search, 1 delete
-	if(AK_btree_search_delete(indexName, searchValue, endRange, toDo, block) == EXIT_SUCCESS){
+
+	/* 5: float keys are ordered as numbers */
+	printf("\nB+tree float key test\n");
+	AK_DeleteAll_L3(&att_list);
+	AK_InsertAtEnd_L3(TYPE_ATTRIBS, "weight\0", 7, att_list);
+	ok = AK_btree_create(tblName, att_list, "student_btree_weight") == EXIT_SUCCESS
+			&& AK_btree_check("student_btree_weight", &meta) == num_rec;
+	float weight, lightest = -1000.0, heaviest = 1000.0;
+	for (i = -5; ok && i < 5; i++) {
+		weight = i * 25.5;
+		AK_InsertAtEnd_L3(TYPE_FLOAT, (char *) &weight, sizeof (float), values);
+		add.addBlock = 2000000 + i;
+		add.indexTd = 0;
+		ok = AK_btree_insert("student_btree_weight", values, &add) == EXIT_SUCCESS;
+		AK_DeleteAll_L3(&values);
+	}
+	weight = -60.0;
+	AK_InsertAtEnd_L3(TYPE_FLOAT, (char *) &lightest, sizeof (float), values);
+	AK_InsertAtEnd_L3(TYPE_FLOAT, (char *) &weight, sizeof (float), end);
+	// -127.5, -102, -76.5
+	ok = ok && AK_btree_search_delete("student_btree_weight", values, end, 0, NULL) == 3;
+	AK_DeleteAll_L3(&values);
+	AK_DeleteAll_L3(&end);
+	AK_InsertAtEnd_L3(TYPE_FLOAT, (char *) &lightest, sizeof (float), values);
+	AK_InsertAtEnd_L3(TYPE_FLOAT, (char *) &heaviest, sizeof (float), end);
+	ok = ok && AK_btree_search_delete("student_btree_weight", values, end, 0, NULL) == num_rec + 10;
+	AK_DeleteAll_L3(&values);
+	AK_DeleteAll_L3(&end);
+	if (ok) {
+		printf("SUCCESS\n");
 		passed_tests++;
+	} else {
+		printf("FAIL\n");
+		failed_tests++;
+	}
+
+	/* 6: an index built from sorted rows fills its pages to the fill factor */
+	printf("\nB+tree bulk load test\n");
+	AK_header load_header[3] = {
+		{TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+		{TYPE_VARCHAR, "name", {0}, {{'\0'}}, {{'\0'}}},
+		{0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+	};
+	AK_segment_writer writer;
+	AK_sort_row load_row;
+	int full_pages = 0;
+	memset(&load_row, 0, sizeof (AK_sort_row));
+	load_row.type[0] = TYPE_INT;
+	load_row.type[1] = TYPE_VARCHAR;
+	load_row.size[0] = sizeof (int);
+	load_row.data[0] = (unsigned char *) &n;
+	load_row.data[1] = (unsigned char *) name;
+	ok = AK_initialize_new_segment("btree_load_test", SEGMENT_TYPE_TABLE, load_header) != EXIT_ERROR
+			&& AK_segment_writer_open(&writer, "btree_load_test", SEGMENT_TYPE_TABLE, 2) == EXIT_SUCCESS;
+	for (i = 0; ok && i < 3000; i++) {
+		n = (i * 7919) % 3000;
+		sprintf(name, "load %05d %s", n, pad);
+		load_row.size[1] = strlen(name);
+		ok = AK_segment_writer_put(&writer, &load_row) == EXIT_SUCCESS;
 	}
-	else{
+	AK_segment_writer_close(&writer);
+	AK_DeleteAll_L3(&att_list);
+	AK_InsertAtEnd_L3(TYPE_ATTRIBS, "name\0", 5, att_list);
+	ok = ok && AK_btree_create("btree_load_test", att_list, "btree_load_index") == EXIT_SUCCESS
+			&& AK_btree_check("btree_load_index", &meta) == 3000;
+	if (ok && AK_btree_rebuild("btree_load_index", 100) == 3000 && AK_btree_check("btree_load_index", &meta) == 3000)
+		full_pages = meta.num_pages;
+	ok = ok && full_pages > 0 && AK_btree_rebuild("btree_load_index", 50) == 3000
+			&& AK_btree_check("btree_load_index", &meta) == 3000 && meta.num_pages > full_pages * 3 / 2;
+	printf("%d pages full, %d pages half full\n", full_pages, meta.num_pages);
+	for (i = 0; ok && i < 3000; i += 599) {
+		sprintf(name, "load %05d %s", i, pad);
+		AK_InsertAtEnd_L3(TYPE_VARCHAR, name, strlen(name), values);
+		ok = AK_btree_search_delete("btree_load_index", values, NULL, 0, &found) == 1
+				&& *(int *) (AK_get_block(found[0].addBlock)->block->data
+				+ AK_get_block(found[0].addBlock)->block->tuple_dict[found[0].indexTd].address) == i;
+		AK_free(found);
+		AK_DeleteAll_L3(&values);
+	}
+	if (ok) {
+		printf("SUCCESS\n");
+		passed_tests++;
+	} else {
+		printf("FAIL\n");
 		failed_tests++;
 	}
+
+	AK_btree_delete(indexName);
+	AK_btree_delete("btree_load_index");
+	AK_delete_segment("btree_load_test", SEGMENT_TYPE_TABLE);
+	AK_btree_delete("student_btree_firstname");
+	AK_btree_delete("student_btree_weight");
+	AK_DeleteAll_L3(&att_list);
+	AK_free(att_list);
+	AK_free(values);
+	AK_free(end);
 	printf("\n");
 	AK_EPI;
 	return TEST_result(passed_tests,failed_tests);
 }
-
@@ -6,12 +6,12 @@
  * it under the terms of the GNU General Public License as published by
  * the Free Software Foundation; either version 2 of the License, or
  * (at your option) any later version.
- * 
+ *
  * This program is distributed in the hope that it will be useful,
  * but WITHOUT ANY WARRANTY; without even the implied warranty of
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU Library General Public License for more details.
- * 
+ *
  * You should have received a copy of the GNU General Public License
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
@@ -20,82 +20,154 @@
 #ifndef BTREE
 #define BTREE
 
-#define B 3
-//order of the tree 6 - it can be lowered to usual 4-5 IF the B is increased!
-#define ORDER 6
-//now we have place for ((B+1)^(0RDER-1))*B = ((3+1)^(6-1))*3 = (4^5)*3 = 1024*3 = 3072 elements
-
-//types for tuple_dict
-#define LEAF 0
-#define NODE 1
-
 #include "../../auxi/test.h"
 #include "index.h"
 #include "../../file/table.h"
 #include "../../auxi/constants.h"
 #include "../../auxi/configuration.h"
 #include "../../auxi/mempro.h"
+#include "../../auxi/comparator.h"
+#include "../filesort.h"
 
-typedef struct{
-	//B values
-	int values[B];
-	/*
-	B + 1 pointers
-	IF type == 1 -> it points to other B+1 nodes/leafs
-	IF type == 0 -> first B points to addresses in tblName
-	and last pointer points to the next leaf (rangeSearch)
-	*/
-	struct_add pointers[B+1];
-}btree_node;
+/**
+ * @def BTREE_PAGE_SIZE
+ * @brief size of a B+tree page, every page is the data of one block of the index segment
+ */
+#define BTREE_PAGE_SIZE (DATA_BLOCK_SIZE * DATA_ENTRY_SIZE)
+/**
+ * @def BTREE_MAX_KEY_SIZE
+ * @brief largest encoded key, small enough that a page split in two always has room for one more entry
+ */
+#define BTREE_MAX_KEY_SIZE (BTREE_PAGE_SIZE / 8)
+/**
+ * @def BTREE_MAX_HEIGHT
+ * @brief largest number of levels of a tree
+ */
+#define BTREE_MAX_HEIGHT 16
+/**
+ * @def BTREE_MAGIC
+ * @brief marks the first block of a B+tree index segment
+ */
+#define BTREE_MAGIC 0x42545245
 
-/*
-root_info->level[index] represents the number of nodes in 
-that level from leafs to root, where root is always 1 (root doesn't
-have to be on index 5 - if order of the tree is 3 it can be on 2 so we
-distinct root lvl by value == 1). This is just theoretical representation
-of the full usage of the array for B=3 and 0=6.
+//types for tuple_dict
+#define LEAF 0
+#define NODE 1
+#define BTREE_META 2
+#define BTREE_FREE_PAGE 3
 
-index|	     0 |       1 |       2 |       3 |       4 |       5 |
-value| (B+1)^5 | (B+1)^4 | (B+1)^3 | (B+1)^2 | (B+1)^1 | (B+1)^0 |
-level|   leaf  |         |         |         |         |   root  |
-*/
-typedef struct{
-	//tuple_dic[ID] of the root node in the block
+/**
+  * @author Unknown
+  * @struct btree_meta
+  * @brief Structure stored in the first block of a B+tree index segment. The pages of the tree are the other
+  *        blocks of the segment.
+ */
+typedef struct {
+	/// BTREE_MAGIC
+	int magic;
+	/// block of the root page
 	int root;
-	//array size of the 0RDER
-	int level[ORDER]; 
-}root_info;
+	/// number of levels, 1 when the root is a leaf
+	int height;
+	/// number of entries in the leaves
+	int num_entries;
+	/// number of pages in use
+	int num_pages;
+	/// block of the page allocated last
+	int last_page;
+	/// first page of the list of freed pages, 0 if the list is empty
+	int free_page;
+	/// number of key columns
+	int num_columns;
+	/// types of the key columns
+	int column_types[MAX_ATTRIBUTES];
+	/// positions of the key columns in the table
+	int column_positions[MAX_ATTRIBUTES];
+	/// indexed table
+	char table[MAX_ATT_NAME];
+} btree_meta;
+
+/**
+  * @author Unknown
+  * @struct btree_page
+  * @brief Header at the start of a B+tree page. It is followed by num_keys btree_slot entries in key order, and then
+  *        by the keys. A key is a list of fields, every field is an int size followed by the value as stored in a
+  *        table block.
+ */
+typedef struct {
+	/// LEAF, NODE or BTREE_FREE_PAGE
+	int type;
+	/// number of slots
+	int num_keys;
+	/// right sibling of a leaf, next free page of a free page, 0 if there is none
+	int next;
+	/// left sibling of a leaf, 0 if there is none
+	int prev;
+	/// child of an inner page with keys below the first key
+	int first_child;
+} btree_page;
 
+/**
+  * @author Unknown
+  * @struct btree_slot
+  * @brief Entry of a B+tree page. Leaf entries are ordered by key and then by row address, so that equal keys of
+  *        different rows have a place of their own in the tree.
+ */
+typedef struct {
+	/// offset of the key from the start of the page
+	int offset;
+	/// size of the key
+	int size;
+	/// row of a leaf entry, in an inner page the row of the first entry of the child
+	struct_add row;
+	/// child of an inner page with keys from this key on
+	int child;
+} btree_slot;
 
 /**
-  * @author Anđelko Spevec
-  * @brief Function that creates new btree index on integer attribute in table
+  * @author Anđelko Spevec, updated by Unknown (paged B+tree)
+  * @brief Function that creates new B+tree index on an attribute of a table and adds every row of the table to it
   * @param tblName - name of the table on which we are creating index
   * @param attributes - attribute on which we are creating index
   * @param indexName - name of the index
+  * @return EXIT_SUCCESS or EXIT_ERROR
  */
-AK_block * AK_btree_create(char *tblName, struct list_node *attributes, char *indexName);
+int AK_btree_create(char *tblName, struct list_node *attributes, char *indexName);
 int AK_btree_delete(char *indexName);
 
-btree_node * makevalues(btree_node * temp_help, int insertValue, int insertTd, int insertBlock, int i);
-btree_node * searchValue(int inserted, int insertValue, btree_node * temp, btree_node * temp_help, int *insertTd, int *insertBlock,int* increase, int number);
-btree_node * setNodePointers(btree_node * temp, btree_node * temp_help,int pointerIndex,int secondValue,int firstPointer,int secondPointer);
-int findCorrectNumber(int number);
-btree_node * findPointers(btree_node * temp_node_one, btree_node * temp, int id, int* nodeInserted,int* nodeIncrease, int number, int pointerIndex);
-btree_node * findValues(btree_node * temp_node_one, AK_block * block, int* helpAddress,int* helpType, btree_node *value_help);
-void btree_delete(btree_node * temp, AK_block * block, int idNext, int i);
-
+/**
+  * @author Unknown
+  * @brief Function that builds a B+tree anew from the rows of its table with a sorted bulk load
+  * @param indexName - name of the index
+  * @param fill_factor - percentage of a page filled
+  * @return number of entries in the index, EXIT_ERROR if it could not be built
+ */
+int AK_btree_rebuild(char *indexName, int fill_factor);
 
 /**
-  * @author Anđelko Spevec
-  * @brief Function that searches or deletes a value in btree index
+  * @author Anđelko Spevec, updated by Unknown (paged B+tree)
+  * @brief Function that searches or deletes values in btree index
   * @param indexName - name of the index
   * @param searchValue - value that we are searching in the index
-  * @param endRange - if 0 search is for 0 value, else searching in range
-  * @param toDo - if 0 we just search else we delete the element if we find it
+  * @param endRange - upper bound of a range search, NULL to search for searchValue only
+  * @param toDo - if 0 we just search else we delete the elements we find
+  * @param result - set to an array of the addresses of the rows found, NULL if not needed
+  * @return number of elements found, EXIT_ERROR if there is no such index
+ */
+int AK_btree_search_delete(char *indexName, struct list_node *searchValue, struct list_node *endRange, int toDo,
+		struct_add **result);
+int AK_btree_insert(char *indexName, struct list_node *insertValue, struct_add *add);
+
+/**
+  * @author Unknown
+  * @brief Function that adds a row of the indexed table to the index or removes its entry
+  * @param indexName - name of the index
+  * @param block - block of the table the row is in
+  * @param row - tuple_dict index of the first attribute of the row
+  * @param delete - if 0 the entry is added else it is removed
+  * @return EXIT_SUCCESS, EXIT_ERROR if there is no such index or the key is too large
  */
-int AK_btree_search_delete(char *indexName,int *searchValue,int *endRange,int *toDo,AK_block * inputBlock);
-int AK_btree_insert(char *indexName,int *insertValue, int *insertTd, int *insertBlock,AK_block * inputBlock);
+int AK_btree_index_row(char *indexName, AK_block *block, int row, int delete);
 TestResult AK_btree_test();
 
 #endif
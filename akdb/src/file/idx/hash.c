@@ -21,322 +21,493 @@
 #include "hash.h"
 
 /**
-  * @author Mislav Čakarić
-  * @brief Function that computes a hash value from varchar or integer
+  * @author Unknown
+  * @struct hash_node
+  * @brief Bucket page read into memory
+ */
+typedef struct {
+    hash_page header;
+    bucket_elem elem[HASH_PAGE_ENTRIES];
+} hash_node;
+
+/**
+  * @author Mislav Čakarić, updated to use the type registry
+  * @brief Function that computes a hash value of an element with the hash function registered for its type
   * @param elem element of row for wich value is to be computed
   * @return hash value
  
  */
-int AK_elem_hash_value(struct list_node *elem) {
-    int type = elem->type, value = 0, i = 0;
-    char temp_char[MAX_VARCHAR_LENGTH];
+unsigned int AK_elem_hash_value(struct list_node *elem) {
+    unsigned int value;
+    int size;
     AK_PRO;
-    switch (type) {
-        case TYPE_INT:
-            memcpy(&value, elem->data, elem->size);
-            break;
-        case TYPE_VARCHAR:
-            memcpy(temp_char, elem->data, elem->size);
-            temp_char[ elem->size ] = '\0';
-            do {
-                value += (int) temp_char[i++];
-            } while (temp_char[i]);
-            break;
-    }
+    size = elem->size > 0 ? elem->size : (int) AK_type_size(elem->type, elem->data);
+    value = AK_hash_value(elem->type, (unsigned char *) elem->data, size);
     AK_EPI;
     return value;
 }
 
 /**
-  * @author Mislav Čakarić
-  * @brief Function that inserts a bucket to block
+  * @author Unknown
+  * @brief Function that reads a bucket page into memory
+  * @param address block of the page
+  * @param node set to the page
+ */
+static void AK_hash_read_node(int address, hash_node *node) {
+    unsigned char *data = AK_get_block(address)->block->data;
+    memcpy(&node->header, data, sizeof (hash_page));
+    memcpy(node->elem, data + sizeof (hash_page), node->header.num_entries * sizeof (bucket_elem));
+}
+
+/**
+  * @author Unknown
+  * @brief Function that writes a node to its bucket page
+  * @param address block of the page
+  * @param node page
+ */
+static void AK_hash_write_node(int address, hash_node *node) {
+    AK_mem_block *mem_block = AK_get_block(address);
+    int size = sizeof (hash_page) + node->header.num_entries * sizeof (bucket_elem);
+    memcpy(mem_block->block->data, &node->header, sizeof (hash_page));
+    memcpy(mem_block->block->data + sizeof (hash_page), node->elem, node->header.num_entries * sizeof (bucket_elem));
+    mem_block->block->tuple_dict[0].type = node->header.type;
+    mem_block->block->tuple_dict[0].address = 0;
+    mem_block->block->tuple_dict[0].size = size;
+    mem_block->block->AK_free_space = size;
+    mem_block->block->last_tuple_dict_id = 0;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+}
+
+/**
+  * @author Unknown
+  * @brief Function that reads the first block of a hash index
   * @param indexName name of index
-  * @param data content of bucket stored in char array
-  * @param type type of bucket (MAIN_BUCKET or HASH_BUCKET)
-  * @return address structure with data where the bucket is stored 
+  * @param info set to the info of the index
+  * @return address of the first block, EXIT_ERROR if there is no such hash index
  */
-struct_add* AK_insert_bucket_to_block(char *indexName, char *data, int type) {
-    int size, id;
-    AK_PRO;
-    struct_add *add = (struct_add*) AK_malloc(sizeof (struct_add));
-    add->addBlock = 0;
-    add->indexTd = 0;
+static int AK_hash_get_info(char *indexName, hash_info *info) {
+    table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
+    int address = addresses->address_from[0];
+    AK_free(addresses);
+    if (address == 0)
+        return EXIT_ERROR;
+    memcpy(info, AK_get_block(address)->block->data, sizeof (hash_info));
+    return info->magic == HASH_MAGIC ? address : EXIT_ERROR;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that writes the first block of a hash index
+  * @param address address of the first block
+  * @param info info of the index
+ */
+static void AK_hash_put_info(int address, hash_info *info) {
+    AK_mem_block *mem_block = AK_get_block(address);
+    memcpy(mem_block->block->data, info, sizeof (hash_info));
+    mem_block->block->tuple_dict[0].type = INFO_BUCKET;
+    mem_block->block->tuple_dict[0].address = 0;
+    mem_block->block->tuple_dict[0].size = sizeof (hash_info);
+    mem_block->block->AK_free_space = sizeof (hash_info);
+    mem_block->block->last_tuple_dict_id = 0;
+    AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+}
 
-    int adr_to_write = (int) AK_find_AK_free_space(AK_get_index_addresses(indexName));
-    if (adr_to_write == -1)
-        adr_to_write = (int) AK_init_new_extent(indexName, SEGMENT_TYPE_INDEX);
-    if (adr_to_write == 0){
-	AK_EPI;
-        return add;
+/**
+  * @author Unknown
+  * @brief Function that gives a page to the index, a freed page if there is one, otherwise the next block of the
+  *        segment. The segment gets a new extent when its blocks are used up.
+  * @return address of the page, EXIT_ERROR if no block is left
+ */
+static int AK_hash_alloc_page(char *indexName, hash_info *info) {
+    hash_page page;
+    table_addresses *addresses;
+    int j, address = EXIT_ERROR;
+    if (info->free_page != 0) {
+        address = info->free_page;
+        memcpy(&page, AK_get_block(address)->block->data, sizeof (hash_page));
+        info->free_page = page.next;
+        info->num_pages++;
+        return address;
+    }
+    addresses = (table_addresses*) AK_get_index_addresses(indexName);
+    for (j = 0; j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0; j++) {
+        if (info->last_page >= addresses->address_from[j] && info->last_page < addresses->address_to[j])
+            break;
     }
+    if (j < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j] != 0 && info->last_page + 1 < addresses->address_to[j])
+        address = info->last_page + 1;
+    else if (j + 1 < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[j + 1] != 0)
+        address = addresses->address_from[j + 1];
+    else
+        address = AK_init_new_extent(indexName, SEGMENT_TYPE_INDEX);
+    AK_free(addresses);
+    if (address == EXIT_ERROR || address == 0)
+        return EXIT_ERROR;
+    info->last_page = address;
+    info->num_pages++;
+    return address;
+}
 
-    AK_block *block = (AK_block*) AK_read_block(adr_to_write);
+/**
+  * @author Unknown
+  * @brief Function that puts a page no longer used by the index on the list of free pages
+ */
+static void AK_hash_free_page(int address, hash_info *info) {
+    hash_node node;
+    node.header.type = HASH_FREE_PAGE;
+    node.header.num_entries = 0;
+    node.header.next = info->free_page;
+    AK_hash_write_node(address, &node);
+    info->free_page = address;
+    info->num_pages--;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that finds the bucket of a hash value. The low level bits of the value address one of
+  *        HASH_INITIAL_BUCKETS << level buckets, buckets below split already use one bit more.
+  * @param info info of the index
+  * @param value hash value
+  * @return bucket number
+ */
+static int AK_hash_bucket(hash_info *info, unsigned int value) {
+    unsigned int bucket = value & ((HASH_INITIAL_BUCKETS << info->level) - 1);
+    if ((int) bucket < info->split)
+        bucket = value & ((HASH_INITIAL_BUCKETS << (info->level + 1)) - 1);
+    return bucket;
+}
 
-    AK_dbg_messg(HIGH, INDICES, "insert_bucket_to_block: Position to write (tuple_dict_index) %d\n", adr_to_write);
+/**
+  * @author Unknown
+  * @brief Function that gives the size of a value in a list
+ */
+static int AK_hash_elem_size(struct list_node *elem) {
+    return elem->size > 0 ? elem->size : (int) AK_type_size(elem->type, elem->data);
+}
 
-    switch (type) {
-        case MAIN_BUCKET:
-            size = sizeof (main_bucket);
-            break;
-        case HASH_BUCKET:
-            size = sizeof (hash_bucket);
-            break;
+/**
+  * @author Unknown
+  * @brief Function that computes the hash value of the key of a row. The hashes of the key columns are combined in
+  *        column order, so that keys with the same values in other columns hash differently.
+  * @param info info of the index
+  * @param block block of the table the row is in
+  * @param row tuple_dict index of the first attribute of the row
+  * @param value set to the hash value
+  * @return 1, 0 if a key column of the row is NULL
+ */
+static int AK_hash_row_value(hash_info *info, AK_block *block, int row, unsigned int *value) {
+    int j, n;
+    *value = 0;
+    for (j = 0; j < info->num_columns; j++) {
+        n = row + info->column_positions[j];
+        if (AK_IS_NULL(block, n))
+            return 0;
+        *value = AK_hash_combine(*value, AK_hash_value(info->column_types[j], block->data + block->tuple_dict[n].address,
+                block->tuple_dict[n].size));
     }
-    id = block->last_tuple_dict_id + 1;
-    memcpy(&block->data[block->AK_free_space], data, size);
-    block->tuple_dict[id].address = block->AK_free_space;
-    block->AK_free_space += size;
-    block->tuple_dict[id].type = type;
-    block->tuple_dict[id].size = size;
-    block->last_tuple_dict_id = id;
-    AK_write_block(block);
-
-    add->addBlock = adr_to_write;
-    add->indexTd = id;
-    AK_EPI;
-    return add;
+    return 1;
 }
 
 /**
-  *  @author Mislav Čakarić
-  *  @brief Function that updates a bucket in block
-  *  @param add address of where the bucket is stored
-  *  @param data content of bucket stored in char array
-  *  @return No return value
+  * @author Unknown
+  * @brief Function that computes the hash value of searched values, in the same way as for a row
+  * @param info info of the index
+  * @param values values of the key columns
+  * @param value set to the hash value
+  * @return 1, 0 if there is not a value for every key column
  */
-void AK_update_bucket_in_block(struct_add *add, char *data) {
-    AK_PRO;
-    AK_block *block = (AK_block*) AK_read_block(add->addBlock);
-    int address = block->tuple_dict[add->indexTd].address;
-    int size = block->tuple_dict[add->indexTd].size;
-    memcpy(&block->data[address], data, size);
-    AK_write_block(block);
-    AK_EPI;
+static int AK_hash_values_value(hash_info *info, struct list_node *values, unsigned int *value) {
+    struct list_node *elem = (struct list_node *) AK_First_L2(values);
+    int j;
+    *value = 0;
+    for (j = 0; elem != NULL && j < info->num_columns; j++, elem = AK_Next_L2(elem))
+        *value = AK_hash_combine(*value, AK_hash_value(info->column_types[j], (unsigned char *) elem->data,
+                AK_hash_elem_size(elem)));
+    return j == info->num_columns && elem == NULL;
 }
 
 /**
-  * @author Mislav Čakarić
-  * @brief Function that changes a info of hash index
+  * @author Unknown
+  * @brief Function that checks if a row has the searched key, rows with equal hash values may have other keys
+  * @param info info of the index
+  * @param add address of the row
+  * @param values values of the key columns
+  * @return 1 if the key of the row is equal to the values, otherwise 0
+ */
+static int AK_hash_row_matches(hash_info *info, struct_add *add, struct list_node *values) {
+    //rows are read through the cache, they may not have been written to disk yet
+    AK_block *block = AK_get_block(add->addBlock)->block;
+    struct list_node *elem = (struct list_node *) AK_First_L2(values);
+    int j, n;
+    for (j = 0; j < info->num_columns; j++, elem = AK_Next_L2(elem)) {
+        n = add->indexTd + info->column_positions[j];
+        if (AK_IS_NULL(block, n) || AK_compare_values(info->column_types[j], block->data + block->tuple_dict[n].address,
+                block->tuple_dict[n].size, (unsigned char *) elem->data, AK_hash_elem_size(elem)) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that writes entries into a chain of bucket pages, overflow pages are allocated as needed
   * @param indexName name of index
-  * @param modulo value for modulo hash function
-  * @param main_bucket_num number of main buckets
-  * @param hash_bucket_num number of hash buckets
-  * @return No return value
+  * @param info info of the index
+  * @param address first page of the chain
+  * @param elems entries
+  * @param n number of entries
+  * @return EXIT_SUCCESS, EXIT_ERROR if no page is left for an overflow page
  */
-void AK_change_hash_info(char *indexName, int modulo, int main_bucket_num, int hash_bucket_num) {
-    AK_PRO;
-    table_addresses *hash_addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    int block_add = hash_addresses->address_from[ 0 ];
-    if (block_add == 0) {
-        printf("Hash index does not exist!\n");
+static int AK_hash_write_chain(char *indexName, hash_info *info, int address, bucket_elem *elems, int n) {
+    hash_node node;
+    int count;
+    do {
+        count = n < HASH_PAGE_ENTRIES ? n : HASH_PAGE_ENTRIES;
+        node.header.type = HASH_BUCKET;
+        node.header.num_entries = count;
+        node.header.next = 0;
+        if (count > 0)
+            memcpy(node.elem, elems, count * sizeof (bucket_elem));
+        elems += count;
+        n -= count;
+        if (n > 0 && (node.header.next = AK_hash_alloc_page(indexName, info)) == EXIT_ERROR) {
+            node.header.next = 0;
+            AK_hash_write_node(address, &node);
+            return EXIT_ERROR;
+        }
+        AK_hash_write_node(address, &node);
+        address = node.header.next;
+    } while (n > 0);
+    return EXIT_SUCCESS;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that splits the next bucket in two. Its entries are divided between the bucket and a new bucket
+  *        at split + (HASH_INITIAL_BUCKETS << level) by one more bit of their hash values, the other buckets are
+  *        not touched. When every bucket of the level has been split the level grows.
+  * @param indexName name of index
+  * @param info info of the index
+  * @return EXIT_SUCCESS, EXIT_ERROR if no page is left
+ */
+static int AK_hash_split(char *indexName, hash_info *info) {
+    hash_node node;
+    bucket_elem *elems, swap;
+    int old = info->split, new_bucket = info->split + (HASH_INITIAL_BUCKETS << info->level);
+    int address, next, page, n = 0, stay = 0, capacity = HASH_PAGE_ENTRIES, i, result;
+
+    page = AK_hash_alloc_page(indexName, info);
+    if (page == EXIT_ERROR)
+        return EXIT_ERROR;
+    elems = (bucket_elem*) AK_malloc(capacity * sizeof (bucket_elem));
+    for (address = info->buckets[old]; address != 0; address = next) {
+        AK_hash_read_node(address, &node);
+        if (n + node.header.num_entries > capacity) {
+            capacity = 2 * (n + node.header.num_entries);
+            elems = (bucket_elem*) AK_realloc(elems, capacity * sizeof (bucket_elem));
+        }
+        memcpy(elems + n, node.elem, node.header.num_entries * sizeof (bucket_elem));
+        n += node.header.num_entries;
+        next = node.header.next;
+        if (address != info->buckets[old])
+            AK_hash_free_page(address, info);
     }
-    AK_block *block = (AK_block*) AK_read_block(block_add);
-    hash_info *info = (hash_info*) AK_malloc(sizeof (hash_info));
-    info->modulo = modulo;
-    info->main_bucket_num = main_bucket_num;
-    info->hash_bucket_num = hash_bucket_num;
-
-    memcpy(block->data, info, sizeof (hash_info));
-    block->tuple_dict[0].address = 0;
-    block->tuple_dict[0].type = INFO_BUCKET;
-    block->tuple_dict[0].size = sizeof (hash_info);
-    AK_write_block(block);
-    AK_EPI;
+
+    info->buckets[new_bucket] = page;
+    info->num_buckets++;
+    if (++info->split == HASH_INITIAL_BUCKETS << info->level) {
+        info->level++;
+        info->split = 0;
+    }
+    //entries that stay in the old bucket are moved to the front
+    for (i = 0; i < n; i++) {
+        if (AK_hash_bucket(info, elems[i].value) == old) {
+            swap = elems[stay];
+            elems[stay++] = elems[i];
+            elems[i] = swap;
+        }
+    }
+    result = AK_hash_write_chain(indexName, info, info->buckets[old], elems, stay);
+    if (result == EXIT_SUCCESS)
+        result = AK_hash_write_chain(indexName, info, page, elems + stay, n - stay);
+    AK_free(elems);
+    return result;
 }
 
 /**
-  * @author Mislav Čakarić
+  * @author Unknown
+  * @brief Function that adds an entry to its bucket, into the first page of the chain with room. The next bucket
+  *        is split when the entries fill more than HASH_LOAD_FACTOR percent of the primary pages.
+  * @param indexName name of index
+  * @param info info of the index
+  * @param elem entry
+  * @return EXIT_SUCCESS, EXIT_ERROR if no page is left
+ */
+static int AK_hash_insert_entry(char *indexName, hash_info *info, bucket_elem *elem) {
+    hash_node node;
+    int address = info->buckets[AK_hash_bucket(info, elem->value)], next;
+    for (;;) {
+        AK_hash_read_node(address, &node);
+        if (node.header.num_entries < HASH_PAGE_ENTRIES)
+            break;
+        if (node.header.next == 0) {
+            next = AK_hash_alloc_page(indexName, info);
+            if (next == EXIT_ERROR)
+                return EXIT_ERROR;
+            node.header.next = next;
+            AK_hash_write_node(address, &node);
+            address = next;
+            node.header.type = HASH_BUCKET;
+            node.header.num_entries = 0;
+            node.header.next = 0;
+            break;
+        }
+        address = node.header.next;
+    }
+    node.elem[node.header.num_entries++] = *elem;
+    AK_hash_write_node(address, &node);
+    info->num_entries++;
+
+    if (info->num_buckets < HASH_MAX_BUCKETS
+            && info->num_entries * 100 > HASH_LOAD_FACTOR * info->num_buckets * HASH_PAGE_ENTRIES)
+        return AK_hash_split(indexName, info);
+    return EXIT_SUCCESS;
+}
+
+/**
+  * @author Unknown
+  * @brief Function that removes an entry from its bucket. The last entry of the page takes its place, an overflow
+  *        page left empty is unlinked and freed.
+  * @param info info of the index
+  * @param elem entry, hash value and row address
+  * @return 1 if the entry was removed, 0 if it is not in the index
+ */
+static int AK_hash_remove_entry(hash_info *info, bucket_elem *elem) {
+    hash_node node;
+    int address = info->buckets[AK_hash_bucket(info, elem->value)], previous = 0, next, i;
+    while (address != 0) {
+        AK_hash_read_node(address, &node);
+        for (i = 0; i < node.header.num_entries; i++) {
+            if (node.elem[i].value == elem->value && node.elem[i].add.addBlock == elem->add.addBlock
+                    && node.elem[i].add.indexTd == elem->add.indexTd)
+                break;
+        }
+        if (i < node.header.num_entries) {
+            node.elem[i] = node.elem[--node.header.num_entries];
+            if (node.header.num_entries == 0 && previous != 0) {
+                next = node.header.next;
+                AK_hash_free_page(address, info);
+                AK_hash_read_node(previous, &node);
+                node.header.next = next;
+                AK_hash_write_node(previous, &node);
+            } else {
+                AK_hash_write_node(address, &node);
+            }
+            info->num_entries--;
+            return 1;
+        }
+        previous = address;
+        address = node.header.next;
+    }
+    return 0;
+}
+
+/**
+  * @author Mislav Čakarić, updated by Unknown (linear hashing)
   * @brief Function that fetches the info for hash index
   * @param indexName name of index
   * @return info bucket with info data for hash index
  */
 hash_info* AK_get_hash_info(char *indexName) {
     AK_PRO;
-    table_addresses *hash_addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    int block_add = hash_addresses->address_from[ 0 ];
     hash_info *info = (hash_info*) AK_malloc(sizeof (hash_info));
-    memset(info, 0, sizeof (hash_info));
-    if (block_add == 0) {
+    if (AK_hash_get_info(indexName, info) == EXIT_ERROR) {
         printf("Hash index does not exist!\n");
-	AK_EPI;
-        return info;
+        memset(info, 0, sizeof (hash_info));
     }
-    AK_block *block = (AK_block*) AK_read_block(block_add);
-    memcpy(info, block->data, sizeof (hash_info));
     AK_EPI;
     return info;
 }
 
 /**
-  * @author Mislav Čakarić
-  * @brief Function that fetches nth main bucket
-  * @param indexName name of index
-  * @param n number of main bucket
-  * @return address structure with data where the bucket is stored
+  *  @author Mislav Čakarić, updated by Unknown (linear hashing)
+  *  @brief Function that inserts a record in hash bucket
+  *  @param indexName name of index
+  *  @param hashValue hash value of record that is being inserted
+  *  @param add address of the record in table
+  *  @return No return value
  */
-struct_add* AK_get_nth_main_bucket_add(char *indexName, int n) {
-    int i = 0, j = 0, k = 0, counter = 0, end = 0;
+void AK_insert_in_hash_index(char *indexName, unsigned int hashValue, struct_add *add) {
+    hash_info info;
+    bucket_elem elem;
+    int address;
     AK_PRO;
-    struct_add *add = (struct_add*) AK_malloc(sizeof (struct_add));
-    add->addBlock = 301;
-    add->indexTd = 2;
-    table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    while (addresses->address_from[i]) {
-        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
-            AK_block *temp = (AK_block*) AK_read_block(j);
-            for (k = 0; k < DATA_BLOCK_SIZE; k++) {
-                if (temp->tuple_dict[k].type == FREE_INT)
-                    break;
-                if (temp->tuple_dict[k].type == MAIN_BUCKET) {
-                    if (n == counter) {
-                        add->addBlock = j;
-                        add->indexTd = k;
-                        end = 1;
-                        break;
-                    }
-                    counter++;
-                }
-            }
-            if (end) break;
-        }
-        i++;
+    address = AK_hash_get_info(indexName, &info);
+    if (address == EXIT_ERROR) {
+        printf("Hash index does not exist!\n");
+        AK_EPI;
+        return;
     }
+    elem.value = hashValue;
+    elem.add = *add;
+    AK_hash_insert_entry(indexName, &info, &elem);
+    AK_hash_put_info(address, &info);
     AK_EPI;
-    return add;
-    AK_free(add);
 }
 
 /**
-  *  @author Mislav Čakarić
-  *  @brief Function that inserts a record in hash bucket
-  *  @param indexName name of index
-  *  @param hashValue hash value of record that is being inserted
-  *  @param add address structure with data where the hash bucket is stored
-  *  @return No return value
+  * @author Mislav Čakarić, updated by Unknown (all matching records, linear hashing)
+  * @brief Function that fetches or deletes records with given values from hash index. Only the chain of one bucket
+  *        is read, the rows of entries with an equal hash value are checked against the values.
+  * @param indexName name of index
+  * @param values list of values (one row) to search in hash index
+  * @param delete if delete is 0 then records are only read otherwise they are deleted from hash index
+  * @param all if 0 only the first matching record is handled
+  * @param rows set to an array of addresses of the records in table
+  * @return number of records found, EXIT_ERROR if there is no such index or not a value for every key column
  */
-void AK_insert_in_hash_index(char *indexName, int hashValue, struct_add *add) {
-    int i, address, size, hash_AK_free_space = 0;
+static int AK_hash_search(char *indexName, struct list_node *values, int delete, int all, struct_add **rows) {
+    hash_info info;
+    hash_node node;
+    bucket_elem elem;
+    unsigned int value;
+    int address, page, i, found = 0, capacity = 4;
     AK_PRO;
-    struct_add *main_add = (struct_add*) AK_malloc(sizeof (struct_add));
-    struct_add *hash_add = (struct_add*) AK_malloc(sizeof (struct_add));
-    main_bucket *temp_main_bucket = (main_bucket*) AK_malloc(sizeof (main_bucket));
-    hash_bucket *temp_hash_bucket = (hash_bucket*) AK_malloc(sizeof (hash_bucket));
-
-    table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    if (addresses->address_from[0] == 0)
+    *rows = (struct_add*) AK_malloc(capacity * sizeof (struct_add));
+    address = AK_hash_get_info(indexName, &info);
+    if (address == EXIT_ERROR) {
         printf("Hash index does not exist!\n");
-    else {
-        char data[255];
-        memset(data, 0, 255);
-        hash_info *info = (hash_info*) AK_malloc(sizeof (hash_info));
-        info = AK_get_hash_info(indexName);
-        if (info->main_bucket_num == 0) {
-            for (i = 0; i < MAIN_BUCKET_SIZE; i++) {
-                temp_main_bucket->element[i].value = i;
-                memset(&temp_main_bucket->element[i].add, 0, sizeof (struct_add));
-            }
-            memcpy(&data, temp_main_bucket, sizeof (main_bucket));
-            main_add = AK_insert_bucket_to_block(indexName, data, MAIN_BUCKET);
-
-            temp_hash_bucket->bucket_level = MAIN_BUCKET_SIZE;
-            for (i = 0; i < HASH_BUCKET_SIZE; i++) {
-                temp_hash_bucket->element[i].value = -1;
-            }
-            memcpy(&data, temp_hash_bucket, sizeof (hash_bucket));
-            for (i = 0; i < MAIN_BUCKET_SIZE; i++) {
-                hash_add = AK_insert_bucket_to_block(indexName, data, HASH_BUCKET);
-
-                memcpy(&temp_main_bucket->element[i].add, hash_add, sizeof (struct_add));
-            }
-            memcpy(&data, temp_main_bucket, sizeof (main_bucket));
-            AK_update_bucket_in_block(main_add, data);
-            AK_change_hash_info(indexName, MAIN_BUCKET_SIZE, 1, MAIN_BUCKET_SIZE);
-        }
-        int hash_bucket_id = hashValue % info->modulo;
-        int main_bucket_id = (int) (hash_bucket_id / MAIN_BUCKET_SIZE);
-
-        main_add = AK_get_nth_main_bucket_add(indexName, main_bucket_id);
-
-        AK_block *temp_block = (AK_block*) AK_read_block(main_add->addBlock);
-        address = temp_block->tuple_dict[main_add->indexTd].address;
-        size = temp_block->tuple_dict[main_add->indexTd].size;
-        memcpy(temp_main_bucket, &temp_block->data[address], size);
-
-        memcpy(hash_add, &temp_main_bucket->element[hash_bucket_id % MAIN_BUCKET_SIZE].add, sizeof (struct_add));
-
-
-        temp_block = (AK_block*) AK_read_block(hash_add->addBlock);
-        address = temp_block->tuple_dict[hash_add->indexTd].address;
-        size = temp_block->tuple_dict[hash_add->indexTd].size;
-        memcpy(temp_hash_bucket, &temp_block->data[address], size);
-        for (i = 0; i < HASH_BUCKET_SIZE; i++) {
-            if (temp_hash_bucket->element[i].value == -1) {
-                hash_AK_free_space = 1;
-                temp_hash_bucket->element[i].value = hashValue;
-                memcpy(&temp_hash_bucket->element[i].add, add, sizeof (struct_add));
-                memcpy(&data, temp_hash_bucket, sizeof (hash_bucket));
-                AK_update_bucket_in_block(hash_add, data);
-                break;
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    if (!AK_hash_values_value(&info, values, &value)) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (page = info.buckets[AK_hash_bucket(&info, value)]; page != 0 && (all || found == 0); page = node.header.next) {
+        AK_hash_read_node(page, &node);
+        for (i = 0; i < node.header.num_entries && (all || found == 0); i++) {
+            if (node.elem[i].value != value || !AK_hash_row_matches(&info, &node.elem[i].add, values))
+                continue;
+            AK_dbg_messg(HIGH, INDICES, "Record found in table block %d and TupleDict ID %d\n",
+                    node.elem[i].add.addBlock, node.elem[i].add.indexTd);
+            if (found == capacity) {
+                capacity *= 2;
+                *rows = (struct_add*) AK_realloc(*rows, capacity * sizeof (struct_add));
             }
+            (*rows)[found++] = node.elem[i].add;
         }
-        if (hash_AK_free_space == 0) {
-
-            if (temp_hash_bucket->bucket_level == info->modulo) {
-                //adding new main buckets
-                for (i = 0; i < info->main_bucket_num; i++) {
-                    main_add = AK_get_nth_main_bucket_add(indexName, i);
-                    AK_block *temp_block = (AK_block*) AK_read_block(main_add->addBlock);
-                    address = temp_block->tuple_dict[main_add->indexTd].address;
-                    size = temp_block->tuple_dict[main_add->indexTd].size;
-                    memcpy(data, &temp_block->data[address], size);
-                    AK_insert_bucket_to_block(indexName, data, MAIN_BUCKET);
-                }
-                AK_change_hash_info(indexName, info->modulo * 2, info->main_bucket_num * 2, info->hash_bucket_num);
-                info = AK_get_hash_info(indexName);
-            }
-            int hash_bucket_id2 = (hash_bucket_id + info->modulo / 2) % info->modulo;
-            int main_bucket_id2 = (int) (hash_bucket_id2 / MAIN_BUCKET_SIZE);
-
-            //swapping hash bucket id's
-            if (hash_bucket_id2 < hash_bucket_id) {
-                int temp = hash_bucket_id;
-                hash_bucket_id = hash_bucket_id2;
-                hash_bucket_id2 = temp;
-                temp = main_bucket_id;
-                main_bucket_id = main_bucket_id2;
-                main_bucket_id2 = temp;
-            }
-
-            hash_bucket *temp_hash_bucket2 = (hash_bucket*) AK_malloc(sizeof (hash_bucket));
-            temp_hash_bucket2->bucket_level = temp_hash_bucket->bucket_level * 2;
-            for (i = 0; i < HASH_BUCKET_SIZE; i++) {
-                temp_hash_bucket2->element[i].value = -1;
-                memset(&temp_hash_bucket2->element[i].add, 0, sizeof (struct_add));
-            }
-            memcpy(data, temp_hash_bucket2, sizeof (hash_bucket));
-            AK_update_bucket_in_block(hash_add, data);
-
-            main_add = AK_get_nth_main_bucket_add(indexName, main_bucket_id2);
-            temp_block = (AK_block*) AK_read_block(main_add->addBlock);
-            address = temp_block->tuple_dict[main_add->indexTd].address;
-            size = temp_block->tuple_dict[main_add->indexTd].size;
-            memcpy(temp_main_bucket, &temp_block->data[address], size);
-
-            hash_add = AK_insert_bucket_to_block(indexName, data, HASH_BUCKET);
-            memcpy(&temp_main_bucket->element[hash_bucket_id2 % MAIN_BUCKET_SIZE].add, hash_add, sizeof (struct_add));
-            memcpy(data, temp_main_bucket, sizeof (main_bucket));
-            AK_update_bucket_in_block(main_add, data);
-
-            AK_change_hash_info(indexName, info->modulo, info->main_bucket_num, info->hash_bucket_num + 1);
-            for (i = 0; i < HASH_BUCKET_SIZE; i++) {
-                int value = temp_hash_bucket->element[i].value;
-                memcpy(main_add, &temp_hash_bucket->element[i].add, sizeof (struct_add));
-                AK_insert_in_hash_index(indexName, value, main_add);
-            }
-            AK_insert_in_hash_index(indexName, hashValue, add);
+    }
+    if (delete == DELETE && found > 0) {
+        elem.value = value;
+        for (i = 0; i < found; i++) {
+            elem.add = (*rows)[i];
+            AK_hash_remove_entry(&info, &elem);
         }
+        AK_hash_put_info(address, &info);
     }
     AK_EPI;
+    return found;
 }
 
 /**
@@ -348,97 +519,34 @@ void AK_insert_in_hash_index(char *indexName, int hashValue, struct_add *add) {
   * @return address structure with data where the record is in table
  
  */
-//Error: expected a ')'
 struct_add *AK_find_delete_in_hash_index(char *indexName, struct list_node *values, int delete) {
     AK_PRO;
     struct_add *add = (struct_add*) AK_malloc(sizeof (struct_add));
+    struct_add *rows;
     memset(add, 0, sizeof (struct_add));
-    table_addresses *addresses = (table_addresses*) AK_get_index_addresses(indexName);
-    if (addresses->address_from[0] == 0) {
-        printf("Hash index does not exist!\n");
-        AK_EPI;
-        return add;
-    } else {
-        int hashValue = 0, address, size, i, j, k, found, match;
-        struct list_node *temp_elem;
-        temp_elem = AK_First_L2(values);
-        while (temp_elem) {
-            hashValue += AK_elem_hash_value(temp_elem);
-            temp_elem = AK_Next_L2(temp_elem);
-        }
-        struct_add *main_add = (struct_add*) AK_malloc(sizeof (struct_add));
-        struct_add *hash_add = (struct_add*) AK_malloc(sizeof (struct_add));
-        main_bucket *temp_main_bucket = (main_bucket*) AK_malloc(sizeof (main_bucket));
-        hash_bucket *temp_hash_bucket = (hash_bucket*) AK_malloc(sizeof (hash_bucket));
-        char data[255];
-        memset(data, 0, 255);
-        hash_info *info = (hash_info*) AK_malloc(sizeof (hash_info));
-        info = AK_get_hash_info(indexName);
-        int hash_bucket_id = hashValue % info->modulo;
-        int main_bucket_id = (int) (hash_bucket_id / MAIN_BUCKET_SIZE);
-
-        main_add = AK_get_nth_main_bucket_add(indexName, main_bucket_id);
-        AK_block *temp_block = (AK_block*) AK_read_block(main_add->addBlock);
-        address = temp_block->tuple_dict[main_add->indexTd].address;
-        size = temp_block->tuple_dict[main_add->indexTd].size;
-        memcpy(temp_main_bucket, &temp_block->data[address], size);
-
-        memcpy(hash_add, &temp_main_bucket->element[hash_bucket_id % MAIN_BUCKET_SIZE].add, sizeof (struct_add));
-
-        temp_block = (AK_block*) AK_read_block(hash_add->addBlock);
-        address = temp_block->tuple_dict[hash_add->indexTd].address;
-        size = temp_block->tuple_dict[hash_add->indexTd].size;
-        memcpy(temp_hash_bucket, &temp_block->data[address], size);
-        for (i = 0; i < HASH_BUCKET_SIZE; i++) {
-            if (temp_hash_bucket->element[i].value == hashValue) {
-                AK_block *temp_table_block = (AK_block*) AK_read_block(temp_hash_bucket->element[i].add.addBlock);
-                j = 0;
-                while (strcmp(temp_block->header[j].att_name, "\0")) {
-                    k = 0;
-                    found = 0;
-                    while (strcmp(temp_table_block->header[k].att_name, "\0")) {
-                        if (strcmp(temp_block->header[j].att_name, temp_table_block->header[k].att_name) == 0) {
-                            found = 1;
-                            match = 0;
-                            int indexTd = temp_hash_bucket->element[i].add.indexTd + k;
-                            int record_address = temp_table_block->tuple_dict[indexTd].address;
-                            int record_size = temp_table_block->tuple_dict[indexTd].size;
-                            int record_type = temp_table_block->tuple_dict[indexTd].type;
-                            memcpy(data, &temp_table_block->data[record_address], record_size);
-                            temp_elem = (struct list_node *)AK_First_L2(values);
-                            while (temp_elem) {
-                                if (temp_elem->type == record_type && memcmp(data, &temp_elem->data, record_size) == 0)
-                                    match = 1;
-                                temp_elem = temp_elem->next;
-                            }
-                            break;
-                        }
-                        k++;
-                    }
-                    if (found == 0 || match == 0) break;
-                    j++;
-                }
-                if (match) {
-                    int addBlock = temp_hash_bucket->element[i].add.addBlock;
-                    int indexTd = temp_hash_bucket->element[i].add.indexTd;
-                    //Error: expected an expression
-                    if (delete==1) {
-                        temp_hash_bucket->element[i].value = -1;
-                        memcpy(data, temp_hash_bucket, sizeof (hash_bucket));
-                        AK_update_bucket_in_block(hash_add, data);
-                    } else
-                        AK_dbg_messg(HIGH, INDICES, "Record found in table block %d and TupleDict ID %d\n", addBlock, indexTd);
-                    add->addBlock = addBlock;
-                    add->indexTd = indexTd;
-                    break;
-                }
-            }
-        }
-    }
+    if (AK_hash_search(indexName, values, delete, 0, &rows) > 0)
+        memcpy(add, rows, sizeof (struct_add));
+    AK_free(rows);
     AK_EPI;
     return add;
 }
 
+/**
+  * @author Unknown
+  * @brief Function that fetches all records with given values from the hash index
+  * @param indexName name of index
+  * @param values list of values (one row) to search in hash index
+  * @param rows set to an array of addresses of the records in table
+  * @return number of records found, EXIT_ERROR if the index can not answer the search
+ */
+int AK_find_all_in_hash_index(char *indexName, struct list_node *values, struct_add **rows) {
+    int found;
+    AK_PRO;
+    found = AK_hash_search(indexName, values, FIND, 1, rows);
+    AK_EPI;
+    return found;
+}
+
 /**
   * @author Mislav Čakarić
   * @brief Function that fetches a record from the hash index
@@ -464,13 +572,50 @@ struct_add * AK_find_in_hash_index(char *indexName, struct list_node *values) {
  */
 void AK_delete_in_hash_index(char *indexName, struct list_node *values) {
     AK_PRO;
-    AK_find_delete_in_hash_index(indexName, values, DELETE);
+    AK_free(AK_find_delete_in_hash_index(indexName, values, DELETE));
     AK_EPI;
 }
 
 /**
-  * @author Mislav Čakarić
-  * @brief Function that creates a hash index
+  * @author Unknown
+  * @brief Function that adds a row of the indexed table to the hash index or removes its record. The values of the
+  *        indexed attributes are read from the block the row is in, only the record of this row is removed. Rows
+  *        with a NULL key are not indexed.
+  * @param indexName name of index
+  * @param block block of the table the row is in
+  * @param row tuple_dict index of the first attribute of the row
+  * @param delete if delete is 0 then the record is inserted otherwise it's deleted from hash index
+  * @return EXIT_SUCCESS, EXIT_ERROR if there is no such index or no page is left
+ */
+int AK_hash_index_row(char *indexName, AK_block *block, int row, int delete) {
+    hash_info info;
+    bucket_elem elem;
+    int address, result = EXIT_SUCCESS;
+    AK_PRO;
+    address = AK_hash_get_info(indexName, &info);
+    if (address == EXIT_ERROR) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    if (!AK_hash_row_value(&info, block, row, &elem.value)) {
+        AK_EPI;
+        return EXIT_SUCCESS;
+    }
+    elem.add.addBlock = block->address;
+    elem.add.indexTd = row;
+    if (delete)
+        AK_hash_remove_entry(&info, &elem);
+    else
+        result = AK_hash_insert_entry(indexName, &info, &elem);
+    AK_hash_put_info(address, &info);
+    AK_EPI;
+    return result;
+}
+
+/**
+  * @author Mislav Čakarić, updated by Unknown (linear hashing)
+  * @brief Function that creates a hash index with HASH_INITIAL_BUCKETS empty buckets and adds every row of the
+  *        table to it
   * @param tblName name of table for which the index is being created
   * @param indexName name of index
   * @param attributes list of attributes over which the index is being created
@@ -478,108 +623,95 @@ void AK_delete_in_hash_index(char *indexName, struct list_node *values) {
  
  */
 int AK_create_hash_index(char *tblName, struct list_node *attributes, char *indexName) {
-    int i, j, k, l, n, exist, hashValue;
+    hash_info *info;
+    table_addresses *addresses;
+    AK_block *block;
+    AK_header i_header[ MAX_ATTRIBUTES ];
+    AK_header *temp, *table_header;
+    bucket_elem elem;
+    int i, j, k, num_attr, startAddress, result = EXIT_SUCCESS;
     AK_PRO;
-    table_addresses *addresses = (table_addresses*) AK_get_table_addresses(tblName);
-    int num_attr = AK_num_attr(tblName);
-    AK_header *table_header = (AK_header *)AK_get_header(tblName);
 
-    AK_header i_header[ MAX_ATTRIBUTES ];
-    AK_header* temp;
+    num_attr = AK_num_attr(tblName);
+    table_header = (AK_header *) AK_get_header(tblName);
+    if (num_attr <= 0 || table_header == NULL) {
+        printf("Table %s does not exist!\n", tblName);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    info = (hash_info*) AK_malloc(sizeof (hash_info));
+    memset(info, 0, sizeof (hash_info));
+    info->magic = HASH_MAGIC;
 
     struct list_node *attribute = (struct list_node *) AK_First_L2(attributes);
-    n = 0;
-    while (attribute != 0) {
-        exist = 0;
-        for (i = 0; i < num_attr; i++) {
-            if (strcmp((table_header + i)->att_name, attribute->data) == 0) {
-				AK_dbg_messg(HIGH, INDICES, "Attribute %s exist in table, found on position: %d\n", (table_header + i)->att_name, i);
-                exist = 1;
-                temp = (AK_header*) AK_create_header((table_header + i)->att_name, (table_header + i)->type, FREE_INT, FREE_CHAR, FREE_CHAR);
-                memcpy(i_header + n, temp, sizeof ( AK_header));
-                n++;
-                if ((table_header + 1)->type != TYPE_VARCHAR && (table_header + 1)->type != TYPE_INT) {
-                    printf("Unsupported data type for hash index! Only int and varchar!");
-                    AK_EPI;
-                    return EXIT_ERROR;
-                }
-            }
-        }
-        if (!exist) {
+    while (attribute != 0 && info->num_columns < MAX_ATTRIBUTES) {
+        for (i = 0; i < num_attr && strcmp((table_header + i)->att_name, attribute->data) != 0; i++)
+            ;
+        if (i == num_attr) {
             printf("Atribut %s ne postoji u tablici", attribute->data);
+            AK_free(info);
             AK_EPI;
             return EXIT_ERROR;
         }
+        if ((table_header + i)->type == TYPE_BLOB) {
+            printf("Unsupported data type for hash index!");
+            AK_free(info);
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+        AK_dbg_messg(HIGH, INDICES, "Attribute %s exist in table, found on position: %d\n", (table_header + i)->att_name, i);
+        temp = (AK_header*) AK_create_header((table_header + i)->att_name, (table_header + i)->type, FREE_INT, FREE_CHAR, FREE_CHAR);
+        memcpy(i_header + info->num_columns, temp, sizeof ( AK_header));
+        AK_free(temp);
+        info->column_types[info->num_columns] = (table_header + i)->type;
+        info->column_positions[info->num_columns] = i;
+        info->num_columns++;
         attribute = attribute->next;
     }
-    memset(i_header + n, 0, MAX_ATTRIBUTES - n);
+    if (info->num_columns == 0) {
+        AK_free(info);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    memset(i_header + info->num_columns, 0, (MAX_ATTRIBUTES - info->num_columns) * sizeof (AK_header));
+
+    //registered in AK_index, where the planner looks for indexes of the table
+    startAddress = AK_initialize_new_index_segment(indexName, AK_get_table_obj_id(tblName), info->column_positions[0], i_header);
+    if (startAddress == EXIT_ERROR) {
+        AK_free(info);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    printf("\nINDEX %s CREATED!\n", indexName);
 
-    int startAddress = AK_initialize_new_segment(indexName, SEGMENT_TYPE_INDEX, i_header);
-    if (startAddress != EXIT_ERROR)
-        printf("\nINDEX %s CREATED!\n", indexName);
+    info->last_page = startAddress;
+    info->num_buckets = HASH_INITIAL_BUCKETS;
+    for (i = 0; i < HASH_INITIAL_BUCKETS && result == EXIT_SUCCESS; i++) {
+        info->buckets[i] = AK_hash_alloc_page(indexName, info);
+        result = info->buckets[i] == EXIT_ERROR ? EXIT_ERROR : AK_hash_write_chain(indexName, info, info->buckets[i], NULL, 0);
+    }
 
-    AK_block *block = (AK_block*) AK_read_block(startAddress);
-    hash_info *info = (hash_info*) AK_malloc(sizeof (hash_info));
-    info->modulo = 4;
-    info->main_bucket_num = 0;
-    info->hash_bucket_num = 0;
-    memcpy(block->data, info, sizeof (hash_info));
-    block->tuple_dict[0].address = 0;
-    block->tuple_dict[0].type = INFO_BUCKET;
-    block->tuple_dict[0].size = sizeof (hash_info);
-    block->AK_free_space += sizeof (hash_info);
-    block->last_tuple_dict_id = 0;
-    AK_write_block(block);
-
-    struct list_node *temp_elem;
-
-    char data[ MAX_VARCHAR_LENGTH ];
-    struct list_node *row = (struct list_node *) AK_malloc(sizeof (struct list_node));
-    AK_Init_L3(&row);
-    i = 0;
-    n = 0;
-    while (addresses->address_from[ i ]) {
-        for (j = addresses->address_from[ i ]; j < addresses->address_to[ i ]; j++) {
-            AK_block *temp = (AK_block*) AK_read_block(j);
-            for (k = 0; k < DATA_BLOCK_SIZE; k += num_attr) {
-                n++;
-                if (temp->tuple_dict[k].type == FREE_INT)
-                    break;
-                for (l = 0; l < num_attr; l++) {
-                    int type = temp->tuple_dict[ k + l ].type;
-                    int size = temp->tuple_dict[ k + l ].size;
-                    int address = temp->tuple_dict[ k + l ].address;
-                    memcpy(data, &(temp->data[address]), size);
-                    data[ size ] = '\0';
-                    AK_InsertAtEnd_L3(type, data, size, row);
-                }
-                /* *************** */
-                hashValue = 0;
-                attribute = (struct list_node *) AK_First_L2(attributes);
-                while (attribute) {
-
-                    for (l = 0; l < num_attr; l++) {
-                        if (strcmp((table_header + l)->att_name, attribute->data) == 0)
-                            break;
-                    }
-                    temp_elem = AK_GetNth_L2(l, row);
-                    hashValue += AK_elem_hash_value(temp_elem);
-
-                    attribute = attribute->next;
-                }
-                AK_dbg_messg(HIGH, INDICES, "Insert in hash index %d. record\n", n);
-                struct_add *add = (struct_add*) AK_malloc(sizeof (struct_add));
-                add->addBlock = j;
-                add->indexTd = k;
-                AK_insert_in_hash_index(indexName, hashValue, add);
-                AK_DeleteAll_L3(&row);
-                /* *************** */
+    addresses = (table_addresses*) AK_get_table_addresses(tblName);
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0 && result == EXIT_SUCCESS; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i] && result == EXIT_SUCCESS; j++) {
+            block = AK_get_block(j)->block;
+            for (k = 0; k + num_attr <= DATA_BLOCK_SIZE && block->tuple_dict[k].type != FREE_INT && result == EXIT_SUCCESS; k += num_attr) {
+                //deleted row, NULL keys are not indexed
+                if (block->tuple_dict[k].type == TYPE_INTERNAL || !AK_hash_row_value(info, block, k, &elem.value))
+                    continue;
+                elem.add.addBlock = j;
+                elem.add.indexTd = k;
+                AK_dbg_messg(HIGH, INDICES, "Insert in hash index %d. record\n", info->num_entries);
+                result = AK_hash_insert_entry(indexName, info, &elem);
+                block = AK_get_block(j)->block;
             }
         }
-        i++;
     }
+    AK_free(addresses);
+    AK_hash_put_info(startAddress, info);
+    AK_free(info);
     AK_EPI;
-    return EXIT_SUCCESS;
+    return result;
 }
 
 void AK_delete_hash_index(char *indexName) {
@@ -590,69 +722,190 @@ void AK_delete_hash_index(char *indexName) {
 }
 
 /**
-  * @author Mislav Čakarić
+  * @author Unknown
+  * @brief Function that checks the structure of a hash index: every entry is in the bucket of its hash value and
+  *        the buckets hold all entries
+  * @param indexName name of index
+  * @param info set to the info of the index
+  * @return number of entries, EXIT_ERROR if the index is damaged
+ */
+static int AK_hash_check(char *indexName, hash_info *info) {
+    hash_node node;
+    int bucket, page, i, count = 0;
+    if (AK_hash_get_info(indexName, info) == EXIT_ERROR)
+        return EXIT_ERROR;
+    for (bucket = 0; bucket < info->num_buckets; bucket++) {
+        for (page = info->buckets[bucket]; page != 0; page = node.header.next) {
+            AK_hash_read_node(page, &node);
+            if (node.header.type != HASH_BUCKET)
+                return EXIT_ERROR;
+            for (i = 0; i < node.header.num_entries; i++) {
+                if (AK_hash_bucket(info, node.elem[i].value) != bucket)
+                    return EXIT_ERROR;
+            }
+            count += node.header.num_entries;
+        }
+    }
+    return count == info->num_entries ? count : EXIT_ERROR;
+}
+
+static int hash_test_run_count = 0;
+
+/**
+  * @author Unknown
+  * @brief Function that counts the rows a hash index finds for values
+  * @param indexName name of index
+  * @param values values of the key columns
+  * @return number of rows found
+ */
+static int AK_hash_test_count(char *indexName, struct list_node *values) {
+    struct_add *rows;
+    int found = AK_find_all_in_hash_index(indexName, values, &rows);
+    if (rows != NULL)
+        AK_free(rows);
+    AK_DeleteAll_L3(&values);
+    return found;
+}
+
+/**
+  * @author Mislav Čakarić, updated by Unknown (linear hashing)
   * @brief Function that tests hash index
-  * @return No return value 
+  * @return TestResult
  */
 TestResult AK_hash_test() {
     int passedTest = 0;
     int failedTest = 0;
     char *tblName = "student";
     char *indexName = "student_hash_index";
-    //AK_print_table("AK_relation");
+    char *anagrams[6] = {"listen", "silent", "enlist", "tinsel", "inlets", "elints"};
+    char table[MAX_ATT_NAME], id_index[MAX_ATT_NAME], name_index[MAX_ATT_NAME];
+    struct list_node *att_list, *values, *row, *value;
+    struct_add *add;
+    hash_info info;
+    int i, ok, num_rec, id;
     AK_PRO;
-    struct list_node *att_list = (struct list_node *) AK_malloc(sizeof (struct list_node));
+
+    AK_header header[3] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "name", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    /* 1: index on two attributes of a table, every row is found by its key */
+    printf("\nHash index create test\n");
+    att_list = (struct list_node *) AK_malloc(sizeof (struct list_node));
     AK_Init_L3(&att_list);
     AK_InsertAtEnd_L3(TYPE_ATTRIBS, "mbr\0", 4, att_list);
     AK_InsertAtEnd_L3(TYPE_ATTRIBS, "firstname\0", 10, att_list);
-
-    if(AK_create_hash_index(tblName, att_list, indexName) == EXIT_ERROR){
-    	failedTest++;
+    values = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&values);
+    num_rec = AK_get_num_records(tblName);
+    ok = AK_create_hash_index(tblName, att_list, indexName) == EXIT_SUCCESS
+            && AK_hash_check(indexName, &info) == num_rec && info.num_buckets == HASH_INITIAL_BUCKETS;
+    printf("Buckets:%d, Pages:%d, Entries:%d\n", info.num_buckets, info.num_pages, info.num_entries);
+    for (i = 0; ok && i < num_rec; i++) {
+        row = AK_get_row(i, tblName);
+        value = AK_GetNth_L2(1, row);
+        AK_InsertAtEnd_L3(value->type, value->data, value->size, values);
+        value = AK_GetNth_L2(2, row);
+        AK_InsertAtEnd_L3(value->type, value->data, value->size, values);
+        add = AK_find_in_hash_index(indexName, values);
+        ok = add->addBlock != 0 && *(int *) (AK_get_block(add->addBlock)->block->data
+                + AK_get_block(add->addBlock)->block->tuple_dict[add->indexTd].address) == *(int *) AK_GetNth_L2(1, row)->data;
+        AK_free(add);
+        AK_DeleteAll_L3(&values);
+        AK_DeleteAll_L3(&row);
+        AK_free(row);
     }
-    else{
-    	passedTest++;
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
     }
 
-    struct list_node *values = (struct list_node *) AK_malloc(sizeof (struct list_node));
-    struct list_node *row = (struct list_node *) AK_malloc(sizeof (struct list_node));
-    AK_Init_L3(&values);
-
-    //AK_delete_hash_index(indexName);
-
-    hash_info *info = (hash_info*) AK_malloc(sizeof (hash_info));
-    info = AK_get_hash_info(indexName);
-    if(info == NULL){
-    	failedTest++;
+    /* 2: keys with many duplicates and anagrams, the buckets split while rows are inserted */
+    printf("\nHash index split test\n");
+    sprintf(table, "hash_test_%d", hash_test_run_count++);
+    sprintf(id_index, "%s_id", table);
+    sprintf(name_index, "%s_name", table);
+    AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, header);
+    row = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row);
+    for (id = 0; id < 1500; id++) {
+        // the indexes are created after the first rows, the rest is added by the inserts
+        if (id == 100) {
+            AK_DeleteAll_L3(&att_list);
+            AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), att_list);
+            AK_create_hash_index(table, att_list, id_index);
+            AK_DeleteAll_L3(&att_list);
+            AK_InsertAtEnd_L3(TYPE_ATTRIBS, "name", sizeof ("name"), att_list);
+            AK_create_hash_index(table, att_list, name_index);
+        }
+        AK_DeleteAll_L3(&row);
+        i = id % 300;
+        AK_Insert_New_Element(TYPE_INT, &i, table, "id", row);
+        AK_Insert_New_Element(TYPE_VARCHAR, anagrams[id % 6], table, "name", row);
+        AK_insert_row(row);
     }
-    else{
-    	passedTest++;
+    ok = AK_hash_check(id_index, &info) == 1500 && info.num_buckets > HASH_INITIAL_BUCKETS
+            && AK_hash_check(name_index, &info) == 1500 && info.num_buckets > HASH_INITIAL_BUCKETS
+            && AK_index_kind(id_index) == INDEX_KIND_HASH;
+    printf("Buckets:%d, Pages:%d, Entries:%d\n", info.num_buckets, info.num_pages, info.num_entries);
+    for (i = 0; ok && i < 300; i++) {
+        AK_InsertAtEnd_L3(TYPE_INT, (char *) &i, sizeof (int), values);
+        ok = AK_hash_test_count(id_index, values) == 5;
+    }
+    for (i = 0; ok && i < 6; i++) {
+        AK_InsertAtEnd_L3(TYPE_VARCHAR, anagrams[i], strlen(anagrams[i]), values);
+        ok = AK_hash_test_count(name_index, values) == 250;
+    }
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "islent", strlen("islent"), values);
+    ok = ok && AK_hash_test_count(name_index, values) == 0;
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
     }
-    printf("Main buckets:%d, Hash buckets:%d, Modulo:%d\n", info->main_bucket_num, info->hash_bucket_num, info->modulo);
-
-    //AK_delete_hash_index(indexName);
-    AK_print_table("AK_relation");
-    AK_print_table("AK_index");
 
-    printf("Hash index search test:\n");
-    int i, num_rec = AK_get_num_records(tblName);
-    for (i = 0; i < num_rec; i++) {
-        row = AK_get_row(i, tblName);
-        struct list_node *value = AK_GetNth_L2(1, row);
-        AK_InsertAtEnd_L3(value->type, value->data, value->size, values);
-        value = AK_GetNth_L2(1, row);
-        AK_InsertAtEnd_L3(value->type, value->data, value->size, values);
-        struct_add *add = AK_find_in_hash_index(indexName, values);
-        if(add->addBlock == NULL){
-    		failedTest++;
-    	}
-    	else{
-    		passedTest++;
-    	}
-        AK_DeleteAll_L3(&values);
-        if (add->addBlock && add->indexTd)
-            printf("Record found in table block %d and TupleDict ID %d\n", add->addBlock, add->indexTd);
+    /* 3: deleted rows and records are no longer found, the other ones are */
+    printf("\nHash index delete test\n");
+    AK_DeleteAll_L3(&row);
+    id = 7;
+    AK_Update_Existing_Element(TYPE_INT, &id, table, "id", row);
+    AK_delete_row(row);
+    id = 8;
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &id, sizeof (int), values);
+    AK_delete_in_hash_index(id_index, values);
+    AK_DeleteAll_L3(&values);
+    ok = AK_hash_check(id_index, &info) == 1494 && AK_hash_check(name_index, &info) == 1495;
+    for (i = 0; ok && i < 300; i++) {
+        AK_InsertAtEnd_L3(TYPE_INT, (char *) &i, sizeof (int), values);
+        ok = AK_hash_test_count(id_index, values) == (i == 7 ? 0 : i == 8 ? 4 : 5);
     }
-    printf("hash_test: Present!\n");
+    // rows 7, 307, ... of id 7 had every sixth name starting from the second
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, anagrams[1], strlen(anagrams[1]), values);
+    ok = ok && AK_hash_test_count(name_index, values) == 245;
+    if (ok) {
+        printf("SUCCESS\n");
+        passedTest++;
+    } else {
+        printf("FAIL\n");
+        failedTest++;
+    }
+
+    AK_delete_hash_index(indexName);
+    AK_delete_hash_index(id_index);
+    AK_delete_hash_index(name_index);
+    AK_delete_segment(table, SEGMENT_TYPE_TABLE);
+    AK_DeleteAll_L3(&row);
+    AK_free(row);
+    AK_DeleteAll_L3(&att_list);
+    AK_free(att_list);
+    AK_free(values);
     AK_EPI;
-    return TEST_result(passedTest,failedTest);
+    return TEST_result(passedTest, failedTest);
 }
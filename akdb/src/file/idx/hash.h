@@ -20,6 +20,7 @@
 #ifndef HASH
 #define HASH
 
+#include <limits.h>
 #include "../../auxi/test.h"
 #include "index.h"
 #include "../../file/table.h"
@@ -27,19 +28,66 @@
 #include "../../auxi/configuration.h"
 #include "../files.h"
 #include "../../auxi/mempro.h"
+#include "../../auxi/comparator.h"
+
+/**
+ * @def HASH_PAGE_SIZE
+ * @brief size of a bucket page, every page is the data of one block of the index segment
+ */
+#define HASH_PAGE_SIZE (DATA_BLOCK_SIZE * DATA_ENTRY_SIZE)
+/**
+ * @def HASH_INITIAL_BUCKETS
+ * @brief number of buckets of a new hash index, a power of two
+ */
+#define HASH_INITIAL_BUCKETS 4
+/**
+ * @def HASH_MAX_BUCKETS
+ * @brief largest number of buckets, the primary pages of all buckets are kept in the first block of the index.
+ *        Buckets of a larger index grow overflow pages instead of splitting.
+ */
+#define HASH_MAX_BUCKETS 1024
+/**
+ * @def HASH_MAGIC
+ * @brief marks the first block of a hash index segment
+ */
+#define HASH_MAGIC 0x48415348
+
+//types for tuple_dict, INFO_BUCKET and HASH_BUCKET are in constants.h
+#define HASH_FREE_PAGE 3
 
 /**
  * @author Unknown
  * @struct hash_info
- * @brief Structure for defining a hash info element
+ * @brief Structure stored in the first block of a hash index segment. The index is a linear hash table: bucket
+ *        addresses are taken from the low level bits of the hash value, or from level + 1 bits for the buckets
+ *        below split, which were split already in this round. One bucket is split at a time when the index fills
+ *        up, so an insert never reorganises more than one bucket.
 */
 typedef struct {
-	/// modulo value for hash function
-    int modulo;
-    /// bucket number
-    int main_bucket_num;
-    /// hash bucket number
-    int hash_bucket_num;
+    /// HASH_MAGIC
+    int magic;
+    /// number of times the table of buckets doubled
+    int level;
+    /// next bucket to split
+    int split;
+    /// number of buckets
+    int num_buckets;
+    /// number of entries in the buckets
+    int num_entries;
+    /// number of pages in use
+    int num_pages;
+    /// block of the page allocated last
+    int last_page;
+    /// first page of the list of freed pages, 0 if the list is empty
+    int free_page;
+    /// number of key columns
+    int num_columns;
+    /// types of the key columns
+    int column_types[MAX_ATTRIBUTES];
+    /// positions of the key columns in the table
+    int column_positions[MAX_ATTRIBUTES];
+    /// primary page of every bucket
+    int buckets[HASH_MAX_BUCKETS];
 } hash_info;
 
 /**
@@ -56,64 +104,32 @@ typedef struct {
 
 /**
  * @author Unknown
- * @struct main_bucket
- * @brief Structure for defining main bucket for table hashing
+ * @struct hash_page
+ * @brief Header at the start of a bucket page, it is followed by num_entries bucket_elem entries
  */
 typedef struct {
-	/// main bucket array of bucket_elem elements
-    bucket_elem element[MAIN_BUCKET_SIZE];
-} main_bucket;
+    /// HASH_BUCKET or HASH_FREE_PAGE
+    int type;
+    /// number of entries
+    int num_entries;
+    /// next overflow page of the bucket, next free page of a free page, 0 if there is none
+    int next;
+} hash_page;
 
 /**
- * @author Unknown
- * @struct hash_bucket
- * @brief Structure for hash bucket for table hashing
+ * @def HASH_PAGE_ENTRIES
+ * @brief number of entries that fit into a bucket page
  */
-typedef struct {
-	/// hash bucket level
-    int bucket_level;
-    /// hash bucket array of bucket_elem elements
-    bucket_elem element[HASH_BUCKET_SIZE];
-} hash_bucket;
+#define HASH_PAGE_ENTRIES ((int) ((HASH_PAGE_SIZE - sizeof (hash_page)) / sizeof (bucket_elem)))
 
 /**
   * @author Mislav Čakarić
-  * @brief Function that computes a hash value from varchar or integer
+  * @brief Function that computes a hash value of an element with the hash function registered for its type
   * @param elem element of row for wich value is to be computed
   * @return hash value
  
  */
-int AK_elem_hash_value(struct list_node *elem);
-
-/**
-  * @author Mislav Čakarić
-  * @brief Function that inserts a bucket to block
-  * @param indexName name of index
-  * @param data content of bucket stored in char array
-  * @param type type of bucket (MAIN_BUCKET or HASH_BUCKET)
-  * @return address structure with data where the bucket is stored 
- */
-struct_add* AK_insert_bucket_to_block(char *indexName, char *data, int type);
-
-/**
-  *  @author Mislav Čakarić
-  *  @brief Function that updates a bucket in block
-  *  @param add address of where the bucket is stored
-  *  @param data content of bucket stored in char array
-  *  @return No return value
- */
-void AK_update_bucket_in_block(struct_add *add, char *data);
-
-/**
-  * @author Mislav Čakarić
-  * @brief Function that changes a info of hash index
-  * @param indexName name of index
-  * @param modulo value for modulo hash function
-  * @param main_bucket_num number of main buckets
-  * @param hash_bucket_num number of hash buckets
-  * @return No return value
- */
-void AK_change_hash_info(char *indexName, int modulo, int main_bucket_num, int hash_bucket_num);
+unsigned int AK_elem_hash_value(struct list_node *elem);
 
 /**
   * @author Mislav Čakarić
@@ -123,24 +139,15 @@ void AK_change_hash_info(char *indexName, int modulo, int main_bucket_num, int h
  */
 hash_info* AK_get_hash_info(char *indexName);
 
-/**
-  * @author Mislav Čakarić
-  * @brief Function that fetches nth main bucket
-  * @param indexName name of index
-  * @param n number of main bucket
-  * @return address structure with data where the bucket is stored
- */
-struct_add* AK_get_nth_main_bucket_add(char *indexName, int n);
-
 /**
   *  @author Mislav Čakarić
   *  @brief Function that inserts a record in hash bucket
   *  @param indexName name of index
   *  @param hashValue hash value of record that is being inserted
-  *  @param add address structure with data where the hash bucket is stored
+  *  @param add address of the record in table
   *  @return No return value
  */
-void AK_insert_in_hash_index(char *indexName, int hashValue, struct_add *add);
+void AK_insert_in_hash_index(char *indexName, unsigned int hashValue, struct_add *add);
 
 /**
   * @author Mislav Čakarić
@@ -163,6 +170,16 @@ struct_add *AK_find_delete_in_hash_index(char *indexName, struct list_node *valu
  */
 struct_add * AK_find_in_hash_index(char *indexName, struct list_node *values);
 
+/**
+  * @author Unknown
+  * @brief Function that fetches all records with given values from the hash index
+  * @param indexName name of index
+  * @param values list of values (one row) to search in hash index
+  * @param rows set to an array of addresses of the records in table
+  * @return number of records found
+ */
+int AK_find_all_in_hash_index(char *indexName, struct list_node *values, struct_add **rows);
+
 /**
   * @author Mislav Čakarić
   * @brief Function that deletes a record from the hash index
@@ -183,6 +200,17 @@ void AK_delete_in_hash_index(char *indexName, struct list_node *values);
  
  */
 int AK_create_hash_index(char *tblName, struct list_node *attributes, char *indexName);
+
+/**
+  * @author Unknown
+  * @brief Function that adds a row of the indexed table to the hash index or removes its record
+  * @param indexName name of index
+  * @param block block of the table the row is in
+  * @param row tuple_dict index of the first attribute of the row
+  * @param delete if delete is 0 then the record is inserted otherwise it's deleted from hash index
+  * @return EXIT_SUCCESS, EXIT_ERROR if there is no such index
+ */
+int AK_hash_index_row(char *indexName, AK_block *block, int row, int delete);
 void AK_delete_hash_index(char *indexName) ;
 
 /**
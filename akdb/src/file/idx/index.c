@@ -24,6 +24,9 @@
 #include "../../file/table.h"
 #include "../../file/fileio.h"
 #include "../../file/files.h"
+#include "btree.h"
+#include "hash.h"
+#include "bitmap.h"
 
 /**
  * @author Unknown
@@ -559,6 +562,155 @@ void AK_print_index_table(char *indexTblName) {
 
 
 
+/**
+ * @author Unknown
+ * @brief Function that finds out the kind of an index from its first block. A B+tree starts with its meta block,
+ *        a hash index with its info bucket and a bitmap index with its meta block.
+ * @param indexName name of the index
+ * @return INDEX_KIND_BTREE, INDEX_KIND_HASH, INDEX_KIND_BITMAP or INDEX_KIND_NONE
+ */
+int AK_index_kind(char *indexName) {
+    table_addresses *addresses;
+    AK_block *block;
+    int kind = INDEX_KIND_NONE;
+    AK_PRO;
+    addresses = (table_addresses*) AK_get_index_addresses(indexName);
+    if (addresses->address_from[0] != 0) {
+        block = AK_get_block(addresses->address_from[0])->block;
+        if (block->tuple_dict[0].type == BTREE_META && block->tuple_dict[0].size == sizeof (btree_meta)
+                && ((btree_meta *) block->data)->magic == BTREE_MAGIC)
+            kind = INDEX_KIND_BTREE;
+        else if (block->tuple_dict[0].type == INFO_BUCKET && block->tuple_dict[0].size == sizeof (hash_info)
+                && ((hash_info *) block->data)->magic == HASH_MAGIC)
+            kind = INDEX_KIND_HASH;
+        else if (block->tuple_dict[0].type == BITMAP_META && block->tuple_dict[0].size == sizeof (bitmap_meta)
+                && ((bitmap_meta *) block->data)->magic == BITMAP_MAGIC)
+            kind = INDEX_KIND_BITMAP;
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return kind;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that lists the indexes registered for a table in AK_index. Rows of AK_index are obj_id, name,
+ *        start_address, end_address, table_id and attribute_id, an index has a row for every extent.
+ * @param tblName table name
+ * @param indexes array the indexes are written to
+ * @param max size of the array
+ * @return number of indexes found
+ */
+int AK_get_table_indexes(char *tblName, AK_index_info *indexes, int max) {
+    table_addresses *addresses;
+    AK_block *block;
+    char name[MAX_ATT_NAME];
+    int table_id, row_table_id, num_attr, i, j, k, n, num = 0;
+    AK_PRO;
+    table_id = AK_get_table_obj_id(tblName);
+    if (table_id == EXIT_ERROR) {
+        AK_EPI;
+        return 0;
+    }
+    //the rows are read in place from the blocks of AK_index
+    num_attr = AK_num_attr("AK_index");
+    addresses = AK_get_table_addresses("AK_index");
+    for (i = 0; num < max && i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; num < max && j < addresses->address_to[i]; j++) {
+            block = AK_get_block(j)->block;
+            if (block->last_tuple_dict_id == 0)
+                break;
+            for (k = 0; num < max && k + num_attr <= DATA_BLOCK_SIZE; k += num_attr) {
+                //deleted rows have no size
+                if (block->tuple_dict[k].size <= 0 || block->tuple_dict[k + 1].size >= MAX_ATT_NAME)
+                    continue;
+                memcpy(&row_table_id, block->data + block->tuple_dict[k + 4].address, sizeof (int));
+                if (row_table_id != table_id)
+                    continue;
+                memcpy(name, block->data + block->tuple_dict[k + 1].address, block->tuple_dict[k + 1].size);
+                name[block->tuple_dict[k + 1].size] = '\0';
+                for (n = 0; n < num && strcmp(indexes[n].name, name) != 0; n++)
+                    ;
+                if (n < num)
+                    continue;
+                strcpy(indexes[num].name, name);
+                memcpy(&indexes[num].attribute, block->data + block->tuple_dict[k + 5].address, sizeof (int));
+                indexes[num].kind = AK_index_kind(name);
+                if (indexes[num].kind != INDEX_KIND_NONE)
+                    num++;
+                //AK_index_kind reads the index, the block may have left the cache
+                block = AK_get_block(j)->block;
+            }
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return num;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that searches an index of any kind for the rows with key values between two bounds. B+trees
+ *        answer ranges, hash and bitmap indexes only searches for one value.
+ * @param index index to search
+ * @param lower values of the lower bound, an empty list for no lower bound
+ * @param upper values of the upper bound, an empty list for no upper bound, NULL to search for lower only
+ * @param rows set to an array of the addresses of the rows found
+ * @return number of rows found, EXIT_ERROR if the index can not answer the search
+ */
+int AK_index_search(AK_index_info *index, struct list_node *lower, struct list_node *upper, struct_add **rows) {
+    struct list_node *value = (struct list_node *) AK_First_L2(lower);
+    int found = EXIT_ERROR;
+    AK_PRO;
+    *rows = NULL;
+    switch (index->kind) {
+        case INDEX_KIND_BTREE:
+            found = AK_btree_search_delete(index->name, lower, upper, 0, rows);
+            break;
+        case INDEX_KIND_HASH:
+            if (upper == NULL && value != NULL)
+                found = AK_find_all_in_hash_index(index->name, lower, rows);
+            break;
+        case INDEX_KIND_BITMAP:
+            if (upper == NULL && value != NULL)
+                found = AK_bitmap_search(index->name, value, rows);
+            break;
+    }
+    if (found == EXIT_ERROR && *rows != NULL) {
+        AK_free(*rows);
+        *rows = NULL;
+    }
+    AK_EPI;
+    return found;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds a row of the indexed table to an index of any kind or removes its entry
+ * @param index index to update
+ * @param block block of the table the row is in
+ * @param row tuple_dict index of the first attribute of the row
+ * @param delete if 0 the row is added else it is removed
+ * @return EXIT_SUCCESS, EXIT_ERROR if the index could not be updated
+ */
+int AK_index_row(AK_index_info *index, AK_block *block, int row, int delete) {
+    int result = EXIT_ERROR;
+    AK_PRO;
+    switch (index->kind) {
+        case INDEX_KIND_BTREE:
+            result = AK_btree_index_row(index->name, block, row, delete);
+            break;
+        case INDEX_KIND_HASH:
+            result = AK_hash_index_row(index->name, block, row, delete);
+            break;
+        case INDEX_KIND_BITMAP:
+            result = AK_bitmap_index_row(index->name, index->attribute, block, row, delete);
+            break;
+    }
+    AK_EPI;
+    return result;
+}
+
 /**
  * @author Lovro Predovan
  * @brief  Test funtion for index structures(list) and printing table
@@ -657,7 +809,7 @@ void AK_index_test() {
 
     AK_print_table(tblName);
     AK_print_table("AK_index");
-    AK_print_index_table(indexTblName);
+    AK_bitmap_print(indexTblName);
 
     printf("\n\nIndex table %s exists: %i\n\n",indexTblName,AK_index_table_exist(indexTblName));
     printf("Number of rows in index %s: %i\n\n",indexTblName,AK_get_index_num_records(indexTblName));
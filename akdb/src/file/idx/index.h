@@ -107,6 +107,14 @@ int AK_get_index_num_records(char *indexTblName);
  * */
 int AK_num_index_attr(char *indexTblName);
 
+/**
+ * @author Matija Šestak, modified for indexes by Lovro Predovan
+ * @brief  Function that gets index table header
+ * @param  *indexTblName index table name
+ * @result array of index table header, 0 if there is no such index
+ */
+AK_header *AK_get_index_header(char *indexTblName);
+
 struct list_node *AK_get_index_tuple(int row, int column, char *indexTblName);
 
 /**
@@ -187,6 +195,86 @@ void AK_Delete_All_elementsAd(list_ad *L) ;
  * */
 void AK_Insert_NewelementAd(int addBlock, int indexTd, char *attName, element_ad elementBefore);
 
+/**
+ * @def INDEX_KIND_NONE
+ * @brief segment that is not an index of a known kind
+ */
+#define INDEX_KIND_NONE 0
+/**
+ * @def INDEX_KIND_BTREE
+ * @brief B+tree index, answers equality and range searches
+ */
+#define INDEX_KIND_BTREE 1
+/**
+ * @def INDEX_KIND_HASH
+ * @brief hash index, answers equality searches
+ */
+#define INDEX_KIND_HASH 2
+/**
+ * @def INDEX_KIND_BITMAP
+ * @brief bitmap index, answers equality searches
+ */
+#define INDEX_KIND_BITMAP 3
+/**
+ * @def MAX_TABLE_INDEXES
+ * @brief largest number of indexes of one table the planner looks at
+ */
+#define MAX_TABLE_INDEXES 16
+
+/**
+  * @author Unknown
+  * @struct AK_index_info
+  * @brief Structure describing an index of a table as registered in AK_index
+ */
+typedef struct {
+	/// name of the index
+	char name[MAX_ATT_NAME];
+	/// INDEX_KIND_BTREE, INDEX_KIND_HASH or INDEX_KIND_BITMAP
+	int kind;
+	/// position of the indexed attribute in the table
+	int attribute;
+} AK_index_info;
+
+/**
+ * @author Unknown
+ * @brief Function that finds out the kind of an index from its first block
+ * @param indexName name of the index
+ * @return INDEX_KIND_BTREE, INDEX_KIND_HASH, INDEX_KIND_BITMAP or INDEX_KIND_NONE
+ */
+int AK_index_kind(char *indexName);
+
+/**
+ * @author Unknown
+ * @brief Function that lists the indexes registered for a table in AK_index
+ * @param tblName table name
+ * @param indexes array the indexes are written to
+ * @param max size of the array
+ * @return number of indexes found
+ */
+int AK_get_table_indexes(char *tblName, AK_index_info *indexes, int max);
+
+/**
+ * @author Unknown
+ * @brief Function that searches an index of any kind for the rows with key values between two bounds
+ * @param index index to search
+ * @param lower values of the lower bound, an empty list for no lower bound
+ * @param upper values of the upper bound, an empty list for no upper bound, NULL to search for lower only
+ * @param rows set to an array of the addresses of the rows found
+ * @return number of rows found, EXIT_ERROR if the index can not answer the search
+ */
+int AK_index_search(AK_index_info *index, struct list_node *lower, struct list_node *upper, struct_add **rows);
+
+/**
+ * @author Unknown
+ * @brief Function that adds a row of the indexed table to an index of any kind or removes its entry
+ * @param index index to update
+ * @param block block of the table the row is in
+ * @param row tuple_dict index of the first attribute of the row
+ * @param delete if 0 the row is added else it is removed
+ * @return EXIT_SUCCESS, EXIT_ERROR if the index could not be updated
+ */
+int AK_index_row(AK_index_info *index, AK_block *block, int row, int delete);
+
 void AK_index_test();
 
 
@@ -0,0 +1,273 @@
+/**
+@file pax.c Provides functions for column-grouped (PAX) table blocks. A block of a SEGMENT_TYPE_PAX_TABLE segment
+keeps the values of every column in its own area of data, in row order, while tuple_dict still lists the entries
+row by row. Row readers follow tuple_dict as for any other block, column readers find all values of a column in
+one contiguous range (AK_pax_column).
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "pax.h"
+#include "fileio.h"
+#include "vacuum.h"
+
+/**
+ * @author Unknown
+ * @brief Function that counts the attributes of the rows of a block
+ * @param block block
+ * @return number of attributes
+ */
+static int AK_pax_num_attr(AK_block *block) {
+    int num_attr = 0;
+    while (num_attr < MAX_ATTRIBUTES && block->header[num_attr].att_name[0] != FREE_CHAR)
+        num_attr++;
+    return num_attr;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reserves space for a new value of a column in a block. A row block appends the value at
+ *        AK_free_space. A PAX block inserts it at the end of the area of the column: the areas of the following
+ *        columns move up by size bytes and the addresses of their entries with them, so AK_free_space still
+ *        marks the end of the used data.
+ * @param block block the value is written to
+ * @param column index of the column in the block header
+ * @param size size of the value in bytes
+ * @return address in data to copy the value to, EXIT_ERROR if a PAX block has no room for it
+ */
+int AK_pax_alloc(AK_block *block, int column, int size) {
+    int k, c, address, num_attr;
+    AK_PRO;
+    if (!block->pax) {
+        address = block->AK_free_space;
+        block->AK_free_space += size;
+        AK_EPI;
+        return address;
+    }
+    num_attr = AK_pax_num_attr(block);
+    if (column < 0 || column >= num_attr || block->AK_free_space + size > DATA_BLOCK_SIZE * DATA_ENTRY_SIZE) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    address = block->minipage[column];
+    memmove(block->data + address + size, block->data + address, block->AK_free_space - address);
+    for (k = 0; k < DATA_BLOCK_SIZE && block->tuple_dict[k].type != FREE_INT; k++) {
+        if (block->tuple_dict[k].size > 0 && block->tuple_dict[k].address >= address)
+            block->tuple_dict[k].address += size;
+    }
+    for (c = column; c < num_attr; c++)
+        block->minipage[c] += size;
+    block->AK_free_space += size;
+    AK_EPI;
+    return address;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that rewrites the data of a block grouped by column and marks the block as a PAX block. Only
+ *        values of live entries are kept, values of dictionary encoded columns stay shared by their rows.
+ * @param block block
+ */
+void AK_pax_layout_block(AK_block *block) {
+    unsigned char data[DATA_BLOCK_SIZE * DATA_ENTRY_SIZE];
+    int source[DATA_BLOCK_SIZE];
+    int c, k, m, num_attr, offset = 0;
+    AK_PRO;
+    num_attr = AK_pax_num_attr(block);
+    for (k = 0; k < DATA_BLOCK_SIZE; k++)
+        source[k] = block->tuple_dict[k].address;
+    for (c = 0; c < num_attr; c++) {
+        for (k = c; k < DATA_BLOCK_SIZE && block->tuple_dict[k - c].type != FREE_INT; k += num_attr) {
+            if (block->tuple_dict[k].size <= 0)
+                continue;
+            m = k;
+            if (block->header[c].dictionary_encoded)
+                for (m = c; m < k && (source[m] != source[k] || block->tuple_dict[m].size <= 0); m += num_attr)
+                    ;
+            if (m < k) {
+                block->tuple_dict[k].address = block->tuple_dict[m].address;
+            } else {
+                memcpy(data + offset, block->data + source[k], block->tuple_dict[k].size);
+                block->tuple_dict[k].address = offset;
+                offset += block->tuple_dict[k].size;
+            }
+        }
+        block->minipage[c] = offset;
+    }
+    for (c = num_attr; c < MAX_ATTRIBUTES; c++)
+        block->minipage[c] = offset;
+    memset(data + offset, FREE_CHAR, DATA_BLOCK_SIZE * DATA_ENTRY_SIZE - offset);
+    memcpy(block->data, data, sizeof (data));
+    block->AK_free_space = offset;
+    block->pax = 1;
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that gives the values of one column of a PAX block. They are stored one after another in row
+ *        order, so fixed size values can be read as an array.
+ * @param block block
+ * @param column index of the column in the block header
+ * @param size set to the number of bytes the column takes
+ * @return pointer to the first value of the column, NULL if the block is not a PAX block
+ */
+unsigned char *AK_pax_column(AK_block *block, int column, int *size) {
+    int start;
+    AK_PRO;
+    if (!block->pax || column < 0 || column >= AK_pax_num_attr(block)) {
+        *size = 0;
+        AK_EPI;
+        return NULL;
+    }
+    start = column == 0 ? 0 : block->minipage[column - 1];
+    *size = block->minipage[column] - start;
+    AK_EPI;
+    return block->data + start;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that checks that the column areas of a PAX test block hold the rows with the given ids in
+ *        order, and that row reads through tuple_dict see the same values
+ * @param block block
+ * @param ids expected ids, in row order
+ * @param num_rows number of expected rows
+ * @return 1 if the block is as expected, otherwise 0
+ */
+static int AK_pax_check_block(AK_block *block, int *ids, int num_rows) {
+    unsigned char *ids_column, *scores_column;
+    int i, ids_size, scores_size, ok;
+    AK_PRO;
+    ids_column = AK_pax_column(block, 0, &ids_size);
+    scores_column = AK_pax_column(block, 2, &scores_size);
+    ok = ids_column != NULL && ids_size == num_rows * (int) sizeof (int) && scores_size == num_rows * (int) sizeof (int);
+    for (i = 0; ok && i < num_rows; i++) {
+        ok = ((int *) ids_column)[i] == ids[i] && ((int *) scores_column)[i] == ids[i] * 10
+                && block->tuple_dict[i * 3].address == i * (int) sizeof (int)
+                && *(int *) (block->data + block->tuple_dict[i * 3 + 2].address) == ids[i] * 10;
+    }
+    AK_EPI;
+    return ok;
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing PAX table blocks
+ * @return TestResult
+ */
+TestResult AK_pax_test() {
+    static int run_count = 0;
+    char table[MAX_ATT_NAME], name[MAX_VARCHAR_LENGTH];
+    table_addresses *addresses;
+    AK_block *block;
+    struct list_node *row_root, *row;
+    int i, id, score, ids[40], num_ids = 0, passed = 0, failed = 0;
+    AK_PRO;
+
+    AK_header header[4] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "name", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_INT, "score", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    sprintf(table, "pax_test_%d", run_count++);
+    if (AK_initialize_new_segment(table, SEGMENT_TYPE_PAX_TABLE, header) == EXIT_ERROR) {
+        AK_EPI;
+        return TEST_result(0, 1);
+    }
+    row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row_root);
+    for (id = 0; id < 40; id++) {
+        score = id * 10;
+        sprintf(name, "name %d", id);
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, name, table, "name", row_root);
+        AK_Insert_New_Element(TYPE_INT, &score, table, "score", row_root);
+        AK_insert_row(row_root);
+        ids[num_ids++] = id;
+    }
+    addresses = AK_get_table_addresses(table);
+    block = AK_get_block(addresses->address_from[0])->block;
+    AK_free(addresses);
+
+    /* 1: inserted values are grouped by column */
+    printf("\nPAX insert test\n");
+    if (block->pax && AK_pax_check_block(block, ids, num_ids)) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 2: rows read through tuple_dict are unchanged */
+    printf("\nPAX row read test\n");
+    row = AK_get_row(17, table);
+    if (row != NULL && *(int *) AK_GetNth_L2(1, row)->data == 17 && strcmp(AK_GetNth_L2(2, row)->data, "name 17") == 0
+            && *(int *) AK_GetNth_L2(3, row)->data == 170) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+    if (row != NULL) {
+        AK_DeleteAll_L3(&row);
+        AK_free(row);
+    }
+
+    /* 3: VACUUM keeps the block grouped by column */
+    printf("\nPAX vacuum test\n");
+    for (id = 1; id < 40; id += 3) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Update_Existing_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_delete_row(row_root);
+    }
+    num_ids = 0;
+    for (id = 0; id < 40; id++)
+        if (id % 3 != 1)
+            ids[num_ids++] = id;
+    AK_vacuum_table(table, NULL);
+    addresses = AK_get_table_addresses(table);
+    block = AK_get_block(addresses->address_from[0])->block;
+    AK_free(addresses);
+    if (block->pax && AK_pax_check_block(block, ids, num_ids) && AK_get_num_records(table) == num_ids) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 4: new extents of the table are PAX too */
+    printf("\nPAX extent test\n");
+    i = AK_init_new_extent(table, SEGMENT_TYPE_TABLE);
+    if (i != EXIT_ERROR && AK_get_block(i)->block->pax) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_DeleteAll_L3(&row_root);
+    AK_free(row_root);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
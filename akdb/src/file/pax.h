@@ -0,0 +1,33 @@
+/**
+@file pax.h Header file that provides declarations of functions for column-grouped (PAX) table blocks
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef PAX
+#define PAX
+
+#include "../auxi/test.h"
+#include "../dm/dbman.h"
+#include "../mm/memoman.h"
+#include "../auxi/mempro.h"
+
+int AK_pax_alloc(AK_block *block, int column, int size);
+void AK_pax_layout_block(AK_block *block);
+unsigned char *AK_pax_column(AK_block *block, int column, int *size);
+TestResult AK_pax_test();
+
+#endif
@@ -20,6 +20,95 @@
 
 #include "sequence.h"
 
+static pthread_mutex_t sequenceCacheMut = PTHREAD_MUTEX_INITIALIZER;
+static AK_sequence_cache_entry sequence_cache[SEQUENCE_CACHE_ENTRIES];
+static int sequence_cache_victim = 0;
+
+/**
+ * @author Unknown
+ * @brief Function that finds the cached values of a sequence. The caller holds sequenceCacheMut.
+ * @param name name of the sequence
+ * @return cache entry, NULL if the sequence has no values in memory
+ */
+static AK_sequence_cache_entry *AK_sequence_cache_find(char *name) {
+    int i;
+    for (i = 0; i < SEQUENCE_CACHE_ENTRIES; i++)
+        if (sequence_cache[i].name[0] != '\0' && strcmp(sequence_cache[i].name, name) == 0)
+            return &sequence_cache[i];
+    return NULL;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that forgets the cached values of a sequence. Reserved values that were not handed out are
+ *        skipped.
+ * @param name name of the sequence
+ */
+static void AK_sequence_cache_drop(char *name) {
+    AK_sequence_cache_entry *entry;
+    pthread_mutex_lock(&sequenceCacheMut);
+    entry = AK_sequence_cache_find(name);
+    if (entry != NULL)
+        entry->name[0] = '\0';
+    pthread_mutex_unlock(&sequenceCacheMut);
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads the row of a sequence from AK_sequence
+ * @param name name of the sequence
+ * @param entry set to the values of the row, last to its current value
+ * @return EXIT_SUCCESS or EXIT_ERROR if there is no such sequence
+ */
+static int AK_sequence_read_row(char *name, AK_sequence_cache_entry *entry) {
+    int i = 0;
+    struct list_node *row;
+    AK_PRO;
+    while ((row = (struct list_node *)AK_get_row(i, "AK_sequence")) != NULL){
+        if (strcmp(get_row_attr_data(1,row), name) == 0) {
+            memcpy(&entry->obj_id, get_row_attr_data(0,row), sizeof (int));
+            memcpy(&entry->last, get_row_attr_data(2,row), sizeof (int));
+            memcpy(&entry->increment, get_row_attr_data(3,row), sizeof (int));
+            memcpy(&entry->max_value, get_row_attr_data(4,row), sizeof (int));
+            memcpy(&entry->min_value, get_row_attr_data(5,row), sizeof (int));
+            memcpy(&entry->cycle, get_row_attr_data(6,row), sizeof (int));
+            AK_DeleteAll_L3(&row);
+            AK_free(row);
+            AK_EPI;
+            return EXIT_SUCCESS;
+        }
+        AK_DeleteAll_L3(&row);
+        AK_free(row);
+        i++;
+    }
+    AK_EPI;
+    return EXIT_ERROR;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that gives the value of a sequence following the given one
+ * @param entry sequence
+ * @param value current value
+ * @param next set to the next value
+ * @return EXIT_SUCCESS or EXIT_ERROR if a non-cyclic sequence has no more values
+ */
+static int AK_sequence_step(AK_sequence_cache_entry *entry, int value, int *next) {
+    value += entry->increment;
+    if (value < entry->min_value) {
+        if (entry->cycle == 0)
+            return EXIT_ERROR;
+        value = entry->max_value;
+    }
+    if (value > entry->max_value) {
+        if (entry->cycle == 0)
+            return EXIT_ERROR;
+        value = entry->min_value;
+    }
+    *next = value;
+    return EXIT_SUCCESS;
+}
+
 /**
  * @author Boris Kišić
  * @brief Function for adding sequence.
@@ -71,6 +160,7 @@ int AK_sequence_add(char *name, int start_value, int increment, int max_value, i
 int AK_sequence_remove(char *name){
     AK_PRO;
     printf("\n***Remove sequence***");
+    AK_sequence_cache_drop(name);
 
     struct list_node *row_root = (struct list_node *) AK_malloc(sizeof(struct list_node));
     AK_Init_L3(&row_root);
@@ -97,107 +187,103 @@ int AK_sequence_remove(char *name){
  * @return current_value or EXIT_ERROR
  */
 int AK_sequence_current_value(char *name){
-    int i = 0;
-    int current_value = -1;
-    int num_rows = AK_get_num_records("AK_sequence");
-    
-    struct list_node *row;
+    AK_sequence_cache_entry *cached, entry;
+    int current_value;
     AK_PRO;
 
-    while ((row = (struct list_node *)AK_get_row(i, "AK_sequence")) != NULL){
-        if (strcmp(get_row_attr_data(1,row), name) == 0) {
-            memcpy(&current_value, get_row_attr_data(2,row), sizeof (int));
-	    break;
-        }
-        i++;
+    // values reserved in AK_sequence are ahead of the one handed out last
+    pthread_mutex_lock(&sequenceCacheMut);
+    cached = AK_sequence_cache_find(name);
+    if (cached != NULL) {
+        current_value = cached->last;
+        pthread_mutex_unlock(&sequenceCacheMut);
+        AK_EPI;
+        return current_value;
     }
-    
-    if (current_value == -1){
+    pthread_mutex_unlock(&sequenceCacheMut);
+
+    if (AK_sequence_read_row(name, &entry) == EXIT_ERROR){
 	AK_EPI;
         return EXIT_ERROR;
     }
     AK_EPI;
-    return current_value;
+    return entry.last;
 }
 
 /**
- * @author Boris Kišić
- * @brief Function that returns the next value of the sequence and writes it in a system table as current value.
+ * @author Boris Kišić, updated by Unknown (values reserved in ranges)
+ * @brief Function that returns the next value of the sequence. SEQUENCE_CACHE_SIZE values are reserved with one write
+ *        of the last of them in a system table as current value, the rest are handed out from memory.
  * @param name name of the sequence
  * @return next_value or EXIT_ERROR
  */
 int AK_sequence_next_value(char *name){
-    int next_value ;
-    int i = 0;
-    int obj_id;
-    int current_value = -1;
-    int increment;
-    int max_value;
-    int min_value;
-    int cycle;
-    
-    struct list_node *row;
+    AK_sequence_cache_entry *entry, row;
+    int next_value;
+    int reserved;
+    int count = 0;
+    int i;
     AK_PRO;
 
-    while ((row = (struct list_node *)AK_get_row(i, "AK_sequence")) != NULL){
-        if(strcmp( get_row_attr_data(1,row) ,name) == 0) {
-        memcpy(&obj_id, get_row_attr_data(0,row), sizeof (int));
-        memcpy(&current_value, get_row_attr_data(2,row), sizeof (int));
-        memcpy(&increment, get_row_attr_data(3,row), sizeof (int));
-        memcpy(&max_value, get_row_attr_data(4,row), sizeof (int));
-        memcpy(&min_value, get_row_attr_data(5,row), sizeof (int));
-        memcpy(&cycle, get_row_attr_data(6,row), sizeof (int));
-        break;
+    pthread_mutex_lock(&sequenceCacheMut);
+    entry = AK_sequence_cache_find(name);
+
+    if (entry == NULL || entry->remaining == 0) {
+        if (AK_sequence_read_row(name, &row) == EXIT_ERROR) {
+            pthread_mutex_unlock(&sequenceCacheMut);
+            AK_EPI;
+            return EXIT_ERROR;
         }
-        i++;
-    }
-   
 
-    if (current_value == -1){
-    AK_EPI;
-        return EXIT_ERROR;
-    }
- 
-    next_value = current_value + increment;
-    
-    if(next_value < min_value){
-    if(cycle==0){
-        printf("\nNon-cyclic sequence can not go below its minimum value.");
+        reserved = row.last;
+        while (count < SEQUENCE_CACHE_SIZE && AK_sequence_step(&row, reserved, &reserved) == EXIT_SUCCESS)
+            count++;
+        if (count == 0) {
+            if (row.increment < 0)
+                printf("\nNon-cyclic sequence can not go below its minimum value.");
+            else
+                printf("\nNon-cyclic sequence can not go over its maximum value.");
+            if (entry != NULL)
+                entry->name[0] = '\0';
+            pthread_mutex_unlock(&sequenceCacheMut);
             AK_EPI;
-        return EXIT_ERROR;
-    }
-    else{
-        next_value=max_value;
-    } 
-    }
-    
-    if(next_value > max_value){
-    if(cycle==0){
-        printf("\nNon-cyclic sequence can not go over its maximum value.");
-        AK_EPI;
-        return EXIT_ERROR;
-    }
-    else{
-        next_value=min_value;
-    } 
-    }
-    
- 
-    struct list_node *row_root = (struct list_node *) AK_malloc(sizeof(struct list_node));
-    AK_Init_L3(&row_root);
-    
-    AK_Update_Existing_Element(TYPE_INT, &obj_id, "AK_sequence", "obj_id", row_root);
-    AK_Insert_New_Element(TYPE_INT, &next_value, "AK_sequence", "current_value", row_root);
-    int result =  AK_update_row(row_root); 
-    AK_DeleteAll_L3(&row_root);
-    AK_free(row_root);
-   
-   if (result == EXIT_ERROR) {
-      AK_dbg_messg(HIGH, SEQUENCES, "AK_sequence_next_value: Could not retrieve next value.\n");
-      AK_EPI;
-      return EXIT_ERROR;
+            return EXIT_ERROR;
+        }
+
+        struct list_node *row_root = (struct list_node *) AK_malloc(sizeof(struct list_node));
+        AK_Init_L3(&row_root);
+        AK_Update_Existing_Element(TYPE_INT, &row.obj_id, "AK_sequence", "obj_id", row_root);
+        AK_Insert_New_Element(TYPE_INT, &reserved, "AK_sequence", "current_value", row_root);
+        int result =  AK_update_row(row_root);
+        AK_DeleteAll_L3(&row_root);
+        AK_free(row_root);
+
+        if (result == EXIT_ERROR) {
+            AK_dbg_messg(HIGH, SEQUENCES, "AK_sequence_next_value: Could not retrieve next value.\n");
+            pthread_mutex_unlock(&sequenceCacheMut);
+            AK_EPI;
+            return EXIT_ERROR;
+        }
+
+        if (entry == NULL) {
+            for (i = 0; entry == NULL && i < SEQUENCE_CACHE_ENTRIES; i++)
+                if (sequence_cache[i].name[0] == '\0')
+                    entry = &sequence_cache[i];
+            if (entry == NULL) {
+                entry = &sequence_cache[sequence_cache_victim];
+                sequence_cache_victim = (sequence_cache_victim + 1) % SEQUENCE_CACHE_ENTRIES;
+            }
+        }
+        *entry = row;
+        strncpy(entry->name, name, MAX_VARCHAR_LENGTH - 1);
+        entry->name[MAX_VARCHAR_LENGTH - 1] = '\0';
+        entry->remaining = count;
     }
-   
+
+    AK_sequence_step(entry, entry->last, &next_value);
+    entry->last = next_value;
+    entry->remaining--;
+    pthread_mutex_unlock(&sequenceCacheMut);
     AK_EPI;
     return next_value;
 }
@@ -258,6 +344,15 @@ int AK_sequence_rename(char *old_name, char *new_name){
       AK_EPI;
       return EXIT_ERROR;
     }
+
+    // reserved values stay with the sequence under its new name
+    pthread_mutex_lock(&sequenceCacheMut);
+    AK_sequence_cache_entry *entry = AK_sequence_cache_find(old_name);
+    if (entry != NULL) {
+        strncpy(entry->name, new_name, MAX_VARCHAR_LENGTH - 1);
+        entry->name[MAX_VARCHAR_LENGTH - 1] = '\0';
+    }
+    pthread_mutex_unlock(&sequenceCacheMut);
     AK_EPI;
     return EXIT_SUCCESS;
 }
@@ -276,6 +371,7 @@ int AK_sequence_rename(char *old_name, char *new_name){
 int AK_sequence_modify(char *name, int start_value, int increment, int max_value, int min_value, int cycle){
     AK_PRO;
     printf("\n***Edit sequence***");
+    AK_sequence_cache_drop(name);
 
     int seq_id = AK_sequence_get_id(name);
     
@@ -324,10 +420,21 @@ TestResult AK_sequence_test() {
     printf("\nCurrent value of sequence sequence1: %d", currval);
     int nextval = AK_sequence_next_value("sequence1");
     printf("\nNext value of sequence sequence1: %d\n", nextval);
+
+    printf("\n***Reserved values check***\n");
+    AK_sequence_cache_entry stored;
+    int reserved_ok = AK_sequence_next_value("sequence1") == 110 && AK_sequence_next_value("sequence1") == 115
+            && AK_sequence_current_value("sequence1") == 115;
+    // the table holds the last reserved value, 100 + 5 * SEQUENCE_CACHE_SIZE capped by the cycle at 200
+    reserved_ok = reserved_ok && AK_sequence_read_row("sequence1", &stored) == EXIT_SUCCESS && stored.last == 200;
+    // sequence2 wraps from 200 over its maximum 205 to its minimum 100
+    reserved_ok = reserved_ok && AK_sequence_next_value("sequence2") == 100 && AK_sequence_next_value("sequence2") == 110;
+    printf("\nValues handed out from memory, last reserved value of sequence1: %d\n", stored.last);
     
     int rename = AK_sequence_rename("sequence1", "sequence3");
     printf("\nRenaming 'sequence 1' to 'sequence2'.\n");
     AK_print_table("AK_sequence"); 
+    reserved_ok = reserved_ok && AK_sequence_next_value("sequence3") == 120;
 
     int modify = AK_sequence_modify("sequence3", 200, 20, 300, 150, 0);
     printf("\nModifying 'sequence3.'\n");
@@ -370,6 +477,10 @@ TestResult AK_sequence_test() {
     	printf("\nError removing 'sequence2'.\n");
         failed++;
     } 
+    if (!reserved_ok) {
+    	printf("\nError while handing out reserved values.\n");
+        failed++;
+    }
     AK_EPI;
-    return TEST_result(8-failed,failed);
+    return TEST_result(9-failed,failed);
 }
@@ -25,6 +25,43 @@
 #include "id.h"
 #include "fileio.h"
 #include "../auxi/mempro.h"
+#include <pthread.h>
+
+/**
+ * @def SEQUENCE_CACHE_SIZE
+ * @brief number of values of a sequence reserved with one write to AK_sequence
+ */
+#define SEQUENCE_CACHE_SIZE 20
+/**
+ * @def SEQUENCE_CACHE_ENTRIES
+ * @brief number of sequences whose reserved values are kept in memory
+ */
+#define SEQUENCE_CACHE_ENTRIES 16
+
+/**
+ * @author Unknown
+ * @struct AK_sequence_cache_entry
+ * @brief Structure for the values of a sequence reserved in AK_sequence and not handed out yet. current_value of
+ *        the row is already the last reserved value.
+ * @var AK_sequence_cache_entry::name
+ * name of the sequence, empty for an unused entry
+ * @var AK_sequence_cache_entry::obj_id
+ * id of the sequence row
+ * @var AK_sequence_cache_entry::last
+ * value handed out last
+ * @var AK_sequence_cache_entry::remaining
+ * number of reserved values left
+ */
+typedef struct {
+    char name[MAX_VARCHAR_LENGTH];
+    int obj_id;
+    int last;
+    int remaining;
+    int increment;
+    int max_value;
+    int min_value;
+    int cycle;
+} AK_sequence_cache_entry;
 
 /**
  * @author Boris Kišić
@@ -18,6 +18,7 @@
  */
 
 #include "../file/table.h"
+#include "../file/fileio.h"
 
 
 /**
@@ -112,6 +113,7 @@ void AK_temp_create_table(char *table, AK_header *header, int type_segment) {
     //insert end address
     num = startAddress + 19;
     AK_insert_entry(sys_block, TYPE_INT, &num, endAddressEntry);
+    sys_block->num_records = FREE_INT;
 
     AK_write_block(sys_block);
     AK_free(sys_block);
@@ -174,7 +176,7 @@ int AK_num_attr(char * tblName) {
  * @param *tableName table name
  * @return number of rows in the table
  */
-int AK_get_num_records(char *tblName) {
+int AK_scan_num_records(char *tblName) {
     int num_rec = 0;
     int blocks_per_row; //how many chained blocks are needed to store one entry of the table
     int i = 0, j, k;
@@ -211,6 +213,35 @@ int AK_get_num_records(char *tblName) {
     return num_rec / num_head;
 }
 
+/**
+ * @author Unknown
+ * @brief  Function that returns the number of rows in the table. The count is kept in the first block of the
+ *         segment and maintained by insert and delete, so this is a single block lookup. When the count is not
+ *         known (system tables whose rows were written directly) the table is scanned once with
+ *         AK_scan_num_records and the result is stored.
+ * @param *tableName table name
+ * @return number of rows in the table
+ */
+int AK_get_num_records(char *tblName) {
+    int num_rec;
+    AK_PRO;
+    table_addresses *addresses = AK_get_table_addresses(tblName);
+    int first = addresses->address_from[0];
+    AK_free(addresses);
+    if (first == 0) {
+        AK_EPI;
+        return EXIT_WARNING;
+    }
+
+    num_rec = AK_get_block(first)->block->num_records;
+    if (num_rec == FREE_INT) {
+        num_rec = AK_scan_num_records(tblName);
+        AK_set_num_records(tblName, num_rec);
+    }
+    AK_EPI;
+    return num_rec;
+}
+
 /**
  * @author Matija Šestak, updated by Josip Šušnjara (chained blocks support)
  * @brief  Function that fetches the table header
@@ -237,9 +268,8 @@ AK_header *AK_get_header(char *tblName) {
 
     num_attr = AK_num_attr(tblName);
     
-    // Is calloc the right choice here? The memory gets overridden immediately anyway
-    //AK_header *head = (AK_header*) AK_calloc(num_attr, sizeof (AK_header));
-    AK_header *head = AK_malloc(sizeof(AK_header) * num_attr);
+    // one zeroed entry more ends the header, AK_new_segment copies entries up to the first of type 0
+    AK_header *head = (AK_header*) AK_calloc(num_attr + 1, sizeof (AK_header));
     current_attr = 0;
     while(1){
         for (int i = 0; i < MAX_ATTRIBUTES && current_attr < num_attr; i++){
@@ -362,6 +392,8 @@ struct list_node *AK_get_column(int num, char *tblName) {
                     memcpy(data, &(temp->block->data[address]), size);
                     data[ size ] = '\0';
                     AK_InsertAtEnd_L3(type, data, size, row_root);
+                    if (AK_IS_NULL(temp->block, k))
+                        AK_End_L2(row_root)->is_null = 1;
                 }
             }
         }
@@ -406,6 +438,8 @@ struct list_node *AK_get_row(int num, char * tblName) {
                         memcpy(data, &(temp->block->data[address]), size);
                         data[size] = '\0';
                         AK_InsertAtEnd_L3(type, data, size, row_root);
+                        if (AK_IS_NULL(temp->block, k + l))
+                            AK_End_L2(row_root)->is_null = 1;
                     }
                     AK_free(addresses);
                     AK_EPI;
@@ -473,6 +507,7 @@ struct list_node *AK_find_tuple(int row, int column, int num_attr, table_address
                     AK_InsertAtEnd_L3(type, data, size, row_root);
                     AK_free(addresses);
 					next = AK_First_L2(row_root); //store next
+                    next->is_null = AK_IS_NULL(temp->block, k + column);
                     AK_free(row_root);
 					//returns next in row_root leaving base of the list allocated, so we made some corrections
                     //return (struct list_node *) AK_First_L2(row_root);
@@ -523,13 +558,17 @@ struct list_node *AK_get_tuple(int row, int column, char *tblName) {
  * @author Matija Šestak.
  * @brief  Function that converts tuple value to string
  * @param *tuple tuple in the list
- * @return tuple value as a string
+ * @return tuple value as a string, NULL if the tuple holds NULL
  */
 char * AK_tuple_to_string(struct list_node *tuple) {
     int temp_int;
     double temp_float;
     char temp_char[ MAX_VARCHAR_LENGTH ];
     AK_PRO;
+    if (tuple->is_null) {
+        AK_EPI;
+        return NULL;
+    }
     char *buff = (char*) AK_malloc(MAX_VARCHAR_LENGTH);
 
     //assert(tuple->type);
@@ -602,7 +641,7 @@ void AK_print_row(int col_len[], struct list_node *row) {
     printf("\n|");
     while (el != NULL) {
         memset(data, 0, MAX_VARCHAR_LENGTH);
-        switch (el->type) {
+        switch (el->is_null ? FREE_CHAR : el->type) {
             case FREE_CHAR:
                 //case FREE_INT:
                 printf(" %-*s|", col_len[i] + TBL_BOX_OFFSET, "null");
@@ -697,8 +736,14 @@ void AK_print_table(char *tblName) {
             for (j = 0; j < num_rows; j++) 
 			{
                 struct list_node *el = AK_get_tuple(j, i, tblName);
-                switch (el->type) 
+                switch (el->is_null ? FREE_CHAR : el->type) 
 				{
+                    case FREE_CHAR:
+                        if (len[i] < (int) strlen("null"))
+						{
+                            len[i] = strlen("null");
+                        }
+                        break;
                     case TYPE_INT:
                         length = AK_chars_num_from_number(*((int *) (el)->data), 10);
                         if (len[i] < length) 
@@ -909,7 +954,7 @@ void AK_print_row_to_file(int col_len[], struct list_node * row) {
     fprintf(fp, "\n|");
     while (el != NULL) {
         memset(data, 0, MAX_VARCHAR_LENGTH);
-        switch (el->type) {
+        switch (el->is_null ? FREE_CHAR : el->type) {
             case FREE_CHAR:
                 //case FREE_INT:
                 fprintf(fp, " %-*s|", col_len[i] + TBL_BOX_OFFSET, "null");
@@ -976,7 +1021,12 @@ void AK_print_table_to_file(char *tblName) {
         for (i = 0; i < num_attr; i++) {
             for (j = 0; j < num_rows; j++) {
                 struct list_node *el = AK_get_tuple(j, i, tblName);
-                switch (el->type) {
+                switch (el->is_null ? FREE_CHAR : el->type) {
+                    case FREE_CHAR:
+                        if (len[i] < (int) strlen("null")) {
+                            len[i] = strlen("null");
+                        }
+                        break;
                     case TYPE_INT:
                         length = AK_chars_num_from_number(*((int *) (el)->data), 10);
                         if (len[i] < length) {
@@ -1104,28 +1154,36 @@ int AK_table_empty(char *tblName) {
 }
 
 /**
- * @author Dejan Frankovic
- * @brief  Function that fetches an obj_id of named table from AK_relation system table
+ * @author Dejan Frankovic, updated by Unknown (reads the blocks of AK_relation)
+ * @brief  Function that fetches an obj_id of named table from AK_relation system table. The rows are read in place
+ *         from the blocks of AK_relation, rows of AK_relation are obj_id, name, start_address and end_address.
  * @param *table table name
  * @return obj_id of the table or EXIT_ERROR if there is no table with that name
  */
 int AK_get_table_obj_id(char *table) {
-    int i = 0, table_id = -1;
-    struct list_node *row;
-
-    i = 0;
+    table_addresses *addresses;
+    AK_block *block;
+    int i, j, k, table_id = EXIT_ERROR;
+    int length = strlen(table);
     AK_PRO;
-    while ((row = AK_get_row(i, "AK_relation")) != NULL) {
-        if (strcmp(row->next->next->data, table) == 0) {
-            memcpy(&table_id, row->next->data, sizeof (int));
-            break;
+    int num_attr = AK_num_attr("AK_relation");
+    addresses = AK_get_table_addresses("AK_relation");
+    for (i = 0; table_id == EXIT_ERROR && i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; table_id == EXIT_ERROR && j < addresses->address_to[i]; j++) {
+            block = AK_get_block(j)->block;
+            if (block->last_tuple_dict_id == 0)
+                break;
+            for (k = 0; k + num_attr <= DATA_BLOCK_SIZE; k += num_attr) {
+                //deleted rows have no size
+                if (block->tuple_dict[k].size > 0 && block->tuple_dict[k + 1].size == length
+                        && memcmp(block->data + block->tuple_dict[k + 1].address, table, length) == 0) {
+                    memcpy(&table_id, block->data + block->tuple_dict[k].address, sizeof (int));
+                    break;
+                }
+            }
         }
-        i++;
-    }
-    if (table_id == -1){
-        AK_EPI;
-        return EXIT_ERROR;
     }
+    AK_free(addresses);
     AK_EPI;
     return table_id;
 }
@@ -1495,7 +1553,7 @@ TestResult AK_table_test() {
 
     printf("\nTable \"%s\":AK_create_table\n", table_name);
 
-    AK_create_table_parameter *params = (AK_create_table_parameter *) AK_malloc(2 * sizeof(AK_create_table_parameter*));
+    AK_create_table_parameter *params = (AK_create_table_parameter *) AK_malloc(2 * sizeof(AK_create_table_parameter));
 
     params[0] = *(AK_create_create_table_parameter(TYPE_INT, "ID"));
     params[1] = *(AK_create_create_table_parameter(TYPE_VARCHAR, "Name"));
@@ -79,6 +79,17 @@ int AK_num_attr(char * tblName);
  * @param *tableName table name
  * @return number of rows in the table
  */
+int AK_scan_num_records(char *tblName);
+
+/**
+ * @author Unknown
+ * @brief  Function that returns the number of rows in the table. The count is kept in the first block of the
+ *         segment and maintained by insert and delete, so this is a single block lookup. When the count is not
+ *         known (system tables whose rows were written directly) the table is scanned once with
+ *         AK_scan_num_records and the result is stored.
+ * @param *tableName table name
+ * @return number of rows in the table
+ */
 int AK_get_num_records(char *tblName);
 
 /**
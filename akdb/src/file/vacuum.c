@@ -0,0 +1,673 @@
+/**
+@file vacuum.c Provides functions for block compaction (VACUUM) of tables
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "vacuum.h"
+#include <unistd.h>
+
+/* serializes VACUUM runs, explicit ones and the ones started by the background thread */
+pthread_mutex_t vacuumMut = PTHREAD_MUTEX_INITIALIZER;
+/* protects the list of scheduled tables and the state of the background thread */
+pthread_mutex_t vacuumScheduleMut = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t vacuumScheduleCond = PTHREAD_COND_INITIALIZER;
+
+static char AK_vacuum_tables[MAX_VACUUM_TABLES][MAX_ATT_NAME];
+static int AK_vacuum_num_tables = 0;
+static int AK_vacuum_interval = 0;
+static int AK_vacuum_threshold = 0;
+static int AK_vacuum_running = 0;
+static pthread_t AK_vacuum_thread;
+
+/**
+ * @author Unknown
+ * @brief Function that checks whether the row starting at the given tuple_dict entry was deleted
+ * @param block block to check
+ * @param i index of the first tuple_dict entry of the row
+ * @return 1 if the row was deleted, otherwise 0
+ */
+static int AK_vacuum_row_deleted(AK_block *block, int i) {
+    int deleted;
+    AK_PRO;
+    deleted = block->tuple_dict[i].type == 0 && block->tuple_dict[i].size == 0;
+    AK_EPI;
+    return deleted;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that rewrites a block in place. Live rows are packed to the beginning of tuple_dict and their
+ *        values to the beginning of data, so the space of deleted rows can be used again by AK_insert_row.
+ *        AK_free_space and last_tuple_dict_id are updated accordingly, NULL flags move with their entries,
+ *        values of dictionary encoded columns stay shared by their rows, PAX blocks are grouped by column again
+ *        and the zone maps are rebuilt from the remaining rows.
+ * @param block block to compact
+ * @param num_attr number of attributes of a row
+ * @return number of deleted rows removed from the block
+ */
+int AK_vacuum_block(AK_block *block, int num_attr) {
+    AK_tuple_dict tuple_dict[DATA_BLOCK_SIZE];
+    unsigned char data[DATA_BLOCK_SIZE * DATA_ENTRY_SIZE];
+    unsigned char null_bitmap[BITNSLOTS(DATA_BLOCK_SIZE)];
+    int source[DATA_BLOCK_SIZE];
+    int i, l, m, id = 0, offset = 0, removed = 0;
+    AK_PRO;
+
+    memset(null_bitmap, 0, sizeof (null_bitmap));
+
+    for (i = 0; i + num_attr <= DATA_BLOCK_SIZE && block->tuple_dict[i].type != FREE_INT; i += num_attr) {
+        if (AK_vacuum_row_deleted(block, i)) {
+            removed++;
+            continue;
+        }
+        for (l = i; l < i + num_attr; l++) {
+            tuple_dict[id].type = block->tuple_dict[l].type;
+            tuple_dict[id].size = block->tuple_dict[l].size;
+            source[id] = block->tuple_dict[l].address;
+            if (AK_IS_NULL(block, l))
+                BITSET(null_bitmap, id);
+            /* a value shared by several rows is copied once */
+            m = id;
+            if (block->header[l - i].dictionary_encoded && block->tuple_dict[l].size > 0)
+                for (m = l - i; m < id && (source[m] != source[id] || tuple_dict[m].size <= 0); m += num_attr)
+                    ;
+            if (m < id) {
+                tuple_dict[id].address = tuple_dict[m].address;
+            } else {
+                memcpy(data + offset, block->data + block->tuple_dict[l].address, block->tuple_dict[l].size);
+                tuple_dict[id].address = offset;
+                offset += block->tuple_dict[l].size;
+            }
+            id++;
+        }
+    }
+    if (removed == 0) {
+        AK_EPI;
+        return 0;
+    }
+
+    for (i = id; i < DATA_BLOCK_SIZE; i++) {
+        tuple_dict[i].type = FREE_INT;
+        tuple_dict[i].address = FREE_INT;
+        tuple_dict[i].size = FREE_INT;
+    }
+    memset(data + offset, FREE_CHAR, DATA_BLOCK_SIZE * DATA_ENTRY_SIZE - offset);
+    memcpy(block->tuple_dict, tuple_dict, sizeof (tuple_dict));
+    memcpy(block->data, data, sizeof (data));
+    memcpy(block->null_bitmap, null_bitmap, sizeof (null_bitmap));
+    block->AK_free_space = offset;
+    block->last_tuple_dict_id = id > 0 ? id - 1 : 0;
+    if (block->pax)
+        AK_pax_layout_block(block);
+    AK_zone_map_rebuild(block);
+    AK_bloom_rebuild(block);
+
+    AK_dbg_messg(HIGH, FILE_MAN, "AK_vacuum_block: block %d, removed %d rows, %d bytes used\n", block->address, removed, offset);
+    AK_EPI;
+    return removed;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that appends a row of one block to another block if it fits under the same free space
+ *        limits AK_insert_row uses. The row is then marked deleted in the source block.
+ * @param from source block
+ * @param i index of the first tuple_dict entry of the row in the source block
+ * @param to destination block, already compacted
+ * @param num_attr number of attributes of a row
+ * @return EXIT_SUCCESS if the row was moved, EXIT_ERROR if it does not fit
+ */
+static int AK_vacuum_move_row(AK_block *from, int i, AK_block *to, int num_attr) {
+    int l, id, code, need = 0;
+    AK_PRO;
+    for (l = i; l < i + num_attr; l++)
+        need += from->tuple_dict[l].size;
+    id = to->tuple_dict[0].type == FREE_INT ? 0 : to->last_tuple_dict_id + 1;
+    if (to->AK_free_space + need >= MAX_FREE_SPACE_SIZE || id + num_attr > MAX_LAST_TUPLE_DICT_SIZE_TO_USE
+            || id + num_attr > DATA_BLOCK_SIZE) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (l = i; l < i + num_attr; l++, id++) {
+        code = AK_IS_NULL(from, l) ? -1
+                : AK_encoding_find(to, l - i, from->data + from->tuple_dict[l].address, from->tuple_dict[l].size);
+        if (code >= 0) {
+            to->tuple_dict[id].address = code;
+        } else {
+            code = AK_pax_alloc(to, l - i, from->tuple_dict[l].size);
+            memcpy(to->data + code, from->data + from->tuple_dict[l].address, from->tuple_dict[l].size);
+            to->tuple_dict[id].address = code;
+        }
+        to->tuple_dict[id].type = from->tuple_dict[l].type;
+        to->tuple_dict[id].size = from->tuple_dict[l].size;
+        if (AK_IS_NULL(from, l))
+            AK_SET_NULL(to, id);
+        else
+            AK_CLEAR_NULL(to, id);
+
+        AK_CLEAR_NULL(from, l);
+        if (!AK_encoding_shared(from, l))
+            memset(from->data + from->tuple_dict[l].address, '\0', from->tuple_dict[l].size);
+        from->tuple_dict[l].type = 0;
+        from->tuple_dict[l].address = 0;
+        from->tuple_dict[l].size = 0;
+    }
+    to->last_tuple_dict_id = id - 1;
+    AK_zone_map_add_row(to, id - num_attr, num_attr);
+    AK_bloom_add_row(to, id - num_attr, num_attr);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that returns an empty extent of a table: its row in AK_relation is deleted, its blocks are
+ *        freed with AK_delete_extent and cached copies of the blocks are replaced with the freed ones.
+ * @param table table name
+ * @param from address of the first block of the extent
+ * @param to address after the last block of the extent
+ * @return EXIT_SUCCESS or EXIT_ERROR
+ */
+static int AK_vacuum_release_extent(char *table, int from, int to) {
+    AK_mem_block *mem_block = AK_get_block(AK_get_system_table_address("AK_relation"));
+    AK_block *block = mem_block->block;
+    AK_block *freed;
+    int i, l, start, end, found = 0;
+    AK_PRO;
+
+    /* AK_relation rows are obj_id, name, start_address, end_address */
+    for (i = 0; i + 4 <= DATA_BLOCK_SIZE && block->tuple_dict[i].type != FREE_INT; i += 4) {
+        if (AK_vacuum_row_deleted(block, i) || block->tuple_dict[i + 1].size != strlen(table)
+                || memcmp(block->data + block->tuple_dict[i + 1].address, table, strlen(table)) != 0)
+            continue;
+        memcpy(&start, block->data + block->tuple_dict[i + 2].address, sizeof (int));
+        memcpy(&end, block->data + block->tuple_dict[i + 3].address, sizeof (int));
+        if (start != from || end != to)
+            continue;
+        for (l = i; l < i + 4; l++) {
+            memset(block->data + block->tuple_dict[l].address, '\0', block->tuple_dict[l].size);
+            block->tuple_dict[l].type = 0;
+            block->tuple_dict[l].address = 0;
+            block->tuple_dict[l].size = 0;
+        }
+        AK_mem_block_modify(mem_block, BLOCK_DIRTY);
+        AK_update_num_records("AK_relation", -1);
+        found = 1;
+        break;
+    }
+    if (!found || AK_delete_extent(from, to - 1) == EXIT_ERROR) {
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+
+    for (i = from; i < to; i++) {
+        mem_block = AK_get_block(i);
+        freed = AK_read_block(i);
+        memcpy(mem_block->block, freed, sizeof (AK_block));
+        AK_free(freed);
+        AK_mem_block_modify(mem_block, BLOCK_CLEAN);
+    }
+    AK_dbg_messg(MIDDLE, FILE_MAN, "AK_vacuum_release_extent: released extent %d - %d of %s\n", from, to, table);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that measures how much of the used data space of a table belongs to deleted rows
+ * @param table table name
+ * @return percentage (0 - 100) of dead bytes, EXIT_ERROR if the table does not exist
+ */
+int AK_vacuum_dead_space(char *table) {
+    table_addresses *addresses = AK_get_table_addresses(table);
+    AK_mem_block *mem_block;
+    long used = 0, live = 0;
+    int i, j, k;
+    AK_PRO;
+
+    if (addresses->address_from[0] == 0) {
+        AK_free(addresses);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            mem_block = AK_get_block(j);
+            used += mem_block->block->AK_free_space;
+            for (k = 0; k < DATA_BLOCK_SIZE && mem_block->block->tuple_dict[k].type != FREE_INT; k++)
+                live += mem_block->block->tuple_dict[k].size;
+            live -= AK_encoding_shared_bytes(mem_block->block);
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    /* rounded up, so any dead row shows */
+    return used > 0 ? (int) (((used - live) * 100 + used - 1) / used) : 0;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that vacuums a table while the database stays online.
+ * <ol>
+ * <li>every block of the table is compacted in place (AK_vacuum_block)</li>
+ * <li>rows from the last blocks are moved into free space of the first ones, so the used blocks form a prefix
+ *     of the segment, which is what the scans (e.g. AK_get_num_records) expect</li>
+ * <li>extents left without rows are returned with AK_delete_extent, the first extent is always kept</li>
+ * </ol>
+ * Rows change their block and tuple_dict position, so indexes that store those positions have to be rebuilt
+ * afterwards. Only one VACUUM runs at a time.
+ * @param table table name
+ * @param stats filled with the work done, may be NULL
+ * @return EXIT_SUCCESS, EXIT_WARNING for tables with chained blocks or EXIT_ERROR if the table does not exist
+ */
+int AK_vacuum_table(char *table, AK_vacuum_stats *stats) {
+    table_addresses *addresses;
+    AK_mem_block *dst_block, *src_block;
+    AK_vacuum_stats local;
+    int *blocks;
+    int num_attr, num_blocks = 0, used, i, j, dst, src, moved, empty;
+    AK_PRO;
+
+    if (stats == NULL)
+        stats = &local;
+    memset(stats, 0, sizeof (AK_vacuum_stats));
+
+    pthread_mutex_lock(&vacuumMut);
+    addresses = AK_get_table_addresses(table);
+    num_attr = AK_num_attr(table);
+    if (addresses->address_from[0] == 0 || num_attr <= 0) {
+        AK_free(addresses);
+        pthread_mutex_unlock(&vacuumMut);
+        AK_EPI;
+        return EXIT_ERROR;
+    }
+    if (num_attr > MAX_ATTRIBUTES) {
+        /* rows of such tables are chained over several blocks and can not be moved one block at a time */
+        AK_dbg_messg(LOW, FILE_MAN, "AK_vacuum_table: %s has chained blocks, skipped\n", table);
+        AK_free(addresses);
+        pthread_mutex_unlock(&vacuumMut);
+        AK_EPI;
+        return EXIT_WARNING;
+    }
+
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++)
+        num_blocks += addresses->address_to[i] - addresses->address_from[i];
+    blocks = (int *) AK_malloc(num_blocks * sizeof (int));
+    num_blocks = 0;
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++)
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++)
+            blocks[num_blocks++] = j;
+
+    /* compact every block in place */
+    for (i = 0; i < num_blocks; i++) {
+        dst_block = AK_get_block(blocks[i]);
+        used = dst_block->block->AK_free_space;
+        if (AK_vacuum_block(dst_block->block, num_attr) > 0) {
+            stats->blocks_compacted++;
+            stats->bytes_reclaimed += used - dst_block->block->AK_free_space;
+            AK_mem_block_modify(dst_block, BLOCK_DIRTY);
+        }
+    }
+
+    /* move rows from the back of the segment into free space at the front */
+    dst = 0;
+    src = num_blocks - 1;
+    while (dst < src) {
+        src_block = AK_get_block(blocks[src]);
+        if (src_block->block->tuple_dict[0].type == FREE_INT) {
+            src--;
+            continue;
+        }
+        dst_block = AK_get_block(blocks[dst]);
+        moved = 0;
+        for (i = 0; i + num_attr <= DATA_BLOCK_SIZE && src_block->block->tuple_dict[i].type != FREE_INT; i += num_attr) {
+            if (AK_vacuum_row_deleted(src_block->block, i))
+                continue;
+            if (AK_vacuum_move_row(src_block->block, i, dst_block->block, num_attr) == EXIT_ERROR)
+                break;
+            moved++;
+        }
+        if (moved > 0) {
+            AK_vacuum_block(src_block->block, num_attr);
+            AK_mem_block_modify(src_block, BLOCK_DIRTY);
+            AK_mem_block_modify(dst_block, BLOCK_DIRTY);
+            stats->rows_moved += moved;
+        }
+        if (src_block->block->tuple_dict[0].type == FREE_INT)
+            src--;
+        else
+            dst++;
+    }
+    AK_free(blocks);
+
+    /* give back extents without rows, the first extent keeps the segment alive */
+    for (i = MAX_EXTENTS_IN_SEGMENT - 1; i > 0; i--) {
+        if (addresses->address_from[i] == 0)
+            continue;
+        empty = 1;
+        for (j = addresses->address_from[i]; j < addresses->address_to[i] && empty; j++)
+            empty = AK_get_block(j)->block->tuple_dict[0].type == FREE_INT;
+        if (empty && AK_vacuum_release_extent(table, addresses->address_from[i], addresses->address_to[i]) == EXIT_SUCCESS)
+            stats->extents_released++;
+    }
+    AK_free(addresses);
+    pthread_mutex_unlock(&vacuumMut);
+
+    AK_dbg_messg(LOW, FILE_MAN, "AK_vacuum_table: %s: %d blocks compacted, %d rows moved, %d bytes reclaimed, %d extents released\n",
+            table, stats->blocks_compacted, stats->rows_moved, stats->bytes_reclaimed, stats->extents_released);
+    AK_EPI;
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that runs in the background thread. Every interval seconds it vacuums the scheduled tables
+ *        whose dead space reached the threshold percentage.
+ * @param arg not used
+ * @return NULL
+ */
+static void *AK_vacuum_worker(void *arg) {
+    char tables[MAX_VACUUM_TABLES][MAX_ATT_NAME];
+    struct timespec wake;
+    int i, num_tables, dead;
+
+    pthread_mutex_lock(&vacuumScheduleMut);
+    while (AK_vacuum_running) {
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += AK_vacuum_interval;
+        pthread_cond_timedwait(&vacuumScheduleCond, &vacuumScheduleMut, &wake);
+        if (!AK_vacuum_running)
+            break;
+        num_tables = AK_vacuum_num_tables;
+        memcpy(tables, AK_vacuum_tables, sizeof (tables));
+        pthread_mutex_unlock(&vacuumScheduleMut);
+
+        for (i = 0; i < num_tables; i++) {
+            dead = AK_vacuum_dead_space(tables[i]);
+            if (dead > 0 && dead >= AK_vacuum_threshold)
+                AK_vacuum_table(tables[i], NULL);
+        }
+        pthread_mutex_lock(&vacuumScheduleMut);
+    }
+    pthread_mutex_unlock(&vacuumScheduleMut);
+    return NULL;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that adds a table to the tables vacuumed by the background thread
+ * @param table table name
+ * @return EXIT_SUCCESS, EXIT_WARNING if the table is already scheduled or EXIT_ERROR if the list is full
+ */
+int AK_vacuum_schedule(char *table) {
+    int i, result = EXIT_SUCCESS;
+    AK_PRO;
+    pthread_mutex_lock(&vacuumScheduleMut);
+    for (i = 0; i < AK_vacuum_num_tables; i++) {
+        if (strcmp(AK_vacuum_tables[i], table) == 0)
+            result = EXIT_WARNING;
+    }
+    if (result == EXIT_SUCCESS && AK_vacuum_num_tables == MAX_VACUUM_TABLES)
+        result = EXIT_ERROR;
+    if (result == EXIT_SUCCESS) {
+        memset(AK_vacuum_tables[AK_vacuum_num_tables], '\0', MAX_ATT_NAME);
+        strncpy(AK_vacuum_tables[AK_vacuum_num_tables], table, MAX_ATT_NAME - 1);
+        AK_vacuum_num_tables++;
+    }
+    pthread_mutex_unlock(&vacuumScheduleMut);
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that removes a table from the tables vacuumed by the background thread
+ * @param table table name
+ * @return EXIT_SUCCESS or EXIT_WARNING if the table was not scheduled
+ */
+int AK_vacuum_unschedule(char *table) {
+    int i, result = EXIT_WARNING;
+    AK_PRO;
+    pthread_mutex_lock(&vacuumScheduleMut);
+    for (i = 0; i < AK_vacuum_num_tables; i++) {
+        if (strcmp(AK_vacuum_tables[i], table) == 0) {
+            memmove(AK_vacuum_tables[i], AK_vacuum_tables[i + 1], (AK_vacuum_num_tables - i - 1) * MAX_ATT_NAME);
+            AK_vacuum_num_tables--;
+            result = EXIT_SUCCESS;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&vacuumScheduleMut);
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that starts the background vacuum thread
+ * @param interval seconds between two rounds, VACUUM_INTERVAL is used if it is not positive
+ * @param threshold percentage of dead space (see AK_vacuum_dead_space) at which a table is vacuumed,
+ *        VACUUM_THRESHOLD is used if it is negative
+ * @return EXIT_SUCCESS, EXIT_WARNING if the thread is already running or EXIT_ERROR
+ */
+int AK_vacuum_start_background(int interval, int threshold) {
+    int result = EXIT_SUCCESS;
+    AK_PRO;
+    pthread_mutex_lock(&vacuumScheduleMut);
+    if (AK_vacuum_running) {
+        result = EXIT_WARNING;
+    } else {
+        AK_vacuum_interval = interval > 0 ? interval : VACUUM_INTERVAL;
+        AK_vacuum_threshold = threshold >= 0 ? threshold : VACUUM_THRESHOLD;
+        AK_vacuum_running = 1;
+        if (pthread_create(&AK_vacuum_thread, NULL, AK_vacuum_worker, NULL) != 0) {
+            AK_vacuum_running = 0;
+            result = EXIT_ERROR;
+        }
+    }
+    pthread_mutex_unlock(&vacuumScheduleMut);
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that stops the background vacuum thread and waits for it to finish
+ * @return No return value
+ */
+void AK_vacuum_stop_background() {
+    int running;
+    AK_PRO;
+    pthread_mutex_lock(&vacuumScheduleMut);
+    running = AK_vacuum_running;
+    AK_vacuum_running = 0;
+    pthread_cond_signal(&vacuumScheduleCond);
+    pthread_mutex_unlock(&vacuumScheduleMut);
+    if (running)
+        pthread_join(AK_vacuum_thread, NULL);
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that counts the blocks of a table that hold at least one row
+ * @param table table name
+ * @return number of used blocks
+ */
+static int AK_vacuum_used_blocks(char *table) {
+    table_addresses *addresses = AK_get_table_addresses(table);
+    int i, j, used = 0;
+    AK_PRO;
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            if (AK_get_block(j)->block->tuple_dict[0].type != FREE_INT)
+                used++;
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return used;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that counts the extents of a table
+ * @param table table name
+ * @return number of extents
+ */
+static int AK_vacuum_num_extents(char *table) {
+    table_addresses *addresses = AK_get_table_addresses(table);
+    int i;
+    AK_PRO;
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++)
+        ;
+    AK_free(addresses);
+    AK_EPI;
+    return i;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that checks the rows left in the table used by AK_vacuum_test, only even ids in group "keep"
+ * @param table table name
+ * @return number of rows if all of them are correct, otherwise EXIT_ERROR
+ */
+static int AK_vacuum_check_rows(char *table) {
+    table_addresses *addresses = AK_get_table_addresses(table);
+    AK_block *block;
+    int i, j, k, id, rows = 0, correct = 1;
+    AK_PRO;
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            block = AK_get_block(j)->block;
+            for (k = 0; k + 2 <= DATA_BLOCK_SIZE && block->tuple_dict[k].type != FREE_INT; k += 2) {
+                if (AK_vacuum_row_deleted(block, k))
+                    continue;
+                memcpy(&id, block->data + block->tuple_dict[k].address, sizeof (int));
+                if (id % 2 != 0 || block->tuple_dict[k + 1].size != 4
+                        || memcmp(block->data + block->tuple_dict[k + 1].address, "keep", 4) != 0)
+                    correct = 0;
+                rows++;
+            }
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return correct ? rows : EXIT_ERROR;
+}
+
+static int vacuum_test_run_count = 0;
+
+/**
+ * @author Unknown
+ * @brief Function for testing VACUUM. A table is filled over two blocks, every second row is deleted and an
+ *        empty extent is added, then the table is vacuumed explicitly and by the background thread.
+ * @return TestResult
+ */
+TestResult AK_vacuum_test() {
+    char table[MAX_ATT_NAME];
+    AK_vacuum_stats stats;
+    struct list_node *row_root;
+    int i, id, rows, blocks, passed = 0, failed = 0;
+    AK_PRO;
+
+    AK_header header[3] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "grp", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    sprintf(table, "vacuum_test_%d", vacuum_test_run_count++);
+    if (AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, header) == EXIT_ERROR) {
+        AK_EPI;
+        return TEST_result(0, 1);
+    }
+
+    row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row_root);
+    for (id = 0; id < 300; id++) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, id % 2 ? "drop" : "keep", table, "grp", row_root);
+        AK_insert_row(row_root);
+    }
+    AK_init_new_extent(table, SEGMENT_TYPE_TABLE);
+
+    AK_DeleteAll_L3(&row_root);
+    AK_Update_Existing_Element(TYPE_VARCHAR, "drop", table, "grp", row_root);
+    AK_delete_row(row_root);
+
+    rows = AK_get_num_records(table);
+    blocks = AK_vacuum_used_blocks(table);
+    printf("AK_vacuum_test: before VACUUM %d rows in %d blocks, %d extents, %d%% dead space\n",
+            rows, blocks, AK_vacuum_num_extents(table), AK_vacuum_dead_space(table));
+
+    /* 1: deleted rows are reclaimed and the rows of the second block fit into the first one */
+    if (AK_vacuum_table(table, &stats) == EXIT_SUCCESS && stats.bytes_reclaimed > 0 && stats.rows_moved > 0
+            && AK_vacuum_dead_space(table) == 0 && AK_vacuum_used_blocks(table) < blocks) {
+        passed++;
+    } else {
+        failed++;
+    }
+    printf("AK_vacuum_test: %d blocks compacted, %d rows moved, %d bytes reclaimed, %d extents released\n",
+            stats.blocks_compacted, stats.rows_moved, stats.bytes_reclaimed, stats.extents_released);
+
+    /* 2: the empty extent is given back */
+    if (stats.extents_released == 1 && AK_vacuum_num_extents(table) == 1) {
+        passed++;
+    } else {
+        failed++;
+    }
+
+    /* 3: the table still holds exactly the rows that were not deleted */
+    if (rows == 150 && AK_get_num_records(table) == rows && AK_vacuum_check_rows(table) == rows) {
+        passed++;
+    } else {
+        failed++;
+    }
+
+    /* 4: the background thread vacuums a scheduled table */
+    for (id = 300; id < 310; id++) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, "temp", table, "grp", row_root);
+        AK_insert_row(row_root);
+    }
+    AK_DeleteAll_L3(&row_root);
+    AK_Update_Existing_Element(TYPE_VARCHAR, "temp", table, "grp", row_root);
+    AK_delete_row(row_root);
+    if (AK_vacuum_dead_space(table) > 0 && AK_vacuum_schedule(table) == EXIT_SUCCESS
+            && AK_vacuum_start_background(1, 0) == EXIT_SUCCESS) {
+        for (i = 0; i < 10 && AK_vacuum_dead_space(table) > 0; i++)
+            sleep(1);
+        AK_vacuum_stop_background();
+        AK_vacuum_unschedule(table);
+        if (AK_vacuum_dead_space(table) == 0 && AK_vacuum_check_rows(table) == rows)
+            passed++;
+        else
+            failed++;
+    } else {
+        failed++;
+    }
+
+    AK_print_table(table);
+    AK_DeleteAll_L3(&row_root);
+    AK_free(row_root);
+    AK_delete_segment(table, SEGMENT_TYPE_TABLE);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
@@ -0,0 +1,66 @@
+/**
+@file vacuum.h Header file that provides data structures and declarations of functions for block compaction (VACUUM)
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef VACUUM
+#define VACUUM
+
+#include <pthread.h>
+#include "../auxi/test.h"
+#include "../mm/memoman.h"
+#include "../dm/dbman.h"
+#include "table.h"
+#include "files.h"
+#include "fileio.h"
+#include "zonemap.h"
+#include "bloom.h"
+#include "encoding.h"
+#include "pax.h"
+#include "../auxi/mempro.h"
+
+/**
+ * @def MAX_VACUUM_TABLES
+ * @brief maximum number of tables the background vacuum takes care of
+ */
+#define MAX_VACUUM_TABLES 32
+
+/**
+ * @struct AK_vacuum_stats
+ * @brief Work done by one VACUUM of a table
+ * @var blocks_compacted blocks rewritten in place
+ * @var rows_moved rows moved into an earlier block of the segment
+ * @var bytes_reclaimed data bytes of deleted rows given back to the blocks
+ * @var extents_released empty extents returned with AK_delete_extent
+ */
+typedef struct {
+    int blocks_compacted;
+    int rows_moved;
+    int bytes_reclaimed;
+    int extents_released;
+} AK_vacuum_stats;
+
+int AK_vacuum_block(AK_block *block, int num_attr);
+int AK_vacuum_dead_space(char *table);
+int AK_vacuum_table(char *table, AK_vacuum_stats *stats);
+int AK_vacuum_schedule(char *table);
+int AK_vacuum_unschedule(char *table);
+int AK_vacuum_start_background(int interval, int threshold);
+void AK_vacuum_stop_background();
+TestResult AK_vacuum_test();
+
+#endif
@@ -0,0 +1,556 @@
+/**
+@file zonemap.c Provides functions for per-block zone maps. Every block keeps the smallest and the largest
+value and the number of NULLs of each of its columns, so scans can skip blocks that cannot hold a matching row.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#include "zonemap.h"
+#include "fileio.h"
+
+/**
+ * @author Unknown
+ * @brief Function that tells if min and max of a type say something about its values, i.e. if the type
+ *        has an ordering registered in the comparator registry
+ * @param type data type
+ * @return 1 if min/max are kept for the type, 0 otherwise
+ */
+int AK_zone_map_orderable(int type) {
+    AK_PRO;
+    switch (type) {
+        case TYPE_INT:
+        case TYPE_FLOAT:
+        case TYPE_NUMBER:
+        case TYPE_DATE:
+        case TYPE_DATETIME:
+        case TYPE_TIME:
+            AK_EPI;
+            return 1;
+        default:
+            AK_EPI;
+            return 0;
+    }
+}
+
+/**
+ * @author Unknown
+ * @brief Function that widens the zone map of a column so that it covers a new value. The zone map is only
+ *        widened, values that are deleted or overwritten stay covered until AK_zone_map_rebuild.
+ * @param block block the value was written to
+ * @param column index of the column in the block header
+ * @param type data type of the value
+ * @param value value in its block representation
+ * @param size size of the value in bytes
+ * @param is_null 1 if the value is NULL
+ */
+void AK_zone_map_add(AK_block *block, int column, int type, unsigned char *value, int size, int is_null) {
+    AK_zone_map *zone;
+    AK_PRO;
+    if (column < 0 || column >= MAX_ATTRIBUTES) {
+        AK_EPI;
+        return;
+    }
+    zone = &block->zone_map[column];
+    if (is_null) {
+        zone->null_count++;
+        AK_EPI;
+        return;
+    }
+    if (zone->count > 0 && zone->type != type) {
+        //values of different types in one column, nothing can be said about the block
+        block->zone_map_stale = 1;
+        AK_EPI;
+        return;
+    }
+    if (size > (int) sizeof (zone->min))
+        size = sizeof (zone->min);
+    if (zone->count == 0) {
+        zone->type = type;
+        if (AK_zone_map_orderable(type)) {
+            memset(zone->min, 0, sizeof (zone->min));
+            memcpy(zone->min, value, size);
+            memcpy(zone->max, zone->min, sizeof (zone->max));
+        }
+    } else if (AK_zone_map_orderable(type)) {
+        if (AK_compare_values(type, value, size, zone->min, sizeof (zone->min)) < 0) {
+            memset(zone->min, 0, sizeof (zone->min));
+            memcpy(zone->min, value, size);
+        }
+        if (AK_compare_values(type, value, size, zone->max, sizeof (zone->max)) > 0) {
+            memset(zone->max, 0, sizeof (zone->max));
+            memcpy(zone->max, value, size);
+        }
+    }
+    zone->count++;
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that widens the zone maps of a block with all values of one row
+ * @param block block the row was written to
+ * @param id index of the first tuple_dict entry of the row
+ * @param num_attr number of attributes of the row
+ */
+void AK_zone_map_add_row(AK_block *block, int id, int num_attr) {
+    int l;
+    AK_PRO;
+    for (l = 0; l < num_attr && id + l < DATA_BLOCK_SIZE; l++) {
+        AK_zone_map_add(block, l, block->tuple_dict[id + l].type, block->data + block->tuple_dict[id + l].address,
+                block->tuple_dict[id + l].size, AK_IS_NULL(block, id + l));
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that computes the zone maps of a block again from its live rows. It makes the zone maps
+ *        tight after deletes and updates, and trusted again after they were marked stale.
+ * @param block block
+ */
+void AK_zone_map_rebuild(AK_block *block) {
+    int i, num_attr = 0;
+    AK_PRO;
+    memset(block->zone_map, 0, sizeof (block->zone_map));
+    block->zone_map_stale = 0;
+    while (num_attr < MAX_ATTRIBUTES && block->header[num_attr].att_name[0] != FREE_CHAR)
+        num_attr++;
+    if (num_attr == 0) {
+        AK_EPI;
+        return;
+    }
+    for (i = 0; i + num_attr <= DATA_BLOCK_SIZE && block->tuple_dict[i + num_attr - 1].type != FREE_INT; i += num_attr) {
+        //deleted rows have all entries cleared
+        if (block->tuple_dict[i].type == 0 && block->tuple_dict[i].size == 0)
+            continue;
+        AK_zone_map_add_row(block, i, num_attr);
+    }
+    AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that returns how many bytes of a value of an orderable type the comparator reads
+ * @param type data type
+ * @return size in bytes, 0 for types without min/max
+ */
+static int AK_zone_map_value_size(int type) {
+    switch (type) {
+        case TYPE_FLOAT:
+            return sizeof (float);
+        case TYPE_NUMBER:
+            return sizeof (double);
+        default:
+            return AK_zone_map_orderable(type) ? sizeof (int) : 0;
+    }
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if some non NULL value of a column may stand in relation op to a given value
+ * @param block block
+ * @param column index of the column in the block header
+ * @param type data type of the given value
+ * @param op one of =, <, <=, >, >=
+ * @param value given value
+ * @return 0 if no value of the column can satisfy the comparison, 1 if some value may
+ */
+static int AK_zone_map_may_compare(AK_block *block, int column, int type, const char *op, unsigned char *value) {
+    AK_zone_map *zone;
+    int low, high;
+
+    if (strcmp(op, "=") != 0 && strcmp(op, "<") != 0 && strcmp(op, "<=") != 0
+            && strcmp(op, ">") != 0 && strcmp(op, ">=") != 0)
+        return 1;
+    if (block->zone_map_stale || column < 0 || column >= MAX_ATTRIBUTES)
+        return 1;
+    zone = &block->zone_map[column];
+    //no rows or only NULLs, a comparison with NULL is never satisfied
+    if (zone->count == 0)
+        return 0;
+    if (zone->type != type || !AK_zone_map_orderable(type))
+        return 1;
+
+    low = AK_compare_values(type, zone->min, sizeof (zone->min), value, sizeof (zone->min));
+    high = AK_compare_values(type, zone->max, sizeof (zone->max), value, sizeof (zone->max));
+    if (strcmp(op, "=") == 0)
+        return low <= 0 && high >= 0;
+    if (strcmp(op, "<") == 0)
+        return low < 0;
+    if (strcmp(op, "<=") == 0)
+        return low <= 0;
+    if (strcmp(op, ">") == 0)
+        return high > 0;
+    return high >= 0;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if a block may hold a non NULL value of a column in a closed interval
+ * @param block block
+ * @param column index of the column in the block header
+ * @param type data type of the bounds
+ * @param lower lower bound, NULL for none
+ * @param upper upper bound, NULL for none
+ * @return 0 if the block surely has no such value, 1 otherwise
+ */
+int AK_zone_map_may_contain(AK_block *block, int column, int type, unsigned char *lower, unsigned char *upper) {
+    int result = 1;
+    unsigned char value[sizeof (double)];
+    AK_PRO;
+    if (lower != NULL) {
+        memset(value, 0, sizeof (value));
+        memcpy(value, lower, AK_zone_map_value_size(type));
+        result = AK_zone_map_may_compare(block, column, type, ">=", value);
+    }
+    if (result && upper != NULL) {
+        memset(value, 0, sizeof (value));
+        memcpy(value, upper, AK_zone_map_value_size(type));
+        result = AK_zone_map_may_compare(block, column, type, "<=", value);
+    }
+    AK_EPI;
+    return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if a block may hold a NULL in a column
+ * @param block block
+ * @param column index of the column in the block header
+ * @return 0 if the column surely has no NULLs in the block, 1 otherwise
+ */
+int AK_zone_map_may_contain_null(AK_block *block, int column) {
+    AK_PRO;
+    if (block->zone_map_stale || column < 0 || column >= MAX_ATTRIBUTES) {
+        AK_EPI;
+        return 1;
+    }
+    AK_EPI;
+    return block->zone_map[column].null_count > 0;
+}
+
+/**
+ * @struct AK_zone_map_operand
+ * @brief Operand of a selection expression as seen by AK_zone_map_may_satisfy
+ * @var column index of the column in the block header, -1 for a constant
+ * @var type data type of a constant
+ * @var value data of a constant
+ */
+typedef struct {
+    int column;
+    int type;
+    unsigned char *value;
+} AK_zone_map_operand;
+
+/**
+ * @author Unknown
+ * @brief Function that tells if the comparison a op b may hold for some row of a block, one of the operands
+ *        has to be a column and the other a constant
+ * @return 0 if the comparison fails for every row, 1 otherwise
+ */
+static int AK_zone_map_may_hold(AK_block *block, AK_zone_map_operand *a, const char *op, AK_zone_map_operand *b) {
+    if (a->column >= 0 && b->column < 0)
+        return AK_zone_map_may_compare(block, a->column, b->type, op, b->value);
+    if (a->column < 0 && b->column >= 0) {
+        //constant op column is column flipped(op) constant
+        if (strcmp(op, "<") == 0)
+            op = ">";
+        else if (strcmp(op, ">") == 0)
+            op = "<";
+        else if (strcmp(op, "<=") == 0)
+            op = ">=";
+        else if (strcmp(op, ">=") == 0)
+            op = "<=";
+        return AK_zone_map_may_compare(block, b->column, a->type, op, a->value);
+    }
+    return 1;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that tells if some row of a block may satisfy a selection expression. The postfix expression
+ *        is walked the same way AK_check_if_row_satisfies_expression walks it, but every comparison of a column
+ *        with a constant is decided from the zone map of the column. Operators the zone maps say nothing about
+ *        count as satisfied, so a block is only skipped when no row of it can be selected.
+ * @param block block
+ * @param expr selection expression in postfix notation
+ * @return 0 if no row of the block satisfies the expression, 1 otherwise
+ */
+int AK_zone_map_may_satisfy(AK_block *block, struct list_node *expr) {
+    AK_zone_map_operand operands[ZONE_MAP_STACK_SIZE];
+    char results[ZONE_MAP_STACK_SIZE];
+    int num_operands = 0, num_results = 0, column;
+    struct list_node *el;
+    AK_zone_map_operand *a, *b, *c;
+    char result;
+    AK_PRO;
+
+    if (expr == NULL || block->zone_map_stale) {
+        AK_EPI;
+        return 1;
+    }
+
+    for (el = AK_First_L2(expr); el != NULL; el = el->next) {
+        if (el->type == TYPE_OPERATOR) {
+            if (num_results == ZONE_MAP_STACK_SIZE) {
+                AK_EPI;
+                return 1;
+            }
+            if (strcmp(el->data, "AND") == 0 || strcmp(el->data, "OR") == 0) {
+                if (num_results < 2) {
+                    AK_EPI;
+                    return 1;
+                }
+                if (strcmp(el->data, "AND") == 0)
+                    result = results[num_results - 1] && results[num_results - 2];
+                else
+                    result = results[num_results - 1] || results[num_results - 2];
+            } else if (strcmp(el->data, "BETWEEN") == 0) {
+                if (num_operands < 3) {
+                    AK_EPI;
+                    return 1;
+                }
+                c = &operands[num_operands - 3];
+                a = &operands[num_operands - 2];
+                b = &operands[num_operands - 1];
+                result = AK_zone_map_may_hold(block, c, ">=", a) && AK_zone_map_may_hold(block, c, "<=", b);
+            } else if (num_operands >= 2) {
+                a = &operands[num_operands - 2];
+                b = &operands[num_operands - 1];
+                result = AK_zone_map_may_hold(block, a, el->data, b);
+            } else {
+                result = 1;
+            }
+            //operands stay on their stack, like in AK_check_if_row_satisfies_expression
+            results[num_results++] = result;
+            continue;
+        }
+
+        if (num_operands == ZONE_MAP_STACK_SIZE) {
+            AK_EPI;
+            return 1;
+        }
+        if (el->type == TYPE_ATTRIBS) {
+            for (column = 0; column < MAX_ATTRIBUTES && block->header[column].att_name[0] != FREE_CHAR; column++) {
+                if (strcmp(block->header[column].att_name, el->data) == 0)
+                    break;
+            }
+            if (column == MAX_ATTRIBUTES || block->header[column].att_name[0] == FREE_CHAR) {
+                AK_EPI;
+                return 1;
+            }
+            operands[num_operands].column = column;
+        } else {
+            operands[num_operands].column = -1;
+        }
+        operands[num_operands].type = el->type;
+        operands[num_operands].value = (unsigned char *) el->data;
+        num_operands++;
+    }
+
+    AK_EPI;
+    return num_results > 0 ? results[num_results - 1] : 1;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that counts the blocks of a table whose zone maps say they may hold a value of an
+ *        integer column in an interval
+ * @param table table name
+ * @param column index of the column
+ * @param lower lower bound
+ * @param upper upper bound
+ * @param used set to the number of blocks that hold rows
+ * @return number of blocks that may hold a matching value
+ */
+static int AK_zone_map_test_count_blocks(char *table, int column, int lower, int upper, int *used) {
+    table_addresses *addresses = AK_get_table_addresses(table);
+    AK_block *block;
+    int i, j, count = 0;
+    AK_PRO;
+    *used = 0;
+    for (i = 0; i < MAX_EXTENTS_IN_SEGMENT && addresses->address_from[i] != 0; i++) {
+        for (j = addresses->address_from[i]; j < addresses->address_to[i]; j++) {
+            block = AK_get_block(j)->block;
+            if (block->tuple_dict[0].type == FREE_INT)
+                continue;
+            (*used)++;
+            if (AK_zone_map_may_contain(block, column, TYPE_INT, (unsigned char *) &lower, (unsigned char *) &upper))
+                count++;
+        }
+    }
+    AK_free(addresses);
+    AK_EPI;
+    return count;
+}
+
+/**
+ * @author Unknown
+ * @brief Function for testing zone maps
+ * @return TestResult
+ */
+TestResult AK_zone_map_test() {
+    char table[MAX_ATT_NAME];
+    static int run_count = 0;
+    AK_block *block;
+    struct list_node *row_root, *expr;
+    int i, id, used, passed = 0, failed = 0;
+    int low = 30, high = 12, in_low = 20, in_high = 25, min = 10, max = 19, value;
+    float weight;
+    unsigned char entry[sizeof (double)];
+    AK_PRO;
+
+    AK_header header[4] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_FLOAT, "weight", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "note", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+    AK_header table_header[2] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+
+    block = AK_init_block();
+    memcpy(block->header, header, sizeof (header));
+    row_root = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&row_root);
+    for (id = 10; id < 20; id++) {
+        weight = id / 2.0f;
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, "zone_map_block", "id", row_root);
+        AK_Insert_New_Element(TYPE_FLOAT, &weight, "zone_map_block", "weight", row_root);
+        AK_Insert_New_Element(TYPE_VARCHAR, id % 2 ? "odd" : NULL, "zone_map_block", "note", row_root);
+        AK_insert_row_to_block(row_root, block);
+    }
+
+    /* 1: inserts widen min, max and the NULL count */
+    printf("\nZone map maintenance test\n");
+    value = 15;
+    if (!block->zone_map_stale && block->zone_map[0].count == 10 && block->zone_map[2].null_count == 5
+            && AK_compare_values(TYPE_INT, block->zone_map[0].min, sizeof (int), (unsigned char *) &min, sizeof (int)) == 0
+            && AK_compare_values(TYPE_INT, block->zone_map[0].max, sizeof (int), (unsigned char *) &max, sizeof (int)) == 0
+            && AK_zone_map_may_contain(block, 0, TYPE_INT, (unsigned char *) &value, (unsigned char *) &value)
+            && !AK_zone_map_may_contain(block, 0, TYPE_INT, (unsigned char *) &in_low, (unsigned char *) &in_high)
+            && AK_zone_map_may_contain_null(block, 2) && !AK_zone_map_may_contain_null(block, 0)) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 2: selection expressions, id > 30 OR id < 12 may match, id BETWEEN 20 AND 25 and id > 30 AND id < 12 do not */
+    printf("\nZone map expression test\n");
+    expr = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &low, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &high, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "<", sizeof ("<"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "OR", sizeof ("OR"), expr);
+    i = AK_zone_map_may_satisfy(block, expr);
+    AK_DeleteAll_L3(&expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &low, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &high, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "<", sizeof ("<"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "AND", sizeof ("AND"), expr);
+    i = i && !AK_zone_map_may_satisfy(block, expr);
+    AK_DeleteAll_L3(&expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &in_low, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, (char *) &in_high, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "BETWEEN", sizeof ("BETWEEN"), expr);
+    i = i && !AK_zone_map_may_satisfy(block, expr);
+    AK_DeleteAll_L3(&expr);
+    weight = 1.0f;
+    AK_InsertAtEnd_L3(TYPE_FLOAT, (char *) &weight, sizeof (float), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "weight", sizeof ("weight"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    i = i && !AK_zone_map_may_satisfy(block, expr);
+    AK_DeleteAll_L3(&expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "note", sizeof ("note"), expr);
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "zzz", sizeof ("zzz"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    i = i && AK_zone_map_may_satisfy(block, expr);
+    AK_DeleteAll_L3(&expr);
+    AK_free(expr);
+    if (i) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    /* 3: a stale zone map skips nothing until it is rebuilt */
+    printf("\nZone map rebuild test\n");
+    value = 22;
+    weight = 11.0f;
+    memset(entry, 0, sizeof (entry));
+    memcpy(entry, &weight, sizeof (float));
+    id = block->last_tuple_dict_id + 1;
+    AK_insert_entry(block, TYPE_INT, &value, id);
+    AK_insert_entry(block, TYPE_FLOAT, entry, id + 1);
+    AK_insert_entry(block, TYPE_VARCHAR, "even", id + 2);
+    block->last_tuple_dict_id = id + 2;
+    i = block->zone_map_stale && AK_zone_map_may_contain(block, 0, TYPE_INT, (unsigned char *) &in_low, (unsigned char *) &in_high);
+    AK_zone_map_rebuild(block);
+    if (i && !block->zone_map_stale && block->zone_map[0].count == 11
+            && AK_zone_map_may_contain(block, 0, TYPE_INT, (unsigned char *) &in_low, (unsigned char *) &in_high)
+            && !AK_zone_map_may_contain(block, 0, TYPE_INT, (unsigned char *) &low, NULL)) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+    AK_free(block);
+
+    /* 4: rows inserted in id order fill the blocks of a table with disjoint zones */
+    printf("\nZone map table test\n");
+    sprintf(table, "zone_map_test_%d", run_count++);
+    if (AK_initialize_new_segment(table, SEGMENT_TYPE_TABLE, table_header) == EXIT_ERROR) {
+        AK_DeleteAll_L3(&row_root);
+        AK_free(row_root);
+        AK_EPI;
+        return TEST_result(passed, failed + 1);
+    }
+    for (id = 0; id < 600; id++) {
+        AK_DeleteAll_L3(&row_root);
+        AK_Insert_New_Element(TYPE_INT, &id, table, "id", row_root);
+        AK_insert_row(row_root);
+    }
+    i = AK_zone_map_test_count_blocks(table, 0, 100, 110, &used);
+    printf("%d of %d blocks may hold id between 100 and 110\n", i, used);
+    if (used > 1 && i == 1) {
+        printf("SUCCESS\n");
+        passed++;
+    } else {
+        printf("FAIL\n");
+        failed++;
+    }
+
+    AK_DeleteAll_L3(&row_root);
+    AK_free(row_root);
+    AK_EPI;
+    return TEST_result(passed, failed);
+}
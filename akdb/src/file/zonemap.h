@@ -0,0 +1,45 @@
+/**
+@file zonemap.h Header file that provides declarations of functions for per-block zone maps (min/max/NULL summaries of columns)
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor Boston, MA 02110-1301,  USA
+ */
+
+#ifndef ZONEMAP
+#define ZONEMAP
+
+#include "../auxi/test.h"
+#include "../auxi/auxiliary.h"
+#include "../auxi/comparator.h"
+#include "../dm/dbman.h"
+#include "../mm/memoman.h"
+#include "../auxi/mempro.h"
+
+/**
+ * @def ZONE_MAP_STACK_SIZE
+ * @brief maximum number of operands of a selection expression AK_zone_map_may_satisfy can look at
+ */
+#define ZONE_MAP_STACK_SIZE 64
+
+int AK_zone_map_orderable(int type);
+void AK_zone_map_add(AK_block *block, int column, int type, unsigned char *value, int size, int is_null);
+void AK_zone_map_add_row(AK_block *block, int id, int num_attr);
+void AK_zone_map_rebuild(AK_block *block);
+int AK_zone_map_may_contain(AK_block *block, int column, int type, unsigned char *lower, unsigned char *upper);
+int AK_zone_map_may_contain_null(AK_block *block, int column);
+int AK_zone_map_may_satisfy(AK_block *block, struct list_node *expr);
+TestResult AK_zone_map_test();
+
+#endif
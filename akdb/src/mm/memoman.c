@@ -23,6 +23,7 @@
 
 #include "memoman.h"
 #include "../dm/dbman.h"
+#include "../file/table.h"
 
 PtrContainer db_cache;
 PtrContainer redo_log;
@@ -597,28 +598,40 @@ table_addresses *AK_get_segment_addresses_internal(char *tableName, char *segmen
 	int address_from;
 	int address_to;
 	int j = 0;
-	for (i = 0; i < DATA_BLOCK_SIZE; i++)
+	int num_attr;
+	int block;
+	//rows of AK_index have table_id and attribute_id after the addresses
+	for (num_attr = 0; num_attr < MAX_ATTRIBUTES && mem_block->block->header[num_attr].att_name[0] != FREE_CHAR; num_attr++)
+		;
+	//rows are inserted into the blocks of the system table extent one after another
+	for (block = address_sys; block < address_sys + INITIAL_EXTENT_SIZE; block++)
 	{
-		if (mem_block->block->tuple_dict[i].type == FREE_INT)
-			break;
-		if ( (mem_block->block->last_tuple_dict_id) <= i )
+		mem_block = AK_get_block(block);
+		if (mem_block->block->tuple_dict[0].type == FREE_INT)
 			break;
-		i++;
-		memcpy(name, &(mem_block->block->data[mem_block->block->tuple_dict[i].address]), mem_block->block->tuple_dict[i].size);
-		name[ mem_block->block->tuple_dict[i].size] = '\0';
-		i++;
-		memcpy(&address_from, &(mem_block->block->data[mem_block->block->tuple_dict[i].address]), mem_block->block->tuple_dict[i].size);
-		i++;
-		memcpy(&address_to, &(mem_block->block->data[mem_block->block->tuple_dict[i].address]), mem_block->block->tuple_dict[i].size);
-		//if found the table that addresses we need
-		if (strcmp(name, segmentName) == 0)
+		for (i = 0; i < DATA_BLOCK_SIZE; i += num_attr - 3)
 		{
-			addresses->address_from[j] = address_from;
-			addresses->address_to[j] = address_to;
-			j++;
-			AK_dbg_messg(HIGH, MEMO_MAN, "get_segment_addresses(%s): Found addresses of searching segment: %d , %d \n", name, address_from, address_to);
-		}
+			if (mem_block->block->tuple_dict[i].type == FREE_INT)
+				break;
+			if ( (mem_block->block->last_tuple_dict_id) <= i )
+				break;
+			i++;
+			memcpy(name, &(mem_block->block->data[mem_block->block->tuple_dict[i].address]), mem_block->block->tuple_dict[i].size);
+			name[ mem_block->block->tuple_dict[i].size] = '\0';
+			i++;
+			memcpy(&address_from, &(mem_block->block->data[mem_block->block->tuple_dict[i].address]), mem_block->block->tuple_dict[i].size);
+			i++;
+			memcpy(&address_to, &(mem_block->block->data[mem_block->block->tuple_dict[i].address]), mem_block->block->tuple_dict[i].size);
+			//if found the table that addresses we need
+			if (strcmp(name, segmentName) == 0 && j < MAX_EXTENTS_IN_SEGMENT)
+			{
+				addresses->address_from[j] = address_from;
+				addresses->address_to[j] = address_to;
+				j++;
+				AK_dbg_messg(HIGH, MEMO_MAN, "get_segment_addresses(%s): Found addresses of searching segment: %d , %d \n", name, address_from, address_to);
+			}
 
+		}
 	}
 	AK_EPI;
 	return addresses;
@@ -780,7 +793,9 @@ int AK_find_AK_free_space(table_addresses * addresses)
         SEGMENT_TYPE_TABLE,
         SEGMENT_TYPE_INDEX,
         SEGMENT_TYPE_TRANSACTION,
-        SEGMENT_TYPE_TEMP
+        SEGMENT_TYPE_TEMP,
+        SEGMENT_TYPE_PAX_TABLE,
+        SEGMENT_TYPE_APPEND_TABLE; extents of a PAX or append-only table keep its type even if SEGMENT_TYPE_TABLE is given
   * @return address of new extent, otherwise EXIT_ERROR
 
  */
@@ -790,7 +805,8 @@ int AK_init_new_extent(char *table_name, int extent_type)
 
 	int old_size = 0;
 	int new_size = 0;
-	table_addresses *addresses = (table_addresses *) AK_get_segment_addresses(table_name);
+	table_addresses *addresses = extent_type == SEGMENT_TYPE_INDEX ? (table_addresses *) AK_get_index_addresses(table_name)
+		: (table_addresses *) AK_get_segment_addresses(table_name);
 	int block_address = addresses->address_from[0]; //before 1
 	int block_written;
 
@@ -822,6 +838,12 @@ int AK_init_new_extent(char *table_name, int extent_type)
 
 	old_size++;
 
+	//a PAX or append-only table keeps its layout in the new extent
+	if (extent_type == SEGMENT_TYPE_TABLE && mem_block->block->pax)
+		extent_type = SEGMENT_TYPE_PAX_TABLE;
+	if (extent_type == SEGMENT_TYPE_TABLE && mem_block->block->append_only)
+		extent_type = SEGMENT_TYPE_APPEND_TABLE;
+
 	if ((start_address = AK_new_extent(1, old_size, extent_type, mem_block->block->header)) == EXIT_ERROR)
 	{
 		printf("AK_init_new_extent: Could not allocate the new extent\n");
@@ -833,6 +855,8 @@ int AK_init_new_extent(char *table_name, int extent_type)
 	switch (extent_type)
 	{
 		case SEGMENT_TYPE_TABLE:
+		case SEGMENT_TYPE_PAX_TABLE:
+		case SEGMENT_TYPE_APPEND_TABLE:
 			RESIZE_FACTOR = EXTENT_GROWTH_TABLE;
 			sys_table = "AK_relation";
 			break;
@@ -846,7 +870,7 @@ int AK_init_new_extent(char *table_name, int extent_type)
 			break;
 		case SEGMENT_TYPE_TEMP:
 			RESIZE_FACTOR = EXTENT_GROWTH_TEMP;
-			printf("Not implemented yet!\n");
+			sys_table = "AK_relation";
 			break;
 	}
 
@@ -860,7 +884,30 @@ int AK_init_new_extent(char *table_name, int extent_type)
 	AK_Insert_New_Element(TYPE_VARCHAR, table_name, sys_table, "name", row_root);
 	AK_Insert_New_Element(TYPE_INT, &start_address, sys_table, "start_address", row_root);
 	AK_Insert_New_Element(TYPE_INT, &end_address, sys_table, "end_address", row_root);
+	if (extent_type == SEGMENT_TYPE_INDEX)
+	{
+		//the new extent belongs to the same table and attribute as the first one
+		int table_id = 0, attribute_id = 0, num_rows = AK_get_num_records(sys_table);
+		struct list_node *row;
+		for (i = 0; i < num_rows; i++)
+		{
+			row = AK_get_row(i, sys_table);
+			if (strcmp(AK_GetNth_L2(2, row)->data, table_name) == 0)
+			{
+				memcpy(&table_id, AK_GetNth_L2(5, row)->data, sizeof (int));
+				memcpy(&attribute_id, AK_GetNth_L2(6, row)->data, sizeof (int));
+				i = num_rows;
+			}
+			AK_DeleteAll_L3(&row);
+			AK_free(row);
+		}
+		AK_Insert_New_Element(TYPE_INT, &table_id, sys_table, "table_id", row_root);
+		AK_Insert_New_Element(TYPE_INT, &attribute_id, sys_table, "attribute_id", row_root);
+	}
 	AK_insert_row(row_root);
+	AK_DeleteAll_L3(&row_root);
+	AK_free(row_root);
+	AK_free(addresses);
 	AK_EPI;
 	return start_address;
 }
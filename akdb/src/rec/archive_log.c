@@ -90,7 +90,7 @@ char* AK_get_timestamp() {
     tm=localtime(&tv.tv_sec);
 
     // dobavljanje timestampa
-    char* log_name = malloc(30);
+    char* log_name = malloc(32);
     sprintf(log_name, "%d.%d.%d-%d:%02d:%02d.%lu.bin", tm->tm_mday, tm->tm_mon+1,
             tm->tm_year+1900, tm->tm_hour, tm->tm_min, tm->tm_sec, tv.tv_usec);
 
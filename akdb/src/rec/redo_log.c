@@ -59,11 +59,12 @@ int AK_add_to_redolog(int command, struct list_node *row_root){
     char** attrs = AK_calloc(attrs_length, sizeof(char*));
     int i = 0;
     while (el != NULL) {
-        switch (el->type) {
+        switch (el->is_null ? FREE_CHAR : el->type) {
 
             case FREE_CHAR:
                 strncat(record, "null", 4);
-                attrs[i] = "null";
+                attrs[i] = (char*) AK_malloc(MAX_VARCHAR_LENGTH * sizeof(char));
+                strcpy(attrs[i], "null");
                 break;
             case TYPE_INT:
 				attrs[i] = (char*) AK_malloc(MAX_VARCHAR_LENGTH * sizeof(char));
@@ -241,6 +241,7 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
     int num_attr = AK_num_attr(source_table);
 
     int k, l, m, n, o, counter;
+    int not_null[MAX_ATTRIBUTES]; //number of non NULL values every aggregation has seen, when there is no grouping
 
     AK_block *temp;
     AK_mem_block *mem_block;
@@ -253,6 +254,7 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
 
     i = 0;
     counter = 0;
+    memset(not_null, 0, sizeof (not_null));
 
     while (addresses->address_from[ i ] != 0) {
         for (j = addresses->address_from[ i ]; j < addresses->address_to[ i ]; j++) {
@@ -268,6 +270,10 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
                 	for (l = 0; l < num_attr; l++) {
 						for (m = 0; m < num_aggregations; m++) {
 							if (strcmp(needed_values[m].att_name, temp->header[l].att_name) == 0) {
+								//aggregate functions skip NULL values
+								if (AK_IS_NULL(temp, k + l))
+									continue;
+								not_null[m]++;
 								switch (needed_values[m].agg_task) {
 									case AGG_TASK_COUNT:
 										//no break is intentional
@@ -277,7 +283,7 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
 
 
 										//prepravljeni dio koda
-										*((int*)needed_values[m].data) = counter;
+										*((int*)needed_values[m].data) = not_null[m];
 										((char*)needed_values[m].data)[sizeof(int)] = '\0';
 										
 									break;
@@ -286,19 +292,19 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
 										switch (agg_head[m].type) {
 											case TYPE_INT:
 												memcpy(&inttemp, &(temp->data[temp->tuple_dict[k + l].address]), temp->tuple_dict[k + l].size);
-												if (*((int*)needed_values[m].data) < inttemp || counter == 1)
+												if (*((int*)needed_values[m].data) < inttemp || not_null[m] == 1)
 													memcpy(needed_values[m].data, &inttemp, sizeof (int));
 												break;
 
 											case TYPE_FLOAT:
 												memcpy(&floattemp, &(temp->data[temp->tuple_dict[k + l].address]), temp->tuple_dict[k + l].size);
-												if (*((float *)needed_values[m].data) < floattemp || counter == 1)
+												if (*((float *)needed_values[m].data) < floattemp || not_null[m] == 1)
 													memcpy(needed_values[m].data, &floattemp, sizeof(float));
 												break;
 
 											case TYPE_NUMBER:
 												memcpy(&doubletemp, &(temp->data[temp->tuple_dict[k + l].address]), temp->tuple_dict[k + l].size);
-												if (*((double *)needed_values[m].data) < doubletemp || counter == 1)
+												if (*((double *)needed_values[m].data) < doubletemp || not_null[m] == 1)
 													memcpy(needed_values[m].data, &doubletemp, sizeof(double));
 												break;
 										}
@@ -309,19 +315,19 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
 										switch (agg_head[m].type) {
 											case TYPE_INT:
 												memcpy(&inttemp, &(temp->data[temp->tuple_dict[k + l].address]), temp->tuple_dict[k + l].size);
-												if (*((int*)needed_values[m].data) > inttemp || counter == 1)
+												if (*((int*)needed_values[m].data) > inttemp || not_null[m] == 1)
 													memcpy(needed_values[m].data, &inttemp, sizeof (int));
 												break;
 
 											case TYPE_FLOAT:
 												memcpy(&floattemp, &(temp->data[temp->tuple_dict[k + l].address]), temp->tuple_dict[k + l].size);
-												if (*((float *)needed_values[m].data) > floattemp || counter == 1)
+												if (*((float *)needed_values[m].data) > floattemp || not_null[m] == 1)
 													memcpy(needed_values[m].data, &floattemp, sizeof(float));
 												break;
 
 											case TYPE_NUMBER:
 												memcpy(&doubletemp, &(temp->data[temp->tuple_dict[k + l].address]), temp->tuple_dict[k + l].size);
-												if (*((double *)needed_values[m].data) > doubletemp || counter == 1)
+												if (*((double *)needed_values[m].data) > doubletemp || not_null[m] == 1)
 													memcpy(needed_values[m].data, &doubletemp, sizeof(double));
 												break;
 										}
@@ -452,7 +458,8 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
 
 						for (l = 0; l < num_attr; l++) {
 							for (m = 0; m < num_aggregations; m++) {
-								if (strcmp(needed_values[m].att_name, temp->header[l].att_name) == 0) {
+								//NULL values leave the aggregates of the group unchanged
+								if (strcmp(needed_values[m].att_name, temp->header[l].att_name) == 0 && !AK_IS_NULL(temp, k + l)) {
 									switch (needed_values[m].agg_task) {
 										case AGG_TASK_COUNT:
 											//no break is intentional
@@ -584,6 +591,9 @@ int AK_aggregation(AK_agg_input *input, char *source_table, char *agg_table) {
 						}
 
 						//AK_update_delete_row_from_block(mem_block->block, row_root, 0);
+						//the aggregates were changed in place
+						AK_zone_map_rebuild(mem_block->block);
+						AK_bloom_rebuild(mem_block->block);
                         AK_mem_block_modify(mem_block, BLOCK_DIRTY);
 					}
 				}
@@ -101,7 +101,6 @@ int AK_difference(char *srcTable1, char *srcTable2, char *dstTable) {
 		different = num_rows = summ = 0;
 		
         char data1[MAX_VARCHAR_LENGTH];
-		char data2[MAX_VARCHAR_LENGTH];
 
 		//initializing new segment
 		AK_header *header = (AK_header *) AK_malloc(num_att * sizeof (AK_header));
@@ -150,18 +149,15 @@ int AK_difference(char *srcTable1, char *srcTable2, char *dstTable) {
 											
 											//for each element in row
 											for (o = 0; o < num_att; o++) {
-												address = tbl1_temp_block->block->tuple_dict[m + o].address;
-												size = tbl1_temp_block->block->tuple_dict[m + o].size;
 												type = tbl1_temp_block->block->tuple_dict[m + o].type;
-												AK_difference_Print_By_Type(data1,address, size, type, tbl1_temp_block);
-
-												address = tbl2_temp_block->block->tuple_dict[n + o].address;
-												size = tbl2_temp_block->block->tuple_dict[n + o].size;
-												type = tbl2_temp_block->block->tuple_dict[n + o].type;
-												AK_difference_Print_By_Type(data2,address, size, type, tbl2_temp_block);
 
-												//if they are the same
-												if(strcmp(data1,data2)==0){
+												//if they are the same, compared by their stored values of the same type
+												if (type == tbl2_temp_block->block->tuple_dict[n + o].type
+														&& AK_compare_values(type,
+															tbl1_temp_block->block->data + tbl1_temp_block->block->tuple_dict[m + o].address,
+															tbl1_temp_block->block->tuple_dict[m + o].size,
+															tbl2_temp_block->block->data + tbl2_temp_block->block->tuple_dict[n + o].address,
+															tbl2_temp_block->block->tuple_dict[n + o].size) == 0) {
 													different++;
 												}
 												if(different==(num_att-1)) 
@@ -183,7 +179,7 @@ int AK_difference(char *srcTable1, char *srcTable2, char *dstTable) {
 												memset(data1, '\0', MAX_VARCHAR_LENGTH);
 												memcpy(data1, tbl1_temp_block->block->data + address, size);
 
-												AK_Insert_New_Element(type, data1, dstTable, tbl1_temp_block->block->header[o].att_name, row_root);
+												AK_Insert_New_Element(type, AK_IS_NULL(tbl1_temp_block->block, m + o) ? NULL : data1, dstTable, tbl1_temp_block->block->header[o].att_name, row_root);
 											}
 
 											AK_insert_row(row_root);
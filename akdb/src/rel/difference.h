@@ -23,6 +23,7 @@
 #include "../file/table.h"
 #include "../file/fileio.h"
 #include "../auxi/mempro.h"
+#include "../auxi/comparator.h"
 #include "../sql/drop.h"
 
 /**
@@ -319,7 +319,7 @@ int AK_check_regex_operator_expression(const char * value, const char * expressi
 
 void evaluate_equal_operator(struct list_node *a, struct list_node *b, struct list_node *temp_result) {
 	char true = 1, false = 0;
-	if (memcmp(a->data, b->data, a->size) == 0) {
+	if (AK_check_arithmetic_statement(b, "=", a->data, b->data) == 1) {
 	AK_InsertAtEnd_L3(TYPE_INT, &true, sizeof(int), temp_result);
 	} else {
 	AK_InsertAtEnd_L3(TYPE_INT, &false, sizeof(int), temp_result);
@@ -328,7 +328,7 @@ void evaluate_equal_operator(struct list_node *a, struct list_node *b, struct li
 
 void evaluate_not_equal_operator(struct list_node *a, struct list_node *b, struct list_node *temp_result) {
 	char true = 1, false = 0;
-	if (memcmp(a->data, b->data, a->size) != 0) {
+	if (AK_check_arithmetic_statement(b, "!=", a->data, b->data) == 1) {
 	AK_InsertAtEnd_L3(TYPE_INT, &true, sizeof(int), temp_result);
 	} else {
 	AK_InsertAtEnd_L3(TYPE_INT, &false, sizeof(int), temp_result);
@@ -892,7 +892,8 @@ void evaluate_tilde_star_operator(struct list_node *a, struct list_node *b, stru
  * @author Matija Šestak, updated by Dino Laktašić,Nikola Miljancic, abstracted by Tomislav Mikulček, updated by Fran Turković, Karlo Rusovan
  * @brief  Function that evaluates whether one record (row) satisfies logical expression. It goes through
            given row. If it comes to logical operator, it evaluates by itself. For arithmetic operators
-           function AK_check_arithmetic_statement() is called.
+           function AK_check_arithmetic_statement() is called. Operators other than AND and OR are not
+           satisfied when an operand is NULL (is_null flag of the row element).
  * @param row_root beginning of the row that is to be evaluated
  * @param *expr list with the logical expression in postfix notation
  * @result 0 if row does not satisfy, 1 if row satisfies expression
@@ -908,11 +909,16 @@ int AK_check_if_row_satisfies_expression(struct list_node *row_root, struct list
     
     int found;//, result;
     char result = 0;    
+    //temporary stacks go to the query arena if the caller opened one, they are dropped by rewinding it
+    AK_arena *arena = AK_arena_current();
+    AK_arena_mark mark;
+    if (arena != NULL)
+        mark = AK_arena_get_mark(arena);
    	//list of values
-    struct list_node *temp = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    struct list_node *temp = (struct list_node *) AK_temp_alloc(sizeof (struct list_node));
     AK_Init_L3(&temp);
     //list of results (0,1)
-    struct list_node *temp_result = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    struct list_node *temp_result = (struct list_node *) AK_temp_alloc(sizeof (struct list_node));
     AK_Init_L3(&temp_result);
     struct list_node *el = AK_First_L2(expr);
     struct list_node *row;
@@ -933,19 +939,28 @@ int AK_check_if_row_satisfies_expression(struct list_node *row_root, struct list
             }
             if (!found) {
             	AK_dbg_messg(MIDDLE, REL_OP, "Expression ckeck was not able to find column: %s\n", el->data);
-				AK_EPI;
-                return 0;
+                result = 0;
+                break;
             } else {
                 int type = row->type;
+                //only the value itself, the rest of the element holds whatever followed it in the block
                 memset(data, 0, MAX_VARCHAR_LENGTH);
-                memcpy(data, &row->data, sizeof(row->data));     
+                memcpy(data, &row->data, row->size > 0 && row->size < MAX_VARCHAR_LENGTH ? row->size : sizeof(row->data));
 				AK_InsertAtEnd_L3(type, data, sizeof(row->data), temp);
+                if (row->is_null)
+                    AK_End_L2(temp)->is_null = 1;
             }
         } else if (el->type == TYPE_OPERATOR) {
             b = AK_End_L2(temp);
             a = AK_Previous_L2(b, temp);
             c = AK_Previous_L2(a,temp);                   
-            if (strcmp(el->data, "=") == 0) {
+            if (strcmp(el->data, "OR") != 0 && strcmp(el->data, "AND") != 0
+                    && ((b != NULL && b != temp && b->is_null) || (a != NULL && a != temp && a->is_null)
+                        || (c != NULL && c != temp && c->is_null && strcmp(el->data, "BETWEEN") == 0))) {
+                //a comparison with NULL is never satisfied
+                char rs = 0;
+                AK_InsertAtEnd_L3(TYPE_INT, &rs, sizeof (int), temp_result);
+            } else if (strcmp(el->data, "=") == 0) {
                 evaluate_equal_operator(a, b, temp_result);
             } else if (strcmp(el->data, "<>") == 0) {
                 evaluate_not_equal_operator(a, b, temp_result);
@@ -1005,11 +1020,16 @@ int AK_check_if_row_satisfies_expression(struct list_node *row_root, struct list
         }
         el = el->next;
     }
-    memcpy(&result, ((struct list_node *) AK_End_L2(temp_result))->data, sizeof (char));
-    AK_DeleteAll_L3(&temp);
-    AK_free(temp);
-    AK_DeleteAll_L3(&temp_result);
-    AK_free(temp_result);
+    if (el == NULL)
+        memcpy(&result, ((struct list_node *) AK_End_L2(temp_result))->data, sizeof (char));
+    if (arena != NULL) {
+        AK_arena_release(arena, mark);
+    } else {
+        AK_DeleteAll_L3(&temp);
+        AK_free(temp);
+        AK_DeleteAll_L3(&temp_result);
+        AK_free(temp_result);
+    }
     AK_EPI;
     return result;
 }
@@ -63,7 +63,6 @@ int AK_intersect(char *srcTable1, char *srcTable2, char *dstTable) {
 		thesame = 0;
 		
         char data1[MAX_VARCHAR_LENGTH];
-        char data2[MAX_VARCHAR_LENGTH];
 
         //initialize new segment
         AK_header *header = (AK_header *) AK_malloc(num_att * sizeof (AK_header));
@@ -117,22 +116,17 @@ int AK_intersect(char *srcTable1, char *srcTable2, char *dstTable) {
                                                 for (column = 0; column < num_att; column++) 
 												{
                                                     type = tbl1_temp_block->block->tuple_dict[touple1 + column].type;
-                                                    size = tbl1_temp_block->block->tuple_dict[touple1 + column].size;
-                                                    address = tbl1_temp_block->block->tuple_dict[touple1 + column].address;
-													
-                                                    memcpy(data1, &(tbl1_temp_block->block->data[address]), size);
-                                                    data1[size] = '\0';
-
-                                                    type = tbl2_temp_block->block->tuple_dict[touple2 + column].type;
-                                                    size = tbl2_temp_block->block->tuple_dict[touple2 + column].size;
-                                                    address = tbl2_temp_block->block->tuple_dict[touple2 + column].address;
-													
-                                                    memcpy(data2, &(tbl2_temp_block->block->data[address]), size);
-                                                    data2[size] = '\0';
 
                                                     //if two attributes are different, stop searching that row
-													if(strcmp(data1,data2)!=0)break;
-													else if(strcmp(data1, data2) == 0 && column ==(num_att-1)) thesame=1;
+                                                    if (type != tbl2_temp_block->block->tuple_dict[touple2 + column].type
+                                                            || AK_compare_values(type,
+                                                                tbl1_temp_block->block->data + tbl1_temp_block->block->tuple_dict[touple1 + column].address,
+                                                                tbl1_temp_block->block->tuple_dict[touple1 + column].size,
+                                                                tbl2_temp_block->block->data + tbl2_temp_block->block->tuple_dict[touple2 + column].address,
+                                                                tbl2_temp_block->block->tuple_dict[touple2 + column].size) != 0)
+                                                        break;
+                                                    else if (column == (num_att - 1))
+                                                        thesame = 1;
                                                 }
 
                                                 if (thesame == 1) 
@@ -146,7 +140,7 @@ int AK_intersect(char *srcTable1, char *srcTable2, char *dstTable) {
                                                         memcpy(data1, &(tbl1_temp_block->block->data[address]), size);
                                                         data1[size] = '\0';
 														
-                                                        AK_Insert_New_Element(type, data1, dstTable, tbl1_temp_block->block->header[column].att_name, row_root);
+                                                        AK_Insert_New_Element(type, AK_IS_NULL(tbl1_temp_block->block, touple1 + column) ? NULL : data1, dstTable, tbl1_temp_block->block->header[column].att_name, row_root);
                                                     }
                                                     AK_insert_row(row_root);
 
@@ -24,6 +24,7 @@
 #include "../file/fileio.h"
 #include "../rec/archive_log.h"
 #include "../auxi/mempro.h"
+#include "../auxi/comparator.h"
 #include "../sql/drop.h"
 
 /**
@@ -141,7 +141,8 @@ void AK_merge_block_join(struct list_node *row_root, struct list_node *row_root_
                     memcpy(data, temp_block->data + temp_block->tuple_dict[i].address, temp_block->tuple_dict[i].size);
 
                     //if merge data is not equal
-                    if (strcmp(some_element->data, data) != 0) {
+                    if (AK_compare_values(temp_block->tuple_dict[i].type, (unsigned char *) some_element->data,
+                            AK_type_size(some_element->type, some_element->data), (unsigned char *) data, size) != 0) {
                         //dont copy these set of tuple_dicts
                         something_to_copy = 0;
 			break;
@@ -162,7 +163,7 @@ void AK_merge_block_join(struct list_node *row_root, struct list_node *row_root_
 
                 //insert data from second table to insert_list
                 //AK_Insert_New_Element(temp_block->tuple_dict[i].type, data, new_table, temp_block->header[head].att_name, &row_root_insert);
-                AK_Insert_New_Element(temp_block->tuple_dict[i].type, data, new_table, temp_block->header[head].att_name, row_root_insert);
+                AK_Insert_New_Element(temp_block->tuple_dict[i].type, AK_IS_NULL(temp_block, i) ? NULL : data, new_table, temp_block->header[head].att_name, row_root_insert);
 
             }
             not_in_list = 1;
@@ -228,7 +229,7 @@ void AK_copy_blocks_join(AK_block *tbl1_temp_block, AK_block *tbl2_temp_block, s
                     //insert element into list on which we compare
                     AK_Insert_New_Element(tbl1_temp_block->tuple_dict[i].type, data, new_table, list_elem->data, row_root);
                     //insert element into list which we insert into join_table together with second table data
-                    AK_Insert_New_Element(tbl1_temp_block->tuple_dict[i].type, data, new_table, list_elem->data, row_root_insert);
+                    AK_Insert_New_Element(tbl1_temp_block->tuple_dict[i].type, AK_IS_NULL(tbl1_temp_block, i) ? NULL : data, new_table, list_elem->data, row_root_insert);
                     
 
                     something_to_copy = 1;
@@ -244,7 +245,7 @@ void AK_copy_blocks_join(AK_block *tbl1_temp_block, AK_block *tbl2_temp_block, s
                     memset(data, '\0', MAX_VARCHAR_LENGTH);
                     //data[MAX_VARCHAR_LENGHT] = '\0';
                     memcpy(data, tbl1_temp_block->data + tbl1_temp_block->tuple_dict[i].address, tbl1_temp_block->tuple_dict[i].size);
-                    AK_Insert_New_Element(tbl1_temp_block->tuple_dict[i].type, data, new_table, tbl1_temp_block->header[head].att_name, row_root_insert);
+                    AK_Insert_New_Element(tbl1_temp_block->tuple_dict[i].type, AK_IS_NULL(tbl1_temp_block, i) ? NULL : data, new_table, tbl1_temp_block->header[head].att_name, row_root_insert);
 
             }
             not_in_list = 1; //reset not_in_list
@@ -24,6 +24,7 @@
 #include "../file/fileio.h"
 #include "../rel/projection.h"
 #include "../auxi/mempro.h"
+#include "../auxi/comparator.h"
 #include "../sql/drop.h"
 /*
 void AK_create_join_block_header(int table_address1, int table_address2, char *new_table, AK_list *att);
@@ -40,7 +40,7 @@ void AK_create_block_header(int old_block, char *dstTable, struct list_node *att
     struct list_node *list_elem,*list_elem2;
     struct list_node *att_operation_elem,*a,*b,*c,*d,*operator,*cached_elem;
 
-    AK_header header[MAX_ATTRIBUTES];
+    AK_header header[MAX_ATTRIBUTES + 1]; // one more for the terminating empty header
     
     int head = 0; //counter of the headers
     int new_head = 0; //counter of the new headers created for the projection table
@@ -93,7 +93,7 @@ void AK_create_block_header(int old_block, char *dstTable, struct list_node *att
         head++;     
     }
     
-    memset(header + new_head, '\0', MAX_ATTRIBUTES - new_head);
+    memset(header + new_head, '\0', (MAX_ATTRIBUTES + 1 - new_head) * sizeof (AK_header));
 
     AK_free(temp_block);
     AK_temp_create_table(dstTable, header, SEGMENT_TYPE_TABLE); // creates new table - destination table with given attributes
@@ -243,7 +243,7 @@ void AK_copy_block_projection(AK_block *old_block, struct list_node *att, char *
                     memcpy(data, old_block->data + old_block->tuple_dict[i].address, old_block->tuple_dict[i].size); //copy data
                    
                     //insert element to list to be inserted into new table
-                    AK_Insert_New_Element(old_block->tuple_dict[i].type, data, dstTable, list_elem->data, row_root); //ForUpdate 0
+                    AK_Insert_New_Element(old_block->tuple_dict[i].type, AK_IS_NULL(old_block, i) ? NULL : data, dstTable, list_elem->data, row_root); //ForUpdate 0
 
                     //set indicator for existing data in touple_dict that can be copied
                     something_to_copy = 1;
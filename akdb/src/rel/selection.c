@@ -19,10 +19,357 @@
 
 #include "selection.h"
 #include "aggregation.h"
+#include "../file/idx/btree.h"
+#include "../file/idx/hash.h"
+#include "../file/idx/bitmap.h"
 
 /**
- * @author Matija Šestak, updated by Elena Kržina
- * @brief  Function that which implements selection
+ * @author Unknown
+ * @brief Function that gives the size of a constant of a selection expression. Varchar constants may hold their
+ *        terminating zero, values in blocks do not.
+ * @param value constant
+ * @return size of the value
+ */
+static int AK_selection_value_size(struct list_node *value) {
+	if (value->type == TYPE_VARCHAR)
+		return strnlen(value->data, value->size);
+	return value->size;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that picks the tighter of two bounds of an attribute
+ * @param a first bound, NULL if there is none
+ * @param b second bound, NULL if there is none
+ * @param lower 1 to pick the larger bound, 0 to pick the smaller one
+ * @return the tighter bound
+ */
+static struct list_node *AK_selection_tighter(struct list_node *a, struct list_node *b, int lower) {
+	int cmp;
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+	cmp = AK_compare_values(a->type, (unsigned char *) a->data, AK_selection_value_size(a), (unsigned char *) b->data,
+			AK_selection_value_size(b));
+	return (lower ? cmp >= 0 : cmp <= 0) ? a : b;
+}
+
+/**
+ * @struct AK_selection_bound
+ * @brief Bounds a part of a selection expression puts on an attribute, NULL where it puts none
+ */
+typedef struct {
+	struct list_node *lower;
+	struct list_node *upper;
+} AK_selection_bound;
+
+/**
+ * @author Unknown
+ * @brief Function that finds the bounds a selection expression puts on the values of an attribute. The postfix
+ *        expression is walked the same way AK_check_if_row_satisfies_expression walks it. A comparison of the
+ *        attribute with a constant of its type gives a bound, BETWEEN gives two, AND keeps the tighter bounds of its
+ *        operands and every other operator gives none, so only rows within the bounds can satisfy the expression.
+ * @param expr selection expression in postfix notation
+ * @param attribute name of the attribute
+ * @param type type of the attribute
+ * @param bound set to the bounds, both NULL if the expression puts none on the attribute
+ */
+static void AK_selection_bounds(struct list_node *expr, char *attribute, int type, AK_selection_bound *bound) {
+	struct list_node *operands[ZONE_MAP_STACK_SIZE];
+	AK_selection_bound results[ZONE_MAP_STACK_SIZE];
+	int num_operands = 0, num_results = 0, a_attr, b_attr, a_const, b_const;
+	struct list_node *el, *a, *b, *c, *value;
+	AK_selection_bound result;
+	char *op;
+	AK_PRO;
+
+	bound->lower = bound->upper = NULL;
+	for (el = AK_First_L2(expr); el != NULL; el = el->next) {
+		if (el->type != TYPE_OPERATOR) {
+			if (num_operands == ZONE_MAP_STACK_SIZE) {
+				AK_EPI;
+				return;
+			}
+			operands[num_operands++] = el;
+			continue;
+		}
+		if (num_results == ZONE_MAP_STACK_SIZE) {
+			AK_EPI;
+			return;
+		}
+
+		op = el->data;
+		result.lower = result.upper = NULL;
+		a = num_operands >= 2 ? operands[num_operands - 2] : NULL;
+		b = num_operands >= 1 ? operands[num_operands - 1] : NULL;
+		if (strcmp(op, "AND") == 0) {
+			if (num_results >= 2) {
+				result.lower = AK_selection_tighter(results[num_results - 1].lower, results[num_results - 2].lower, 1);
+				result.upper = AK_selection_tighter(results[num_results - 1].upper, results[num_results - 2].upper, 0);
+			}
+		} else if (strcmp(op, "BETWEEN") == 0) {
+			c = num_operands >= 3 ? operands[num_operands - 3] : NULL;
+			if (c != NULL && c->type == TYPE_ATTRIBS && strcmp(c->data, attribute) == 0 && a->type == type
+					&& b->type == type) {
+				result.lower = a;
+				result.upper = b;
+			}
+		} else if (a != NULL && (strcmp(op, "=") == 0 || strcmp(op, "<") == 0 || strcmp(op, "<=") == 0
+				|| strcmp(op, ">") == 0 || strcmp(op, ">=") == 0)) {
+			a_attr = a->type == TYPE_ATTRIBS && strcmp(a->data, attribute) == 0;
+			b_attr = b->type == TYPE_ATTRIBS && strcmp(b->data, attribute) == 0;
+			a_const = a->type == type;
+			b_const = b->type == type;
+			if ((a_attr && b_const) || (a_const && b_attr)) {
+				value = a_attr ? b : a;
+				//constant op attribute is attribute flipped(op) constant
+				if (op[0] == '=' || (op[0] == '<') == a_attr)
+					result.upper = value;
+				if (op[0] == '=' || (op[0] == '>') == a_attr)
+					result.lower = value;
+			}
+		}
+		//operands stay on their stack, like in AK_check_if_row_satisfies_expression
+		results[num_results++] = result;
+	}
+	if (num_results > 0)
+		*bound = results[num_results - 1];
+	AK_EPI;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads the rows a selection expression can be true for from the bitmap indexes of the table.
+ *        The postfix expression is walked like in AK_selection_bounds. An attribute with a bitmap index compared
+ *        with a constant of its type by = gives the bitmap of the constant, by <> the bitmap of all values without
+ *        it. AND intersects the bitmaps of its operands and keeps the one known if only one is, OR unites them if
+ *        both are known, every other operator gives no bitmap, so only rows in the bitmap can satisfy the
+ *        expression. Since all bitmap indexes of a table number rows the same way, predicates on several
+ *        attributes are combined before the table is read.
+ * @param expr selection expression in postfix notation
+ * @param t_header header of the table
+ * @param num_attr number of attributes of the table
+ * @param indexes indexes of the table
+ * @param num_indexes number of indexes
+ * @param used set to the position of a bitmap index the bitmap was read from
+ * @return bitmap of the rows, NULL if the expression can not be answered from the bitmap indexes
+ */
+static AK_bitmap *AK_selection_bitmap(struct list_node *expr, AK_header *t_header, int num_attr,
+		AK_index_info *indexes, int num_indexes, int *used) {
+	struct list_node *operands[ZONE_MAP_STACK_SIZE];
+	AK_bitmap *results[ZONE_MAP_STACK_SIZE], *allocated[ZONE_MAP_STACK_SIZE], *result, *all, *value_rows;
+	int num_operands = 0, num_results = 0, num_allocated = 0, a_attr, i, j;
+	struct list_node *el, *a, *b, *attribute, *value;
+	char *op;
+	AK_PRO;
+
+	*used = EXIT_ERROR;
+	for (el = AK_First_L2(expr); el != NULL; el = el->next) {
+		if (el->type != TYPE_OPERATOR) {
+			if (num_operands == ZONE_MAP_STACK_SIZE)
+				break;
+			operands[num_operands++] = el;
+			continue;
+		}
+		if (num_results == ZONE_MAP_STACK_SIZE)
+			break;
+
+		op = el->data;
+		result = NULL;
+		a = num_operands >= 2 ? operands[num_operands - 2] : NULL;
+		b = num_operands >= 1 ? operands[num_operands - 1] : NULL;
+		if (strcmp(op, "AND") == 0 || strcmp(op, "OR") == 0) {
+			if (num_results >= 2 && results[num_results - 1] != NULL && results[num_results - 2] != NULL) {
+				result = op[0] == 'A' ? AK_bitmap_and(results[num_results - 2], results[num_results - 1])
+						: AK_bitmap_or(results[num_results - 2], results[num_results - 1]);
+				allocated[num_allocated++] = result;
+			} else if (op[0] == 'A' && num_results >= 2) {
+				result = results[num_results - 1] != NULL ? results[num_results - 1] : results[num_results - 2];
+			}
+		} else if (a != NULL && (strcmp(op, "=") == 0 || strcmp(op, "<>") == 0)) {
+			a_attr = a->type == TYPE_ATTRIBS;
+			attribute = a_attr ? a : b;
+			value = a_attr ? b : a;
+			for (i = 0; attribute->type == TYPE_ATTRIBS && value->type != TYPE_ATTRIBS && i < num_indexes; i++) {
+				j = indexes[i].attribute;
+				if (indexes[i].kind != INDEX_KIND_BITMAP || j < 0 || j >= num_attr || value->type != t_header[j].type
+						|| (value->type != TYPE_INT && value->type != TYPE_VARCHAR)
+						|| strcmp(attribute->data, t_header[j].att_name) != 0)
+					continue;
+				result = AK_bitmap_index_get(indexes[i].name, value);
+				if (result != NULL && op[0] == '<') {
+					//NULLs are in no bitmap, like they satisfy no comparison
+					value_rows = result;
+					all = AK_bitmap_index_get(indexes[i].name, NULL);
+					result = AK_bitmap_andnot(all, value_rows);
+					AK_bitmap_free(all);
+					AK_bitmap_free(value_rows);
+				}
+				if (result != NULL) {
+					allocated[num_allocated++] = result;
+					*used = i;
+					break;
+				}
+			}
+		}
+		//operands stay on their stack, like in AK_check_if_row_satisfies_expression
+		results[num_results++] = result;
+	}
+
+	result = el == NULL && num_results > 0 ? results[num_results - 1] : NULL;
+	for (i = 0; i < num_allocated; i++) {
+		if (allocated[i] != result)
+			AK_bitmap_free(allocated[i]);
+	}
+	AK_EPI;
+	return result;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that chooses how a selection reads its source table. For every index of the table whose
+ *        attribute the expression bounds, the index is searched: B+trees for the range between the bounds, hash
+ *        indexes only when the bounds are one value. The bitmap indexes are read together, see AK_selection_bitmap.
+ *        The index giving the fewest rows is used, unless it gives more than INDEX_SCAN_MAX_SELECTIVITY percent of
+ *        the rows of the table, then the table is scanned.
+ * @param srcTable source table name
+ * @param expr selection expression in postfix notation
+ * @param index set to the index used
+ * @param rows set to an array of the addresses of the rows read through the index
+ * @return number of rows read through the index, EXIT_ERROR if the table is to be scanned
+ */
+int AK_selection_access_path(char *srcTable, struct list_node *expr, AK_index_info *index, struct_add **rows) {
+	AK_index_info indexes[MAX_TABLE_INDEXES];
+	AK_selection_bound bound;
+	AK_header *t_header;
+	struct list_node *lower, *upper;
+	struct_add *found;
+	AK_bitmap *bitmap;
+	int num_indexes, num_attr, limit, equal, count, best = EXIT_ERROR, i;
+	AK_PRO;
+
+	*rows = NULL;
+	num_indexes = expr != NULL ? AK_get_table_indexes(srcTable, indexes, MAX_TABLE_INDEXES) : 0;
+	if (num_indexes == 0) {
+		AK_EPI;
+		return EXIT_ERROR;
+	}
+	t_header = (AK_header *) AK_get_header(srcTable);
+	num_attr = AK_num_attr(srcTable);
+	limit = AK_get_num_records(srcTable) * INDEX_SCAN_MAX_SELECTIVITY / 100;
+	lower = (struct list_node *) AK_malloc(sizeof (struct list_node));
+	upper = (struct list_node *) AK_malloc(sizeof (struct list_node));
+	AK_Init_L3(&lower);
+	AK_Init_L3(&upper);
+
+	for (i = 0; i < num_indexes; i++) {
+		if (indexes[i].kind == INDEX_KIND_BITMAP || indexes[i].attribute < 0 || indexes[i].attribute >= num_attr)
+			continue;
+		//index keys are compared as stored in blocks, floats are not kept in the size of a float constant
+		if (t_header[indexes[i].attribute].type != TYPE_INT && t_header[indexes[i].attribute].type != TYPE_VARCHAR)
+			continue;
+		AK_selection_bounds(expr, t_header[indexes[i].attribute].att_name, t_header[indexes[i].attribute].type, &bound);
+		if (bound.lower == NULL && bound.upper == NULL)
+			continue;
+		equal = bound.lower != NULL && bound.upper != NULL && AK_compare_values(bound.lower->type,
+				(unsigned char *) bound.lower->data, AK_selection_value_size(bound.lower),
+				(unsigned char *) bound.upper->data, AK_selection_value_size(bound.upper)) == 0;
+		if (!equal && indexes[i].kind != INDEX_KIND_BTREE)
+			continue;
+
+		if (bound.lower != NULL)
+			AK_InsertAtEnd_L3(bound.lower->type, bound.lower->data, AK_selection_value_size(bound.lower), lower);
+		if (bound.upper != NULL)
+			AK_InsertAtEnd_L3(bound.upper->type, bound.upper->data, AK_selection_value_size(bound.upper), upper);
+		count = AK_index_search(&indexes[i], lower, equal ? NULL : upper, &found);
+		AK_dbg_messg(MIDDLE, REL_OP, "Index %s of %s gives %d rows.\n", indexes[i].name, srcTable, count);
+		if (count != EXIT_ERROR && count <= limit && (best == EXIT_ERROR || count < best)) {
+			if (*rows != NULL)
+				AK_free(*rows);
+			*rows = found;
+			*index = indexes[i];
+			best = count;
+		} else if (found != NULL) {
+			AK_free(found);
+		}
+		AK_DeleteAll_L3(&lower);
+		AK_DeleteAll_L3(&upper);
+	}
+
+	bitmap = AK_selection_bitmap(expr, t_header, num_attr, indexes, num_indexes, &i);
+	if (bitmap != NULL) {
+		count = AK_bitmap_cardinality(bitmap);
+		AK_dbg_messg(MIDDLE, REL_OP, "Bitmap indexes of %s give %d rows.\n", srcTable, count);
+		if (count <= limit && (best == EXIT_ERROR || count < best)) {
+			if (*rows != NULL)
+				AK_free(*rows);
+			best = AK_bitmap_rows(bitmap, num_attr, rows);
+			*index = indexes[i];
+		}
+		AK_bitmap_free(bitmap);
+	}
+
+	AK_free(lower);
+	AK_free(upper);
+	AK_free(t_header);
+	AK_EPI;
+	return best;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that orders addresses of rows by block and place in the block
+ */
+static int AK_selection_compare_rows(const void *a, const void *b) {
+	const struct_add *x = a, *y = b;
+	if (x->addBlock != y->addBlock)
+		return x->addBlock < y->addBlock ? -1 : 1;
+	return x->indexTd < y->indexTd ? -1 : x->indexTd > y->indexTd;
+}
+
+/**
+ * @author Unknown
+ * @brief Function that reads the row starting at a tuple of a block and inserts it into the destination table if it
+ *        satisfies the expression
+ * @param block block of the row
+ * @param k tuple of the first value of the row
+ * @param num_attr number of attributes of the table
+ * @param t_header header of the table
+ * @param dstTable destination table name
+ * @param expr selection expression in postfix notation
+ * @param row_root row list, reset by rewinding the query arena
+ * @param arena query arena
+ * @param row_mark mark of the arena before the row
+ */
+static void AK_selection_row(AK_block *block, int k, int num_attr, AK_header *t_header, char *dstTable,
+		struct list_node *expr, struct list_node **row_root, AK_arena *arena, AK_arena_mark row_mark) {
+	int type, size, address;
+	char data[MAX_VARCHAR_LENGTH];
+	AK_arena *outer;
+
+	for (int l = 0; l < num_attr; l++) {
+		type = block->tuple_dict[k + l].type;
+		size = block->tuple_dict[k + l].size;
+		address = block->tuple_dict[k + l].address;
+		memcpy(data, &(block->data[address]), size);
+		data[size] = '\0';
+		AK_Insert_New_Element(type, AK_IS_NULL(block, k + l) ? NULL : data, dstTable, t_header[l].att_name, *row_root);
+	}
+	if (AK_check_if_row_satisfies_expression(*row_root, expr)){
+		/* storage layer may keep what it allocates, so it works outside the arena */
+		outer = AK_arena_set_current(NULL);
+		AK_insert_row(*row_root);
+		AK_arena_set_current(outer);
+	}
+	AK_arena_release(arena, row_mark);
+	AK_Init_L3(row_root);
+}
+
+/**
+ * @author Matija Šestak, updated by Elena Kržina, updated by Unknown (index access paths)
+ * @brief  Function that which implements selection. The source table is read through one of its indexes if
+ *         AK_selection_access_path finds one that bounds the rows well enough, otherwise it is scanned whole.
  * @param *srcTable source table name
  * @param *dstTable destination table name
  * @param *expr list with posfix notation of the logical expression
@@ -51,37 +398,59 @@
 	table_addresses *src_addr = (table_addresses*) AK_get_table_addresses(srcTable);
 	struct list_node * row_root = (struct list_node *) AK_malloc(sizeof(struct list_node));
 	AK_Init_L3(&row_root);
-		
-	int type, size, address;
-	char data[MAX_VARCHAR_LENGTH];
 
-	/* code steps through all addresses of table, gets the block of each current address, counts the number of attributes, 
-	fetches values for each attribute and inserts data into the destination table if row satisfies given expression */ 
-	for (int i = 0; src_addr->address_from[i] != 0; i++) {
+	AK_index_info index;
+	struct_add *rows;
+	int num_rows = AK_selection_access_path(srcTable, expr, &index, &rows);
+
+	/* row lists and expression stacks live in the query arena and are dropped per row by rewinding it */
+	AK_arena *arena = AK_query_arena_begin();
+	AK_arena_mark row_mark = AK_arena_get_mark(arena);
+
+	if (num_rows != EXIT_ERROR) {
+		AK_dbg_messg(LOW, REL_OP, "\nSelection reads %d rows of %s through index %s.\n", num_rows, srcTable, index.name);
+		/* rows in block order, every block is fetched once */
+		qsort(rows, num_rows, sizeof (struct_add), AK_selection_compare_rows);
+		for (int r = 0; r < num_rows; r++) {
+			int i, k = rows[r].indexTd;
+			if (r > 0 && AK_selection_compare_rows(&rows[r - 1], &rows[r]) == 0)
+				continue;
+			for (i = 0; src_addr->address_from[i] != 0; i++) {
+				if (rows[r].addBlock >= src_addr->address_from[i] && rows[r].addBlock < src_addr->address_to[i])
+					break;
+			}
+			if (src_addr->address_from[i] == 0 || k < 0 || k + num_attr > DATA_BLOCK_SIZE)
+				continue;
+			AK_mem_block *temp = (AK_mem_block *) AK_get_block(rows[r].addBlock);
+			/* an entry of a row deleted after the index was built points to a cleared tuple */
+			if (temp->block->tuple_dict[k].type == FREE_INT || temp->block->tuple_dict[k].type == TYPE_INTERNAL)
+				continue;
+			AK_selection_row(temp->block, k, num_attr, t_header, dstTable, expr, &row_root, arena, row_mark);
+		}
+		AK_free(rows);
+	} else {
+		/* code steps through all addresses of table, gets the block of each current address, counts the number of attributes, 
+		fetches values for each attribute and inserts data into the destination table if row satisfies given expression */ 
+		/* rows are read from a copy, inserting into the destination table may give the cached block to another one */
+		AK_block *block = (AK_block *) AK_malloc(sizeof (AK_block));
+		for (int i = 0; src_addr->address_from[i] != 0; i++) {
 
-		for (int j = src_addr->address_from[i]; j < src_addr->address_to[i]; j++) {
+			for (int j = src_addr->address_from[i]; j < src_addr->address_to[i]; j++) {
 
-			AK_mem_block *temp = (AK_mem_block *) AK_get_block(j);
+				AK_mem_block *temp = (AK_mem_block *) AK_get_block(j);
 
-			if (temp->block->last_tuple_dict_id != 0){
-				for (int k = 0; k < DATA_BLOCK_SIZE && !(temp->block->tuple_dict[k].type == FREE_INT); k += num_attr) {
-					for (int l = 0; l < num_attr; l++) {
-						type = temp->block->tuple_dict[k + l].type;
-						size = temp->block->tuple_dict[k + l].size;
-						address = temp->block->tuple_dict[k + l].address;
-						memcpy(data, &(temp->block->data[address]), size);
-						data[size] = '\0';
-						AK_Insert_New_Element(type, data, dstTable, t_header[l].att_name, row_root);
-					}
-					if (AK_check_if_row_satisfies_expression(row_root, expr)){
-						AK_insert_row(row_root);
-					}
-					AK_DeleteAll_L3(&row_root);
+				/* blocks whose zone maps show that no row can satisfy the expression are skipped */
+				if (temp->block->last_tuple_dict_id != 0 && AK_zone_map_may_satisfy(temp->block, expr)){
+					memcpy(block, temp->block, sizeof (AK_block));
+					for (int k = 0; k < DATA_BLOCK_SIZE && !(block->tuple_dict[k].type == FREE_INT); k += num_attr)
+						AK_selection_row(block, k, num_attr, t_header, dstTable, expr, &row_root, arena, row_mark);
 				}
 			}
 		}
+		AK_free(block);
 	}
 
+	AK_query_arena_end(arena);
 	AK_free(src_addr);
 	AK_free(t_header);
 	AK_free(row_root);
@@ -221,6 +590,216 @@ TestResult AK_op_selection_test() { //test 36
     } 
 
     AK_DeleteAll_L3(&expr);
+
+    /* 3-7: access paths through the indexes of a larger table */
+    char *indexTable = "selection_index_test";
+    AK_header index_header[MAX_ATTRIBUTES] = {
+        {TYPE_INT, "id", {0}, {{'\0'}}, {{'\0'}}},
+        {TYPE_VARCHAR, "name", {0}, {{'\0'}}, {{'\0'}}},
+        {0, {'\0'}, {0}, {{'\0'}}, {{'\0'}}}
+    };
+    AK_segment_writer writer;
+    AK_sort_row index_row;
+    AK_index_info index;
+    struct_add *index_rows;
+    char name[32], scanTable[256], indexScanTable[256];
+    int id, num_index_rows, ok, lower, upper;
+
+    memset(&index_row, 0, sizeof (AK_sort_row));
+    index_row.type[0] = TYPE_INT;
+    index_row.type[1] = TYPE_VARCHAR;
+    index_row.size[0] = sizeof (int);
+    index_row.data[0] = (unsigned char *) &id;
+    index_row.data[1] = (unsigned char *) name;
+    ok = AK_initialize_new_segment(indexTable, SEGMENT_TYPE_TABLE, index_header) != EXIT_ERROR
+            && AK_segment_writer_open(&writer, indexTable, SEGMENT_TYPE_TABLE, 2) == EXIT_SUCCESS;
+    for (id = 0; ok && id < 1000; id++) {
+        sprintf(name, "name %d", id % 100);
+        index_row.size[1] = strlen(name);
+        ok = AK_segment_writer_put(&writer, &index_row) == EXIT_SUCCESS;
+    }
+    AK_segment_writer_close(&writer);
+
+    /* 3: a range is read through a B+tree and gives the rows a full scan gives */
+    printf("\nQUERY: SELECT * FROM selection_index_test WHERE id BETWEEN 100 AND 149;\n\n");
+    sprintf(scanTable, "selection_test_scan_%d", test_run_count);
+    sprintf(indexScanTable, "selection_test_index_%d", test_run_count);
+    lower = 100;
+    upper = 149;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &lower, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &upper, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "BETWEEN", sizeof ("BETWEEN"), expr);
+    ok = ok && AK_selection(indexTable, scanTable, expr) == EXIT_SUCCESS;
+    struct list_node *att_list = (struct list_node *) AK_malloc(sizeof (struct list_node));
+    AK_Init_L3(&att_list);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id\0", 3, att_list);
+    ok = ok && AK_btree_create(indexTable, att_list, "selection_index_id") == EXIT_SUCCESS;
+    num_index_rows = AK_selection_access_path(indexTable, expr, &index, &index_rows);
+    if (num_index_rows != EXIT_ERROR)
+        AK_free(index_rows);
+    ok = ok && num_index_rows == 50 && index.kind == INDEX_KIND_BTREE && strcmp(index.name, "selection_index_id") == 0
+            && AK_selection(indexTable, indexScanTable, expr) == EXIT_SUCCESS
+            && AK_get_num_records(scanTable) == 50 && AK_get_num_records(indexScanTable) == 50;
+    for (int r = 0; ok && r < 50; r++) {
+        row1 = (struct list_node *) AK_get_row(r, indexScanTable);
+        memcpy(&id, get_row_attr_data(0, row1), sizeof (int));
+        ok = id == 100 + r;
+        AK_DeleteAll_L3(&row1);
+        AK_free(row1);
+    }
+    AK_DeleteAll_L3(&expr);
+    if (ok) {
+        printf("\nSelection test 3 succeeded.\n");
+        successful++;
+    } else {
+        printf("\nSelection test 3 failed.\n");
+        failed++;
+    }
+
+    /* 4: strict bounds, the index gives the closed range and the expression drops its ends */
+    printf("\nQUERY: SELECT * FROM selection_index_test WHERE id > 990 AND id < 995;\n\n");
+    sprintf(indexScanTable, "selection_test_strict_%d", test_run_count);
+    lower = 990;
+    upper = 995;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &lower, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &upper, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "AND", sizeof ("AND"), expr);
+    num_index_rows = AK_selection_access_path(indexTable, expr, &index, &index_rows);
+    if (num_index_rows != EXIT_ERROR)
+        AK_free(index_rows);
+    if (num_index_rows == 6 && AK_selection(indexTable, indexScanTable, expr) == EXIT_SUCCESS
+            && AK_get_num_records(indexScanTable) == 4) {
+        printf("\nSelection test 4 succeeded.\n");
+        successful++;
+    } else {
+        printf("\nSelection test 4 failed.\n");
+        failed++;
+    }
+    AK_DeleteAll_L3(&expr);
+
+    /* 5: an equality is read through a hash index, built on a smaller table of its own */
+    printf("\nQUERY: SELECT * FROM selection_hash_test WHERE id = 12;\n\n");
+    sprintf(indexScanTable, "selection_test_hash_%d", test_run_count);
+    ok = AK_initialize_new_segment("selection_hash_test", SEGMENT_TYPE_TABLE, index_header) != EXIT_ERROR
+            && AK_segment_writer_open(&writer, "selection_hash_test", SEGMENT_TYPE_TABLE, 2) == EXIT_SUCCESS;
+    for (id = 0; ok && id < 40; id++) {
+        sprintf(name, "name %d", id % 20);
+        index_row.size[1] = strlen(name);
+        ok = AK_segment_writer_put(&writer, &index_row) == EXIT_SUCCESS;
+    }
+    AK_segment_writer_close(&writer);
+    ok = ok && AK_create_hash_index("selection_hash_test", att_list, "selection_index_hash") == EXIT_SUCCESS;
+    lower = 12;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &lower, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "=", sizeof ("="), expr);
+    num_index_rows = AK_selection_access_path("selection_hash_test", expr, &index, &index_rows);
+    if (num_index_rows != EXIT_ERROR)
+        AK_free(index_rows);
+    ok = ok && num_index_rows == 1 && index.kind == INDEX_KIND_HASH
+            && AK_selection("selection_hash_test", indexScanTable, expr) == EXIT_SUCCESS
+            && AK_get_num_records(indexScanTable) == 1;
+    if (ok) {
+        row1 = (struct list_node *) AK_get_row(0, indexScanTable);
+        memcpy(&id, get_row_attr_data(0, row1), sizeof (int));
+        ok = id == 12 && strcmp(get_row_attr_data(1, row1), "name 12") == 0;
+        AK_DeleteAll_L3(&row1);
+        AK_free(row1);
+    }
+    AK_DeleteAll_L3(&expr);
+    if (ok) {
+        printf("\nSelection test 5 succeeded.\n");
+        successful++;
+    } else {
+        printf("\nSelection test 5 failed.\n");
+        failed++;
+    }
+
+    /* 6: many rows or no bounds, the table is scanned */
+    lower = 100;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &lower, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    ok = AK_selection_access_path(indexTable, expr, &index, &index_rows) == EXIT_ERROR;
+    AK_DeleteAll_L3(&expr);
+    upper = 950;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &lower, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "<", sizeof ("<"), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &upper, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, ">", sizeof (">"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "OR", sizeof ("OR"), expr);
+    ok = ok && AK_selection_access_path(indexTable, expr, &index, &index_rows) == EXIT_ERROR;
+    AK_DeleteAll_L3(&expr);
+    if (ok) {
+        printf("\nSelection test 6 succeeded.\n");
+        successful++;
+    } else {
+        printf("\nSelection test 6 failed.\n");
+        failed++;
+    }
+
+    /* 7: equalities on a bitmap index are united before the table is read, a range on id is left to the expression */
+    printf("\nQUERY: SELECT * FROM selection_index_test WHERE name = 'name 7' OR name = 'name 8';\n\n");
+    sprintf(indexScanTable, "selection_test_bitmap_%d", test_run_count);
+    AK_DeleteAll_L3(&att_list);
+    AK_Insert_New_Element(TYPE_VARCHAR, "name", indexTable, "name", att_list);
+    AK_create_Index_Table(indexTable, att_list);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "name", sizeof ("name"), expr);
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "name 7", strlen("name 7"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "=", sizeof ("="), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "name", sizeof ("name"), expr);
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "name 8", strlen("name 8"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "=", sizeof ("="), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "OR", sizeof ("OR"), expr);
+    num_index_rows = AK_selection_access_path(indexTable, expr, &index, &index_rows);
+    if (num_index_rows != EXIT_ERROR)
+        AK_free(index_rows);
+    ok = num_index_rows == 20 && index.kind == INDEX_KIND_BITMAP
+            && AK_selection(indexTable, indexScanTable, expr) == EXIT_SUCCESS
+            && AK_get_num_records(indexScanTable) == 20;
+    for (int r = 0; ok && r < 20; r++) {
+        row1 = (struct list_node *) AK_get_row(r, indexScanTable);
+        memcpy(&id, get_row_attr_data(0, row1), sizeof (int));
+        ok = id % 100 == 7 || id % 100 == 8;
+        AK_DeleteAll_L3(&row1);
+        AK_free(row1);
+    }
+    AK_DeleteAll_L3(&expr);
+    upper = 500;
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "name", sizeof ("name"), expr);
+    AK_InsertAtEnd_L3(TYPE_VARCHAR, "name 7", strlen("name 7"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "=", sizeof ("="), expr);
+    AK_InsertAtEnd_L3(TYPE_ATTRIBS, "id", sizeof ("id"), expr);
+    AK_InsertAtEnd_L3(TYPE_INT, &upper, sizeof (int), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "<", sizeof ("<"), expr);
+    AK_InsertAtEnd_L3(TYPE_OPERATOR, "AND", sizeof ("AND"), expr);
+    num_index_rows = AK_selection_access_path(indexTable, expr, &index, &index_rows);
+    if (num_index_rows != EXIT_ERROR)
+        AK_free(index_rows);
+    ok = ok && num_index_rows == 10 && index.kind == INDEX_KIND_BITMAP;
+    AK_DeleteAll_L3(&expr);
+    if (ok) {
+        printf("\nSelection test 7 succeeded.\n");
+        successful++;
+    } else {
+        printf("\nSelection test 7 failed.\n");
+        failed++;
+    }
+
+    AK_btree_delete("selection_index_id");
+    AK_delete_bitmap_index("selection_index_testname_bmapIndex");
+    AK_delete_hash_index("selection_index_hash");
+    AK_delete_segment("selection_hash_test", SEGMENT_TYPE_TABLE);
+    AK_delete_segment(indexTable, SEGMENT_TYPE_TABLE);
+    AK_DeleteAll_L3(&att_list);
+    AK_free(att_list);
     AK_free(expr);
 	test_run_count++;
 
@@ -532,7 +1111,7 @@ int AK_selection_op_rename(char *srcTable, char *dstTable, struct list_node *exp
 						address = temp->block->tuple_dict[k + l].address;
 						memcpy(data, &(temp->block->data[address]), size);
 						data[size] = '\0';
-						AK_Insert_New_Element(type, data, dstTable, t_header[l].att_name, row_root);
+						AK_Insert_New_Element(type, AK_IS_NULL(temp->block, k + l) ? NULL : data, dstTable, t_header[l].att_name, row_root);
 					}
 
 						AK_insert_row(row_root);
@@ -622,7 +1201,7 @@ int AK_selection_having(char *srcTable, char *dstTable, struct list_node *expr,
 		{
 			AK_mem_block *temp = (AK_mem_block *)AK_get_block(j);
 
-			if (temp->block->last_tuple_dict_id != 0)
+			if (temp->block->last_tuple_dict_id != 0 && AK_zone_map_may_satisfy(temp->block, expr))
 			{
 				for (int k = 0; k < DATA_BLOCK_SIZE && !(temp->block->tuple_dict[k].type == FREE_INT); k += num_attr)
 				{
@@ -633,7 +1212,7 @@ int AK_selection_having(char *srcTable, char *dstTable, struct list_node *expr,
 						address = temp->block->tuple_dict[k + l].address;
 						memcpy(data, &(temp->block->data[address]), size);
 						data[size] = '\0';
-						AK_Insert_New_Element(type, data, dstTable, t_header[l].att_name, row_root);
+						AK_Insert_New_Element(type, AK_IS_NULL(temp->block, k + l) ? NULL : data, dstTable, t_header[l].att_name, row_root);
 					}
 
 					// Check if the row satisfies the WHERE expression
@@ -26,6 +26,9 @@
 #include "../auxi/constants.h"
 #include "../auxi/configuration.h"
 #include "../file/files.h"
+#include "../file/zonemap.h"
+#include "../file/idx/index.h"
+#include "../auxi/comparator.h"
 #include "../auxi/mempro.h"
 
 
@@ -38,6 +41,17 @@
  * @return EXIT_SUCCESS
  */
 int AK_selection(char *srcTable, char *dstTable, struct list_node *expr);
+
+/**
+ * @author Unknown
+ * @brief Function that chooses how a selection reads its source table, through one of its indexes or by a full scan
+ * @param srcTable source table name
+ * @param expr selection expression in postfix notation
+ * @param index set to the index used
+ * @param rows set to an array of the addresses of the rows read through the index
+ * @return number of rows read through the index, EXIT_ERROR if the table is to be scanned
+ */
+int AK_selection_access_path(char *srcTable, struct list_node *expr, AK_index_info *index, struct_add **rows);
 TestResult AK_op_selection_test();
 TestResult AK_op_selection_test_pattern();
 
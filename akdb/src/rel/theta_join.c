@@ -176,7 +176,7 @@ void AK_check_constraints(AK_block *tbl1_temp_block, AK_block *tbl2_temp_block,
 			type = tbl1_temp_block->tuple_dict[tbl1_row + tbl1_att].type;
 			memset(data, 0, MAX_VARCHAR_LENGTH);
 			memcpy(data, &(tbl1_temp_block->data[address]), size);
-			AK_Insert_New_Element(type, data, new_table, t_header[tbl1_att].att_name, row_root_init);
+			AK_Insert_New_Element(type, AK_IS_NULL(tbl1_temp_block, tbl1_row + tbl1_att) ? NULL : data, new_table, t_header[tbl1_att].att_name, row_root_init);
 		}
 
 
@@ -193,7 +193,7 @@ void AK_check_constraints(AK_block *tbl1_temp_block, AK_block *tbl2_temp_block,
 				type = tbl2_temp_block->tuple_dict[tbl2_row + tbl2_att].type;
 				memset(data, 0, MAX_VARCHAR_LENGTH);
 				memcpy(data, &(tbl2_temp_block->data[address]), size);
-				AK_Insert_New_Element(type, data, new_table, t_header[tbl1_att + tbl2_att].att_name, row_root_full);
+				AK_Insert_New_Element(type, AK_IS_NULL(tbl2_temp_block, tbl2_row + tbl2_att) ? NULL : data, new_table, t_header[tbl1_att + tbl2_att].att_name, row_root_full);
 			}
 
 			if (AK_check_if_row_satisfies_expression(row_root_full, constraints)){
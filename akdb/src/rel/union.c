@@ -120,7 +120,7 @@ void AK_Write_Segments(char *dstTable, int num_att, table_addresses *src_addr1,
                     memset(data, '\0', MAX_VARCHAR_LENGTH);
                     memcpy(data, tbl1_temp_block->block->data + address, size);
 
-                    AK_Insert_New_Element(type, data, dstTable, tbl1_temp_block->block->header[k % num_att].att_name, row_root);
+                    AK_Insert_New_Element(type, AK_IS_NULL(tbl1_temp_block->block, k) ? NULL : data, dstTable, tbl1_temp_block->block->header[k % num_att].att_name, row_root);
 
                     if ((k + 1) % num_att == 0 && k != 0) {
                         AK_insert_row(row_root);
@@ -90,8 +90,6 @@ int AK_check_constraint_not_null(char* tableName, char* attName, char* constrain
 	int uniqueConstraintName;
 	struct list_node *row;
 	struct list_node *attribute;
-	
-	char *tupple_to_string_return;
 
 	AK_PRO;
 
@@ -106,7 +104,7 @@ int AK_check_constraint_not_null(char* tableName, char* attName, char* constrain
 			row = AK_get_row(i, tableName);
 			attribute = AK_GetNth_L2(positionOfAtt, row);
 			
-			if((tupple_to_string_return=AK_tuple_to_string(attribute)) == NULL)
+			if(attribute->is_null)
 			{
 				printf("\nFAILURE!\nTable: %s\ncontains NULL sign and that would violate NOT NULL constraint which You would like to set on attribute: %s\n\n", tableName, attName);
 				AK_DeleteAll_L3(&row);
@@ -114,8 +112,6 @@ int AK_check_constraint_not_null(char* tableName, char* attName, char* constrain
 				AK_EPI;
 				return EXIT_ERROR;
 			}
-			else
-				AK_free(tupple_to_string_return);
 			AK_DeleteAll_L3(&row);
 			AK_free(row);
 		}
@@ -100,8 +100,9 @@ AK_ref_item AK_get_reference(char *tableName, char *constraintName) {
  * @return EXIT ERROR if check failed, EXIT_SUCCESS if referential integrity is ok
  */
 int AK_reference_check_attribute(char *tableName, char *attribute, char *value) {
-    int i;
-    int att_index;
+    int i = 0;
+    int att_index, att_type;
+    AK_header *parent_header;
 
     struct list_node *list_row, *list_col;
     AK_PRO;
@@ -109,6 +110,18 @@ int AK_reference_check_attribute(char *tableName, char *attribute, char *value)
         if (strcmp(list_row->next->data, tableName) == 0 &&
                 strcmp(list_row->next->next->next->data, attribute) == 0) {
             att_index = AK_get_attr_index(list_row->next->next->next->next->data, list_row->next->next->next->next->next->data);
+            parent_header = AK_get_header(list_row->next->next->next->next->data);
+            att_type = parent_header != NULL && att_index >= 0 ? parent_header[att_index].type : 0;
+            AK_free(parent_header);
+            // a varchar parent key is looked up only in the blocks its Bloom filter does not rule out
+            if (att_type == TYPE_VARCHAR) {
+                if (!AK_bloom_find_string(list_row->next->next->next->next->data, list_row->next->next->next->next->next->data, value)) {
+                    AK_EPI;
+                    return EXIT_ERROR;
+                }
+                i++;
+                continue;
+            }
             list_col = AK_get_column(att_index, list_row->next->next->next->next->data);
             while (strcmp(list_col->data, value) != 0) {
                 list_col = list_col->next;
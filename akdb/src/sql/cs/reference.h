@@ -23,6 +23,7 @@
 #include "../../auxi/test.h"
 #include "../../dm/dbman.h"
 #include "../../file/table.h"
+#include "../../file/bloom.h"
 #include "../../auxi/mempro.h"
 /**
  * @def REF_TYPE_NONE
@@ -106,12 +106,13 @@ int AK_set_constraint_unique(char* tableName, char attName[], char constraintNam
 			for(impoIndexInArray=0; (impoIndexInArray<numOfImpAttPos)&&(match==1); impoIndexInArray++)
 			{
 				attribute = AK_GetNth_L2(positionsOfAtts[impoIndexInArray], row);
-				tuple_to_string_return = AK_tuple_to_string(attribute);
-				if(tuple_to_string_return==NULL)
+				if(attribute->is_null)
 				{
 					match = 0;
+					continue;
 				}
-				else if(dictionary_get(dict, tuple_to_string_return, NULL) == NULL)
+				tuple_to_string_return = AK_tuple_to_string(attribute);
+				if(dictionary_get(dict, tuple_to_string_return, NULL) == NULL)
 				{
 					key=AK_tuple_to_string(attribute);
 					val=AK_tuple_to_string(attribute);
@@ -286,6 +287,15 @@ int AK_read_constraint_unique(char* tableName, char attName[], char newValue[]){
 						value2 = strtok(NULL, SEPARATOR);
 					}
 
+					//a single varchar attribute is looked up only in the blocks its Bloom filter does not rule out
+					if(numOfImpAttPos == 1 && AK_GetNth_L2(positionsOfAtts[0], row2)->type == TYPE_VARCHAR)
+					{
+						match = AK_bloom_find_string(table->data, namesOfAtts[0], values[0]);
+						AK_DeleteAll_L3(&row2);
+						AK_free(row2);
+						AK_EPI;
+						return match ? EXIT_ERROR : EXIT_SUCCESS;
+					}
 					
 					for(h=0; h<numRows; h++)
 					{
@@ -296,7 +306,7 @@ int AK_read_constraint_unique(char* tableName, char attName[], char newValue[]){
 						for(impoIndexInArray=0; (impoIndexInArray<numOfImpAttPos)&&(match==1); impoIndexInArray++)
 						{
 							attribute2 = AK_GetNth_L2(positionsOfAtts[impoIndexInArray], row2);
-							if(AK_tuple_to_string(attribute2) == NULL)
+							if(attribute2->is_null)
 							{
 								match = 0;
 							}
@@ -377,12 +387,13 @@ int AK_read_constraint_unique(char* tableName, char attName[], char newValue[]){
 			for(impoIndexInArray=0; (impoIndexInArray<numOfImpAttPos)&&(match==1); impoIndexInArray++)
 			{
 				attribute2 = AK_GetNth_L2(positionsOfAtts[impoIndexInArray], row);
-				tuple_to_string_return = AK_tuple_to_string(attribute2);
-				if(tuple_to_string_return == NULL)
+				if(attribute2->is_null)
 				{
 					match = 0;
+					continue;
 				}
-				else if(strcmp(values[impoIndexInArray], tuple_to_string_return) != 0)
+				tuple_to_string_return = AK_tuple_to_string(attribute2);
+				if(strcmp(values[impoIndexInArray], tuple_to_string_return) != 0)
 				{
 					match = 0 ;
 					AK_free(tuple_to_string_return);
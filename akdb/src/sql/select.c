@@ -40,14 +40,21 @@ int AK_apply_select_by_condition(char *src_table, char *selection_table, struct
 
 /**
  * @author Filip Žmuk, Edited by: Marko Belusic
- * @brief Helper function in SELECT clause which does the ordering
- * @param ordering - condition on which to order
+ * @brief Helper function in SELECT clause which does the ordering. With a limit the rows are taken by
+ *        the Top-N operator (AK_top_n) instead of sorting the whole table.
+ * @param ordering - attributes to order by, each optionally followed by a TYPE_OPERATOR node "ASC" or "DESC"
  * @param sorted_table - table in which result of applied ordering is stored
  * @param selection_table - table in which result of applied condition is stored
+ * @param limit - maximum number of result rows, 0 for no limit
  * @return EXIT_SUCCESS if there was no error ordering
  */
-int AK_apply_select_by_sorting(char *sorted_table, char *selection_table, struct list_node *ordering){
+int AK_apply_select_by_sorting(char *sorted_table, char *selection_table, struct list_node *ordering, int limit){
     strcat(sorted_table, selection_table);
+    if (limit > 0)
+    {
+        strcat(sorted_table, "__top");
+        return AK_top_n(selection_table, sorted_table, ordering, limit);
+    }
     //sort required rows
     if (ordering != NULL)
     {
@@ -119,9 +126,10 @@ void AK_clear_projection_attributes(struct list_node *projection_attributes){
  * @param projection_attributes - projected attributes
  * @param sorted_table - temp table for sorting
  * @param ordering - atributes for result sorting
+ * @param limit - maximum number of result rows, 0 for no limit
  * @return EXIT_SUCCESS or EXIT_ERROR
  */
-int AK_apply_select(char *srcTable, char *selection_table, struct list_node *condition, struct list_node *attributes, struct list_node *projection_attributes, char *sorted_table, struct list_node *ordering){
+int AK_apply_select(char *srcTable, char *selection_table, struct list_node *condition, struct list_node *attributes, struct list_node *projection_attributes, char *sorted_table, struct list_node *ordering, int limit){
     if (AK_apply_select_by_condition(srcTable, selection_table, condition) != EXIT_SUCCESS){
         return EXIT_ERROR;
     }
@@ -130,7 +138,7 @@ int AK_apply_select(char *srcTable, char *selection_table, struct list_node *con
     AK_create_copy_of_attributes(attributes, projection_attributes);
 
     //create help table name for sorting
-    if (AK_apply_select_by_sorting(sorted_table, selection_table, ordering) != EXIT_SUCCESS){
+    if (AK_apply_select_by_sorting(sorted_table, selection_table, ordering, limit) != EXIT_SUCCESS){
         return EXIT_ERROR;
     }
     return EXIT_SUCCESS;
@@ -138,15 +146,16 @@ int AK_apply_select(char *srcTable, char *selection_table, struct list_node *con
 
 /**
  * @author Filip Žmuk, Edited by: Marko Belusic
- * @brief Function that implements SELECT relational operator
+ * @brief Function that implements SELECT relational operator with a LIMIT clause
  * @param src_table - original table that is used for selection
  * @param dest_table - table that contains the result
  * @param condition - condition for selection
  * @param attributes - atributes to be selected
  * @param ordering - atributes for result sorting
+ * @param limit - maximum number of result rows, 0 for no limit
  * @return EXIT_SUCCESS if cache result in memory and print table else break 
  */
-int AK_select(char *src_table, char *dest_table, struct list_node *attributes, struct list_node *condition, struct list_node *ordering)
+int AK_select_limit(char *src_table, char *dest_table, struct list_node *attributes, struct list_node *condition, struct list_node *ordering, int limit)
 {
     AK_PRO;
     //create help table name for selection
@@ -154,7 +163,7 @@ int AK_select(char *src_table, char *dest_table, struct list_node *attributes, s
     struct list_node *projectionAttributes = (struct list_node *)AK_malloc(sizeof(struct list_node));
     char sorted_table[ MAX_ATT_NAME ] = "";
 
-    if(AK_apply_select(src_table, selection_table, condition, attributes, projectionAttributes, sorted_table, ordering) != EXIT_SUCCESS){
+    if(AK_apply_select(src_table, selection_table, condition, attributes, projectionAttributes, sorted_table, ordering, limit) != EXIT_SUCCESS){
         AK_clear_projection_attributes(projectionAttributes);
         AK_EPI;
         return EXIT_ERROR;
@@ -176,6 +185,25 @@ int AK_select(char *src_table, char *dest_table, struct list_node *attributes, s
     return EXIT_SUCCESS;
 }
 
+/**
+ * @author Filip Žmuk, Edited by: Marko Belusic
+ * @brief Function that implements SELECT relational operator
+ * @param src_table - original table that is used for selection
+ * @param dest_table - table that contains the result
+ * @param condition - condition for selection
+ * @param attributes - atributes to be selected
+ * @param ordering - atributes for result sorting
+ * @return EXIT_SUCCESS if cache result in memory and print table else break 
+ */
+int AK_select(char *src_table, char *dest_table, struct list_node *attributes, struct list_node *condition, struct list_node *ordering)
+{
+    int result;
+    AK_PRO;
+    result = AK_select_limit(src_table, dest_table, attributes, condition, ordering, 0);
+    AK_EPI;
+    return result;
+}
+
 /**
  * @author Renata Mesaros, updated by Filip Žmuk and Josip Susnjara
  * @brief Function for testing the implementation
@@ -199,6 +227,7 @@ TestResult AK_select_test(){
 	char *src_table="student";
 	char *dest_table1="select_result1";
     char *dest_table2="select_result2";
+    char *dest_table3="select_result3";
 
 	AK_Init_L3(&attributes);
 	AK_InsertAtEnd_L3(TYPE_ATTRIBS, "firstname", sizeof("firstname"), attributes);
@@ -240,14 +269,31 @@ TestResult AK_select_test(){
     {
         failed_tests++;
     }
+
+    AK_Init_L3(&ordering);
+	AK_InsertAtEnd_L3(TYPE_ATTRIBS, "year", sizeof("year"), ordering);
+	AK_InsertAtEnd_L3(TYPE_OPERATOR, "DESC", sizeof("DESC"), ordering);
+
+    if (AK_select_limit(src_table, dest_table3, attributes, NULL, ordering, 3) == EXIT_SUCCESS
+        && AK_get_num_records(dest_table3) == 3)
+    {
+        succesful_tests++;
+    }
+    else
+    {
+        failed_tests++;
+    }
     
     AK_DeleteAll_L3(&attributes);
+    AK_DeleteAll_L3(&ordering);
 	
     AK_print_table(src_table);
 	printf("\n SELECT firstname, year, weight, weight+year FROM student WHERE year < 2008 ORDER BY firstname;\n\n");
     AK_print_table(dest_table1);
     printf("\n SELECT firstname, year FROM select_result1;\n\n");
     AK_print_table(dest_table2);
+    printf("\n SELECT firstname, year FROM student ORDER BY year DESC LIMIT 3;\n\n");
+    AK_print_table(dest_table3);
 	
     //free memory
 	AK_free(attributes);
@@ -257,6 +303,7 @@ TestResult AK_select_test(){
     // reset all the tables
     AK_delete_segment(dest_table1, SEGMENT_TYPE_TABLE);
     AK_delete_segment(dest_table2, SEGMENT_TYPE_TABLE);
+    AK_delete_segment(dest_table3, SEGMENT_TYPE_TABLE);
 	AK_EPI;
 
 	return TEST_result(succesful_tests, failed_tests);
@@ -38,4 +38,18 @@
  * @return EXIT_SUCCESS if cache result in memory and print table else break 
  */
 int AK_select(char *srcTable,char *destTable,struct list_node *attributes,struct list_node *condition, struct list_node *ordering);
+
+/**
+ * @author Filip Žmuk
+ * @brief Function that implements SELECT relational operator with a LIMIT clause. Ordered rows are
+ *        picked with a bounded heap (AK_top_n), the source is never fully sorted.
+ * @param srcTable - original table that is used for selection
+ * @param destTable - table that contains the result
+ * @param condition - condition for selection
+ * @param attributes - atributes to be selected
+ * @param ordering - atributes for result sorting
+ * @param limit - maximum number of result rows, 0 for no limit
+ * @return EXIT_SUCCESS if cache result in memory and print table else break
+ */
+int AK_select_limit(char *srcTable,char *destTable,struct list_node *attributes,struct list_node *condition, struct list_node *ordering, int limit);
 TestResult AK_select_test();
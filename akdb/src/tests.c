@@ -6,6 +6,9 @@
 #include "auxi/constants.h"
 #include "auxi/configuration.h"
 #include "auxi/dictionary.h"
+#include "auxi/arena.h"
+#include "auxi/comparator.h"
+#include "auxi/lz.h"
 // Disk management
 #include "dm/dbman.h"
 // Memory wrappers and debug mode
@@ -17,6 +20,12 @@
 #include "file/files.h"
 #include "file/filesearch.h"
 #include "file/filesort.h"
+#include "file/vacuum.h"
+#include "file/zonemap.h"
+#include "file/bloom.h"
+#include "file/encoding.h"
+#include "file/pax.h"
+#include "file/append.h"
 #include "file/table.h"
 #include "file/test.h"
 #include "file/sequence.h"
@@ -70,12 +79,16 @@ Test tests[] = {
 {"auxi: AK_mempro", &AK_mempro_test},//auxi/mempro.c
 {"auxi: AK_dictionary", &AK_dictionary_test},//auxi/dictionary.c
 {"auxi: AK_iniparser", &AK_iniparser_test},//auxi/iniparser.c
-//6 total
+{"auxi: AK_arena", &AK_arena_test},//auxi/arena.c
+{"auxi: AK_comparator", &AK_comparator_test},//auxi/comparator.c
+{"auxi: AK_lz", &AK_lz_test},//auxi/lz.c
+//7 total
 //dm:
 //-------
 {"dm: AK_allocationbit", &AK_allocationbit_test}, //dm/dbman.c
 {"dm: AK_allocationtable", &AK_allocationtable_test}, //dm/dbman.c
 {"dm: AK_thread_safe_block_access", &AK_thread_safe_block_access_test}, //dm/dbman.c
+{"dm: AK_block_compression", &AK_block_compression_test}, //dm/dbman.c
 //3+6=9 total
 //file:
 //---------
@@ -88,6 +101,12 @@ Test tests[] = {
 {"file: AK_filesearch", &AK_filesearch_test}, //file/filesearch.c
 {"file: AK_sequence", &AK_sequence_test}, //file/sequence.c  //old 14, new 17, old user  rinkovec  named this as btree which is not 14=btree??
 {"file: AK_table_test", &AK_table_test}, //file/table.c //old 15, new 18
+{"file: AK_vacuum", &AK_vacuum_test}, //file/vacuum.c
+{"file: AK_zone_map", &AK_zone_map_test}, //file/zonemap.c
+{"file: AK_bloom", &AK_bloom_test}, //file/bloom.c
+{"file: AK_encoding", &AK_encoding_test}, //file/encoding.c
+{"file: AK_pax", &AK_pax_test}, //file/pax.c
+{"file: AK_append", &AK_append_test}, //file/append.c
 //9+9=18 total
 //file/idx:
 //-------------